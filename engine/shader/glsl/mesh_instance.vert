@@ -0,0 +1,80 @@
+#version 310 es
+
+#extension GL_GOOGLE_include_directive : enable
+
+#include "constants.h"
+#include "structures.h"
+
+struct DirectionalLight
+{
+    vec3  direction;
+    float _padding_direction;
+    vec3  color;
+    float _padding_color;
+};
+
+struct PointLight
+{
+    vec3  position;
+    float radius;
+    vec3  intensity;
+    float _padding_intensity;
+};
+
+layout(set = 0, binding = 0) readonly buffer _unused_name_perframe
+{
+    mat4             proj_view_matrix;
+    vec3             camera_position;
+    float            _padding_camera_position;
+    vec3             ambient_light;
+    float            _padding_ambient_light;
+    uint             point_light_num;
+    uint             _padding_point_light_num_1;
+    uint             _padding_point_light_num_2;
+    uint             _padding_point_light_num_3;
+    PointLight       scene_point_lights[m_max_point_light_count];
+    DirectionalLight scene_directional_light;
+    highp mat4       directional_light_proj_view;
+};
+
+layout(set = 3, binding = 0) readonly buffer _unused_name_instances
+{
+    VulkanMeshInstanceData instances[];
+};
+
+// written by mesh_instance_culling.comp, gl_InstanceIndex includes the first instance of the indirect draw
+layout(set = 3, binding = 1) readonly buffer _unused_name_visible_instances
+{
+    highp uint visible_instances[];
+};
+
+layout(location = 0) in vec3 in_position; // for some types as dvec3 takes 2 locations
+layout(location = 1) in vec3 in_normal;
+layout(location = 2) in vec3 in_tangent;
+layout(location = 3) in vec2 in_texcoord;
+
+layout(location = 0) out vec3 out_world_position; // output in framebuffer 0 for fragment shader
+layout(location = 1) out vec3 out_normal;
+layout(location = 2) out vec3 out_tangent;
+layout(location = 3) out vec2 out_texcoord;
+// read by the bindless fragment shaders only
+layout(location = 4) flat out highp uint out_material_index;
+
+void main()
+{
+    highp uint instance_index = visible_instances[gl_InstanceIndex];
+    highp mat4 model_matrix   = instances[instance_index].model_matrix;
+
+    out_world_position = (model_matrix * vec4(in_position, 1.0)).xyz;
+
+    gl_Position = proj_view_matrix * vec4(out_world_position, 1.0f);
+
+    // TODO: normal matrix
+    mat3x3 tangent_matrix = mat3x3(model_matrix[0].xyz, model_matrix[1].xyz, model_matrix[2].xyz);
+    out_normal            = normalize(tangent_matrix * in_normal);
+    out_tangent           = normalize(tangent_matrix * in_tangent);
+
+    out_texcoord = in_texcoord;
+
+    out_material_index = instances[instance_index].material_index;
+}
@@ -1,10 +1,7 @@
-struct VulkanMeshInstance
+struct VulkanMeshInstanceReference
 {
-    highp float enable_vertex_blending;
-    highp float _padding_enable_vertex_blending_1;
-    highp float _padding_enable_vertex_blending_2;
-    highp float _padding_enable_vertex_blending_3;
-    highp mat4  model_matrix;
+    highp uint instance_index;
+    highp uint joint_matrix_offset; // 0xFFFFFFFF if the instance is not skinned
 };
 
 struct VulkanMeshVertexJointBinding
@@ -12,3 +9,41 @@ struct VulkanMeshVertexJointBinding
     highp ivec4 indices;
     highp vec4  weights;
 };
+
+struct VulkanMeshInstanceData
+{
+    highp mat4  model_matrix;
+    highp vec3  bounding_box_center;
+    highp uint  batch_index;
+    highp vec3  bounding_box_half_extent;
+    highp uint  material_index;
+};
+
+// MeshBindlessMaterialStorageBufferObject, the texture indices are slots in the bindless texture array
+struct MeshBindlessMaterial
+{
+    highp vec4  baseColorFactor;
+    highp float metallicFactor;
+    highp float roughnessFactor;
+    highp float normalScale;
+    highp float occlusionStrength;
+    highp vec3  emissiveFactor;
+    highp uint  is_blend;
+    highp uint  is_double_sided;
+    highp uint  base_color_texture_index;
+    highp uint  metallic_roughness_texture_index;
+    highp uint  normal_texture_index;
+    highp uint  occlusion_texture_index;
+    highp uint  emissive_texture_index;
+    highp uint  _padding_texture_index_1;
+    highp uint  _padding_texture_index_2;
+};
+
+struct DrawIndexedIndirectCommand
+{
+    uint index_count;
+    uint instance_count;
+    uint first_index;
+    int  vertex_offset;
+    uint first_instance;
+};
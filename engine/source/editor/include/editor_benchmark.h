@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Piccolo
+{
+    class PiccoloEngine;
+
+    /// Performance report of the engine hot paths, run by the --bench option of the editor instead of the editor
+    /// itself. Every section times the code path as it is built, the results are logged so that the runs before
+    /// and after a change can be compared.
+    class PiccoloBenchmark
+    {
+    public:
+        void initialize(PiccoloEngine* engine_runtime);
+
+        void run();
+
+    protected:
+        // engine startup time to the first rendered frame
+        void benchmarkStartup();
+        // level component tick of 1k/10k/100k objects
+        void benchmarkComponentTick(size_t object_count);
+        // tryGetComponent against the former scan over the component type names
+        void benchmarkComponentLookup(size_t object_count);
+        // frustum and point light culling of 1k/10k/100k render entities
+        void benchmarkCulling(size_t object_count);
+        // heap allocations and time of a whole engine frame, and of the render system tick alone
+        void benchmarkFrameAllocations();
+        // engine frame time with 1 to 64 particle emitters
+        void benchmarkParticleEmitters();
+        // matrix, transform and quaternion kernels, scalar or simd as built with ENABLE_MATH_SIMD
+        void benchmarkMath();
+        // pose evaluation of 1,000 animated characters, serial and over the job system workers
+        void benchmarkAnimation();
+
+        PiccoloEngine* m_engine_runtime {nullptr};
+    };
+} // namespace Piccolo
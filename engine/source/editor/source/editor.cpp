@@ -1,5 +1,6 @@
 #include "editor//include/editor.h"
 
+#include "runtime/core/base/macro.h"
 #include "runtime/engine.h"
 #include "runtime/function/global/global_context.h"
 #include "runtime/function/render/render_camera.h"
@@ -32,6 +33,15 @@ namespace Piccolo
         g_is_editor_mode = true;
         m_engine_runtime = engine_runtime;
 
+        // the editor ui and scene manager access the world and the render scene from the main thread, the pipelined
+        // mode of RenderFrameLatency is only available to a runtime driven without the editor
+        if (m_engine_runtime->m_render_frame_latency != 0)
+        {
+            LOG_INFO("RenderFrameLatency {} is ignored by the editor, rendering on the main thread",
+                     m_engine_runtime->m_render_frame_latency);
+            m_engine_runtime->m_render_frame_latency = 0;
+        }
+
         EditorGlobalContextInitInfo init_info = {g_runtime_global_context.m_window_system.get(),
                                                  g_runtime_global_context.m_render_system.get(),
                                                  engine_runtime};
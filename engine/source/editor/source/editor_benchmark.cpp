@@ -0,0 +1,695 @@
+#include "editor/include/editor_benchmark.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/job/job_system.h"
+#include "runtime/core/math/axis_aligned.h"
+#include "runtime/core/math/math.h"
+#include "runtime/core/math/math_simd.h"
+#include "runtime/core/math/matrix4.h"
+#include "runtime/core/math/quaternion.h"
+#include "runtime/engine.h"
+
+#include "runtime/function/framework/component/animation/animation_component.h"
+#include "runtime/function/framework/component/component_storage.h"
+#include "runtime/function/framework/component/rigidbody/rigidbody_component.h"
+#include "runtime/function/framework/component/transform/transform_component.h"
+#include "runtime/function/framework/object/object.h"
+#include "runtime/function/global/global_context.h"
+#include "runtime/function/particle/particle_manager.h"
+#include "runtime/function/render/render_culling.h"
+#include "runtime/function/render/render_helper.h"
+#include "runtime/function/render/render_swap_context.h"
+#include "runtime/function/render/render_system.h"
+#include "runtime/function/render/window_system.h"
+
+#include "runtime/resource/asset_manager/asset_manager.h"
+#include "runtime/resource/res_type/common/object.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Piccolo
+{
+    namespace
+    {
+        constexpr float k_frame_delta_time = 1.0f / 60.0f;
+
+        // the first frame is rendered by the first tick, or a few ticks later by the render thread
+        constexpr uint32_t k_max_startup_frame_count = 16;
+
+        // the culled entities are scattered in a cube of this half extent around the camera
+        constexpr float    k_culling_scene_extent     = 500.0f;
+        constexpr uint32_t k_culling_point_light_count = 8;
+
+        constexpr uint32_t k_allocation_warm_up_frame_count = 8;
+        constexpr uint32_t k_allocation_frame_count         = 120;
+
+        constexpr uint32_t k_max_particle_emitter_count = 64;
+        // the new emitters are created by the render system within these frames
+        constexpr uint32_t k_particle_warm_up_frame_count = 8;
+        constexpr uint32_t k_particle_frame_count         = 120;
+
+        // elements per math kernel call, small enough to stay in the caches
+        constexpr size_t k_math_element_count = 4096;
+        constexpr size_t k_math_repeat_count  = 256;
+
+        // the animated character of the demo level
+        constexpr const char* k_animated_object_definition_url = "asset/objects/character/player/player.object.json";
+        constexpr size_t      k_animated_character_count       = 1000;
+        constexpr size_t      k_animation_frame_count          = 60;
+
+        // every object count runs about the same number of component updates
+        size_t getRepeatCount(size_t object_count) { return std::max<size_t>(1, 1000000 / object_count); }
+
+        // average duration of one call of function in milliseconds
+        template<typename Function>
+        double measureMilliseconds(size_t repeat_count, Function&& function)
+        {
+            using namespace std::chrono;
+
+            const steady_clock::time_point begin_time_point = steady_clock::now();
+            for (size_t repeat_index = 0; repeat_index < repeat_count; ++repeat_index)
+            {
+                function();
+            }
+            return duration<double, std::milli>(steady_clock::now() - begin_time_point).count() / repeat_count;
+        }
+
+#if defined(PICCOLO_BENCHMARK_ALLOCATION_COUNT)
+        // allocations through the global operator new of the executable, from any thread
+        std::atomic<uint64_t> s_allocation_count {0};
+
+        void* countedAllocate(std::size_t size)
+        {
+            s_allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+            void* memory = std::malloc(size != 0 ? size : 1);
+            if (!memory)
+                throw std::bad_alloc();
+            return memory;
+        }
+
+        void* countedAlignedAllocate(std::size_t size, std::align_val_t alignment)
+        {
+            s_allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+            // aligned_alloc takes a multiple of the alignment only
+            const std::size_t alignment_size = static_cast<std::size_t>(alignment);
+            const std::size_t aligned_size =
+                (std::max<std::size_t>(size, 1) + alignment_size - 1) & ~(alignment_size - 1);
+#if defined(_MSC_VER)
+            void* memory = _aligned_malloc(aligned_size, alignment_size);
+#else
+            void* memory = std::aligned_alloc(alignment_size, aligned_size);
+#endif
+            if (!memory)
+                throw std::bad_alloc();
+            return memory;
+        }
+
+        void alignedFree(void* memory) noexcept
+        {
+#if defined(_MSC_VER)
+            _aligned_free(memory);
+#else
+            std::free(memory);
+#endif
+        }
+
+        constexpr bool k_is_allocation_count_enabled = true;
+
+        uint64_t getAllocationCount() { return s_allocation_count.load(std::memory_order_relaxed); }
+#else
+        constexpr bool k_is_allocation_count_enabled = false;
+
+        uint64_t getAllocationCount() { return 0; }
+#endif
+
+        // keeps the benchmarked results alive
+        volatile size_t s_benchmark_sink {0};
+        volatile float  s_benchmark_float_sink {0.0f};
+
+        // objects owning the component returned by create_component each, the ids are their indices
+        template<typename CreateComponent>
+        std::vector<std::shared_ptr<GObject>> createObjects(size_t object_count, CreateComponent&& create_component)
+        {
+            std::vector<std::shared_ptr<GObject>> objects;
+            objects.reserve(object_count);
+            for (size_t object_index = 0; object_index < object_count; ++object_index)
+            {
+                std::vector<Reflection::ReflectionPtr<Component>> components;
+                components.push_back(create_component());
+
+                auto object = std::make_shared<GObject>(object_index);
+                object->load(ObjectInstanceRes(), std::move(components));
+                objects.push_back(std::move(object));
+            }
+            return objects;
+        }
+
+        // the lookup tryGetComponent replaced, a linear scan comparing the type name of every component
+        Component* findComponentByTypeName(const std::vector<Reflection::ReflectionPtr<Component>>& components,
+                                           const std::string&                                       type_name)
+        {
+            for (const auto& component : components)
+            {
+                if (component.getTypeName() == type_name)
+                    return component.getPtr();
+            }
+            return nullptr;
+        }
+    } // namespace
+
+    void PiccoloBenchmark::initialize(PiccoloEngine* engine_runtime)
+    {
+        assert(engine_runtime);
+
+        m_engine_runtime = engine_runtime;
+
+        // the render system tick is measured on its own, which needs it on this thread
+        if (m_engine_runtime->m_render_frame_latency != 0)
+        {
+            LOG_INFO("RenderFrameLatency {} is ignored by the benchmark, rendering on the main thread",
+                     m_engine_runtime->m_render_frame_latency);
+            m_engine_runtime->m_render_frame_latency = 0;
+        }
+    }
+
+    void PiccoloBenchmark::run()
+    {
+        // before anything else renders a frame
+        benchmarkStartup();
+
+        for (size_t object_count : {1000, 10000, 100000})
+        {
+            benchmarkComponentTick(object_count);
+            benchmarkComponentLookup(object_count);
+            benchmarkCulling(object_count);
+        }
+
+        benchmarkFrameAllocations();
+        benchmarkParticleEmitters();
+        benchmarkMath();
+        benchmarkAnimation();
+    }
+
+    void PiccoloBenchmark::benchmarkStartup()
+    {
+        for (uint32_t frame_index = 0;
+             frame_index < k_max_startup_frame_count && m_engine_runtime->getStartupTime() < 0;
+             ++frame_index)
+        {
+            m_engine_runtime->tickOneFrame(k_frame_delta_time);
+        }
+
+        const int64_t startup_time = m_engine_runtime->getStartupTime();
+        if (startup_time < 0)
+        {
+            LOG_ERROR("startup: no frame rendered after {} frames", k_max_startup_frame_count);
+            return;
+        }
+        LOG_INFO("startup: first frame rendered {} ms after engine start", startup_time);
+    }
+
+    void PiccoloBenchmark::benchmarkComponentTick(size_t object_count)
+    {
+        std::vector<std::shared_ptr<GObject>> objects = createObjects(object_count, [] {
+            return Reflection::ReflectionPtr<Component>("TransformComponent", new TransformComponent());
+        });
+
+        // declared after the objects, the pools must not outlive the components
+        ComponentStorage component_storage;
+        for (const auto& object : objects)
+        {
+            component_storage.addObject(object);
+        }
+
+        const double tick_time = measureMilliseconds(getRepeatCount(object_count), [&component_storage] {
+            component_storage.tick(k_frame_delta_time);
+        });
+        LOG_INFO("component tick, {} objects: {:.3f} ms per frame, {:.1f} ns per object",
+                 object_count,
+                 tick_time,
+                 tick_time * 1e6 / object_count);
+    }
+
+    void PiccoloBenchmark::benchmarkComponentLookup(size_t object_count)
+    {
+        std::vector<std::shared_ptr<GObject>> objects = createObjects(object_count, [] {
+            return Reflection::ReflectionPtr<Component>("TransformComponent", new TransformComponent());
+        });
+
+        std::vector<std::vector<Reflection::ReflectionPtr<Component>>> object_components;
+        object_components.reserve(object_count);
+        for (const auto& object : objects)
+        {
+            object_components.push_back(object->getComponents());
+        }
+
+        const size_t repeat_count = getRepeatCount(object_count);
+
+        // the transform component is found, the rigid body component is missing as for most objects
+        const double type_index_hit_time = measureMilliseconds(repeat_count, [&objects] {
+            size_t found_count = 0;
+            for (const auto& object : objects)
+            {
+                found_count += object->tryGetComponent(TransformComponent) != nullptr;
+            }
+            s_benchmark_sink = s_benchmark_sink + found_count;
+        });
+        const double type_index_miss_time = measureMilliseconds(repeat_count, [&objects] {
+            size_t found_count = 0;
+            for (const auto& object : objects)
+            {
+                found_count += object->tryGetComponent(RigidBodyComponent) != nullptr;
+            }
+            s_benchmark_sink = s_benchmark_sink + found_count;
+        });
+
+        const std::string transform_type_name  = "TransformComponent";
+        const std::string rigid_body_type_name = "RigidBodyComponent";
+
+        const double type_name_hit_time = measureMilliseconds(repeat_count, [&] {
+            size_t found_count = 0;
+            for (const auto& components : object_components)
+            {
+                found_count += findComponentByTypeName(components, transform_type_name) != nullptr;
+            }
+            s_benchmark_sink = s_benchmark_sink + found_count;
+        });
+        const double type_name_miss_time = measureMilliseconds(repeat_count, [&] {
+            size_t found_count = 0;
+            for (const auto& components : object_components)
+            {
+                found_count += findComponentByTypeName(components, rigid_body_type_name) != nullptr;
+            }
+            s_benchmark_sink = s_benchmark_sink + found_count;
+        });
+
+        const double ns_per_lookup = 1e6 / object_count;
+        LOG_INFO("component lookup, {} objects: type index {:.1f} ns hit {:.1f} ns miss, "
+                 "type name {:.1f} ns hit {:.1f} ns miss",
+                 object_count,
+                 type_index_hit_time * ns_per_lookup,
+                 type_index_miss_time * ns_per_lookup,
+                 type_name_hit_time * ns_per_lookup,
+                 type_name_miss_time * ns_per_lookup);
+    }
+
+    void PiccoloBenchmark::benchmarkCulling(size_t object_count)
+    {
+        std::mt19937                          random_engine(static_cast<uint32_t>(object_count));
+        std::uniform_real_distribution<float> position_distribution(-k_culling_scene_extent, k_culling_scene_extent);
+
+        // unit boxes at random positions
+        std::vector<RenderEntity> entities(object_count);
+        RenderCulling             culling;
+        for (size_t entity_index = 0; entity_index < object_count; ++entity_index)
+        {
+            RenderEntity& entity = entities[entity_index];
+            entity.m_instance_id = static_cast<uint32_t>(entity_index);
+            entity.m_model_matrix.makeTrans(position_distribution(random_engine),
+                                            position_distribution(random_engine),
+                                            position_distribution(random_engine));
+            entity.m_bounding_box.update(Vector3::ZERO, Vector3::UNIT_SCALE);
+
+            culling.addOrUpdateEntity(entity, static_cast<uint32_t>(entity_index));
+        }
+
+        const Matrix4x4 view_matrix = Math::makeLookAtMatrix(Vector3::ZERO, Vector3::UNIT_X, Vector3::UNIT_Z);
+        const Matrix4x4 proj_matrix =
+            Math::makePerspectiveMatrix(Radian(Degree(60.0f)), 16.0f / 9.0f, 0.1f, 2.0f * k_culling_scene_extent);
+        const ClusterFrustum frustum =
+            CreateClusterFrustumFromMatrix(proj_matrix * view_matrix, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
+
+        std::vector<BoundingSphere> point_light_spheres(k_culling_point_light_count);
+        for (BoundingSphere& sphere : point_light_spheres)
+        {
+            sphere.m_center = Vector3(position_distribution(random_engine),
+                                      position_distribution(random_engine),
+                                      position_distribution(random_engine)) *
+                              0.1f;
+            sphere.m_radius = 0.2f * k_culling_scene_extent;
+        }
+
+        const size_t          repeat_count = getRepeatCount(object_count);
+        std::vector<uint32_t> visible_entities;
+
+        RenderCullingStats frustum_stats;
+        const double       frustum_time = measureMilliseconds(repeat_count, [&] {
+            frustum_stats = culling.cullFrustum(frustum, visible_entities);
+        });
+        RenderCullingStats point_light_stats;
+        const double       point_light_time = measureMilliseconds(repeat_count, [&] {
+            point_light_stats = culling.cullSpheres(point_light_spheres, visible_entities);
+        });
+
+        // the former path, the bounds of every entity are transformed and tested one by one
+        size_t       serial_frustum_visible_count = 0;
+        const double serial_frustum_time          = measureMilliseconds(repeat_count, [&] {
+            serial_frustum_visible_count = 0;
+            for (const RenderEntity& entity : entities)
+            {
+                const BoundingBox local_bounds(entity.m_bounding_box.getMinCorner(),
+                                               entity.m_bounding_box.getMaxCorner());
+                serial_frustum_visible_count +=
+                    TiledFrustumIntersectBox(frustum, BoundingBoxTransform(local_bounds, entity.m_model_matrix));
+            }
+        });
+        size_t       serial_point_light_visible_count = 0;
+        const double serial_point_light_time          = measureMilliseconds(repeat_count, [&] {
+            serial_point_light_visible_count = 0;
+            for (const RenderEntity& entity : entities)
+            {
+                const BoundingBox local_bounds(entity.m_bounding_box.getMinCorner(),
+                                               entity.m_bounding_box.getMaxCorner());
+                const BoundingBox world_bounds = BoundingBoxTransform(local_bounds, entity.m_model_matrix);
+
+                bool is_visible = true;
+                for (const BoundingSphere& sphere : point_light_spheres)
+                {
+                    if (!BoxIntersectsWithSphere(world_bounds, sphere))
+                    {
+                        is_visible = false;
+                        break;
+                    }
+                }
+                serial_point_light_visible_count += is_visible;
+            }
+        });
+
+        LOG_INFO("culling, {} entities: frustum {:.3f} ms ({} visible, {} culled, {} tested one by one), "
+                 "serial {:.3f} ms ({} visible)",
+                 object_count,
+                 frustum_time,
+                 frustum_stats.m_visible_count,
+                 frustum_stats.getCulledCount(),
+                 frustum_stats.m_candidate_count,
+                 serial_frustum_time,
+                 serial_frustum_visible_count);
+        LOG_INFO("culling, {} entities, {} point lights: {:.3f} ms ({} visible, {} culled), "
+                 "serial {:.3f} ms ({} visible)",
+                 object_count,
+                 k_culling_point_light_count,
+                 point_light_time,
+                 point_light_stats.m_visible_count,
+                 point_light_stats.getCulledCount(),
+                 serial_point_light_time,
+                 serial_point_light_visible_count);
+    }
+
+    void PiccoloBenchmark::benchmarkFrameAllocations()
+    {
+        for (uint32_t frame_index = 0; frame_index < k_allocation_warm_up_frame_count; ++frame_index)
+        {
+            m_engine_runtime->tickOneFrame(k_frame_delta_time);
+        }
+
+        // whole frames, world, components, physics and scripts included
+        const uint64_t frame_begin_allocation_count = getAllocationCount();
+
+        const double frame_time = measureMilliseconds(k_allocation_frame_count, [this] {
+            m_engine_runtime->tickOneFrame(k_frame_delta_time);
+        });
+
+        const uint64_t frame_allocation_count = getAllocationCount() - frame_begin_allocation_count;
+
+        // the render system tick alone, the render scene update and the command recording and submission through
+        // the rhi, the logic of the frame runs outside the measured part
+        std::shared_ptr<RenderSystem> render_system = g_runtime_global_context.m_render_system;
+        std::shared_ptr<WindowSystem> window_system = g_runtime_global_context.m_window_system;
+
+        double   render_time             = 0.0;
+        uint64_t render_allocation_count = 0;
+        for (uint32_t frame_index = 0; frame_index < k_allocation_frame_count; ++frame_index)
+        {
+            g_runtime_global_context.m_job_system->beginFrame();
+            m_engine_runtime->logicalTick(k_frame_delta_time);
+            render_system->swapLogicRenderData();
+
+            const uint64_t render_begin_allocation_count = getAllocationCount();
+            render_time += measureMilliseconds(1, [&render_system] { render_system->tick(k_frame_delta_time); });
+            render_allocation_count += getAllocationCount() - render_begin_allocation_count;
+
+            window_system->pollEvents();
+        }
+        render_time /= k_allocation_frame_count;
+
+        if (k_is_allocation_count_enabled)
+        {
+            LOG_INFO("frame: {:.3f} ms, {:.1f} heap allocations per frame",
+                     frame_time,
+                     static_cast<double>(frame_allocation_count) / k_allocation_frame_count);
+            LOG_INFO("render recording: {:.3f} ms, {:.1f} heap allocations per frame",
+                     render_time,
+                     static_cast<double>(render_allocation_count) / k_allocation_frame_count);
+        }
+        else
+        {
+            LOG_INFO("frame: {:.3f} ms, render recording: {:.3f} ms, build with ENABLE_BENCHMARK_ALLOCATION_COUNT "
+                     "for the heap allocations",
+                     frame_time,
+                     render_time);
+        }
+    }
+
+    void PiccoloBenchmark::benchmarkParticleEmitters()
+    {
+        // the fountain of asset/objects/environment/particle
+        ParticleComponentRes particle_res;
+        particle_res.m_velocity     = Vector4(0.02f, 0.02f, 2.5f, 4.0f);
+        particle_res.m_acceleration = Vector4(0.0f, 0.0f, -2.5f, 0.0f);
+        particle_res.m_size         = Vector3(0.02f, 0.02f, 0.0f);
+        particle_res.m_emitter_type = 1;
+        particle_res.m_life         = Vector2(1.5f, 0.0f);
+        particle_res.m_color        = Vector4(9.047718f, 0.601811f, 0.0f, 1.0f);
+
+        std::shared_ptr<ParticleManager> particle_manager = g_runtime_global_context.m_particle_manager;
+        std::shared_ptr<RenderSystem>    render_system    = g_runtime_global_context.m_render_system;
+
+        std::vector<ParticleEmitterID> emitter_ids;
+        auto                           tick_frame = [this, &render_system, &emitter_ids] {
+            // the emitters are ticked by their particle components otherwise
+            RenderSwapData& logic_swap_data = render_system->getSwapContext().getLogicSwapData();
+            for (ParticleEmitterID emitter_id : emitter_ids)
+            {
+                logic_swap_data.addTickParticleEmitter(emitter_id);
+            }
+            m_engine_runtime->tickOneFrame(k_frame_delta_time);
+        };
+
+        const double base_frame_time = measureMilliseconds(k_particle_frame_count, tick_frame);
+        LOG_INFO("particles, no emitter: {:.3f} ms per frame", base_frame_time);
+
+        // emitters can't be destroyed, every step adds emitters to the ones of the previous step
+        for (uint32_t emitter_count = 1; emitter_count <= k_max_particle_emitter_count; emitter_count *= 2)
+        {
+            while (emitter_ids.size() < emitter_count)
+            {
+                ParticleEmitterTransformDesc transform_desc;
+                transform_desc.m_position = Vector4(2.0f * emitter_ids.size(), 0.0f, 0.0f, 1.0f);
+                transform_desc.m_rotation = Matrix4x4::IDENTITY;
+
+                particle_manager->createParticleEmitter(particle_res, transform_desc);
+                emitter_ids.push_back(transform_desc.m_id);
+            }
+
+            measureMilliseconds(k_particle_warm_up_frame_count, tick_frame);
+            const double frame_time = measureMilliseconds(k_particle_frame_count, tick_frame);
+            LOG_INFO("particles, {} emitters: {:.3f} ms per frame, {:.3f} ms over no emitter",
+                     emitter_count,
+                     frame_time,
+                     frame_time - base_frame_time);
+        }
+    }
+
+    void PiccoloBenchmark::benchmarkMath()
+    {
+        std::mt19937                          random_engine(0);
+        std::uniform_real_distribution<float> value_distribution(-1.0f, 1.0f);
+        auto                                  random_vector = [&] {
+            return Vector3(value_distribution(random_engine),
+                           value_distribution(random_engine),
+                           value_distribution(random_engine));
+        };
+
+        std::vector<Vector3>        positions(k_math_element_count);
+        std::vector<Vector3>        scales(k_math_element_count);
+        std::vector<Quaternion>     rotations(k_math_element_count);
+        std::vector<Matrix4x4>      matrices(k_math_element_count);
+        std::vector<AxisAlignedBox> boxes(k_math_element_count);
+        for (size_t element_index = 0; element_index < k_math_element_count; ++element_index)
+        {
+            positions[element_index] = random_vector() * 100.0f;
+            scales[element_index]    = Vector3(1.5f, 1.5f, 1.5f) + random_vector();
+            rotations[element_index] = Quaternion(Radian(Math_PI * value_distribution(random_engine)),
+                                                  (random_vector() + Vector3(0.0f, 0.0f, 2.0f)).normalisedCopy());
+            matrices[element_index].makeTransform(
+                positions[element_index], scales[element_index], rotations[element_index]);
+            boxes[element_index].update(random_vector() * 100.0f, scales[element_index]);
+        }
+
+        std::vector<Matrix4x4>      out_matrices(k_math_element_count);
+        std::vector<Vector3>        out_positions(k_math_element_count);
+        std::vector<Vector3>        out_scales(k_math_element_count);
+        std::vector<Quaternion>     out_rotations(k_math_element_count);
+        std::vector<AxisAlignedBox> out_boxes(k_math_element_count);
+
+        const double multiply_time = measureMilliseconds(k_math_repeat_count, [&] {
+            for (size_t element_index = 0; element_index < k_math_element_count; ++element_index)
+            {
+                out_matrices[element_index] =
+                    matrices[element_index] * matrices[k_math_element_count - 1 - element_index];
+            }
+        });
+        s_benchmark_float_sink = out_matrices.back()[0][0];
+
+        const double make_transform_time = measureMilliseconds(k_math_repeat_count, [&] {
+            for (size_t element_index = 0; element_index < k_math_element_count; ++element_index)
+            {
+                out_matrices[element_index].makeTransform(
+                    positions[element_index], scales[element_index], rotations[element_index]);
+            }
+        });
+        s_benchmark_float_sink = out_matrices.back()[0][3];
+
+        const double decomposition_time = measureMilliseconds(k_math_repeat_count, [&] {
+            for (size_t element_index = 0; element_index < k_math_element_count; ++element_index)
+            {
+                matrices[element_index].decomposition(
+                    out_positions[element_index], out_scales[element_index], out_rotations[element_index]);
+            }
+        });
+        s_benchmark_float_sink = out_positions.back().x + out_scales.back().x + out_rotations.back().w;
+
+        const double nlerp_time = measureMilliseconds(k_math_repeat_count, [&] {
+            for (size_t element_index = 0; element_index < k_math_element_count; ++element_index)
+            {
+                out_rotations[element_index] = Quaternion::nLerp(
+                    0.25f, rotations[element_index], rotations[k_math_element_count - 1 - element_index], true);
+            }
+        });
+        s_benchmark_float_sink = out_rotations.back().w;
+
+        const Matrix4x4& batch_matrix = matrices.front();
+
+        const double point_batch_time = measureMilliseconds(k_math_repeat_count, [&] {
+            batch_matrix.transformPoints(positions.data(), out_positions.data(), k_math_element_count);
+        });
+        s_benchmark_float_sink = out_positions.back().x;
+
+        const double box_batch_time = measureMilliseconds(k_math_repeat_count, [&] {
+            batch_matrix.transformAxisAlignedBoxes(boxes.data(), out_boxes.data(), k_math_element_count);
+        });
+        s_benchmark_float_sink = out_boxes.back().getMaxCorner().x;
+
+#if defined(PICCOLO_MATH_SSE)
+        const char* math_backend = "simd";
+#else
+        const char* math_backend = "scalar";
+#endif
+        const double ns_per_element = 1e6 / k_math_element_count;
+        LOG_INFO("math ({}), ns per element: matrix multiply {:.2f}, makeTransform {:.2f}, decomposition {:.2f}, "
+                 "nLerp {:.2f}, point batch {:.2f}, box batch {:.2f}",
+                 math_backend,
+                 multiply_time * ns_per_element,
+                 make_transform_time * ns_per_element,
+                 decomposition_time * ns_per_element,
+                 nlerp_time * ns_per_element,
+                 point_batch_time * ns_per_element,
+                 box_batch_time * ns_per_element);
+    }
+
+    void PiccoloBenchmark::benchmarkAnimation()
+    {
+        ObjectDefinitionRes definition_res;
+        if (!g_runtime_global_context.m_asset_manager->loadAsset(k_animated_object_definition_url, definition_res))
+        {
+            LOG_ERROR("animation benchmark skipped, can't load {}", k_animated_object_definition_url);
+            return;
+        }
+
+        const AnimationComponent* source_component = nullptr;
+        for (const auto& component : definition_res.m_components)
+        {
+            if (component.getTypeName() == "AnimationComponent")
+            {
+                source_component = static_cast<const AnimationComponent*>(component.getPtr());
+                break;
+            }
+        }
+
+        if (source_component)
+        {
+            // copies of the loaded component, every character gets its own skeleton and blender once loaded
+            std::vector<std::shared_ptr<GObject>> characters =
+                createObjects(k_animated_character_count, [source_component] {
+                    return Reflection::ReflectionPtr<Component>("AnimationComponent",
+                                                                new AnimationComponent(*source_component));
+                });
+
+            ComponentStorage component_storage;
+            for (const auto& character : characters)
+            {
+                component_storage.addObject(character);
+            }
+
+            const double serial_time = measureMilliseconds(k_animation_frame_count, [&characters] {
+                for (const auto& character : characters)
+                {
+                    character->tryGetComponent(AnimationComponent)->tick(k_frame_delta_time);
+                }
+            });
+            // the animation component pool ticks in parallel
+            const double parallel_time = measureMilliseconds(k_animation_frame_count, [&component_storage] {
+                component_storage.tick(k_frame_delta_time);
+            });
+
+            LOG_INFO("animation, {} characters of {} bones: serial {:.3f} ms per frame, parallel {:.3f} ms per frame",
+                     k_animated_character_count,
+                     characters.front()->tryGetComponent(AnimationComponent)->getSkeleton().getBonesCount(),
+                     serial_time,
+                     parallel_time);
+        }
+        else
+        {
+            LOG_ERROR("animation benchmark skipped, {} has no animation component", k_animated_object_definition_url);
+        }
+
+        for (auto& component : definition_res.m_components)
+        {
+            PICCOLO_REFLECTION_DELETE(component);
+        }
+    }
+} // namespace Piccolo
+
+#if defined(PICCOLO_BENCHMARK_ALLOCATION_COUNT)
+// the replaceable global allocation functions, so that the benchmark counts the heap allocations of a frame, the
+// nothrow forms of the standard library forward to these
+void* operator new(std::size_t size) { return Piccolo::countedAllocate(size); }
+void* operator new[](std::size_t size) { return Piccolo::countedAllocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return Piccolo::countedAlignedAllocate(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return Piccolo::countedAlignedAllocate(size, alignment);
+}
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { Piccolo::alignedFree(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { Piccolo::alignedFree(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { Piccolo::alignedFree(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { Piccolo::alignedFree(memory); }
+#endif
@@ -5,8 +5,11 @@
 #include <unordered_map>
 
 #include "runtime/engine.h"
+#include "runtime/function/global/global_context.h"
+#include "runtime/resource/asset_manager/asset_manager.h"
 
 #include "editor/include/editor.h"
+#include "editor/include/editor_benchmark.h"
 
 // https://gcc.gnu.org/onlinedocs/cpp/Stringizing.html
 #define PICCOLO_XSTR(s) PICCOLO_STR(s)
@@ -22,6 +25,28 @@ int main(int argc, char** argv)
     engine->startEngine(config_file_path.generic_string());
     engine->initialize();
 
+    // offline step: write the cooked version of every json asset next to it and exit
+    if (argc > 1 && std::string(argv[1]) == "--cook-assets")
+    {
+        const Piccolo::AssetCookStats stats = Piccolo::g_runtime_global_context.m_asset_manager->cookAssets();
+
+        engine->clear();
+        engine->shutdownEngine();
+        return stats.m_failed_count == 0 ? 0 : 1;
+    }
+
+    // log the timings of the engine hot paths and exit
+    if (argc > 1 && std::string(argv[1]) == "--bench")
+    {
+        Piccolo::PiccoloBenchmark benchmark;
+        benchmark.initialize(engine);
+        benchmark.run();
+
+        engine->clear();
+        engine->shutdownEngine();
+        return 0;
+    }
+
     Piccolo::PiccoloEditor* editor = new Piccolo::PiccoloEditor();
     editor->initialize(engine);
 
@@ -21,6 +21,7 @@ namespace Generator
         GeneratorInterface::prepareStatus(path);
         TemplateManager::getInstance()->loadTemplates(m_root_path, "commonReflectionFile");
         TemplateManager::getInstance()->loadTemplates(m_root_path, "allReflectionFile");
+        TemplateManager::getInstance()->loadTemplates(m_root_path, "allComponentType");
         return;
     }
 
@@ -53,6 +54,12 @@ namespace Generator
             class_names.insert_or_assign(class_temp->getClassName(), false);
             class_names[class_temp->getClassName()] = true;
 
+            std::vector<std::string>& base_names = m_class_base_names[class_temp->getClassName()];
+            for (auto& base_class : class_temp->m_base_classes)
+            {
+                base_names.emplace_back(base_class->name);
+            }
+
             std::vector<std::string>                                   field_names;
             std::map<std::string, std::pair<std::string, std::string>> vector_map;
 
@@ -135,6 +142,47 @@ namespace Generator
         std::string render_string =
             TemplateManager::getInstance()->renderByTemplate("allReflectionFile", mustache_data);
         Utils::saveFile(render_string, m_out_path + "/all_reflection.h");
+
+        generateComponentTypes();
+    }
+
+    void ReflectionGenerator::generateComponentTypes()
+    {
+        static const std::string component_base_name = "Component";
+
+        std::function<bool(const std::string&, int)> is_component = [&](const std::string& class_name, int depth) {
+            auto iter = m_class_base_names.find(class_name);
+            if (iter == m_class_base_names.end() || depth > 16)
+                return false;
+            for (auto& base_name : iter->second)
+            {
+                if (base_name == component_base_name || is_component(base_name, depth + 1))
+                    return true;
+            }
+            return false;
+        };
+
+        // the map is sorted by class name, the indices are stable as long as the set of components is
+        Mustache::data component_defines = Mustache::data::type::list;
+        size_t         component_count   = 0;
+        for (auto& class_base_names : m_class_base_names)
+        {
+            if (!is_component(class_base_names.first, 0))
+                continue;
+
+            Mustache::data component_define;
+            component_define.set("class_name", class_base_names.first);
+            component_define.set("component_type_index", std::to_string(component_count));
+            component_defines.push_back(component_define);
+            ++component_count;
+        }
+
+        Mustache::data mustache_data;
+        mustache_data.set("component_defines", component_defines);
+        mustache_data.set("component_type_count", std::to_string(component_count));
+        std::string render_string =
+            TemplateManager::getInstance()->renderByTemplate("allComponentType", mustache_data);
+        Utils::saveFile(render_string, m_out_path + "/all_component_type.h");
     }
 
     ReflectionGenerator::~ReflectionGenerator() {}
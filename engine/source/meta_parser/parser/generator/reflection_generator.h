@@ -1,5 +1,9 @@
 #pragma once
 #include "generator/generator.h"
+
+#include <map>
+#include <vector>
+
 namespace Generator
 {
     class ReflectionGenerator : public GeneratorInterface
@@ -16,7 +20,11 @@ namespace Generator
         virtual std::string processFileName(std::string path) override;
 
     private:
+        void generateComponentTypes();
+
         std::vector<std::string> m_head_file_list;
         std::vector<std::string> m_sourcefile_list;
+        // base class names of every reflected class, used to find the component types
+        std::map<std::string, std::vector<std::string>> m_class_base_names;
     };
 } // namespace Generator
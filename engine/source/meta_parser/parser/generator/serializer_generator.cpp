@@ -43,9 +43,13 @@ namespace Generator
             Mustache::data class_def;
             genClassRenderData(class_temp, class_def);
 
+            m_schema_text += "class " + class_temp->getClassName() + ";";
+
             // deal base class
             for (int index = 0; index < class_temp->m_base_classes.size(); ++index)
             {
+                m_schema_text += "base " + class_temp->m_base_classes[index]->name + ";";
+
                 auto include_file = m_get_include_func(class_temp->m_base_classes[index]->name);
                 if (!include_file.empty())
                 {
@@ -61,6 +65,9 @@ namespace Generator
             {
                 if (!field->shouldCompile())
                     continue;
+
+                m_schema_text += "field " + field->m_type + " " + field->m_name + ";";
+
                 // deal vector
                 if (field->m_type.find("std::vector") == 0)
                 {
@@ -94,9 +101,18 @@ namespace Generator
 
     void SerializerGenerator::finish()
     {
+        // 64 bit FNV-1a, stable across compilers unlike std::hash
+        uint64_t schema_hash = 14695981039346656037ull;
+        for (unsigned char c : m_schema_text)
+        {
+            schema_hash ^= c;
+            schema_hash *= 1099511628211ull;
+        }
+
         Mustache::data mustache_data;
         mustache_data.set("class_defines", m_class_defines);
         mustache_data.set("include_headfiles", m_include_headfiles);
+        mustache_data.set("schema_hash", std::to_string(schema_hash));
 
         std::string render_string = TemplateManager::getInstance()->renderByTemplate("allSerializer.h", mustache_data);
         Utils::saveFile(render_string, m_out_path + "/all_serializer.h");
@@ -22,5 +22,7 @@ namespace Generator
     private:
         Mustache::data m_class_defines {Mustache::data::type::list};
         Mustache::data m_include_headfiles {Mustache::data::type::list};
+        // every serialized class, base class and field in generation order, hashed into the cooked asset version
+        std::string m_schema_text;
     };
 } // namespace Generator
@@ -0,0 +1,378 @@
+#include "runtime/core/job/job_system.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Piccolo
+{
+    namespace
+    {
+        thread_local const JobSystem* t_owner_job_system {nullptr};
+        thread_local uint32_t         t_worker_index {0};
+
+        int64_t getNowNanoseconds()
+        {
+            using namespace std::chrono;
+            return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+        }
+    } // namespace
+
+    JobSystem::~JobSystem() { clear(); }
+
+    void JobSystem::initialize(uint32_t worker_count)
+    {
+        if (worker_count == 0)
+        {
+            const uint32_t hardware_thread_count = std::thread::hardware_concurrency();
+            worker_count = hardware_thread_count > 1 ? hardware_thread_count - 1 : 1;
+        }
+
+        m_is_quit          = false;
+        m_worker_count     = worker_count;
+        m_frame_begin_time = getNowNanoseconds();
+
+        // the queues must be ready before any worker starts to steal
+        for (uint32_t queue_index = 0; queue_index <= worker_count; ++queue_index)
+        {
+            m_queues.push_back(std::make_unique<JobQueue>());
+            m_profile_buffers.push_back(std::make_unique<ProfileBuffer>());
+        }
+
+        for (uint32_t worker_index = 0; worker_index < worker_count; ++worker_index)
+        {
+            m_workers.emplace_back(&JobSystem::workerMain, this, worker_index);
+        }
+    }
+
+    void JobSystem::clear()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_wake_mutex);
+            m_is_quit = true;
+        }
+        m_wake_condition.notify_all();
+        m_waiter_condition.notify_all();
+
+        for (std::thread& worker : m_workers)
+        {
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+        m_workers.clear();
+        m_worker_count = 0;
+
+        m_queues.clear();
+        m_profile_buffers.clear();
+        m_queued_job_count = 0;
+    }
+
+    JobHandle JobSystem::schedule(const char* name, JobFunction function, const std::vector<JobHandle>& dependencies)
+    {
+        JobHandle job = std::make_shared<Job>(name, std::move(function));
+
+        for (const JobHandle& dependency : dependencies)
+        {
+            if (!dependency)
+                continue;
+
+            std::lock_guard<std::mutex> lock(dependency->m_dependents_mutex);
+            if (!dependency->isDone())
+            {
+                job->m_pending_dependency_count.fetch_add(1, std::memory_order_relaxed);
+                dependency->m_dependents.push_back(job);
+            }
+        }
+
+        // release the scheduling count, the job is queued here if no dependency is pending
+        if (job->m_pending_dependency_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            enqueue(job);
+        }
+
+        return job;
+    }
+
+    void JobSystem::wait(const JobHandle& job)
+    {
+        if (!job)
+            return;
+
+        waitUntilDone(job);
+        if (job->m_exception)
+        {
+            std::rethrow_exception(job->m_exception);
+        }
+    }
+
+    void JobSystem::waitAll(const std::vector<JobHandle>& jobs)
+    {
+        for (const JobHandle& job : jobs)
+        {
+            if (job)
+            {
+                waitUntilDone(job);
+            }
+        }
+
+        for (const JobHandle& job : jobs)
+        {
+            if (job && job->m_exception)
+            {
+                std::rethrow_exception(job->m_exception);
+            }
+        }
+    }
+
+    void JobSystem::waitUntilDone(const JobHandle& job)
+    {
+        while (!job->isDone())
+        {
+            if (tryRunOneJob())
+                continue;
+
+            // the count is raised before the job is checked, execute and enqueue see it once they changed the state
+            std::unique_lock<std::mutex> lock(m_wake_mutex);
+            m_sleeping_waiter_count.fetch_add(1);
+            m_waiter_condition.wait(lock, [this, &job]() {
+                return job->m_is_done.load() || m_queued_job_count.load() > 0 || m_is_quit;
+            });
+            m_sleeping_waiter_count.fetch_sub(1);
+        }
+    }
+
+    void JobSystem::parallelFor(const char*                                 name,
+                                size_t                                      count,
+                                size_t                                      batch_size,
+                                const std::function<void(size_t, size_t)>& function)
+    {
+        if (count == 0)
+            return;
+
+        batch_size               = std::max<size_t>(batch_size, 1);
+        const size_t batch_count = (count + batch_size - 1) / batch_size;
+
+        // not worth a round trip through the queues
+        if (batch_count == 1 || m_worker_count == 0)
+        {
+            function(0, count);
+            return;
+        }
+
+        // every job pulls batches from a shared counter, so a slow batch doesn't stall the others
+        std::atomic<size_t> next_batch {0};
+        auto                run_batches = [&]() {
+            size_t batch_index;
+            while ((batch_index = next_batch.fetch_add(1, std::memory_order_relaxed)) < batch_count)
+            {
+                const size_t begin = batch_index * batch_size;
+                const size_t end   = std::min(begin + batch_size, count);
+                function(begin, end);
+            }
+        };
+
+        const size_t helper_count = std::min<size_t>(batch_count - 1, m_worker_count);
+
+        std::vector<JobHandle> helpers;
+        helpers.reserve(helper_count);
+        for (size_t helper_index = 0; helper_index < helper_count; ++helper_index)
+        {
+            helpers.push_back(schedule(name, run_batches));
+        }
+
+        // the helpers reference the locals of this frame, they must stop before an exception leaves it
+        std::exception_ptr exception;
+        try
+        {
+            run_batches();
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+            next_batch.store(batch_count, std::memory_order_relaxed);
+        }
+
+        for (const JobHandle& helper : helpers)
+        {
+            waitUntilDone(helper);
+            if (!exception)
+            {
+                exception = helper->m_exception;
+            }
+        }
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    bool JobSystem::tryRunOneJob()
+    {
+        JobHandle job = dequeue();
+        if (!job)
+            return false;
+
+        execute(job);
+        return true;
+    }
+
+    void JobSystem::beginFrame()
+    {
+        m_last_frame_records.clear();
+        for (auto& profile_buffer : m_profile_buffers)
+        {
+            std::lock_guard<std::mutex> lock(profile_buffer->m_mutex);
+            m_last_frame_records.insert(
+                m_last_frame_records.end(), profile_buffer->m_records.begin(), profile_buffer->m_records.end());
+            profile_buffer->m_records.clear();
+        }
+
+        std::sort(m_last_frame_records.begin(),
+                  m_last_frame_records.end(),
+                  [](const JobProfileRecord& lhs, const JobProfileRecord& rhs) {
+                      return lhs.m_start_ms < rhs.m_start_ms;
+                  });
+
+        m_frame_begin_time = getNowNanoseconds();
+    }
+
+    void JobSystem::workerMain(uint32_t worker_index)
+    {
+        t_owner_job_system = this;
+        t_worker_index     = worker_index;
+
+        while (true)
+        {
+            if (tryRunOneJob())
+                continue;
+
+            std::unique_lock<std::mutex> lock(m_wake_mutex);
+            m_wake_condition.wait(lock, [this]() { return m_is_quit || m_queued_job_count.load() > 0; });
+            if (m_is_quit)
+                break;
+        }
+
+        t_owner_job_system = nullptr;
+    }
+
+    uint32_t JobSystem::getCurrentQueueIndex() const
+    {
+        return t_owner_job_system == this ? t_worker_index : m_worker_count;
+    }
+
+    void JobSystem::enqueue(JobHandle job)
+    {
+        JobQueue& queue = *m_queues[getCurrentQueueIndex()];
+        {
+            std::lock_guard<std::mutex> lock(queue.m_mutex);
+            queue.m_jobs.push_back(std::move(job));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_wake_mutex);
+            m_queued_job_count.fetch_add(1);
+        }
+        m_wake_condition.notify_one();
+        notifyWaiters();
+    }
+
+    void JobSystem::notifyWaiters()
+    {
+        if (m_sleeping_waiter_count.load() == 0)
+            return;
+
+        // taking the lock orders the notification after the check of a waiter about to sleep
+        {
+            std::lock_guard<std::mutex> lock(m_wake_mutex);
+        }
+        m_waiter_condition.notify_all();
+    }
+
+    JobHandle JobSystem::dequeue()
+    {
+        if (m_queued_job_count.load(std::memory_order_relaxed) <= 0)
+            return nullptr;
+
+        const uint32_t queue_count = static_cast<uint32_t>(m_queues.size());
+        const uint32_t self_index  = getCurrentQueueIndex();
+
+        // newest job of our own queue first, it's the most likely to be hot in cache
+        {
+            JobQueue&                   queue = *m_queues[self_index];
+            std::lock_guard<std::mutex> lock(queue.m_mutex);
+            if (!queue.m_jobs.empty())
+            {
+                JobHandle job = std::move(queue.m_jobs.back());
+                queue.m_jobs.pop_back();
+                m_queued_job_count.fetch_sub(1);
+                return job;
+            }
+        }
+
+        // then steal the oldest job from the others
+        for (uint32_t offset = 1; offset < queue_count; ++offset)
+        {
+            JobQueue&                   queue = *m_queues[(self_index + offset) % queue_count];
+            std::lock_guard<std::mutex> lock(queue.m_mutex);
+            if (!queue.m_jobs.empty())
+            {
+                JobHandle job = std::move(queue.m_jobs.front());
+                queue.m_jobs.pop_front();
+                m_queued_job_count.fetch_sub(1);
+                return job;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void JobSystem::execute(const JobHandle& job)
+    {
+        const int64_t begin_time = getNowNanoseconds();
+
+        // the job is done either way, a throwing job must neither hang its waiters nor end the worker
+        try
+        {
+            job->m_function();
+        }
+        catch (...)
+        {
+            job->m_exception = std::current_exception();
+        }
+
+        const int64_t end_time = getNowNanoseconds();
+
+        // release the captured resources right away, the handle may live much longer
+        job->m_function = nullptr;
+
+        std::vector<JobHandle> dependents;
+        {
+            std::lock_guard<std::mutex> lock(job->m_dependents_mutex);
+            job->m_is_done.store(true);
+            dependents.swap(job->m_dependents);
+        }
+        notifyWaiters();
+
+        for (JobHandle& dependent : dependents)
+        {
+            if (dependent->m_pending_dependency_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                enqueue(std::move(dependent));
+            }
+        }
+
+        const uint32_t queue_index      = getCurrentQueueIndex();
+        const int64_t  frame_begin_time = m_frame_begin_time.load(std::memory_order_relaxed);
+
+        JobProfileRecord record;
+        record.m_name         = job->m_name;
+        record.m_thread_index = queue_index;
+        record.m_start_ms     = static_cast<float>(begin_time - frame_begin_time) * 1e-6f;
+        record.m_duration_ms  = static_cast<float>(end_time - begin_time) * 1e-6f;
+
+        ProfileBuffer&              profile_buffer = *m_profile_buffers[queue_index];
+        std::lock_guard<std::mutex> lock(profile_buffer.m_mutex);
+        profile_buffer.m_records.push_back(record);
+    }
+} // namespace Piccolo
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Piccolo
+{
+    using JobFunction = std::function<void()>;
+
+    class Job
+    {
+        friend class JobSystem;
+
+    public:
+        Job(const char* name, JobFunction function) : m_name(name), m_function(std::move(function)) {}
+
+        const char* getName() const { return m_name; }
+        bool        isDone() const { return m_is_done.load(std::memory_order_acquire); }
+
+    private:
+        const char* m_name {nullptr};
+        JobFunction m_function;
+
+        // one extra count is held by the scheduler until all dependencies are registered
+        std::atomic<uint32_t> m_pending_dependency_count {1};
+        std::atomic<bool>     m_is_done {false};
+        // what the function threw, written before the job is done
+        std::exception_ptr m_exception;
+
+        std::mutex                        m_dependents_mutex;
+        std::vector<std::shared_ptr<Job>> m_dependents;
+    };
+
+    using JobHandle = std::shared_ptr<Job>;
+
+    struct JobProfileRecord
+    {
+        const char* m_name {nullptr};
+        uint32_t    m_thread_index {0};
+        // relative to the beginning of the frame
+        float m_start_ms {0.f};
+        float m_duration_ms {0.f};
+    };
+
+    /// Engine wide work-stealing job system.
+    /// Each worker thread owns a job queue, it pops its own jobs in LIFO order and steals the oldest jobs from
+    /// other queues when it runs dry. Jobs submitted from non-worker threads go to a shared queue.
+    /// Threads waiting for a job (wait/parallelFor) execute other jobs, and sleep when there is none to run.
+    /// A job that throws is still done and releases its dependents, the exception is rethrown by the wait.
+    class JobSystem
+    {
+    public:
+        JobSystem() = default;
+        ~JobSystem();
+
+        // worker_count 0 means one worker per hardware thread except the calling thread
+        void initialize(uint32_t worker_count = 0);
+        void clear();
+
+        /// schedule a job, it starts as soon as all dependencies are done
+        /// @name: must outlive the job, string literals are expected
+        JobHandle schedule(const char* name, JobFunction function, const std::vector<JobHandle>& dependencies = {});
+
+        /// block until the job is done, the calling thread runs pending jobs meanwhile, rethrows what the job threw
+        void wait(const JobHandle& job);
+        /// wait for every job, then rethrow the first exception in the order of the jobs
+        void waitAll(const std::vector<JobHandle>& jobs);
+
+        /// run function(begin, end) over [0, count) split into batches, returns when all batches are done,
+        /// the first exception of a batch is rethrown once every batch has stopped
+        void parallelFor(const char*                                 name,
+                         size_t                                      count,
+                         size_t                                      batch_size,
+                         const std::function<void(size_t, size_t)>& function);
+
+        /// run one pending job on the calling thread, return false if there is nothing to run
+        bool tryRunOneJob();
+
+        uint32_t getWorkerCount() const { return m_worker_count; }
+        // workers plus the thread driving the frame
+        uint32_t getMaxConcurrency() const { return getWorkerCount() + 1; }
+
+        /// start a new profiling frame, the records of the previous frame become available
+        void                                 beginFrame();
+        const std::vector<JobProfileRecord>& getLastFrameProfile() const { return m_last_frame_records; }
+
+    private:
+        struct JobQueue
+        {
+            std::mutex            m_mutex;
+            std::deque<JobHandle> m_jobs;
+        };
+
+        struct ProfileBuffer
+        {
+            std::mutex                    m_mutex;
+            std::vector<JobProfileRecord> m_records;
+        };
+
+        void workerMain(uint32_t worker_index);
+
+        void      enqueue(JobHandle job);
+        JobHandle dequeue();
+        void      execute(const JobHandle& job);
+        // wait without rethrowing
+        void waitUntilDone(const JobHandle& job);
+        void notifyWaiters();
+
+        uint32_t getCurrentQueueIndex() const;
+
+        uint32_t                 m_worker_count {0};
+        std::vector<std::thread> m_workers;
+
+        // one queue and profile buffer per worker, the last ones are shared by non-worker threads
+        std::vector<std::unique_ptr<JobQueue>>      m_queues;
+        std::vector<std::unique_ptr<ProfileBuffer>> m_profile_buffers;
+
+        std::atomic<int32_t>    m_queued_job_count {0};
+        std::atomic<bool>       m_is_quit {false};
+        std::mutex              m_wake_mutex;
+        std::condition_variable m_wake_condition;
+        // threads in wait are woken when a job is done or queued, only notified while some of them sleep
+        std::atomic<int32_t>    m_sleeping_waiter_count {0};
+        std::condition_variable m_waiter_condition;
+
+        // steady clock time in nanoseconds, read by the workers when they record a job
+        std::atomic<int64_t>          m_frame_begin_time {0};
+        std::vector<JobProfileRecord> m_last_frame_records;
+    };
+} // namespace Piccolo
@@ -0,0 +1,136 @@
+#pragma once
+
+// SSE4.1/AVX2 kernels behind Matrix4x4, Quaternion and the batch transforms, selected at build time with the
+// ENABLE_MATH_SIMD cmake option. The math types keep their scalar layout, so that they can still be copied into
+// mapped gpu buffers whose offsets are only aligned to the device limits, hence the unaligned loads and stores.
+#if defined(PICCOLO_MATH_SIMD) && (defined(__SSE4_1__) || defined(__AVX__))
+#include <immintrin.h>
+#define PICCOLO_MATH_SSE
+#endif
+
+#if defined(PICCOLO_MATH_SSE)
+namespace Piccolo
+{
+    namespace SIMD
+    {
+        // a * b + c
+        inline __m128 madd(__m128 a, __m128 b, __m128 c)
+        {
+#if defined(__FMA__) || defined(__AVX2__)
+            return _mm_fmadd_ps(a, b, c);
+#else
+            return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+        }
+
+        template<int lane>
+        inline __m128 splat(__m128 v)
+        {
+            return _mm_shuffle_ps(v, v, _MM_SHUFFLE(lane, lane, lane, lane));
+        }
+
+        inline __m128 abs(__m128 v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+
+        inline __m128 loadVector3(const float* v, float w) { return _mm_set_ps(w, v[2], v[1], v[0]); }
+
+        inline void storeVector3(__m128 v, float* out)
+        {
+            _mm_store_ss(out, v);
+            _mm_store_ss(out + 1, splat<1>(v));
+            _mm_store_ss(out + 2, splat<2>(v));
+        }
+
+        // a row of a * b for the row major 4x4 matrices of Matrix4x4, a linear combination of the rows of b
+        inline __m128 multiplyRow(const float* a_row, __m128 b0, __m128 b1, __m128 b2, __m128 b3)
+        {
+#if defined(__AVX__)
+            // broadcasts straight from memory are load port operations with avx, unlike shuffles
+            __m128 r_row = _mm_mul_ps(_mm_set1_ps(a_row[0]), b0);
+            r_row        = madd(_mm_set1_ps(a_row[1]), b1, r_row);
+            r_row        = madd(_mm_set1_ps(a_row[2]), b2, r_row);
+            return madd(_mm_set1_ps(a_row[3]), b3, r_row);
+#else
+            const __m128 a = _mm_loadu_ps(a_row);
+
+            __m128 r_row = _mm_mul_ps(splat<0>(a), b0);
+            r_row        = madd(splat<1>(a), b1, r_row);
+            r_row        = madd(splat<2>(a), b2, r_row);
+            return madd(splat<3>(a), b3, r_row);
+#endif
+        }
+
+        // r = a * b, all the rows are computed before storing any, so that r may alias a or b
+        inline void multiplyMatrix(const float* a, const float* b, float* r)
+        {
+            const __m128 b0 = _mm_loadu_ps(b);
+            const __m128 b1 = _mm_loadu_ps(b + 4);
+            const __m128 b2 = _mm_loadu_ps(b + 8);
+            const __m128 b3 = _mm_loadu_ps(b + 12);
+
+            const __m128 r0 = multiplyRow(a, b0, b1, b2, b3);
+            const __m128 r1 = multiplyRow(a + 4, b0, b1, b2, b3);
+            const __m128 r2 = multiplyRow(a + 8, b0, b1, b2, b3);
+            const __m128 r3 = multiplyRow(a + 12, b0, b1, b2, b3);
+            _mm_storeu_ps(r, r0);
+            _mm_storeu_ps(r + 4, r1);
+            _mm_storeu_ps(r + 8, r2);
+            _mm_storeu_ps(r + 12, r3);
+        }
+
+        // m * v with one dot product per row, for single vectors where transposing m does not pay off
+        inline __m128 transformVector(const float* m, __m128 v)
+        {
+            const __m128 x = _mm_dp_ps(_mm_loadu_ps(m), v, 0xF1);
+            const __m128 y = _mm_dp_ps(_mm_loadu_ps(m + 4), v, 0xF2);
+            const __m128 z = _mm_dp_ps(_mm_loadu_ps(m + 8), v, 0xF4);
+            const __m128 w = _mm_dp_ps(_mm_loadu_ps(m + 12), v, 0xF8);
+            return _mm_or_ps(_mm_or_ps(x, y), _mm_or_ps(z, w));
+        }
+
+        // the columns of m, to transform many vectors with the same matrix
+        struct MatrixColumns
+        {
+            __m128 m_columns[4];
+
+            explicit MatrixColumns(const float* m)
+            {
+                m_columns[0] = _mm_loadu_ps(m);
+                m_columns[1] = _mm_loadu_ps(m + 4);
+                m_columns[2] = _mm_loadu_ps(m + 8);
+                m_columns[3] = _mm_loadu_ps(m + 12);
+                _MM_TRANSPOSE4_PS(m_columns[0], m_columns[1], m_columns[2], m_columns[3]);
+            }
+
+            __m128 transform(__m128 v) const
+            {
+                __m128 r = _mm_mul_ps(m_columns[0], splat<0>(v));
+                r        = madd(m_columns[1], splat<1>(v), r);
+                r        = madd(m_columns[2], splat<2>(v), r);
+                return madd(m_columns[3], splat<3>(v), r);
+            }
+
+            // the upper 3x3 of m with absolute values, to project box extents
+            __m128 transformAbsolute3x3(__m128 v) const
+            {
+                __m128 r = _mm_mul_ps(abs(m_columns[0]), splat<0>(v));
+                r        = madd(abs(m_columns[1]), splat<1>(v), r);
+                return madd(abs(m_columns[2]), splat<2>(v), r);
+            }
+        };
+
+        // normalized a + t * (b - a), for quaternions stored as w x y z
+        inline void nLerp(float t, const float* a, const float* b, bool shortest_path, float* out)
+        {
+            const __m128 qa = _mm_loadu_ps(a);
+            __m128       qb = _mm_loadu_ps(b);
+            if (shortest_path && _mm_cvtss_f32(_mm_dp_ps(qa, qb, 0xF1)) < 0.0f)
+            {
+                qb = _mm_xor_ps(qb, _mm_set1_ps(-0.0f));
+            }
+
+            const __m128 r = madd(_mm_set1_ps(t), _mm_sub_ps(qb, qa), qa);
+            _mm_storeu_ps(out, _mm_div_ps(r, _mm_sqrt_ps(_mm_dp_ps(r, r, 0xFF))));
+        }
+    } // namespace SIMD
+} // namespace Piccolo
+#endif
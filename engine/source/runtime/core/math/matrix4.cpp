@@ -1,5 +1,6 @@
 
 #include "runtime/core/math/matrix4.h"
+#include "runtime/core/math/axis_aligned.h"
 
 namespace Piccolo
 {
@@ -180,6 +181,68 @@ namespace Piccolo
         position = Vector3(m_mat[0][3], m_mat[1][3], m_mat[2][3]);
     }
 
+    //-----------------------------------------------------------------------
+    void Matrix4x4::transformPoints(const Vector3* in_points, Vector3* out_points, size_t count) const
+    {
+#if defined(PICCOLO_MATH_SSE)
+        const SIMD::MatrixColumns columns(&m_mat[0][0]);
+        for (size_t index = 0; index < count; ++index)
+        {
+            const __m128 p = columns.transform(SIMD::loadVector3(&in_points[index].x, 1.0f));
+            SIMD::storeVector3(_mm_div_ps(p, SIMD::splat<3>(p)), &out_points[index].x);
+        }
+#else
+        for (size_t index = 0; index < count; ++index)
+        {
+            out_points[index] = (*this) * in_points[index];
+        }
+#endif
+    }
+
+    //-----------------------------------------------------------------------
+    void Matrix4x4::transformAxisAlignedBoxes(const AxisAlignedBox* in_boxes,
+                                              AxisAlignedBox*       out_boxes,
+                                              size_t                count) const
+    {
+        assert(isAffine());
+
+        // the bounds of the transformed box are the transformed center plus the extents projected on the absolute
+        // rotation scale part
+#if defined(PICCOLO_MATH_SSE)
+        const SIMD::MatrixColumns columns(&m_mat[0][0]);
+        for (size_t index = 0; index < count; ++index)
+        {
+            const Vector3& center      = in_boxes[index].getCenter();
+            const Vector3& half_extent = in_boxes[index].getHalfExtent();
+
+            Vector3 out_center;
+            Vector3 out_half_extent;
+            SIMD::storeVector3(columns.transform(SIMD::loadVector3(&center.x, 1.0f)), &out_center.x);
+            SIMD::storeVector3(columns.transformAbsolute3x3(SIMD::loadVector3(&half_extent.x, 0.0f)),
+                               &out_half_extent.x);
+            out_boxes[index].update(out_center, out_half_extent);
+        }
+#else
+        for (size_t index = 0; index < count; ++index)
+        {
+            const Vector3& center      = in_boxes[index].getCenter();
+            const Vector3& half_extent = in_boxes[index].getHalfExtent();
+
+            Vector3 out_center;
+            Vector3 out_half_extent;
+            for (size_t row = 0; row < 3; ++row)
+            {
+                out_center[row] =
+                    m_mat[row][0] * center.x + m_mat[row][1] * center.y + m_mat[row][2] * center.z + m_mat[row][3];
+                out_half_extent[row] = std::fabs(m_mat[row][0]) * half_extent.x +
+                                       std::fabs(m_mat[row][1]) * half_extent.y +
+                                       std::fabs(m_mat[row][2]) * half_extent.z;
+            }
+            out_boxes[index].update(out_center, out_half_extent);
+        }
+#endif
+    }
+
     Vector4 operator*(const Vector4& v, const Matrix4x4& mat)
     {
         return Vector4(v.x * mat[0][0] + v.y * mat[1][0] + v.z * mat[2][0] + v.w * mat[3][0],
@@ -1,13 +1,18 @@
 #pragma once
 
 #include "runtime/core/math/math.h"
+#include "runtime/core/math/math_simd.h"
 #include "runtime/core/math/matrix3.h"
 #include "runtime/core/math/quaternion.h"
 #include "runtime/core/math/vector3.h"
 #include "runtime/core/math/vector4.h"
 
+#include <cstddef>
+
 namespace Piccolo
 {
+    class AxisAlignedBox;
+
     /** Class encapsulating a standard 4x4 homogeneous matrix.
     @remarks
     CHAOS uses column vectors when applying matrix multiplications,
@@ -289,6 +294,9 @@ namespace Piccolo
         Matrix4x4 concatenate(const Matrix4x4& m2) const
         {
             Matrix4x4 r;
+#if defined(PICCOLO_MATH_SSE)
+            SIMD::multiplyMatrix(&m_mat[0][0], &m2.m_mat[0][0], &r.m_mat[0][0]);
+#else
             r.m_mat[0][0] = m_mat[0][0] * m2.m_mat[0][0] + m_mat[0][1] * m2.m_mat[1][0] + m_mat[0][2] * m2.m_mat[2][0] +
                             m_mat[0][3] * m2.m_mat[3][0];
             r.m_mat[0][1] = m_mat[0][0] * m2.m_mat[0][1] + m_mat[0][1] * m2.m_mat[1][1] + m_mat[0][2] * m2.m_mat[2][1] +
@@ -324,6 +332,7 @@ namespace Piccolo
                             m_mat[3][3] * m2.m_mat[3][2];
             r.m_mat[3][3] = m_mat[3][0] * m2.m_mat[0][3] + m_mat[3][1] * m2.m_mat[1][3] + m_mat[3][2] * m2.m_mat[2][3] +
                             m_mat[3][3] * m2.m_mat[3][3];
+#endif
 
             return r;
         }
@@ -345,6 +354,11 @@ namespace Piccolo
         {
             Vector3 r;
 
+#if defined(PICCOLO_MATH_SSE)
+            const __m128 p = SIMD::transformVector(&m_mat[0][0], SIMD::loadVector3(&v.x, 1.0f));
+            SIMD::storeVector3(_mm_div_ps(p, SIMD::splat<3>(p)), &r.x);
+            return r;
+#else
             float inv_w = 1.0f / (m_mat[3][0] * v.x + m_mat[3][1] * v.y + m_mat[3][2] * v.z + m_mat[3][3]);
 
             r.x = (m_mat[0][0] * v.x + m_mat[0][1] * v.y + m_mat[0][2] * v.z + m_mat[0][3]) * inv_w;
@@ -352,14 +366,21 @@ namespace Piccolo
             r.z = (m_mat[2][0] * v.x + m_mat[2][1] * v.y + m_mat[2][2] * v.z + m_mat[2][3]) * inv_w;
 
             return r;
+#endif
         }
 
         Vector4 operator*(const Vector4& v) const
         {
+#if defined(PICCOLO_MATH_SSE)
+            Vector4 r;
+            _mm_storeu_ps(&r.x, SIMD::transformVector(&m_mat[0][0], _mm_loadu_ps(&v.x)));
+            return r;
+#else
             return Vector4(m_mat[0][0] * v.x + m_mat[0][1] * v.y + m_mat[0][2] * v.z + m_mat[0][3] * v.w,
                            m_mat[1][0] * v.x + m_mat[1][1] * v.y + m_mat[1][2] * v.z + m_mat[1][3] * v.w,
                            m_mat[2][0] * v.x + m_mat[2][1] * v.y + m_mat[2][2] * v.z + m_mat[2][3] * v.w,
                            m_mat[3][0] * v.x + m_mat[3][1] * v.y + m_mat[3][2] * v.z + m_mat[3][3] * v.w);
+#endif
         }
 
         /** Matrix addition.
@@ -872,9 +893,15 @@ namespace Piccolo
         {
             assert(isAffine());
 
+#if defined(PICCOLO_MATH_SSE)
+            Vector3 r;
+            SIMD::storeVector3(SIMD::transformVector(&m_mat[0][0], SIMD::loadVector3(&v.x, 1.0f)), &r.x);
+            return r;
+#else
             return Vector3(m_mat[0][0] * v.x + m_mat[0][1] * v.y + m_mat[0][2] * v.z + m_mat[0][3],
                            m_mat[1][0] * v.x + m_mat[1][1] * v.y + m_mat[1][2] * v.z + m_mat[1][3],
                            m_mat[2][0] * v.x + m_mat[2][1] * v.y + m_mat[2][2] * v.z + m_mat[2][3]);
+#endif
         }
 
         /** 4-D Vector transformation specially for an affine matrix.
@@ -966,6 +993,17 @@ namespace Piccolo
             return Vector3::ZERO;
         }
 
+        /** Transforms count points like operator*(const Vector3&), the matrix is transposed once for the whole
+        batch. in_points and out_points may be the same array.
+        */
+        void transformPoints(const Vector3* in_points, Vector3* out_points, size_t count) const;
+
+        /** Transforms count boxes, each out box bounds the transformed in box.
+        @note
+        The matrix must be an affine matrix. @see Matrix4::isAffine.
+        */
+        void transformAxisAlignedBoxes(const AxisAlignedBox* in_boxes, AxisAlignedBox* out_boxes, size_t count) const;
+
         static const Matrix4x4 ZERO;
         static const Matrix4x4 ZEROAFFINE;
         static const Matrix4x4 IDENTITY;
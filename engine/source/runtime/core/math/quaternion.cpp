@@ -1,4 +1,5 @@
 #include "runtime/core/math/quaternion.h"
+#include "runtime/core/math/math_simd.h"
 #include "runtime/core/math/matrix3.h"
 #include "runtime/core/math/matrix4.h"
 #include "runtime/core/math/vector3.h"
@@ -391,6 +392,9 @@ namespace Piccolo
     Quaternion Quaternion::nLerp(float t, const Quaternion& kp, const Quaternion& kq, bool shortest_path)
     {
         Quaternion result;
+#if defined(PICCOLO_MATH_SSE)
+        SIMD::nLerp(t, kp.ptr(), kq.ptr(), shortest_path, result.ptr());
+#else
         float      cos_value = kp.dot(kq);
         if (cos_value < 0.0f && shortest_path)
         {
@@ -401,6 +405,7 @@ namespace Piccolo
             result = kp + t * (kq - kp);
         }
         result.normalise();
+#endif
         return result;
     }
 } // namespace Piccolo
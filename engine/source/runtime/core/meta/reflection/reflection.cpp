@@ -136,6 +136,27 @@ namespace Piccolo
             return Json();
         }
 
+        ReflectionInstance TypeMeta::newFromNameAndBinary(std::string type_name, BinaryReader& reader)
+        {
+            auto iter = m_class_map.find(type_name);
+
+            if (iter != m_class_map.end())
+            {
+                return ReflectionInstance(TypeMeta(type_name), (std::get<3>(*iter->second)(reader)));
+            }
+            return ReflectionInstance();
+        }
+
+        void TypeMeta::writeBinaryByName(std::string type_name, BinaryWriter& writer, void* instance)
+        {
+            auto iter = m_class_map.find(type_name);
+
+            if (iter != m_class_map.end())
+            {
+                std::get<4>(*iter->second)(writer, instance);
+            }
+        }
+
         std::string TypeMeta::getTypeName() { return m_type_name; }
 
         int TypeMeta::getFieldsList(FieldAccessor*& out_list)
@@ -24,7 +24,8 @@ namespace Piccolo
 
 #define REFLECTION_BODY(class_name) \
     friend class Reflection::TypeFieldReflectionOparator::Type##class_name##Operator; \
-    friend class Serializer;
+    friend class Serializer; \
+    friend class BinarySerializer;
     // public: virtual std::string getTypeName() override {return #class_name;}
 
 #define REFLECTION_TYPE(class_name) \
@@ -68,6 +69,9 @@ namespace Piccolo
     struct is_safely_castable<T, U, std::void_t<decltype(static_cast<U>(std::declval<T>()))>> : std::true_type
     {};
 
+    class BinaryReader;
+    class BinaryWriter;
+
     namespace Reflection
     {
         class TypeMeta;
@@ -87,13 +91,20 @@ namespace Piccolo
 
     typedef std::function<void*(const Json&)>                           ConstructorWithJson;
     typedef std::function<Json(void*)>                                  WriteJsonByName;
+    typedef std::function<void*(BinaryReader&)>                         ConstructorWithBinary;
+    typedef std::function<void(BinaryWriter&, void*)>                   WriteBinaryByName;
     typedef std::function<int(Reflection::ReflectionInstance*&, void*)> GetBaseClassReflectionInstanceListFunc;
 
     typedef std::tuple<SetFuncion, GetFuncion, GetNameFuncion, GetNameFuncion, GetNameFuncion, GetBoolFunc>
                                                        FieldFunctionTuple;
     typedef std::tuple<GetNameFuncion, InvokeFunction> MethodFunctionTuple;
-    typedef std::tuple<GetBaseClassReflectionInstanceListFunc, ConstructorWithJson, WriteJsonByName> ClassFunctionTuple;
-    typedef std::tuple<SetArrayFunc, GetArrayFunc, GetSizeFunc, GetNameFuncion, GetNameFuncion>      ArrayFunctionTuple;
+    typedef std::tuple<GetBaseClassReflectionInstanceListFunc,
+                       ConstructorWithJson,
+                       WriteJsonByName,
+                       ConstructorWithBinary,
+                       WriteBinaryByName>
+        ClassFunctionTuple;
+    typedef std::tuple<SetArrayFunc, GetArrayFunc, GetSizeFunc, GetNameFuncion, GetNameFuncion> ArrayFunctionTuple;
 
     namespace Reflection
     {
@@ -124,6 +135,8 @@ namespace Piccolo
             static bool               newArrayAccessorFromName(std::string array_type_name, ArrayAccessor& accessor);
             static ReflectionInstance newFromNameAndJson(std::string type_name, const Json& json_context);
             static Json               writeByName(std::string type_name, void* instance);
+            static ReflectionInstance newFromNameAndBinary(std::string type_name, BinaryReader& reader);
+            static void               writeBinaryByName(std::string type_name, BinaryWriter& writer, void* instance);
 
             std::string getTypeName();
 
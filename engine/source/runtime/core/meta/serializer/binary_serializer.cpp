@@ -0,0 +1,96 @@
+#include "runtime/core/meta/serializer/binary_serializer.h"
+
+namespace Piccolo
+{
+    void BinarySerializer::writeTypeName(BinaryWriter& writer, const std::string& type_name)
+    {
+        write(writer, type_name);
+    }
+
+    std::string BinarySerializer::readTypeName(BinaryReader& reader)
+    {
+        std::string type_name;
+        read(reader, type_name);
+        return type_name;
+    }
+
+    template<>
+    void BinarySerializer::write(BinaryWriter& writer, const char& instance)
+    {
+        writer.writeValue(instance);
+    }
+    template<>
+    char& BinarySerializer::read(BinaryReader& reader, char& instance)
+    {
+        return instance = reader.readValue<char>();
+    }
+
+    template<>
+    void BinarySerializer::write(BinaryWriter& writer, const int& instance)
+    {
+        writer.writeValue(static_cast<int32_t>(instance));
+    }
+    template<>
+    int& BinarySerializer::read(BinaryReader& reader, int& instance)
+    {
+        return instance = reader.readValue<int32_t>();
+    }
+
+    template<>
+    void BinarySerializer::write(BinaryWriter& writer, const unsigned int& instance)
+    {
+        writer.writeValue(static_cast<uint32_t>(instance));
+    }
+    template<>
+    unsigned int& BinarySerializer::read(BinaryReader& reader, unsigned int& instance)
+    {
+        return instance = reader.readValue<uint32_t>();
+    }
+
+    template<>
+    void BinarySerializer::write(BinaryWriter& writer, const float& instance)
+    {
+        writer.writeValue(instance);
+    }
+    template<>
+    float& BinarySerializer::read(BinaryReader& reader, float& instance)
+    {
+        return instance = reader.readValue<float>();
+    }
+
+    template<>
+    void BinarySerializer::write(BinaryWriter& writer, const double& instance)
+    {
+        writer.writeValue(instance);
+    }
+    template<>
+    double& BinarySerializer::read(BinaryReader& reader, double& instance)
+    {
+        return instance = reader.readValue<double>();
+    }
+
+    template<>
+    void BinarySerializer::write(BinaryWriter& writer, const bool& instance)
+    {
+        writer.writeValue(static_cast<uint8_t>(instance ? 1 : 0));
+    }
+    template<>
+    bool& BinarySerializer::read(BinaryReader& reader, bool& instance)
+    {
+        return instance = reader.readValue<uint8_t>() != 0;
+    }
+
+    template<>
+    void BinarySerializer::write(BinaryWriter& writer, const std::string& instance)
+    {
+        writer.writeCount(instance.size());
+        writer.writeBytes(instance.data(), instance.size());
+    }
+    template<>
+    std::string& BinarySerializer::read(BinaryReader& reader, std::string& instance)
+    {
+        instance.resize(reader.readCount());
+        reader.readBytes(instance.data(), instance.size());
+        return instance;
+    }
+} // namespace Piccolo
@@ -0,0 +1,237 @@
+#pragma once
+#include "runtime/core/meta/serializer/serializer.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Piccolo
+{
+    /// Appends values to a byte buffer in the native (little endian) layout of the cooked assets.
+    class BinaryWriter
+    {
+    public:
+        void writeBytes(const void* data, size_t size)
+        {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+        }
+
+        template<typename T>
+        void writeValue(const T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values are written as is");
+            writeBytes(&value, sizeof(T));
+        }
+
+        void writeCount(size_t count) { writeValue(static_cast<uint32_t>(count)); }
+
+        const std::vector<uint8_t>& getBuffer() const { return m_buffer; }
+        std::vector<uint8_t>&       getBuffer() { return m_buffer; }
+
+    private:
+        std::vector<uint8_t> m_buffer;
+    };
+
+    /// Reads values from a cooked byte range without copying it first, usually a memory mapped file.
+    /// Reading past the end zero fills the values and marks the reader invalid instead of asserting, so that a
+    /// truncated or stale file is detected once the read is over.
+    class BinaryReader
+    {
+        friend class BinarySerializer;
+
+    public:
+        BinaryReader(const void* data, size_t size) : m_data(static_cast<const uint8_t*>(data)), m_size(size) {}
+
+        void readBytes(void* out_data, size_t size)
+        {
+            if (!m_is_valid || size > m_size - m_offset)
+            {
+                m_is_valid = false;
+                std::memset(out_data, 0, size);
+                return;
+            }
+
+            std::memcpy(out_data, m_data + m_offset, size);
+            m_offset += size;
+        }
+
+        template<typename T>
+        T readValue()
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable values are read as is");
+            T value;
+            readBytes(&value, sizeof(T));
+            return value;
+        }
+
+        // every element takes at least one byte, a larger count can only come from a corrupted file
+        size_t readCount()
+        {
+            const size_t count = readValue<uint32_t>();
+            if (count > getRemainingSize())
+            {
+                m_is_valid = false;
+                return 0;
+            }
+            return count;
+        }
+
+        bool   isValid() const { return m_is_valid; }
+        size_t getRemainingSize() const { return m_size - m_offset; }
+
+        /// delete the instances created for the outermost pointers of the read, when it failed half way, the
+        /// nested instances are left to the destructors of their owners as when the asset is unloaded
+        void deleteReadInstances()
+        {
+            for (auto& read_instance : m_read_instances)
+            {
+                read_instance.second(read_instance.first);
+            }
+            m_read_instances.clear();
+        }
+
+    private:
+        using InstanceDeleter = void (*)(void*);
+
+        const uint8_t* m_data {nullptr};
+        size_t         m_size {0};
+        size_t         m_offset {0};
+        bool           m_is_valid {true};
+
+        uint32_t                                       m_pointer_depth {0};
+        std::vector<std::pair<void*, InstanceDeleter>> m_read_instances;
+    };
+
+    /// Binary counterpart of Serializer, the reflected types are written field by field in declaration order
+    /// without names, the layout is checked as a whole with k_serializer_schema_hash.
+    class BinarySerializer
+    {
+    public:
+        template<typename T>
+        static void writePointer(BinaryWriter& writer, T* instance)
+        {
+            writeTypeName(writer, "*");
+            write(writer, *instance);
+        }
+
+        template<typename T>
+        static T*& readPointer(BinaryReader& reader, const std::string& type_name, T*& instance)
+        {
+            assert(instance == nullptr);
+            if (type_name.empty())
+            {
+                return instance;
+            }
+
+            const bool is_outermost = reader.m_pointer_depth++ == 0;
+            if ('*' == type_name[0])
+            {
+                instance = new T;
+                read(reader, *instance);
+            }
+            else
+            {
+                instance =
+                    static_cast<T*>(Reflection::TypeMeta::newFromNameAndBinary(type_name, reader).m_instance);
+            }
+            reader.m_pointer_depth--;
+
+            if (is_outermost && instance)
+            {
+                reader.m_read_instances.emplace_back(instance, [](void* read_instance) {
+                    delete static_cast<T*>(read_instance);
+                });
+            }
+            return instance;
+        }
+
+        template<typename T>
+        static void write(BinaryWriter& writer, const Reflection::ReflectionPtr<T>& instance)
+        {
+            T*          instance_ptr = static_cast<T*>(instance.operator->());
+            std::string type_name    = instance.getTypeName();
+            writeTypeName(writer, type_name);
+            Reflection::TypeMeta::writeBinaryByName(type_name, writer, instance_ptr);
+        }
+
+        template<typename T>
+        static T*& read(BinaryReader& reader, Reflection::ReflectionPtr<T>& instance)
+        {
+            std::string type_name = readTypeName(reader);
+            instance.setTypeName(type_name);
+            return readPointer(reader, type_name, instance.getPtrReference());
+        }
+
+        template<typename T>
+        static void write(BinaryWriter& writer, const T& instance)
+        {
+            if constexpr (std::is_pointer<T>::value)
+            {
+                writePointer(writer, (T)instance);
+            }
+            else
+            {
+                static_assert(always_false<T>, "BinarySerializer::write<T> has not been implemented yet!");
+            }
+        }
+
+        template<typename T>
+        static T& read(BinaryReader& reader, T& instance)
+        {
+            if constexpr (std::is_pointer<T>::value)
+            {
+                return readPointer(reader, readTypeName(reader), instance);
+            }
+            else
+            {
+                static_assert(always_false<T>, "BinarySerializer::read<T> has not been implemented yet!");
+                return instance;
+            }
+        }
+
+    private:
+        static void        writeTypeName(BinaryWriter& writer, const std::string& type_name);
+        static std::string readTypeName(BinaryReader& reader);
+    };
+
+    // implementation of base types
+    template<>
+    void BinarySerializer::write(BinaryWriter& writer, const char& instance);
+    template<>
+    char& BinarySerializer::read(BinaryReader& reader, char& instance);
+
+    template<>
+    void BinarySerializer::write(BinaryWriter& writer, const int& instance);
+    template<>
+    int& BinarySerializer::read(BinaryReader& reader, int& instance);
+
+    template<>
+    void BinarySerializer::write(BinaryWriter& writer, const unsigned int& instance);
+    template<>
+    unsigned int& BinarySerializer::read(BinaryReader& reader, unsigned int& instance);
+
+    template<>
+    void BinarySerializer::write(BinaryWriter& writer, const float& instance);
+    template<>
+    float& BinarySerializer::read(BinaryReader& reader, float& instance);
+
+    template<>
+    void BinarySerializer::write(BinaryWriter& writer, const double& instance);
+    template<>
+    double& BinarySerializer::read(BinaryReader& reader, double& instance);
+
+    template<>
+    void BinarySerializer::write(BinaryWriter& writer, const bool& instance);
+    template<>
+    bool& BinarySerializer::read(BinaryReader& reader, bool& instance);
+
+    template<>
+    void BinarySerializer::write(BinaryWriter& writer, const std::string& instance);
+    template<>
+    std::string& BinarySerializer::read(BinaryReader& reader, std::string& instance);
+} // namespace Piccolo
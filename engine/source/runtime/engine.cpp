@@ -1,6 +1,7 @@
 ﻿#include "runtime/engine.h"
 
 #include "runtime/core/base/macro.h"
+#include "runtime/core/job/job_system.h"
 #include "runtime/core/meta/reflection/reflection_register.h"
 
 #include "runtime/function/framework/world/world_manager.h"
@@ -12,6 +13,8 @@
 #include "runtime/function/render/window_system.h"
 #include "runtime/function/render/debugdraw/debug_draw_manager.h"
 
+#include "runtime/resource/config_manager/config_manager.h"
+
 namespace Piccolo
 {
     bool                            g_is_editor_mode {false};
@@ -19,10 +22,20 @@ namespace Piccolo
 
     void PiccoloEngine::startEngine(const std::string& config_file_path)
     {
+        m_start_time_point = std::chrono::steady_clock::now();
+
         Reflection::TypeMetaRegister::metaRegister();
 
         g_runtime_global_context.startSystems(config_file_path);
 
+        // the pending swap data is the only frame that can be queued between the two threads
+        m_render_frame_latency = g_runtime_global_context.m_config_manager->getRenderFrameLatency();
+        if (m_render_frame_latency > 2)
+        {
+            LOG_WARN("render frame latency {} is not supported, clamped to 2", m_render_frame_latency);
+            m_render_frame_latency = 2;
+        }
+
         LOG_INFO("engine start");
     }
 
@@ -30,6 +43,8 @@ namespace Piccolo
     {
         LOG_INFO("engine shutdown");
 
+        stopRenderThread();
+
         g_runtime_global_context.shutdownSystems();
 
         Reflection::TypeMetaRegister::metaUnregister();
@@ -67,14 +82,29 @@ namespace Piccolo
 
     bool PiccoloEngine::tickOneFrame(float delta_time)
     {
+        // collect the job timings of the last frame
+        g_runtime_global_context.m_job_system->beginFrame();
+
         logicalTick(delta_time);
         calculateFPS(delta_time);
 
-        // single thread
-        // exchange data between logic and render contexts
-        g_runtime_global_context.m_render_system->swapLogicRenderData();
+        if (m_render_frame_latency > 0)
+        {
+            // the render thread is started by the first frame, so that the editor can still opt out
+            if (!m_render_thread.joinable())
+            {
+                startRenderThread();
+            }
+            submitLogicFrame();
+        }
+        else
+        {
+            // single thread
+            // exchange data between logic and render contexts
+            g_runtime_global_context.m_render_system->swapLogicRenderData();
 
-        rendererTick(delta_time);
+            rendererTick(delta_time);
+        }
 
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
         g_runtime_global_context.m_physics_manager->renderPhysicsWorld(delta_time);
@@ -99,9 +129,120 @@ namespace Piccolo
     bool PiccoloEngine::rendererTick(float delta_time)
     {
         g_runtime_global_context.m_render_system->tick(delta_time);
+
+        if (!m_is_first_frame_rendered)
+        {
+            using namespace std::chrono;
+
+            m_is_first_frame_rendered = true;
+            m_startup_time = duration_cast<milliseconds>(steady_clock::now() - m_start_time_point).count();
+            LOG_INFO("first frame rendered {} ms after engine start", m_startup_time.load());
+        }
         return true;
     }
 
+    void PiccoloEngine::startRenderThread()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_render_thread_mutex);
+            m_is_render_thread_quit = false;
+            m_logic_frame_index     = 0;
+            m_rendered_frame_index  = 0;
+        }
+        m_render_thread = std::thread(&PiccoloEngine::renderThreadMain, this);
+
+        LOG_INFO("render thread started, frame latency {}", m_render_frame_latency);
+    }
+
+    void PiccoloEngine::stopRenderThread()
+    {
+        if (!m_render_thread.joinable())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_render_thread_mutex);
+            m_is_render_thread_quit = true;
+        }
+        m_render_thread_condition.notify_all();
+        m_render_thread.join();
+    }
+
+    void PiccoloEngine::renderThreadMain()
+    {
+        RenderSwapContext& swap_context = g_runtime_global_context.m_render_system->getSwapContext();
+
+        std::chrono::steady_clock::time_point last_render_time_point = std::chrono::steady_clock::now();
+        while (true)
+        {
+            bool is_acquired;
+            {
+                std::unique_lock<std::mutex> lock(m_render_thread_mutex);
+                m_render_thread_condition.wait(
+                    lock, [&]() { return m_is_render_thread_quit || swap_context.hasPendingSwapData(); });
+                if (m_is_render_thread_quit)
+                    break;
+
+                // fails while the render swap data still holds requests, this tick processes them first
+                is_acquired = swap_context.acquireRenderSwapData();
+            }
+            if (is_acquired)
+            {
+                // the pending slot is free again, the logic thread can publish its frame
+                m_render_thread_condition.notify_all();
+            }
+
+            float delta_time;
+            {
+                using namespace std::chrono;
+
+                steady_clock::time_point render_time_point = steady_clock::now();
+                delta_time = duration_cast<duration<float>>(render_time_point - last_render_time_point).count();
+                last_render_time_point = render_time_point;
+            }
+
+            rendererTick(delta_time);
+
+            if (is_acquired)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_render_thread_mutex);
+                    ++m_rendered_frame_index;
+                }
+                m_render_thread_condition.notify_all();
+            }
+        }
+    }
+
+    void PiccoloEngine::submitLogicFrame()
+    {
+        RenderSwapContext& swap_context = g_runtime_global_context.m_render_system->getSwapContext();
+
+        std::unique_lock<std::mutex> lock(m_render_thread_mutex);
+        ++m_logic_frame_index;
+
+        // every logic frame is handed over on its own, then the logic waits until it's within the latency budget
+        bool is_published = false;
+        while (true)
+        {
+            if (!is_published && swap_context.publishLogicSwapData())
+            {
+                is_published = true;
+                m_render_thread_condition.notify_all();
+            }
+
+            if (is_published && m_logic_frame_index - m_rendered_frame_index <= m_render_frame_latency)
+                break;
+
+            if (m_render_thread_condition.wait_for(lock, std::chrono::milliseconds(10)) == std::cv_status::timeout)
+            {
+                // keep the window responsive, the render thread waits for it while the window is minimized
+                lock.unlock();
+                g_runtime_global_context.m_window_system->pollEvents();
+                lock.lock();
+            }
+        }
+    }
+
     const float PiccoloEngine::s_fps_alpha = 1.f / 100;
     void        PiccoloEngine::calculateFPS(float delta_time)
     {
@@ -2,8 +2,12 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <filesystem>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_set>
 
 namespace Piccolo
@@ -14,6 +18,7 @@ namespace Piccolo
     class PiccoloEngine
     {
         friend class PiccoloEditor;
+        friend class PiccoloBenchmark;
 
         static const float s_fps_alpha;
 
@@ -30,12 +35,21 @@ namespace Piccolo
 
         int getFPS() const { return m_fps; }
 
+        /// milliseconds from startEngine to the end of the first rendered frame, negative until it is rendered
+        int64_t getStartupTime() const { return m_startup_time; }
+
     protected:
         void logicalTick(float delta_time);
         bool rendererTick(float delta_time);
 
         void calculateFPS(float delta_time);
 
+        // pipelined mode, the render thread renders frame N while the logic thread builds frame N + 1
+        void startRenderThread();
+        void stopRenderThread();
+        void renderThreadMain();
+        void submitLogicFrame();
+
         /**
          *  Each frame can only be called once
          */
@@ -45,10 +59,26 @@ namespace Piccolo
         bool m_is_quit {false};
 
         std::chrono::steady_clock::time_point m_last_tick_time_point {std::chrono::steady_clock::now()};
+        // the startup time is logged once the first frame is rendered
+        std::chrono::steady_clock::time_point m_start_time_point;
+        bool                                  m_is_first_frame_rendered {false};
+        // written by the render thread in pipelined mode
+        std::atomic<int64_t> m_startup_time {-1};
 
         float m_average_duration {0.f};
         int   m_frame_count {0};
         int   m_fps {0};
+
+        // 0 renders on the logic thread, otherwise the number of frames the logic may run ahead of the render thread
+        uint32_t m_render_frame_latency {0};
+
+        std::thread             m_render_thread;
+        std::mutex              m_render_thread_mutex;
+        std::condition_variable m_render_thread_condition;
+        bool                    m_is_render_thread_quit {false};
+        // guarded by m_render_thread_mutex
+        uint64_t m_logic_frame_index {0};
+        uint64_t m_rendered_frame_index {0};
     };
 
 } // namespace Piccolo
@@ -0,0 +1,110 @@
+#include "runtime/function/animation/animation_blender.h"
+
+#include "runtime/function/animation/animation_system.h"
+
+#include <algorithm>
+
+namespace Piccolo
+{
+    void AnimationBlender::evaluate(const BlendState& blend_state, Skeleton& skeleton)
+    {
+        if (isOutdated(blend_state) || m_bone_count != skeleton.getBonesCount())
+        {
+            rebuild(blend_state, skeleton);
+        }
+
+        m_samples.clear();
+        for (size_t clip_index = 0; clip_index < m_clips.size(); clip_index++)
+        {
+            if (!m_clips[clip_index] || !m_anim_skel_maps[clip_index])
+            {
+                continue;
+            }
+
+            SkeletonClipSample sample;
+            sample.m_clip          = m_clips[clip_index].get();
+            sample.m_anim_skel_map = m_anim_skel_maps[clip_index].get();
+            sample.m_phase         = blend_state.blend_ratio[clip_index];
+            sample.m_bone_weights  = m_bone_weights[clip_index].blend_weight.data();
+            m_samples.push_back(sample);
+        }
+
+        skeleton.blendAnimations(m_samples.data(), m_samples.size());
+    }
+
+    bool AnimationBlender::isOutdated(const BlendState& blend_state) const
+    {
+        return blend_state.blend_ratio.size() < m_clips.size() ||
+               m_clip_file_paths != blend_state.blend_clip_file_path ||
+               m_anim_skel_map_paths != blend_state.blend_anim_skel_map_path ||
+               m_mask_file_paths != blend_state.blend_mask_file_path || m_clip_weights != blend_state.blend_weight;
+    }
+
+    void AnimationBlender::rebuild(const BlendState& blend_state, const Skeleton& skeleton)
+    {
+        m_clip_file_paths     = blend_state.blend_clip_file_path;
+        m_anim_skel_map_paths = blend_state.blend_anim_skel_map_path;
+        m_mask_file_paths     = blend_state.blend_mask_file_path;
+        m_clip_weights        = blend_state.blend_weight;
+        m_bone_count          = skeleton.getBonesCount();
+
+        // clips without a path, a skeleton map, a ratio or a weight are not part of the blend
+        const size_t clip_count = std::min({static_cast<size_t>(std::max(blend_state.clip_count, 0)),
+                                            blend_state.blend_clip_file_path.size(),
+                                            blend_state.blend_anim_skel_map_path.size(),
+                                            blend_state.blend_ratio.size(),
+                                            blend_state.blend_weight.size()});
+
+        m_clips.resize(clip_count);
+        m_anim_skel_maps.resize(clip_count);
+        std::vector<std::shared_ptr<BoneBlendMask>> masks(clip_count);
+        for (size_t clip_index = 0; clip_index < clip_count; clip_index++)
+        {
+            m_clips[clip_index] = AnimationManager::tryLoadAnimation(blend_state.blend_clip_file_path[clip_index]);
+            m_anim_skel_maps[clip_index] =
+                AnimationManager::tryLoadAnimationSkeletonMap(blend_state.blend_anim_skel_map_path[clip_index]);
+
+            // a clip without a mask drives all the bones
+            if (clip_index < blend_state.blend_mask_file_path.size() &&
+                !blend_state.blend_mask_file_path[clip_index].empty())
+            {
+                masks[clip_index] = AnimationManager::tryLoadSkeletonMask(blend_state.blend_mask_file_path[clip_index]);
+            }
+        }
+
+        auto is_enabled = [&masks](size_t clip_index, int32_t bone_index) {
+            const std::shared_ptr<BoneBlendMask>& mask = masks[clip_index];
+            return !mask || (static_cast<size_t>(bone_index) < mask->enabled.size() && mask->enabled[bone_index]);
+        };
+
+        m_bone_weights.resize(clip_count);
+        for (size_t clip_index = 0; clip_index < clip_count; clip_index++)
+        {
+            m_bone_weights[clip_index].blend_weight.assign(m_bone_count, 0.0f);
+        }
+        for (int32_t bone_index = 0; bone_index < m_bone_count; bone_index++)
+        {
+            float sum_weight = 0.0f;
+            for (size_t clip_index = 0; clip_index < clip_count; clip_index++)
+            {
+                if (is_enabled(clip_index, bone_index))
+                {
+                    sum_weight += blend_state.blend_weight[clip_index];
+                }
+            }
+            if (fabs(sum_weight) < 0.0001f)
+            {
+                // no clip drives this bone, it stays in the binding pose
+                continue;
+            }
+            for (size_t clip_index = 0; clip_index < clip_count; clip_index++)
+            {
+                if (is_enabled(clip_index, bone_index))
+                {
+                    m_bone_weights[clip_index].blend_weight[bone_index] =
+                        blend_state.blend_weight[clip_index] / sum_weight;
+                }
+            }
+        }
+    }
+} // namespace Piccolo
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "runtime/function/animation/skeleton.h"
+#include "runtime/resource/res_type/data/blend_state.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Piccolo
+{
+    class BoneBlendMask;
+    class CompressedAnimationClip;
+
+    /// Evaluates a BlendState onto a skeleton: every clip of the state is sampled at its own ratio, and blended with
+    /// its weight restricted to the bones enabled by its mask.
+    class AnimationBlender
+    {
+    public:
+        void evaluate(const BlendState& blend_state, Skeleton& skeleton);
+
+    private:
+        bool isOutdated(const BlendState& blend_state) const;
+        void rebuild(const BlendState& blend_state, const Skeleton& skeleton);
+
+        // the clips are shared with the animation manager cache, never copied
+        std::vector<std::shared_ptr<CompressedAnimationClip>> m_clips;
+        std::vector<std::shared_ptr<AnimSkelMap>>   m_anim_skel_maps;
+
+        // weight of each bone for each clip, normalized over the clips enabled on that bone
+        std::vector<BoneBlendWeight> m_bone_weights;
+
+        // the blend state the clips and weights were built from, only rebuilt when it changes
+        std::vector<std::string> m_clip_file_paths;
+        std::vector<std::string> m_anim_skel_map_paths;
+        std::vector<std::string> m_mask_file_paths;
+        std::vector<float>       m_clip_weights;
+        int32_t                  m_bone_count {-1};
+
+        std::vector<SkeletonClipSample> m_samples;
+    };
+} // namespace Piccolo
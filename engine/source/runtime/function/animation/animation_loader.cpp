@@ -71,11 +71,15 @@ namespace Piccolo
         }
     } // namespace
 
-    std::shared_ptr<Piccolo::AnimationClip> AnimationLoader::loadAnimationClipData(std::string animation_clip_url)
+    std::shared_ptr<Piccolo::CompressedAnimationClip>
+    AnimationLoader::loadAnimationClipData(std::string animation_clip_url)
     {
         AnimationAsset animation_clip;
         g_runtime_global_context.m_asset_manager->loadAsset(animation_clip_url, animation_clip);
-        return std::make_shared<Piccolo::AnimationClip>(animation_clip.clip_data);
+
+        auto compressed_clip = std::make_shared<Piccolo::CompressedAnimationClip>();
+        compressed_clip->compress(animation_clip.clip_data);
+        return compressed_clip;
     }
 
     std::shared_ptr<Piccolo::SkeletonData> AnimationLoader::loadSkeletonData(std::string skeleton_data_url)
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "runtime/function/animation/compressed_animation_clip.h"
 #include "runtime/resource/res_type/data/animation_clip.h"
 #include "runtime/resource/res_type/data/animation_skeleton_node_map.h"
 #include "runtime/resource/res_type/data/skeleton_data.h"
@@ -13,9 +14,10 @@ namespace Piccolo
     class AnimationLoader
     {
     public:
-        std::shared_ptr<AnimationClip> loadAnimationClipData(std::string animation_clip_url);
-        std::shared_ptr<SkeletonData>  loadSkeletonData(std::string skeleton_data_url);
-        std::shared_ptr<AnimSkelMap>   loadAnimSkelMap(std::string anim_skel_map_url);
-        std::shared_ptr<BoneBlendMask> loadSkeletonMask(std::string skeleton_mask_file_url);
+        /// the clip is compressed while loading, the source keys are not kept
+        std::shared_ptr<CompressedAnimationClip> loadAnimationClipData(std::string animation_clip_url);
+        std::shared_ptr<SkeletonData>            loadSkeletonData(std::string skeleton_data_url);
+        std::shared_ptr<AnimSkelMap>             loadAnimSkelMap(std::string anim_skel_map_url);
+        std::shared_ptr<BoneBlendMask>           loadSkeletonMask(std::string skeleton_mask_file_url);
     };
 } // namespace Piccolo
\ No newline at end of file
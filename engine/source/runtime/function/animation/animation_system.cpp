@@ -1,152 +1,121 @@
 #include "runtime/function/animation/animation_system.h"
 
-#include "resource/res_type/data/skeleton_mask.h"
-
 #include "runtime/function/animation/animation_loader.h"
-#include "runtime/function/animation/skeleton.h"
 
 namespace Piccolo
 {
-    std::map<std::string, std::shared_ptr<SkeletonData>>  AnimationManager::m_skeleton_definition_cache;
-    std::map<std::string, std::shared_ptr<AnimationClip>> AnimationManager::m_animation_data_cache;
-    std::map<std::string, std::shared_ptr<AnimSkelMap>>   AnimationManager::m_animation_skeleton_map_cache;
-    std::map<std::string, std::shared_ptr<BoneBlendMask>> AnimationManager::m_skeleton_mask_cache;
-
-    std::shared_ptr<SkeletonData> AnimationManager::tryLoadSkeleton(std::string file_path)
+    namespace
     {
-        std::shared_ptr<SkeletonData> res;
-        AnimationLoader               loader;
-        auto                          found = m_skeleton_definition_cache.find(file_path);
-        if (found == m_skeleton_definition_cache.end())
-        {
-            res = loader.loadSkeletonData(file_path);
-            m_skeleton_definition_cache.emplace(file_path, res);
-        }
-        else
+        // soft limits, assets still referenced by a component are never evicted
+        constexpr size_t k_skeleton_cache_budget      = 8 * 1024 * 1024;
+        constexpr size_t k_animation_cache_budget     = 64 * 1024 * 1024;
+        constexpr size_t k_skeleton_map_cache_budget  = 1024 * 1024;
+        constexpr size_t k_skeleton_mask_cache_budget = 1024 * 1024;
+
+        size_t getSkeletonSize(const SkeletonData& skeleton)
         {
-            res = found->second;
+            size_t size = sizeof(SkeletonData) + skeleton.bones_map.capacity() * sizeof(RawBone);
+            for (const RawBone& bone : skeleton.bones_map)
+            {
+                size += bone.name.capacity();
+            }
+            return size;
         }
-        return res;
+    } // namespace
+
+    std::unique_ptr<AssetCache<SkeletonData>>            AnimationManager::m_skeleton_definition_cache;
+    std::unique_ptr<AssetCache<CompressedAnimationClip>> AnimationManager::m_animation_data_cache;
+    std::unique_ptr<AssetCache<AnimSkelMap>>             AnimationManager::m_animation_skeleton_map_cache;
+    std::unique_ptr<AssetCache<BoneBlendMask>>           AnimationManager::m_skeleton_mask_cache;
+
+    void AnimationManager::initialize(std::shared_ptr<JobSystem> job_system)
+    {
+        m_skeleton_definition_cache = std::make_unique<AssetCache<SkeletonData>>(
+            job_system,
+            "AnimationLoadSkeleton",
+            [](const std::string& file_path) { return AnimationLoader().loadSkeletonData(file_path); },
+            getSkeletonSize,
+            k_skeleton_cache_budget);
+
+        m_animation_data_cache = std::make_unique<AssetCache<CompressedAnimationClip>>(
+            job_system,
+            "AnimationLoadClip",
+            [](const std::string& file_path) { return AnimationLoader().loadAnimationClipData(file_path); },
+            [](const CompressedAnimationClip& clip) { return clip.getMemorySize(); },
+            k_animation_cache_budget);
+
+        m_animation_skeleton_map_cache = std::make_unique<AssetCache<AnimSkelMap>>(
+            job_system,
+            "AnimationLoadSkeletonMap",
+            [](const std::string& file_path) { return AnimationLoader().loadAnimSkelMap(file_path); },
+            [](const AnimSkelMap& map) { return sizeof(AnimSkelMap) + map.convert.capacity() * sizeof(int); },
+            k_skeleton_map_cache_budget);
+
+        m_skeleton_mask_cache = std::make_unique<AssetCache<BoneBlendMask>>(
+            job_system,
+            "AnimationLoadSkeletonMask",
+            [](const std::string& file_path) { return AnimationLoader().loadSkeletonMask(file_path); },
+            [](const BoneBlendMask& mask) {
+                return sizeof(BoneBlendMask) + mask.skeleton_file_path.capacity() +
+                       mask.enabled.capacity() * sizeof(int);
+            },
+            k_skeleton_mask_cache_budget);
     }
 
-    std::shared_ptr<AnimationClip> AnimationManager::tryLoadAnimation(std::string file_path)
+    std::shared_ptr<SkeletonData> AnimationManager::tryLoadSkeleton(std::string file_path)
     {
-        std::shared_ptr<AnimationClip> res;
-        AnimationLoader                loader;
-        auto                           found = m_animation_data_cache.find(file_path);
-        if (found == m_animation_data_cache.end())
-        {
-            res = loader.loadAnimationClipData(file_path);
-            m_animation_data_cache.emplace(file_path, res);
-        }
-        else
-        {
-            res = found->second;
-        }
-        return res;
+        return m_skeleton_definition_cache->load(file_path);
+    }
+
+    std::shared_ptr<CompressedAnimationClip> AnimationManager::tryLoadAnimation(std::string file_path)
+    {
+        return m_animation_data_cache->load(file_path);
     }
 
     std::shared_ptr<AnimSkelMap> AnimationManager::tryLoadAnimationSkeletonMap(std::string file_path)
     {
-        std::shared_ptr<AnimSkelMap> res;
-        AnimationLoader              loader;
-        auto                         found = m_animation_skeleton_map_cache.find(file_path);
-        if (found == m_animation_skeleton_map_cache.end())
-        {
-            res = loader.loadAnimSkelMap(file_path);
-            m_animation_skeleton_map_cache.emplace(file_path, res);
-        }
-        else
-        {
-            res = found->second;
-        }
-        return res;
+        return m_animation_skeleton_map_cache->load(file_path);
     }
 
     std::shared_ptr<BoneBlendMask> AnimationManager::tryLoadSkeletonMask(std::string file_path)
     {
-        std::shared_ptr<BoneBlendMask> res;
-        AnimationLoader                loader;
-        auto                           found = m_skeleton_mask_cache.find(file_path);
-        if (found == m_skeleton_mask_cache.end())
-        {
-            res = loader.loadSkeletonMask(file_path);
-            m_skeleton_mask_cache.emplace(file_path, res);
-        }
-        else
-        {
-            res = found->second;
-        }
-        return res;
+        return m_skeleton_mask_cache->load(file_path);
     }
 
-    BlendStateWithClipData AnimationManager::getBlendStateWithClipData(const BlendState& blend_state)
+    void AnimationManager::prefetchBlendState(const BlendState& blend_state)
     {
-
-        for (auto animation_file_path : blend_state.blend_clip_file_path)
-        {
-            tryLoadAnimation(animation_file_path);
-        }
-        for (auto anim_skel_map_path : blend_state.blend_anim_skel_map_path)
-        {
-            tryLoadAnimationSkeletonMap(anim_skel_map_path);
-        }
-        for (auto skeleton_mask_path : blend_state.blend_mask_file_path)
-        {
-            tryLoadSkeletonMask(skeleton_mask_path);
-        }
-
-        BlendStateWithClipData blend_state_with_clip_data;
-        blend_state_with_clip_data.clip_count  = blend_state.clip_count;
-        blend_state_with_clip_data.blend_ratio = blend_state.blend_ratio;
-        for (const auto& iter : blend_state.blend_clip_file_path)
-        {
-            blend_state_with_clip_data.blend_clip.push_back(*m_animation_data_cache[iter]);
-        }
-        for (const auto& iter : blend_state.blend_anim_skel_map_path)
+        for (const std::string& clip_file_path : blend_state.blend_clip_file_path)
         {
-            blend_state_with_clip_data.blend_anim_skel_map.push_back(*m_animation_skeleton_map_cache[iter]);
+            m_animation_data_cache->prefetch(clip_file_path);
         }
-        std::vector<std::shared_ptr<BoneBlendMask>> blend_masks;
-        for (auto& iter : blend_state.blend_mask_file_path)
+        for (const std::string& anim_skel_map_path : blend_state.blend_anim_skel_map_path)
         {
-            blend_masks.push_back(m_skeleton_mask_cache[iter]);
-            tryLoadAnimationSkeletonMap(m_skeleton_mask_cache[iter]->skeleton_file_path);
+            m_animation_skeleton_map_cache->prefetch(anim_skel_map_path);
         }
-        size_t skeleton_bone_count = m_skeleton_definition_cache[blend_masks[0]->skeleton_file_path]->bones_map.size();
-        blend_state_with_clip_data.blend_weight.resize(blend_state.clip_count);
-        for (size_t clip_index = 0; clip_index < blend_state.clip_count; clip_index++)
+        for (const std::string& mask_file_path : blend_state.blend_mask_file_path)
         {
-            blend_state_with_clip_data.blend_weight[clip_index].blend_weight.resize(skeleton_bone_count);
-        }
-        for (size_t bone_index = 0; bone_index < skeleton_bone_count; bone_index++)
-        {
-            float sum_weight = 0;
-            for (size_t clip_index = 0; clip_index < blend_state.clip_count; clip_index++)
-            {
-                if (blend_masks[clip_index]->enabled[bone_index])
-                {
-                    sum_weight += blend_state.blend_weight[clip_index];
-                }
-            }
-            if (fabs(sum_weight) < 0.0001f)
+            if (!mask_file_path.empty())
             {
-                // LOG_ERROR
-            }
-            for (size_t clip_index = 0; clip_index < blend_state.clip_count; clip_index++)
-            {
-                if (blend_masks[clip_index]->enabled[bone_index])
-                {
-
-                    blend_state_with_clip_data.blend_weight[clip_index].blend_weight[bone_index] =
-                        blend_state.blend_weight[clip_index] / sum_weight;
-                }
-                else
-                {
-                    blend_state_with_clip_data.blend_weight[clip_index].blend_weight[bone_index] = 0;
-                }
+                m_skeleton_mask_cache->prefetch(mask_file_path);
             }
         }
-        return blend_state_with_clip_data;
+    }
+
+    AssetCacheStatistics AnimationManager::getCacheStatistics()
+    {
+        AssetCacheStatistics statistics = m_skeleton_definition_cache->getStatistics();
+        statistics += m_animation_data_cache->getStatistics();
+        statistics += m_animation_skeleton_map_cache->getStatistics();
+        statistics += m_skeleton_mask_cache->getStatistics();
+        return statistics;
+    }
+
+    void AnimationManager::clear()
+    {
+        // the caches wait for their loads in flight before going away
+        m_skeleton_definition_cache.reset();
+        m_animation_data_cache.reset();
+        m_animation_skeleton_map_cache.reset();
+        m_skeleton_mask_cache.reset();
     }
 } // namespace Piccolo
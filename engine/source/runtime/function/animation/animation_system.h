@@ -1,12 +1,13 @@
 #pragma once
 
+#include "runtime/function/animation/compressed_animation_clip.h"
+#include "runtime/resource/asset_manager/asset_cache.h"
 #include "runtime/resource/res_type/data/animation_clip.h"
 #include "runtime/resource/res_type/data/animation_skeleton_node_map.h"
 #include "runtime/resource/res_type/data/blend_state.h"
 #include "runtime/resource/res_type/data/skeleton_data.h"
 #include "runtime/resource/res_type/data/skeleton_mask.h"
 
-#include <map>
 #include <memory>
 #include <string>
 
@@ -15,19 +16,31 @@ namespace Piccolo
     class AnimationManager
     {
     private:
-        static std::map<std::string, std::shared_ptr<SkeletonData>>  m_skeleton_definition_cache;
-        static std::map<std::string, std::shared_ptr<AnimationClip>> m_animation_data_cache;
-        static std::map<std::string, std::shared_ptr<AnimSkelMap>>   m_animation_skeleton_map_cache;
-        static std::map<std::string, std::shared_ptr<BoneBlendMask>> m_skeleton_mask_cache;
+        // animation components are ticked in parallel, the caches are shared by all of them
+        static std::unique_ptr<AssetCache<SkeletonData>>            m_skeleton_definition_cache;
+        static std::unique_ptr<AssetCache<CompressedAnimationClip>> m_animation_data_cache;
+        static std::unique_ptr<AssetCache<AnimSkelMap>>             m_animation_skeleton_map_cache;
+        static std::unique_ptr<AssetCache<BoneBlendMask>>           m_skeleton_mask_cache;
 
     public:
-        static std::shared_ptr<SkeletonData>  tryLoadSkeleton(std::string file_path);
-        static std::shared_ptr<AnimationClip> tryLoadAnimation(std::string file_path);
-        static std::shared_ptr<AnimSkelMap>   tryLoadAnimationSkeletonMap(std::string file_path);
-        static std::shared_ptr<BoneBlendMask> tryLoadSkeletonMask(std::string file_path);
-        static BlendStateWithClipData         getBlendStateWithClipData(const BlendState& blend_state);
+        /// create the caches, their assets are loaded on the workers of the job system
+        static void initialize(std::shared_ptr<JobSystem> job_system);
+
+        /// the tryLoad* functions block until the asset is loaded, the calling thread runs other jobs meanwhile
+        static std::shared_ptr<SkeletonData>            tryLoadSkeleton(std::string file_path);
+        static std::shared_ptr<CompressedAnimationClip> tryLoadAnimation(std::string file_path);
+        static std::shared_ptr<AnimSkelMap>             tryLoadAnimationSkeletonMap(std::string file_path);
+        static std::shared_ptr<BoneBlendMask>           tryLoadSkeletonMask(std::string file_path);
+
+        /// start loading the clips, skeleton maps and masks of a blend state on the workers
+        static void prefetchBlendState(const BlendState& blend_state);
+
+        /// hit rate and resident bytes of all the animation caches
+        static AssetCacheStatistics getCacheStatistics();
+        /// drop the caches and every cached asset, called before the job system shuts down
+        static void clear();
 
         AnimationManager() = default;
     };
 
-} // namespace Piccolo
\ No newline at end of file
+} // namespace Piccolo
@@ -0,0 +1,353 @@
+#include "runtime/function/animation/compressed_animation_clip.h"
+
+#include "runtime/resource/res_type/data/animation_clip.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Piccolo
+{
+    namespace
+    {
+        constexpr float k_vector_quantization   = 65535.0f;
+        constexpr float k_rotation_quantization = 32767.0f;
+        // the smallest three components of a unit quaternion are within [-1/sqrt(2), 1/sqrt(2)]
+        constexpr float k_rotation_range = 0.70710678f;
+        // the key frames are stored in 16 bits
+        constexpr size_t k_max_key_count = 65536;
+        // the keys a kept key may span, every candidate end checks all the keys it spans, so the reduction of a
+        // track is linear in its key count rather than quadratic on long runs of keys that interpolate well
+        constexpr uint32_t k_max_key_span = 64;
+
+        uint16_t quantize(float value, float quantization)
+        {
+            return static_cast<uint16_t>(std::lround(std::min(std::max(value, 0.0f), 1.0f) * quantization));
+        }
+
+        void quantizeVector(const Vector3& value, const float* base, const float* extent, uint16_t* quantized)
+        {
+            for (size_t i = 0; i < 3; i++)
+            {
+                quantized[i] =
+                    extent[i] > 0.0f ? quantize((value[i] - base[i]) / extent[i], k_vector_quantization) : 0;
+            }
+        }
+
+        Vector3 dequantizeVector(const uint16_t* quantized, const float* base, const float* extent)
+        {
+            const float scale = 1.0f / k_vector_quantization;
+            return Vector3(base[0] + quantized[0] * scale * extent[0],
+                           base[1] + quantized[1] * scale * extent[1],
+                           base[2] + quantized[2] * scale * extent[2]);
+        }
+
+        // the largest component is dropped and rebuilt from the unit length, its index is kept in the top bits of
+        // the first two values
+        void quantizeRotation(Quaternion rotation, uint16_t* quantized)
+        {
+            float* components    = rotation.ptr();
+            size_t largest_index = 0;
+            for (size_t i = 1; i < 4; i++)
+            {
+                if (std::fabs(components[i]) > std::fabs(components[largest_index]))
+                {
+                    largest_index = i;
+                }
+            }
+            // q and -q are the same rotation, the dropped component is kept positive
+            if (components[largest_index] < 0.0f)
+            {
+                rotation = -rotation;
+            }
+
+            size_t value_index = 0;
+            for (size_t i = 0; i < 4; i++)
+            {
+                if (i != largest_index)
+                {
+                    const float normalized = (components[i] / k_rotation_range + 1.0f) * 0.5f;
+                    quantized[value_index++] = quantize(normalized, k_rotation_quantization);
+                }
+            }
+            quantized[0] |= static_cast<uint16_t>((largest_index & 1) << 15);
+            quantized[1] |= static_cast<uint16_t>((largest_index >> 1) << 15);
+        }
+
+        Quaternion dequantizeRotation(const uint16_t* quantized)
+        {
+            const size_t largest_index = (quantized[0] >> 15) | ((quantized[1] >> 15) << 1);
+
+            Quaternion rotation;
+            float*     components  = rotation.ptr();
+            float      sum_squares = 0.0f;
+            size_t     value_index = 0;
+            for (size_t i = 0; i < 4; i++)
+            {
+                if (i != largest_index)
+                {
+                    const float normalized = (quantized[value_index++] & 0x7FFF) / k_rotation_quantization;
+                    components[i]          = (normalized * 2.0f - 1.0f) * k_rotation_range;
+                    sum_squares += components[i] * components[i];
+                }
+            }
+            components[largest_index] = std::sqrt(std::max(1.0f - sum_squares, 0.0f));
+            return rotation;
+        }
+
+        // greedy key reduction: from each kept key, the segment is extended as long as interpolating its ends
+        // reproduces every key in between and it spans at most k_max_key_span keys, the first and the last key are
+        // always kept
+        template<typename IsReproduced>
+        std::vector<uint32_t> reduceKeys(size_t key_count, IsReproduced is_reproduced)
+        {
+            std::vector<uint32_t> kept_keys {0};
+            uint32_t              start = 0;
+            while (start + 1 < key_count)
+            {
+                uint32_t end = start + 1;
+                while (end + 1 < key_count && end + 1 - start <= k_max_key_span)
+                {
+                    const uint32_t candidate = end + 1;
+                    bool           fits      = true;
+                    for (uint32_t key = start + 1; key < candidate && fits; key++)
+                    {
+                        const float ratio = static_cast<float>(key - start) / (candidate - start);
+                        fits              = is_reproduced(start, candidate, key, ratio);
+                    }
+                    if (!fits)
+                    {
+                        break;
+                    }
+                    end = candidate;
+                }
+                kept_keys.push_back(end);
+                start = end;
+            }
+            return kept_keys;
+        }
+    } // namespace
+
+    void CompressedAnimationClip::compress(const AnimationClip& clip)
+    {
+        m_total_frame = clip.total_frame;
+        m_node_count  = static_cast<int32_t>(std::min(static_cast<size_t>(std::max(clip.node_count, 0)),
+                                                     clip.node_channels.size()));
+
+        m_tracks.assign(m_node_count * k_track_count, Track {});
+        m_key_frames.clear();
+        m_key_values.clear();
+        for (int32_t node_index = 0; node_index < m_node_count; node_index++)
+        {
+            // the three tracks of a channel are sampled with the same key count
+            const AnimationChannel& channel   = clip.node_channels[node_index];
+            const size_t            key_count = std::min({channel.position_keys.size(),
+                                                          channel.rotation_keys.size(),
+                                                          channel.scaling_keys.size(),
+                                                          k_max_key_count});
+
+            Track* tracks = &m_tracks[node_index * k_track_count];
+            compressVectorTrack(channel.position_keys, key_count, k_position_tolerance, tracks[k_position_track]);
+            compressRotationTrack(channel.rotation_keys, key_count, tracks[k_rotation_track]);
+            compressVectorTrack(channel.scaling_keys, key_count, k_scaling_tolerance, tracks[k_scaling_track]);
+        }
+
+        m_tracks.shrink_to_fit();
+        m_key_frames.shrink_to_fit();
+        m_key_values.shrink_to_fit();
+    }
+
+    size_t CompressedAnimationClip::getMemorySize() const
+    {
+        return sizeof(CompressedAnimationClip) + m_tracks.capacity() * sizeof(Track) +
+               m_key_frames.capacity() * sizeof(uint16_t) + m_key_values.capacity() * sizeof(uint16_t);
+    }
+
+    void CompressedAnimationClip::compressVectorTrack(const std::vector<Vector3>& keys,
+                                                      size_t                      key_count,
+                                                      float                       tolerance,
+                                                      Track&                      track)
+    {
+        track.m_key_count = 0;
+        if (key_count == 0)
+        {
+            return;
+        }
+
+        Vector3 minimum = keys[0];
+        Vector3 maximum = keys[0];
+        for (size_t key = 1; key < key_count; key++)
+        {
+            minimum.makeFloor(keys[key]);
+            maximum.makeCeil(keys[key]);
+        }
+
+        const Vector3 extent = maximum - minimum;
+        for (size_t i = 0; i < 3; i++)
+        {
+            track.m_base[i]   = minimum[i];
+            track.m_extent[i] = extent[i];
+        }
+        if (extent.x <= tolerance && extent.y <= tolerance && extent.z <= tolerance)
+        {
+            track.m_key_count = 1;
+            for (size_t i = 0; i < 3; i++)
+            {
+                track.m_base[i]   = keys[0][i];
+                track.m_extent[i] = 0.0f;
+            }
+            return;
+        }
+
+        std::vector<uint16_t> quantized(key_count * 3);
+        std::vector<Vector3>  decoded(key_count);
+        for (size_t key = 0; key < key_count; key++)
+        {
+            quantizeVector(keys[key], track.m_base, track.m_extent, &quantized[key * 3]);
+            decoded[key] = dequantizeVector(&quantized[key * 3], track.m_base, track.m_extent);
+        }
+
+        // the error is measured against the source keys, so that it includes the quantization
+        const std::vector<uint32_t> kept_keys =
+            reduceKeys(key_count, [&](uint32_t start, uint32_t end, uint32_t key, float ratio) {
+                const Vector3 error = Vector3::lerp(decoded[start], decoded[end], ratio) - keys[key];
+                return std::fabs(error.x) <= tolerance && std::fabs(error.y) <= tolerance &&
+                       std::fabs(error.z) <= tolerance;
+            });
+
+        track.m_first_key = static_cast<uint32_t>(m_key_frames.size());
+        track.m_key_count = static_cast<uint32_t>(kept_keys.size());
+        for (uint32_t key : kept_keys)
+        {
+            m_key_frames.push_back(static_cast<uint16_t>(key));
+            m_key_values.insert(m_key_values.end(), &quantized[key * 3], &quantized[key * 3] + 3);
+        }
+    }
+
+    void CompressedAnimationClip::compressRotationTrack(const std::vector<Quaternion>& keys,
+                                                        size_t                         key_count,
+                                                        Track&                         track)
+    {
+        track.m_key_count = 0;
+        if (key_count == 0)
+        {
+            return;
+        }
+
+        std::vector<Quaternion> normalized(keys.begin(), keys.begin() + key_count);
+        for (Quaternion& rotation : normalized)
+        {
+            rotation.normalise();
+        }
+
+        // |dot| of two unit quaternions is the cosine of half the angle between them
+        const float min_dot = std::cos(k_rotation_tolerance * 0.5f);
+
+        bool is_constant = true;
+        for (size_t key = 1; key < key_count && is_constant; key++)
+        {
+            is_constant = std::fabs(normalized[0].dot(normalized[key])) >= min_dot;
+        }
+        if (is_constant)
+        {
+            track.m_key_count = 1;
+            std::copy(normalized[0].ptr(), normalized[0].ptr() + 4, track.m_base);
+            return;
+        }
+
+        std::vector<uint16_t>   quantized(key_count * 3);
+        std::vector<Quaternion> decoded(key_count);
+        for (size_t key = 0; key < key_count; key++)
+        {
+            quantizeRotation(normalized[key], &quantized[key * 3]);
+            decoded[key] = dequantizeRotation(&quantized[key * 3]);
+        }
+
+        const std::vector<uint32_t> kept_keys =
+            reduceKeys(key_count, [&](uint32_t start, uint32_t end, uint32_t key, float ratio) {
+                const Quaternion rotation = Quaternion::nLerp(ratio, decoded[start], decoded[end], true);
+                return std::fabs(rotation.dot(normalized[key])) >= min_dot;
+            });
+
+        track.m_first_key = static_cast<uint32_t>(m_key_frames.size());
+        track.m_key_count = static_cast<uint32_t>(kept_keys.size());
+        for (uint32_t key : kept_keys)
+        {
+            m_key_frames.push_back(static_cast<uint16_t>(key));
+            m_key_values.insert(m_key_values.end(), &quantized[key * 3], &quantized[key * 3] + 3);
+        }
+    }
+
+    bool CompressedAnimationClip::sample(size_t      node_index,
+                                         float       frame,
+                                         Vector3&    position,
+                                         Quaternion& rotation,
+                                         Vector3&    scaling) const
+    {
+        const Track* tracks = &m_tracks[node_index * k_track_count];
+        if (tracks[k_position_track].m_key_count == 0)
+        {
+            return false;
+        }
+
+        position = sampleVectorTrack(tracks[k_position_track], frame);
+        rotation = sampleRotationTrack(tracks[k_rotation_track], frame);
+        scaling  = sampleVectorTrack(tracks[k_scaling_track], frame);
+        return true;
+    }
+
+    void CompressedAnimationClip::findKeys(const Track& track,
+                                           float        frame,
+                                           uint32_t&    low_key,
+                                           uint32_t&    high_key,
+                                           float&       ratio) const
+    {
+        const uint16_t* frames    = m_key_frames.data() + track.m_first_key;
+        const uint32_t  last_key  = track.m_key_count - 1;
+        if (frame >= frames[last_key])
+        {
+            // tracks shorter than the clip hold their last key
+            low_key  = track.m_first_key + last_key;
+            high_key = low_key;
+            ratio    = 0.0f;
+            return;
+        }
+        frame = std::max(frame, 0.0f);
+
+        // the first key is always at frame 0, so the key after the frame is in [1, last_key]
+        const uint32_t next = static_cast<uint32_t>(std::upper_bound(frames, frames + last_key, frame) - frames);
+        low_key             = track.m_first_key + next - 1;
+        high_key            = track.m_first_key + next;
+        ratio               = (frame - frames[next - 1]) / (frames[next] - frames[next - 1]);
+    }
+
+    Vector3 CompressedAnimationClip::sampleVectorTrack(const Track& track, float frame) const
+    {
+        if (track.m_key_count == 1)
+        {
+            return Vector3(track.m_base[0], track.m_base[1], track.m_base[2]);
+        }
+
+        uint32_t low_key, high_key;
+        float    ratio;
+        findKeys(track, frame, low_key, high_key, ratio);
+        return Vector3::lerp(dequantizeVector(&m_key_values[low_key * 3], track.m_base, track.m_extent),
+                             dequantizeVector(&m_key_values[high_key * 3], track.m_base, track.m_extent),
+                             ratio);
+    }
+
+    Quaternion CompressedAnimationClip::sampleRotationTrack(const Track& track, float frame) const
+    {
+        if (track.m_key_count == 1)
+        {
+            return Quaternion(track.m_base[0], track.m_base[1], track.m_base[2], track.m_base[3]);
+        }
+
+        uint32_t low_key, high_key;
+        float    ratio;
+        findKeys(track, frame, low_key, high_key, ratio);
+        return Quaternion::nLerp(ratio,
+                                 dequantizeRotation(&m_key_values[low_key * 3]),
+                                 dequantizeRotation(&m_key_values[high_key * 3]),
+                                 true);
+    }
+} // namespace Piccolo
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "runtime/core/math/quaternion.h"
+#include "runtime/core/math/vector3.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Piccolo
+{
+    class AnimationClip;
+
+    /// Runtime form of an AnimationClip. Constant tracks are stored once, the keys of the animated tracks are reduced
+    /// within an error bound and quantized to 16 bits per component, rotations as their smallest three components.
+    /// The keys of all the tracks are packed in two contiguous arrays and decoded while sampling.
+    class CompressedAnimationClip
+    {
+    public:
+        /// largest error allowed by the key reduction, in model units for positions and scales, in radians for
+        /// rotations
+        static constexpr float k_position_tolerance = 0.001f;
+        static constexpr float k_scaling_tolerance  = 0.001f;
+        static constexpr float k_rotation_tolerance = 0.002f;
+
+        void compress(const AnimationClip& clip);
+
+        /// the keys of a node at a frame, fractional frames are interpolated, false if the node has no keys
+        bool sample(size_t node_index, float frame, Vector3& position, Quaternion& rotation, Vector3& scaling) const;
+
+        int32_t getTotalFrame() const { return m_total_frame; }
+        int32_t getNodeCount() const { return m_node_count; }
+        /// bytes held by the clip, for the cache budgets
+        size_t getMemorySize() const;
+
+    private:
+        static constexpr size_t k_position_track = 0;
+        static constexpr size_t k_rotation_track = 1;
+        static constexpr size_t k_scaling_track  = 2;
+        static constexpr size_t k_track_count    = 3;
+
+        struct Track
+        {
+            // into m_key_frames, and times 3 into m_key_values
+            uint32_t m_first_key {0};
+            // 0 for a node without keys, 1 for a constant track stored in m_base
+            uint32_t m_key_count {0};
+            // the constant value, or the quantized range of an animated position or scaling track
+            float m_base[4] {};
+            float m_extent[3] {};
+        };
+
+        void compressVectorTrack(const std::vector<Vector3>& keys, size_t key_count, float tolerance, Track& track);
+        void compressRotationTrack(const std::vector<Quaternion>& keys, size_t key_count, Track& track);
+
+        void findKeys(const Track& track, float frame, uint32_t& low_key, uint32_t& high_key, float& ratio) const;
+        Vector3    sampleVectorTrack(const Track& track, float frame) const;
+        Quaternion sampleRotationTrack(const Track& track, float frame) const;
+
+        int32_t m_total_frame {0};
+        int32_t m_node_count {0};
+
+        // k_track_count tracks per node
+        std::vector<Track>    m_tracks;
+        std::vector<uint16_t> m_key_frames;
+        std::vector<uint16_t> m_key_values;
+    };
+} // namespace Piccolo
@@ -1,167 +1,193 @@
 #include "runtime/function/animation/skeleton.h"
 
 #include "runtime/core/math/math.h"
+#include "runtime/function/animation/compressed_animation_clip.h"
 
-#include "runtime/function/animation/utilities.h"
+#include "runtime/resource/res_type/data/animation_skeleton_node_map.h"
+#include "runtime/resource/res_type/data/skeleton_data.h"
+
+#include <algorithm>
 
 namespace Piccolo
 {
-    Skeleton::~Skeleton() { delete[] m_bones; }
-
-    void Skeleton::resetSkeleton()
-    {
-        for (size_t i = 0; i < m_bone_count; i++)
-            m_bones[i].resetToInitialPose();
-    }
-
     void Skeleton::buildSkeleton(const SkeletonData& skeleton_definition)
     {
-        m_is_flat = skeleton_definition.is_flat;
-        if (m_bones != nullptr)
-        {
-            delete[] m_bones;
-        }
-        if (!m_is_flat || !skeleton_definition.in_topological_order)
+        m_parent_indices.clear();
+        m_joint_palette.clear();
+        if (!skeleton_definition.is_flat || !skeleton_definition.in_topological_order)
         {
             // LOG_ERROR
             return;
         }
-        m_bone_count = skeleton_definition.bones_map.size();
-        m_bones      = new Bone[m_bone_count];
-        for (size_t i = 0; i < m_bone_count; i++)
+
+        const size_t bone_count = skeleton_definition.bones_map.size();
+        m_parent_indices.resize(bone_count);
+        m_bone_names.resize(bone_count);
+        m_inverse_tposes.resize(bone_count);
+        m_binding_positions.resize(bone_count);
+        m_binding_rotations.resize(bone_count);
+        m_binding_scales.resize(bone_count);
+        for (size_t i = 0; i < bone_count; i++)
         {
-            const RawBone bone_definition = skeleton_definition.bones_map[i];
-            Bone*         parent_bone     = find_by_index(m_bones, bone_definition.parent_index, i, m_is_flat);
-            m_bones[i].initialize(std::make_shared<RawBone>(bone_definition), parent_bone);
+            const RawBone& bone_definition = skeleton_definition.bones_map[i];
+
+            // in topological order, a parent always comes before its children
+            const int parent_index = bone_definition.parent_index;
+            m_parent_indices[i] =
+                (parent_index >= 0 && static_cast<size_t>(parent_index) < i) ? parent_index : k_no_parent;
+
+            m_bone_names[i]     = bone_definition.name;
+            m_inverse_tposes[i] = bone_definition.tpose_matrix;
+
+            Quaternion binding_rotation = bone_definition.binding_pose.m_rotation;
+            if (binding_rotation.isNaN())
+            {
+                binding_rotation = Quaternion::IDENTITY;
+            }
+            binding_rotation.normalise();
+
+            m_binding_positions[i] = bone_definition.binding_pose.m_position;
+            m_binding_rotations[i] = binding_rotation;
+            m_binding_scales[i]    = bone_definition.binding_pose.m_scale;
         }
+
+        m_local_positions = m_binding_positions;
+        m_local_rotations = m_binding_rotations;
+        m_local_scales    = m_binding_scales;
+
+        m_model_positions.resize(bone_count);
+        m_model_rotations.resize(bone_count);
+        m_model_scales.resize(bone_count);
+        m_joint_palette.resize(bone_count + 1);
+
+        updateModelPose();
     }
 
-    void Skeleton::applyAnimation(const BlendStateWithClipData& blend_state)
+    void Skeleton::blendAnimations(const SkeletonClipSample* samples, size_t sample_count)
     {
-        if (!m_bones)
+        const size_t bone_count = m_parent_indices.size();
+        if (bone_count == 0)
         {
             return;
         }
-        resetSkeleton();
-        for (size_t clip_index = 0; clip_index < 1; clip_index++)
+
+        m_blend_weights.assign(bone_count, 0.0f);
+        m_blend_positions.assign(bone_count, Vector3::ZERO);
+        m_blend_rotations.assign(bone_count, Quaternion::ZERO);
+        m_blend_scales.assign(bone_count, Vector3::ZERO);
+        for (size_t sample_index = 0; sample_index < sample_count; sample_index++)
+        {
+            accumulateSample(samples[sample_index]);
+        }
+
+        for (size_t i = 0; i < bone_count; i++)
         {
-            const AnimationClip& animation_clip = blend_state.blend_clip[clip_index];
-            const float          phase          = blend_state.blend_ratio[clip_index];
-            const AnimSkelMap&   anim_skel_map  = blend_state.blend_anim_skel_map[clip_index];
-
-            float exact_frame        = phase * (animation_clip.total_frame - 1);
-            int   current_frame_low  = floor(exact_frame);
-            int   current_frame_high = ceil(exact_frame);
-            float lerp_ratio         = exact_frame - current_frame_low;
-            // for (size_t node_index = 0; node_index < 0; node_index++)
-            for (size_t node_index = 0;
-                 node_index < animation_clip.node_count && node_index < anim_skel_map.convert.size();
-                 node_index++)
+            const float weight = m_blend_weights[i];
+            if (weight < 0.0001f)
             {
-                AnimationChannel channel    = animation_clip.node_channels[node_index];
-                size_t           bone_index = anim_skel_map.convert[node_index];
-                float            weight     = 1; // blend_state.blend_weight[clip_index]->blend_weight[bone_index];
-                weight                      = 1;
-                if (fabs(weight) < 0.0001f)
-                {
-                    continue;
-                }
-                if (bone_index == std::numeric_limits<size_t>().max())
-                {
-                    // LOG_WARNING
-                    continue;
-                }
-                Bone* bone = &m_bones[bone_index];
-                if (channel.position_keys.size() <= current_frame_high)
-                {
-                    current_frame_high = channel.position_keys.size() - 1;
-                }
-                if (channel.scaling_keys.size() <= current_frame_high)
-                {
-                    current_frame_high = channel.scaling_keys.size() - 1;
-                }
-                if (channel.rotation_keys.size() <= current_frame_high)
-                {
-                    current_frame_high = channel.rotation_keys.size() - 1;
-                }
-                current_frame_low = (current_frame_low < current_frame_high) ? current_frame_low : current_frame_high;
-                Vector3 position  = Vector3::lerp(
-                    channel.position_keys[current_frame_low], channel.position_keys[current_frame_high], lerp_ratio);
-                Vector3 scaling = Vector3::lerp(
-                    channel.scaling_keys[current_frame_low], channel.scaling_keys[current_frame_high], lerp_ratio);
-                Quaternion rotation = Quaternion::nLerp(lerp_ratio,
-                                                        channel.rotation_keys[current_frame_low],
-                                                        channel.rotation_keys[current_frame_high],
-                                                        true);
-
-                {
-                    bone->rotate(rotation);
-                    bone->scale(scaling);
-                    bone->translate(position);
-
-                    // bone->rotate({ {},0.01,0,0,1 });
-                    // bone->scale({ {},0.9,0.9,0.9 });
-                }
+                m_local_positions[i] = m_binding_positions[i];
+                m_local_rotations[i] = m_binding_rotations[i];
+                m_local_scales[i]    = m_binding_scales[i];
+                continue;
             }
+
+            const float inverse_weight = 1.0f / weight;
+            Quaternion  rotation       = m_blend_rotations[i];
+            rotation.normalise();
+
+            // the keys are applied on top of the binding pose: rotated locally, scaled, then translated in the
+            // parent space
+            m_local_rotations[i] = m_binding_rotations[i] * rotation;
+            m_local_scales[i]    = m_binding_scales[i] * (m_blend_scales[i] * inverse_weight);
+            m_local_positions[i] = m_binding_positions[i] + m_blend_positions[i] * inverse_weight;
         }
-        // bones[77].rotate(Quaternion{ {},1,0,0,1 });
-        // bones[18].translate(Vector3{ {},0,1,0 });
-        // bones[0].setScale(Vector3{ {},0,1,0.01 });
-        for (size_t i = 0; i < m_bone_count; i++)
-        {
-            m_bones[i].update();
-        }
-#ifdef _DEBUG
-        // bones[107].m_derived_position += Vector3{ {},10, 0, 0 };
-#endif
     }
 
-    AnimationResult Skeleton::outputAnimationResult()
+    void Skeleton::accumulateSample(const SkeletonClipSample& sample)
     {
-        AnimationResult animation_result;
-        for (size_t i = 0; i < m_bone_count; i++)
-        {
-            std::shared_ptr<AnimationResultElement> animation_result_element =
-                std::make_shared<AnimationResultElement>();
-            Bone* bone                      = &m_bones[i];
-            animation_result_element->index = bone->getID() + 1;
-            Vector3 temp_translation        = bone->_getDerivedPosition();
-
-            // TODO: the unit of the joint matrices is wrong
-            Vector3 temp_scale = bone->_getDerivedScale();
+        const CompressedAnimationClip& clip          = *sample.m_clip;
+        const AnimSkelMap&             anim_skel_map = *sample.m_anim_skel_map;
 
-            Quaternion temp_rotation = bone->_getDerivedOrientation();
+        const float exact_frame = sample.m_phase * (clip.getTotalFrame() - 1);
 
-            // auto scale = bone->_getDerivedTScale();
-            // scale.x = 1.f / scale.x;
-            // scale.y = 1.f / scale.y;
-            // scale.z = 1.f / scale.z;
+        const int32_t bone_count = getBonesCount();
+        const size_t  node_count = std::min(static_cast<size_t>(clip.getNodeCount()), anim_skel_map.convert.size());
+        for (size_t node_index = 0; node_index < node_count; node_index++)
+        {
+            const int bone_index = anim_skel_map.convert[node_index];
+            if (bone_index < 0 || bone_index >= bone_count)
+            {
+                // LOG_WARNING
+                continue;
+            }
 
-            // auto revTmat = getMatrix(
-            //	-bone->_getDerivedTPosition(),
-            //	scale,
-            //	conjugate( bone->_getDerivedTOrientation())
-            //);
-            auto objMat =
-                Transform(bone->_getDerivedPosition(), bone->_getDerivedOrientation(), bone->_getDerivedScale())
-                    .getMatrix();
+            const float weight = sample.m_bone_weights[bone_index];
+            if (weight < 0.0001f)
+            {
+                continue;
+            }
 
-            auto resMat = objMat * bone->_getInverseTpose();
+            // decoded in place from the compressed keys
+            Vector3    position;
+            Quaternion rotation;
+            Vector3    scaling;
+            if (!clip.sample(node_index, exact_frame, position, rotation, scaling))
+            {
+                continue;
+            }
 
-            animation_result_element->transform = resMat.toMatrix4x4_();
+            // keep the rotations in the same hemisphere, so that the weighted sum is a shortest path blend
+            if (m_blend_rotations[bone_index].dot(rotation) < 0.0f)
+            {
+                rotation = -rotation;
+            }
 
-            animation_result.node.push_back(*animation_result_element);
+            m_blend_weights[bone_index] += weight;
+            m_blend_positions[bone_index] += position * weight;
+            m_blend_rotations[bone_index] = m_blend_rotations[bone_index] + rotation * weight;
+            m_blend_scales[bone_index] += scaling * weight;
         }
-        return animation_result;
     }
 
-    const Bone* Skeleton::getBones() const
+    void Skeleton::updateModelPose()
     {
-        return m_bones;
+        const int32_t bone_count = getBonesCount();
+        for (int32_t i = 0; i < bone_count; i++)
+        {
+            const int32_t parent_index = m_parent_indices[i];
+            if (parent_index == k_no_parent)
+            {
+                m_model_rotations[i] = m_local_rotations[i];
+                m_model_positions[i] = m_local_positions[i];
+                m_model_scales[i]    = m_local_scales[i];
+                continue;
+            }
+
+            const Quaternion& parent_rotation = m_model_rotations[parent_index];
+            const Vector3&    parent_scale    = m_model_scales[parent_index];
+
+            m_model_rotations[i] = parent_rotation * m_local_rotations[i];
+            m_model_rotations[i].normalise();
+            // scale as equivalent axes, no shearing
+            m_model_scales[i] = parent_scale * m_local_scales[i];
+            m_model_positions[i] =
+                parent_rotation * (parent_scale * m_local_positions[i]) + m_model_positions[parent_index];
+        }
+
+        // the joint indices of the skinned meshes start at 1, the first joint stays in place
+        m_joint_palette[0] = Matrix4x4::IDENTITY;
+        for (int32_t i = 0; i < bone_count; i++)
+        {
+            // TODO: the unit of the joint matrices is wrong
+            m_joint_palette[i + 1] = getModelMatrix(i) * m_inverse_tposes[i];
+        }
     }
 
-    int32_t Skeleton::getBonesCount() const
+    Matrix4x4 Skeleton::getModelMatrix(int32_t bone_index) const
     {
-        return m_bone_count;
+        Matrix4x4 model_matrix;
+        model_matrix.makeTransform(
+            m_model_positions[bone_index], m_model_scales[bone_index], m_model_rotations[bone_index]);
+        return model_matrix;
     }
-} // namespace Piccolo
\ No newline at end of file
+} // namespace Piccolo
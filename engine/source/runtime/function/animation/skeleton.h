@@ -1,29 +1,75 @@
 #pragma once
 
-#include "runtime/resource/res_type/components/animation.h"
+#include "runtime/core/math/matrix4.h"
+#include "runtime/core/math/quaternion.h"
+#include "runtime/core/math/vector3.h"
 
-#include "runtime/function/animation/node.h"
+#include <string>
+#include <vector>
 
 namespace Piccolo
 {
     class SkeletonData;
-    class BlendStateWithClipData;
+    class CompressedAnimationClip;
+    class AnimSkelMap;
 
+    /// One clip sampled into a blend, at phase (0-1) with one weight per bone of the skeleton
+    struct SkeletonClipSample
+    {
+        const CompressedAnimationClip* m_clip {nullptr};
+        const AnimSkelMap*             m_anim_skel_map {nullptr};
+        float                          m_phase {0.0f};
+        const float*                   m_bone_weights {nullptr};
+    };
+
+    /// Pose buffers of a skeleton as structure of arrays, indexed by bone. Bones are stored in topological order,
+    /// so that the model pose is computed in a single forward pass over the parent indices.
     class Skeleton
     {
+    public:
+        static constexpr int32_t k_no_parent = -1;
+
+        void buildSkeleton(const SkeletonData& skeleton_definition);
+
+        /// local pose = binding pose with the weighted blend of the samples applied on top, bones without any
+        /// weight stay in the binding pose
+        void blendAnimations(const SkeletonClipSample* samples, size_t sample_count);
+        /// model pose from the local pose, then the joint palette from the model pose
+        void updateModelPose();
+
+        /// one matrix per bone after the fixed first joint, the joint indices of the skinned meshes start at 1
+        const std::vector<Matrix4x4>& getJointPalette() const { return m_joint_palette; }
+
+        int32_t            getBonesCount() const { return static_cast<int32_t>(m_parent_indices.size()); }
+        int32_t            getParentIndex(int32_t bone_index) const { return m_parent_indices[bone_index]; }
+        const std::string& getBoneName(int32_t bone_index) const { return m_bone_names[bone_index]; }
+        Matrix4x4          getModelMatrix(int32_t bone_index) const;
+
     private:
-        bool  m_is_flat {false};
-        int   m_bone_count {0};
-        Bone* m_bones {nullptr};
+        void accumulateSample(const SkeletonClipSample& sample);
 
-    public:
-        ~Skeleton();
-
-        void            buildSkeleton(const SkeletonData& skeleton_definition);
-        void            applyAnimation(const BlendStateWithClipData& blend_state);
-        AnimationResult outputAnimationResult();
-        void            resetSkeleton();
-        const Bone*     getBones() const;
-        int32_t         getBonesCount() const;
+        std::vector<int32_t>     m_parent_indices;
+        std::vector<std::string> m_bone_names;
+        std::vector<Matrix4x4>   m_inverse_tposes;
+
+        std::vector<Vector3>    m_binding_positions;
+        std::vector<Quaternion> m_binding_rotations;
+        std::vector<Vector3>    m_binding_scales;
+
+        std::vector<Vector3>    m_local_positions;
+        std::vector<Quaternion> m_local_rotations;
+        std::vector<Vector3>    m_local_scales;
+
+        // weighted sums of the sampled keys, normalized by the summed weight of each bone
+        std::vector<float>      m_blend_weights;
+        std::vector<Vector3>    m_blend_positions;
+        std::vector<Quaternion> m_blend_rotations;
+        std::vector<Vector3>    m_blend_scales;
+
+        std::vector<Vector3>    m_model_positions;
+        std::vector<Quaternion> m_model_rotations;
+        std::vector<Vector3>    m_model_scales;
+
+        std::vector<Matrix4x4> m_joint_palette;
     };
 } // namespace Piccolo
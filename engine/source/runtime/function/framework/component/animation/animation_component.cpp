@@ -3,28 +3,43 @@
 #include "runtime/function/animation/animation_system.h"
 #include "runtime/function/framework/object/object.h"
 
+#include <algorithm>
+
 namespace Piccolo
 {
     void AnimationComponent::postLoadResource(std::weak_ptr<GObject> parent_object)
     {
         m_parent_object = parent_object;
 
+        // the clips load on the workers while the skeleton loads
+        AnimationManager::prefetchBlendState(m_animation_res.blend_state);
+
         auto skeleton_res = AnimationManager::tryLoadSkeleton(m_animation_res.skeleton_file_path);
 
         m_skeleton.buildSkeleton(*skeleton_res);
+
+        // resolves the clips of the blend state while loading rather than in the first tick
+        m_blender.evaluate(m_animation_res.blend_state, m_skeleton);
+        m_skeleton.updateModelPose();
     }
 
     void AnimationComponent::tick(float delta_time)
     {
-        m_animation_res.blend_state.blend_ratio[0] +=
-            (delta_time / m_animation_res.blend_state.blend_clip_file_length[0]);
-        m_animation_res.blend_state.blend_ratio[0] -= floor(m_animation_res.blend_state.blend_ratio[0]);
-
-        m_skeleton.applyAnimation(AnimationManager::getBlendStateWithClipData(m_animation_res.blend_state));
-        m_animation_res.animation_result = m_skeleton.outputAnimationResult();
+        // every clip advances at its own length, the ratios stay in [0, 1)
+        BlendState&  blend_state = m_animation_res.blend_state;
+        const size_t clip_count  = std::min(blend_state.blend_ratio.size(), blend_state.blend_clip_file_length.size());
+        for (size_t clip_index = 0; clip_index < clip_count; clip_index++)
+        {
+            float& blend_ratio = blend_state.blend_ratio[clip_index];
+            blend_ratio += (delta_time / blend_state.blend_clip_file_length[clip_index]);
+            blend_ratio -= floor(blend_ratio);
+        }
+
+        // animation components are ticked in parallel, this only touches the skeleton of this component, the
+        // mesh component sends the joint palette to the renderer
+        m_blender.evaluate(blend_state, m_skeleton);
+        m_skeleton.updateModelPose();
     }
 
-    const AnimationResult& AnimationComponent::getResult() const { return m_animation_res.animation_result; }
-
     const Skeleton& AnimationComponent::getSkeleton() const { return m_skeleton; }
 } // namespace Piccolo
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "runtime/function/animation/animation_blender.h"
 #include "runtime/function/animation/skeleton.h"
 #include "runtime/function/framework/component/component.h"
 #include "runtime/resource/res_type/components/animation.h"
@@ -18,14 +19,13 @@ namespace Piccolo
 
         void tick(float delta_time) override;
 
-        const AnimationResult& getResult() const;
-
         const Skeleton& getSkeleton() const;
 
     protected:
         META(Enable)
         AnimationComponentRes m_animation_res;
 
-        Skeleton m_skeleton;
+        Skeleton         m_skeleton;
+        AnimationBlender m_blender;
     };
 } // namespace Piccolo
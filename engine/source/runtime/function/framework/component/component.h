@@ -1,9 +1,22 @@
 #pragma once
 #include "runtime/core/meta/reflection/reflection.h"
 
+#include <cstdint>
+
 namespace Piccolo
 {
     class GObject;
+
+    // component type indices are assigned by the meta parser, see _generated/reflection/all_component_type.h
+    using ComponentTypeIndex = uint32_t;
+
+    constexpr ComponentTypeIndex k_max_component_type_count     = 64;
+    constexpr ComponentTypeIndex k_invalid_component_type_index = k_max_component_type_count;
+
+    // specialized for every component type by the generated code
+    template<typename TComponent>
+    struct ComponentTypeTrait;
+
     // Component
     REFLECTION_TYPE(Component)
     CLASS(Component, WhiteListFields)
@@ -18,6 +31,10 @@ namespace Piccolo
         Component() = default;
         virtual ~Component() {}
 
+        // Loading the resources referenced by the component, before postLoadResource. When a level is streamed
+        // in it runs on a job system worker, so it must not touch the level or the engine systems
+        virtual void loadResource() {}
+
         // Instantiating the component after definition loaded
         virtual void postLoadResource(std::weak_ptr<GObject> parent_object) { m_parent_object = parent_object; }
 
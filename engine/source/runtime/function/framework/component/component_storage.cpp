@@ -0,0 +1,236 @@
+#include "runtime/function/framework/component/component_storage.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/job/job_system.h"
+
+#include "runtime/function/framework/component/animation/animation_component.h"
+#include "runtime/function/framework/component/camera/camera_component.h"
+#include "runtime/function/framework/component/lua/lua_component.h"
+#include "runtime/function/framework/component/mesh/mesh_component.h"
+#include "runtime/function/framework/component/motor/motor_component.h"
+#include "runtime/function/framework/component/particle/particle_component.h"
+#include "runtime/function/framework/component/rigidbody/rigidbody_component.h"
+#include "runtime/function/framework/component/transform/transform_component.h"
+#include "runtime/function/framework/object/object.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace Piccolo
+{
+    namespace
+    {
+        struct ComponentTypeEntry
+        {
+            std::string                   m_type_name;
+            ComponentStorage::PoolFactory m_factory;
+        };
+
+        std::vector<ComponentTypeEntry>& getComponentTypeRegistry()
+        {
+            static std::vector<ComponentTypeEntry> registry;
+            return registry;
+        }
+
+        // the registration order is the tick order, it follows the order components are declared
+        // in object definitions so that intra-object dependencies are kept:
+        // transform swaps its buffers first, animation and particle read it, mesh consumes and clears the
+        // transform dirty flag, motor/camera/lua prepare the next frame
+        void registerBuiltinComponentTypes()
+        {
+            static bool is_registered = false;
+            if (is_registered)
+                return;
+            is_registered = true;
+
+            ComponentStorage::registerComponentType<TransformComponent>("TransformComponent");
+            ComponentStorage::registerComponentType<RigidBodyComponent>("RigidBodyComponent");
+            ComponentStorage::registerComponentType<AnimationComponent>("AnimationComponent", true);
+            ComponentStorage::registerComponentType<ParticleComponent>("ParticleComponent");
+            ComponentStorage::registerComponentType<MeshComponent>("MeshComponent");
+            ComponentStorage::registerComponentType<MotorComponent>("MotorComponent");
+            ComponentStorage::registerComponentType<CameraComponent>("CameraComponent");
+            ComponentStorage::registerComponentType<LuaComponent>("LuaComponent");
+        }
+
+        size_t getComponentTickOrder(const std::string& type_name)
+        {
+            const std::vector<ComponentTypeEntry>& registry = getComponentTypeRegistry();
+            for (size_t index = 0; index < registry.size(); ++index)
+            {
+                if (registry[index].m_type_name == type_name)
+                    return index;
+            }
+            return std::numeric_limits<size_t>::max();
+        }
+
+        constexpr size_t k_parallel_tick_batch_size = 8;
+    } // namespace
+
+    void ComponentPool::add(GObjectID owner_id, Component* component)
+    {
+        ASSERT(m_component_to_slot.find(component) == m_component_to_slot.end());
+
+        m_component_to_slot[component] = m_components.size();
+        m_owner_ids.push_back(owner_id);
+        m_components.push_back(component);
+    }
+
+    void ComponentPool::remove(Component* component)
+    {
+        auto iter = m_component_to_slot.find(component);
+        if (iter == m_component_to_slot.end())
+            return;
+
+        const size_t slot      = iter->second;
+        const size_t last_slot = m_components.size() - 1;
+        if (slot != last_slot)
+        {
+            m_owner_ids[slot]                       = m_owner_ids[last_slot];
+            m_components[slot]                      = m_components[last_slot];
+            m_component_to_slot[m_components[slot]] = slot;
+        }
+
+        m_owner_ids.pop_back();
+        m_components.pop_back();
+        m_component_to_slot.erase(iter);
+    }
+
+    void ComponentPool::clear()
+    {
+        m_owner_ids.clear();
+        m_components.clear();
+        m_component_to_slot.clear();
+    }
+
+    void ComponentPool::tick(float delta_time)
+    {
+        tickRange([this, delta_time](size_t begin, size_t end) {
+            for (size_t slot = begin; slot < end; ++slot)
+            {
+                m_components[slot]->tick(delta_time);
+            }
+        });
+    }
+
+    void ComponentPool::tickRange(const std::function<void(size_t, size_t)>& tick_range)
+    {
+        std::shared_ptr<JobSystem> job_system = g_runtime_global_context.m_job_system;
+        if (!m_is_tick_parallel || !job_system)
+        {
+            tick_range(0, m_components.size());
+            return;
+        }
+
+        job_system->parallelFor("ComponentPoolTick", m_components.size(), k_parallel_tick_batch_size, tick_range);
+    }
+
+    void ComponentStorage::registerPoolFactory(const std::string& type_name, PoolFactory factory)
+    {
+        // builtin types always come first in the tick order
+        registerBuiltinComponentTypes();
+
+        std::vector<ComponentTypeEntry>& registry = getComponentTypeRegistry();
+        for (ComponentTypeEntry& entry : registry)
+        {
+            if (entry.m_type_name == type_name)
+            {
+                entry.m_factory = factory;
+                return;
+            }
+        }
+        registry.push_back({type_name, factory});
+    }
+
+    ComponentPool* ComponentStorage::getPool(const std::string& type_name) const
+    {
+        auto iter = m_type_to_pool.find(type_name);
+        return iter != m_type_to_pool.end() ? iter->second : nullptr;
+    }
+
+    ComponentPool* ComponentStorage::getOrCreatePool(const std::string& type_name)
+    {
+        ComponentPool* pool = getPool(type_name);
+        if (pool)
+            return pool;
+
+        registerBuiltinComponentTypes();
+
+        const size_t tick_order = getComponentTickOrder(type_name);
+
+        std::unique_ptr<ComponentPool> new_pool;
+        if (tick_order != std::numeric_limits<size_t>::max())
+        {
+            new_pool = getComponentTypeRegistry()[tick_order].m_factory(type_name);
+        }
+        else
+        {
+            new_pool = std::make_unique<ComponentPool>(type_name);
+        }
+        pool = new_pool.get();
+
+        // keep pools sorted by tick order, unregistered types keep their creation order at the end
+        auto insert_iter = std::upper_bound(
+            m_pools.begin(),
+            m_pools.end(),
+            tick_order,
+            [](size_t order, const std::unique_ptr<ComponentPool>& other) {
+                return order < getComponentTickOrder(other->getTypeName());
+            });
+        m_pools.insert(insert_iter, std::move(new_pool));
+        m_type_to_pool[type_name] = pool;
+
+        return pool;
+    }
+
+    void ComponentStorage::addObject(const std::shared_ptr<GObject>& object)
+    {
+        if (!object)
+            return;
+
+        const GObjectID object_id = object->getID();
+        removeObject(object_id);
+
+        auto& object_components = m_object_components[object_id];
+        for (auto& component : object->getComponents())
+        {
+            if (!component)
+                continue;
+
+            ComponentPool* pool = getOrCreatePool(component.getTypeName());
+            pool->add(object_id, component.getPtr());
+            object_components.emplace_back(pool, component.getPtr());
+        }
+    }
+
+    void ComponentStorage::removeObject(GObjectID object_id)
+    {
+        auto iter = m_object_components.find(object_id);
+        if (iter == m_object_components.end())
+            return;
+
+        for (auto& object_component : iter->second)
+        {
+            object_component.first->remove(object_component.second);
+        }
+        m_object_components.erase(iter);
+    }
+
+    void ComponentStorage::clear()
+    {
+        m_pools.clear();
+        m_type_to_pool.clear();
+        m_object_components.clear();
+    }
+
+    void ComponentStorage::tick(float delta_time)
+    {
+        for (auto& pool : m_pools)
+        {
+            if (pool->size() == 0 || !shouldComponentTick(pool->getTypeName()))
+                continue;
+
+            pool->tick(delta_time);
+        }
+    }
+} // namespace Piccolo
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "runtime/function/framework/component/component.h"
+#include "runtime/function/framework/object/object_id_allocator.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Piccolo
+{
+    class GObject;
+
+    /// Dense pool of all components of one type in a level.
+    /// Owner ids and component pointers are stored in two parallel arrays (SoA), and a sparse
+    /// table maps a component to its slot so that removal is a swap-and-pop.
+    /// An object may own several components of the type, each of them has a slot of its own.
+    /// The pool doesn't own the components, they are still owned by their GObject.
+    class ComponentPool
+    {
+    public:
+        ComponentPool(const std::string& type_name, bool is_tick_parallel = false) :
+            m_type_name(type_name), m_is_tick_parallel(is_tick_parallel)
+        {}
+        virtual ~ComponentPool() {}
+
+        void add(GObjectID owner_id, Component* component);
+        void remove(Component* component);
+        void clear();
+
+        virtual void tick(float delta_time);
+
+        const std::string&             getTypeName() const { return m_type_name; }
+        size_t                         size() const { return m_components.size(); }
+        const std::vector<GObjectID>&  getOwnerIDs() const { return m_owner_ids; }
+        const std::vector<Component*>& getComponents() const { return m_components; }
+
+    protected:
+        // call tick_range over all slots, split over the job system workers if the pool ticks in parallel
+        void tickRange(const std::function<void(size_t, size_t)>& tick_range);
+
+        std::string m_type_name;
+        bool        m_is_tick_parallel {false};
+
+        std::vector<GObjectID>  m_owner_ids;
+        std::vector<Component*> m_components;
+
+        std::unordered_map<Component*, size_t> m_component_to_slot;
+    };
+
+    /// Pool of a known component type, ticks the components without virtual dispatch
+    template<typename TComponent>
+    class TypedComponentPool : public ComponentPool
+    {
+    public:
+        TypedComponentPool(const std::string& type_name, bool is_tick_parallel) :
+            ComponentPool(type_name, is_tick_parallel)
+        {}
+
+        void tick(float delta_time) override
+        {
+            tickRange([this, delta_time](size_t begin, size_t end) {
+                for (size_t slot = begin; slot < end; ++slot)
+                {
+                    static_cast<TComponent*>(m_components[slot])->TComponent::tick(delta_time);
+                }
+            });
+        }
+    };
+
+    /// Per-level component store, all components are grouped by type so that the level can tick
+    /// them type by type over contiguous arrays instead of walking every GObject.
+    /// GObject still keeps its own ReflectionPtr list and remains the public facade of the components.
+    class ComponentStorage
+    {
+    public:
+        using PoolFactory = std::function<std::unique_ptr<ComponentPool>(const std::string&)>;
+
+        void addObject(const std::shared_ptr<GObject>& object);
+        void removeObject(GObjectID object_id);
+        void clear();
+
+        // tick pools in the registered tick order, pools of unregistered types are ticked afterwards
+        void tick(float delta_time);
+
+        ComponentPool* getPool(const std::string& type_name) const;
+
+        const std::vector<std::unique_ptr<ComponentPool>>& getPools() const { return m_pools; }
+
+        // register a component type so it gets a typed pool and a stable position in the tick order,
+        // is_tick_parallel means the tick of one component only touches its own object
+        template<typename TComponent>
+        static void registerComponentType(const std::string& type_name, bool is_tick_parallel = false)
+        {
+            registerPoolFactory(type_name,
+                                [is_tick_parallel](const std::string& name) -> std::unique_ptr<ComponentPool> {
+                                    return std::make_unique<TypedComponentPool<TComponent>>(name, is_tick_parallel);
+                                });
+        }
+
+    private:
+        static void registerPoolFactory(const std::string& type_name, PoolFactory factory);
+
+        ComponentPool* getOrCreatePool(const std::string& type_name);
+
+        // sorted by tick order
+        std::vector<std::unique_ptr<ComponentPool>> m_pools;
+
+        std::unordered_map<std::string, ComponentPool*> m_type_to_pool;
+        // the pool of every component of an object, to remove them with the object
+        std::unordered_map<GObjectID, std::vector<std::pair<ComponentPool*, Component*>>> m_object_components;
+    };
+} // namespace Piccolo
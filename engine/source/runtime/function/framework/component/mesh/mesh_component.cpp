@@ -13,10 +13,8 @@
 
 namespace Piccolo
 {
-    void MeshComponent::postLoadResource(std::weak_ptr<GObject> parent_object)
+    void MeshComponent::loadResource()
     {
-        m_parent_object = parent_object;
-
         std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
         ASSERT(asset_manager);
 
@@ -56,6 +54,8 @@ namespace Piccolo
         }
     }
 
+    void MeshComponent::postLoadResource(std::weak_ptr<GObject> parent_object) { m_parent_object = parent_object; }
+
     void MeshComponent::tick(float delta_time)
     {
         if (!m_parent_object.lock())
@@ -65,24 +65,18 @@ namespace Piccolo
         const AnimationComponent* animation_component =
             m_parent_object.lock()->tryGetComponentConst(AnimationComponent);
 
+        RenderSwapContext& render_swap_context = g_runtime_global_context.m_render_system->getSwapContext();
+        RenderSwapData&    logic_swap_data     = render_swap_context.getLogicSwapData();
+
         if (transform_component->isDirty())
         {
+            // the joint palette is sent below every tick
             std::vector<GameObjectPartDesc> dirty_mesh_parts;
-            SkeletonAnimationResult         animation_result;
-            animation_result.m_transforms.push_back({Matrix4x4::IDENTITY});
-            if (animation_component != nullptr)
-            {
-                for (auto& node : animation_component->getResult().node)
-                {
-                    animation_result.m_transforms.push_back({Matrix4x4(node.transform)});
-                }
-            }
             for (GameObjectPartDesc& mesh_part : m_raw_meshes)
             {
                 if (animation_component)
                 {
                     mesh_part.m_with_animation                                = true;
-                    mesh_part.m_skeleton_animation_result                     = animation_result;
                     mesh_part.m_skeleton_binding_desc.m_skeleton_binding_file = mesh_part.m_mesh_desc.m_mesh_file;
                 }
                 Matrix4x4 object_transform_matrix = mesh_part.m_transform_desc.m_transform_matrix;
@@ -94,12 +88,22 @@ namespace Piccolo
                 mesh_part.m_transform_desc.m_transform_matrix = object_transform_matrix;
             }
 
-            RenderSwapContext& render_swap_context = g_runtime_global_context.m_render_system->getSwapContext();
-            RenderSwapData&    logic_swap_data     = render_swap_context.getLogicSwapData();
-
             logic_swap_data.addDirtyGameObject(GameObjectDesc {m_parent_object.lock()->getID(), dirty_mesh_parts});
 
             transform_component->setDirtyFlag(false);
         }
+
+        // the animation components are ticked in parallel before the mesh components, the palette is copied into
+        // the swap data here where only one thread writes it
+        if (animation_component)
+        {
+            const std::vector<Matrix4x4>& joint_palette = animation_component->getSkeleton().getJointPalette();
+            if (!joint_palette.empty())
+            {
+                Matrix4x4* joint_matrices = logic_swap_data.addJointPalette(
+                    m_parent_object.lock()->getID(), static_cast<uint32_t>(joint_palette.size()));
+                std::copy(joint_palette.begin(), joint_palette.end(), joint_matrices);
+            }
+        }
     }
 } // namespace Piccolo
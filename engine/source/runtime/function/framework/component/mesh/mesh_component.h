@@ -19,6 +19,7 @@ namespace Piccolo
     public:
         MeshComponent() {};
 
+        void loadResource() override;
         void postLoadResource(std::weak_ptr<GObject> parent_object) override;
 
         const std::vector<GameObjectPartDesc>& getRawMeshes() const { return m_raw_meshes; }
@@ -63,8 +63,7 @@ namespace Piccolo
         if (current_character->getObjectID() != m_parent_object.lock()->getID())
             return;
 
-        TransformComponent* transform_component =
-            m_parent_object.lock()->tryGetComponent<TransformComponent>("TransformComponent");
+        TransformComponent* transform_component = m_parent_object.lock()->tryGetComponent<TransformComponent>();
 
         Radian turn_angle_yaw = g_runtime_global_context.m_input_system->m_cursor_delta_yaw;
 
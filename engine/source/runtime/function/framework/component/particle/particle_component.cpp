@@ -27,8 +27,7 @@ namespace Piccolo
 
     void ParticleComponent::computeGlobalTransform()
     {
-        TransformComponent* transform_component =
-            m_parent_object.lock()->tryGetComponent<TransformComponent>("TransformComponent");
+        TransformComponent* transform_component = m_parent_object.lock()->tryGetComponent<TransformComponent>();
 
         Matrix4x4 global_transform_matrix = transform_component->getMatrix() * m_local_transform;
 
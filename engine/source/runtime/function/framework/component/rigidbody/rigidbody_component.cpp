@@ -32,6 +32,10 @@ namespace Piccolo
 
     RigidBodyComponent::~RigidBodyComponent()
     {
+        // never instantiated, e.g. deleted by a level loader before it's committed
+        if (m_rigidbody_id == s_invalid_rigidbody_id)
+            return;
+
         std::shared_ptr<PhysicsScene> physics_scene =
             g_runtime_global_context.m_world_manager->getCurrentActivePhysicsScene().lock();
         ASSERT(physics_scene);
@@ -39,13 +43,52 @@ namespace Piccolo
         physics_scene->removeRigidBody(m_rigidbody_id);
     }
 
+    void RigidBodyComponent::tick(float delta_time)
+    {
+        if (m_rigidbody_id == s_invalid_rigidbody_id ||
+            static_cast<RigidBodyActorType>(m_rigidbody_res.m_actor_type) != RigidBodyActorType::dynamic_actor)
+        {
+            return;
+        }
+
+        std::shared_ptr<PhysicsScene> physics_scene =
+            g_runtime_global_context.m_world_manager->getCurrentActivePhysicsScene().lock();
+        ASSERT(physics_scene);
+
+        Vector3    position;
+        Quaternion rotation;
+        if (!physics_scene->getInterpolatedTransform(m_rigidbody_id, position, rotation))
+        {
+            return;
+        }
+
+        // at rest
+        if (m_has_synced_pose && position == m_synced_position && rotation == m_synced_rotation)
+        {
+            return;
+        }
+
+        TransformComponent* transform_component = m_parent_object.lock()->tryGetComponent(TransformComponent);
+        if (transform_component == nullptr)
+        {
+            return;
+        }
+        transform_component->setPosition(position);
+        transform_component->setRotation(rotation);
+
+        m_has_synced_pose = true;
+        m_synced_position = position;
+        m_synced_rotation = rotation;
+    }
+
     void RigidBodyComponent::createRigidBody(const Transform& global_transform)
     {
         std::shared_ptr<PhysicsScene> physics_scene =
             g_runtime_global_context.m_world_manager->getCurrentActivePhysicsScene().lock();
         ASSERT(physics_scene);
 
-        m_rigidbody_id = physics_scene->createRigidBody(global_transform, m_rigidbody_res);
+        m_rigidbody_id    = physics_scene->createRigidBody(global_transform, m_rigidbody_res);
+        m_has_synced_pose = false;
     }
 
     void RigidBodyComponent::removeRigidBody()
@@ -67,6 +110,13 @@ namespace Piccolo
         }
         else
         {
+            // the pose came from the simulation in the first place
+            if (m_has_synced_pose && transform.m_position == m_synced_position &&
+                transform.m_rotation == m_synced_rotation)
+            {
+                return;
+            }
+
             std::shared_ptr<PhysicsScene> physics_scene =
                 g_runtime_global_context.m_world_manager->getCurrentActivePhysicsScene().lock();
             ASSERT(physics_scene);
@@ -3,6 +3,7 @@
 #include "runtime/resource/res_type/components/rigid_body.h"
 
 #include "runtime/function/framework/component/component.h"
+#include "runtime/function/physics/physics_scene.h"
 
 namespace Piccolo
 {
@@ -16,7 +17,8 @@ namespace Piccolo
 
         void postLoadResource(std::weak_ptr<GObject> parent_object) override;
 
-        void tick(float delta_time) override {}
+        /// dynamic bodies write their interpolated pose to the transform component
+        void tick(float delta_time) override;
         void updateGlobalTransform(const Transform& transform, bool is_scale_dirty);
         void getShapeBoundingBoxes(std::vector<AxisAlignedBox> & out_boudning_boxes) const;
 
@@ -27,6 +29,11 @@ namespace Piccolo
         META(Enable)
         RigidBodyComponentRes m_rigidbody_res;
 
-        uint32_t m_rigidbody_id {0xffffffff};
+        uint32_t m_rigidbody_id {s_invalid_rigidbody_id};
+
+        // the pose last written to the transform component, it's not sent back to the simulation
+        bool       m_has_synced_pose {false};
+        Vector3    m_synced_position;
+        Quaternion m_synced_rotation;
     };
 } // namespace Piccolo
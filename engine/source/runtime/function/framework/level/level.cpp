@@ -7,24 +7,37 @@
 
 #include "runtime/engine.h"
 #include "runtime/function/character/character.h"
+#include "runtime/function/framework/level/level_loader.h"
 #include "runtime/function/framework/object/object.h"
 #include "runtime/function/particle/particle_manager.h"
 #include "runtime/function/physics/physics_manager.h"
 #include "runtime/function/physics/physics_scene.h"
+#include <algorithm>
 #include <limits>
 
 namespace Piccolo
 {
+    Level::Level() = default;
+
+    Level::~Level() {}
+
     void Level::clear()
     {
+        // wait for the read in flight and delete the objects never committed
+        m_loader.reset();
+        m_committed_object_count = 0;
+        m_load_state             = LevelLoadState::idle;
+        m_is_loaded              = false;
+
         m_current_active_character.reset();
+        m_component_storage.clear();
         m_gobjects.clear();
 
         ASSERT(g_runtime_global_context.m_physics_manager);
         g_runtime_global_context.m_physics_manager->deletePhysicsScene(m_physics_scene);
     }
 
-    GObjectID Level::createObject(const ObjectInstanceRes& object_instance_res)
+    std::shared_ptr<GObject> Level::allocateObject()
     {
         GObjectID object_id = ObjectIDAllocator::alloc();
         ASSERT(object_id != k_invalid_gobject_id);
@@ -38,61 +51,124 @@ namespace Piccolo
         {
             LOG_FATAL("cannot allocate memory for new gobject");
         }
+        return gobject;
+    }
+
+    void Level::addObject(const std::shared_ptr<GObject>& gobject)
+    {
+        m_gobjects.emplace(gobject->getID(), gobject);
+        m_component_storage.addObject(gobject);
+    }
+
+    GObjectID Level::createObject(const ObjectInstanceRes& object_instance_res)
+    {
+        std::shared_ptr<GObject> gobject = allocateObject();
 
         bool is_loaded = gobject->load(object_instance_res);
         if (is_loaded)
         {
-            m_gobjects.emplace(object_id, gobject);
+            addObject(gobject);
         }
         else
         {
             LOG_ERROR("loading object " + object_instance_res.m_name + " failed");
             return k_invalid_gobject_id;
         }
-        return object_id;
+        return gobject->getID();
     }
 
-    bool Level::load(const std::string& level_res_url)
+    void Level::beginLoad(const std::string& level_res_url)
     {
         LOG_INFO("loading level: {}", level_res_url);
 
         m_level_res_url = level_res_url;
 
-        LevelRes   level_res;
-        const bool is_load_success = g_runtime_global_context.m_asset_manager->loadAsset(level_res_url, level_res);
-        if (is_load_success == false)
+        m_loader = std::make_unique<LevelLoader>();
+        m_loader->start(level_res_url);
+        m_committed_object_count = 0;
+        m_load_state             = LevelLoadState::reading;
+    }
+
+    LevelLoadState Level::tickLoad(size_t max_object_count)
+    {
+        if (m_load_state == LevelLoadState::reading)
         {
-            return false;
+            if (!m_loader->isReadDone())
+                return m_load_state;
+
+            if (!m_loader->isReadSucceeded())
+            {
+                m_loader.reset();
+                m_load_state = LevelLoadState::failed;
+                return m_load_state;
+            }
+
+            ASSERT(g_runtime_global_context.m_physics_manager);
+            m_physics_scene = g_runtime_global_context.m_physics_manager->createPhysicsScene(
+                m_loader->getLevelRes().m_gravity);
+            ParticleEmitterIDAllocator::reset();
+
+            m_load_state = LevelLoadState::committing;
         }
 
-        ASSERT(g_runtime_global_context.m_physics_manager);
-        m_physics_scene = g_runtime_global_context.m_physics_manager->createPhysicsScene(level_res.m_gravity);
-        ParticleEmitterIDAllocator::reset();
+        if (m_load_state != LevelLoadState::committing)
+            return m_load_state;
+
+        const size_t object_count = m_loader->getLoadedObjects().size();
+        const size_t commit_count = std::min(max_object_count, object_count - m_committed_object_count);
+        for (size_t commit_index = 0; commit_index < commit_count; ++commit_index)
+        {
+            commitObject(m_committed_object_count);
+            ++m_committed_object_count;
+        }
 
-        for (const ObjectInstanceRes& object_instance_res : level_res.m_objects)
+        if (m_committed_object_count == object_count)
+        {
+            finishLoad();
+        }
+        return m_load_state;
+    }
+
+    void Level::commitObject(size_t object_index)
+    {
+        const ObjectInstanceRes&   object_instance_res = m_loader->getLevelRes().m_objects[object_index];
+        LevelLoader::LoadedObject& loaded_object       = m_loader->getLoadedObjects()[object_index];
+        loaded_object.m_is_committed                   = true;
+
+        // the blocking path reloads the definition and reports what's wrong with it
+        if (!loaded_object.m_is_definition_loaded)
         {
             createObject(object_instance_res);
+            return;
         }
 
+        std::shared_ptr<GObject> gobject = allocateObject();
+        gobject->load(object_instance_res, std::move(loaded_object.m_definition_components));
+        addObject(gobject);
+    }
+
+    void Level::finishLoad()
+    {
         // create active character
+        const std::string& character_name = m_loader->getLevelRes().m_character_name;
         for (const auto& object_pair : m_gobjects)
         {
             std::shared_ptr<GObject> object = object_pair.second;
             if (object == nullptr)
                 continue;
 
-            if (level_res.m_character_name == object->getName())
+            if (character_name == object->getName())
             {
                 m_current_active_character = std::make_shared<Character>(object);
                 break;
             }
         }
 
-        m_is_loaded = true;
+        m_loader.reset();
+        m_is_loaded  = true;
+        m_load_state = LevelLoadState::loaded;
 
         LOG_INFO("level load succeed");
-
-        return true;
     }
 
     void Level::unload()
@@ -103,6 +179,12 @@ namespace Piccolo
 
     bool Level::save()
     {
+        if (!m_is_loaded)
+        {
+            LOG_WARN("level {} is not loaded yet", m_level_res_url);
+            return false;
+        }
+
         LOG_INFO("saving level: {}", m_level_res_url);
         LevelRes output_level_res;
 
@@ -142,14 +224,8 @@ namespace Piccolo
             return;
         }
 
-        for (const auto& id_object_pair : m_gobjects)
-        {
-            assert(id_object_pair.second);
-            if (id_object_pair.second)
-            {
-                id_object_pair.second->tick(delta_time);
-            }
-        }
+        m_component_storage.tick(delta_time);
+
         if (m_current_active_character && g_is_editor_mode == false)
         {
             m_current_active_character->tick(delta_time);
@@ -188,6 +264,7 @@ namespace Piccolo
             }
         }
 
+        m_component_storage.removeObject(go_id);
         m_gobjects.erase(go_id);
     }
 
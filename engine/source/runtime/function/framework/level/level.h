@@ -1,7 +1,9 @@
 #pragma once
 
+#include "runtime/function/framework/component/component_storage.h"
 #include "runtime/function/framework/object/object_id_allocator.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -10,18 +12,35 @@ namespace Piccolo
 {
     class Character;
     class GObject;
+    class LevelLoader;
     class ObjectInstanceRes;
     class PhysicsScene;
 
     using LevelObjectsMap = std::unordered_map<GObjectID, std::shared_ptr<GObject>>;
 
+    enum class LevelLoadState : uint8_t
+    {
+        idle,
+        reading,
+        committing,
+        loaded,
+        failed
+    };
+
     /// The main class to manage all game objects
     class Level
     {
     public:
-        virtual ~Level(){};
+        Level();
+        virtual ~Level();
+
+        /// start reading the level and its objects on the job system, tickLoad has to be called every frame
+        /// until the level is loaded
+        void beginLoad(const std::string& level_res_url);
+        /// commit at most max_object_count read objects to the level
+        LevelLoadState tickLoad(size_t max_object_count);
+        LevelLoadState getLoadState() const { return m_load_state; }
 
-        bool load(const std::string& level_res_url);
         void unload();
 
         bool save();
@@ -40,15 +59,29 @@ namespace Piccolo
 
         std::weak_ptr<PhysicsScene> getPhysicsScene() const { return m_physics_scene; }
 
+        const ComponentStorage& getComponentStorage() const { return m_component_storage; }
+
     protected:
         void clear();
 
+        std::shared_ptr<GObject> allocateObject();
+        void                     addObject(const std::shared_ptr<GObject>& gobject);
+        void                     commitObject(size_t object_index);
+        void                     finishLoad();
+
         bool        m_is_loaded {false};
         std::string m_level_res_url;
 
+        LevelLoadState               m_load_state {LevelLoadState::idle};
+        std::unique_ptr<LevelLoader> m_loader;
+        size_t                       m_committed_object_count {0};
+
         // all game objects in this level, key: object id, value: object instance
         LevelObjectsMap m_gobjects;
 
+        // components of all game objects grouped by type, used to tick the level type by type
+        ComponentStorage m_component_storage;
+
         std::shared_ptr<Character> m_current_active_character;
 
         std::weak_ptr<PhysicsScene> m_physics_scene;
@@ -0,0 +1,178 @@
+#include "runtime/function/framework/level/level_loader.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/meta/serializer/binary_serializer.h"
+
+#include "runtime/resource/asset_manager/asset_manager.h"
+
+#include "runtime/function/framework/component/component.h"
+#include "runtime/function/global/global_context.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include "_generated/serializer/all_serializer.h"
+
+namespace Piccolo
+{
+    namespace
+    {
+        constexpr size_t k_read_object_batch_size = 8;
+    } // namespace
+
+    LevelLoader::~LevelLoader()
+    {
+        m_is_cancelled = true;
+        if (m_read_job)
+        {
+            g_runtime_global_context.m_job_system->wait(m_read_job);
+        }
+
+        // a failed or cancelled read may stop before the loaded objects are allocated, the instanced components of
+        // the level res are owned by the loader until their object is committed all the same
+        for (size_t object_index = 0; object_index < m_level_res.m_objects.size(); ++object_index)
+        {
+            if (object_index < m_loaded_objects.size())
+            {
+                LoadedObject& loaded_object = m_loaded_objects[object_index];
+                if (loaded_object.m_is_committed)
+                    continue;
+
+                for (auto& component : loaded_object.m_definition_components)
+                {
+                    PICCOLO_REFLECTION_DELETE(component);
+                }
+            }
+
+            for (auto& component : m_level_res.m_objects[object_index].m_instanced_components)
+            {
+                PICCOLO_REFLECTION_DELETE(component);
+            }
+        }
+    }
+
+    void LevelLoader::start(const std::string& level_res_url)
+    {
+        ASSERT(!m_read_job);
+
+        m_level_res_url = level_res_url;
+        m_read_job      = g_runtime_global_context.m_job_system->schedule("LevelRead", [this]() { read(); });
+    }
+
+    void LevelLoader::read()
+    {
+        std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
+        ASSERT(asset_manager);
+
+        m_is_read_succeeded = asset_manager->loadAsset(m_level_res_url, m_level_res);
+        if (!m_is_read_succeeded)
+        {
+            m_is_read_done.store(true, std::memory_order_release);
+            return;
+        }
+
+        // objects sharing a definition file share its cooked form
+        std::vector<std::string>                definition_urls;
+        std::vector<size_t>                     object_definition_indices(m_level_res.m_objects.size());
+        std::unordered_map<std::string, size_t> definition_indices;
+        for (size_t object_index = 0; object_index < m_level_res.m_objects.size(); ++object_index)
+        {
+            const std::string& definition_url = m_level_res.m_objects[object_index].m_definition;
+
+            auto iter = definition_indices.emplace(definition_url, definition_urls.size()).first;
+            if (iter->second == definition_urls.size())
+            {
+                definition_urls.push_back(definition_url);
+            }
+            object_definition_indices[object_index] = iter->second;
+        }
+
+        std::vector<std::vector<uint8_t>> cooked_definitions;
+        readDefinitions(definition_urls, cooked_definitions);
+
+        m_loaded_objects.resize(m_level_res.m_objects.size());
+        g_runtime_global_context.m_job_system->parallelFor(
+            "LevelReadObjects",
+            m_level_res.m_objects.size(),
+            k_read_object_batch_size,
+            [&](size_t begin, size_t end) {
+                for (size_t object_index = begin; object_index < end && !m_is_cancelled; ++object_index)
+                {
+                    readObject(object_index, cooked_definitions[object_definition_indices[object_index]]);
+                }
+            });
+
+        LOG_INFO("level {} read: {} objects, {} definitions",
+                 m_level_res_url,
+                 m_level_res.m_objects.size(),
+                 definition_urls.size());
+
+        m_is_read_done.store(true, std::memory_order_release);
+    }
+
+    void LevelLoader::readDefinitions(const std::vector<std::string>&    definition_urls,
+                                      std::vector<std::vector<uint8_t>>& out_cooked_definitions) const
+    {
+        std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
+
+        // an empty buffer marks a definition which failed to load, a loaded one holds at least its count
+        out_cooked_definitions.resize(definition_urls.size());
+        g_runtime_global_context.m_job_system->parallelFor(
+            "LevelReadDefinitions", definition_urls.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t definition_index = begin; definition_index < end && !m_is_cancelled; ++definition_index)
+                {
+                    ObjectDefinitionRes definition_res;
+                    if (!asset_manager->loadAsset(definition_urls[definition_index], definition_res))
+                        continue;
+
+                    BinaryWriter writer;
+                    BinarySerializer::write(writer, definition_res);
+                    out_cooked_definitions[definition_index] = std::move(writer.getBuffer());
+
+                    for (auto& component : definition_res.m_components)
+                    {
+                        PICCOLO_REFLECTION_DELETE(component);
+                    }
+                }
+            });
+    }
+
+    void LevelLoader::readObject(size_t object_index, const std::vector<uint8_t>& cooked_definition)
+    {
+        const ObjectInstanceRes& object_instance_res = m_level_res.m_objects[object_index];
+        LoadedObject&            loaded_object       = m_loaded_objects[object_index];
+
+        // the object is loaded through the blocking path on commit, which reports the error
+        if (cooked_definition.empty())
+            return;
+
+        ObjectDefinitionRes definition_res;
+        BinaryReader        reader(cooked_definition.data(), cooked_definition.size());
+        BinarySerializer::read(reader, definition_res);
+
+        // same rule as GObject::load, the first component of a type wins and the instanced ones come first
+        std::unordered_set<std::string> component_type_names;
+        for (const auto& component : object_instance_res.m_instanced_components)
+        {
+            if (component)
+            {
+                component_type_names.insert(component.getTypeName());
+                component->loadResource();
+            }
+        }
+
+        for (auto& component : definition_res.m_components)
+        {
+            if (!component || !component_type_names.insert(component.getTypeName()).second)
+            {
+                PICCOLO_REFLECTION_DELETE(component);
+                continue;
+            }
+
+            component->loadResource();
+            loaded_object.m_definition_components.push_back(component);
+        }
+
+        loaded_object.m_is_definition_loaded = true;
+    }
+} // namespace Piccolo
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "runtime/core/job/job_system.h"
+
+#include "runtime/resource/res_type/common/level.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace Piccolo
+{
+    class Component;
+
+    /// Reads a level and the definitions of its objects on the job system workers.
+    /// Every definition file is read once however many objects share it, then the objects deserialize their
+    /// own copy of the definition components from the cooked form of the shared one and load the resources of
+    /// their components in parallel. The level commits the read objects on the main thread, see Level::tickLoad.
+    class LevelLoader
+    {
+    public:
+        struct LoadedObject
+        {
+            // components read from the definition, those overridden by an instanced component are not kept
+            std::vector<Reflection::ReflectionPtr<Component>> m_definition_components;
+
+            bool m_is_definition_loaded {false};
+            // set by the level once the object owns the components
+            bool m_is_committed {false};
+        };
+
+        /// cancel the read if it's still running, the components of the objects never committed are deleted
+        ~LevelLoader();
+
+        void start(const std::string& level_res_url);
+
+        bool isReadDone() const { return m_is_read_done.load(std::memory_order_acquire); }
+        bool isReadSucceeded() const { return m_is_read_succeeded; }
+
+        /// valid once the read is done, m_objects[i] is read into getLoadedObjects()[i]
+        LevelRes&                  getLevelRes() { return m_level_res; }
+        std::vector<LoadedObject>& getLoadedObjects() { return m_loaded_objects; }
+
+    private:
+        void read();
+        void readDefinitions(const std::vector<std::string>&    definition_urls,
+                             std::vector<std::vector<uint8_t>>& out_cooked_definitions) const;
+        void readObject(size_t object_index, const std::vector<uint8_t>& cooked_definition);
+
+        std::string m_level_res_url;
+        JobHandle   m_read_job;
+
+        std::atomic<bool> m_is_read_done {false};
+        std::atomic<bool> m_is_cancelled {false};
+        bool              m_is_read_succeeded {false};
+
+        LevelRes                  m_level_res;
+        std::vector<LoadedObject> m_loaded_objects;
+    };
+} // namespace Piccolo
@@ -2,6 +2,7 @@
 
 #include "runtime/engine.h"
 
+#include "runtime/core/base/macro.h"
 #include "runtime/core/meta/reflection/reflection.h"
 
 #include "runtime/resource/asset_manager/asset_manager.h"
@@ -36,21 +37,16 @@ namespace Piccolo
             PICCOLO_REFLECTION_DELETE(component);
         }
         m_components.clear();
-    }
-
-    void GObject::tick(float delta_time)
-    {
-        for (auto& component : m_components)
-        {
-            if (shouldComponentTick(component.getTypeName()))
-            {
-                component->tick(delta_time);
-            }
-        }
+        rebuildComponentTypeTable();
     }
 
     bool GObject::hasComponent(const std::string& compenent_type_name) const
     {
+        const ComponentTypeIndex type_index = getComponentTypeIndex(compenent_type_name);
+        if (type_index != k_invalid_component_type_index)
+            return hasComponentType(type_index);
+
+        // not a generated component type
         for (const auto& component : m_components)
         {
             if (component.getTypeName() == compenent_type_name)
@@ -69,10 +65,12 @@ namespace Piccolo
 
         // load object instanced components
         m_components = object_instance_res.m_instanced_components;
+        rebuildComponentTypeTable();
         for (auto component : m_components)
         {
             if (component)
             {
+                component->loadResource();
                 component->postLoadResource(weak_from_this());
             }
         }
@@ -86,21 +84,54 @@ namespace Piccolo
         if (!is_loaded_success)
             return false;
 
+        // the type table only covers the instanced components, it's rebuilt once all definition components are added
+        const size_t instanced_component_count = m_components.size();
+        TypeNameSet  added_type_names;
         for (auto loaded_component : definition_res.m_components)
         {
             const std::string type_name = loaded_component.getTypeName();
-            // don't create component if it has been instanced
-            if (hasComponent(type_name))
+            // don't create component if it has been instanced, the definition copy is owned by nobody then
+            if (hasComponent(type_name) || !added_type_names.insert(type_name).second)
+            {
+                PICCOLO_REFLECTION_DELETE(loaded_component);
                 continue;
+            }
 
+            loaded_component->loadResource();
             loaded_component->postLoadResource(weak_from_this());
 
             m_components.push_back(loaded_component);
         }
+        if (m_components.size() != instanced_component_count)
+        {
+            rebuildComponentTypeTable();
+        }
 
         return true;
     }
 
+    void GObject::load(const ObjectInstanceRes&                          object_instance_res,
+                       std::vector<Reflection::ReflectionPtr<Component>>&& definition_components)
+    {
+        m_components.clear();
+
+        setName(object_instance_res.m_name);
+        m_definition_url = object_instance_res.m_definition;
+
+        m_components = object_instance_res.m_instanced_components;
+        m_components.insert(m_components.end(), definition_components.begin(), definition_components.end());
+        definition_components.clear();
+        rebuildComponentTypeTable();
+
+        for (auto component : m_components)
+        {
+            if (component)
+            {
+                component->postLoadResource(weak_from_this());
+            }
+        }
+    }
+
     void GObject::save(ObjectInstanceRes& out_object_instance_res)
     {
         out_object_instance_res.m_name       = m_name;
@@ -109,4 +140,25 @@ namespace Piccolo
         out_object_instance_res.m_instanced_components = m_components;
     }
 
+    void GObject::rebuildComponentTypeTable()
+    {
+        m_component_type_mask = 0;
+
+        for (size_t component_index = 0; component_index < m_components.size(); ++component_index)
+        {
+            const auto& component = m_components[component_index];
+            if (!component)
+                continue;
+
+            const ComponentTypeIndex type_index = getComponentTypeIndex(component.getTypeName());
+            // the first component of a type wins, as with the former linear lookup
+            if (type_index == k_invalid_component_type_index || hasComponentType(type_index))
+                continue;
+
+            ASSERT(component_index <= UINT8_MAX);
+            m_component_type_mask |= uint64_t {1} << type_index;
+            m_component_slots[type_index] = static_cast<uint8_t>(component_index);
+        }
+    }
+
 } // namespace Piccolo
\ No newline at end of file
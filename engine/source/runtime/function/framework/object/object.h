@@ -5,13 +5,23 @@
 
 #include "runtime/resource/res_type/common/object.h"
 
+// the parser runs before the component types are generated
+#if !defined(__REFLECTION_PARSER__)
+#include "_generated/reflection/all_component_type.h"
+#endif
+
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <unordered_set>
 #include <vector>
 
 namespace Piccolo
 {
+    bool shouldComponentTick(std::string component_type_name);
+
     /// GObject : Game Object base class
     class GObject : public std::enable_shared_from_this<GObject>
     {
@@ -21,9 +31,10 @@ namespace Piccolo
         GObject(GObjectID id) : m_id {id} {}
         virtual ~GObject();
 
-        virtual void tick(float delta_time);
-
         bool load(const ObjectInstanceRes& object_instance_res);
+        /// load with the definition components already read and their resources loaded, see LevelLoader
+        void load(const ObjectInstanceRes&                          object_instance_res,
+                  std::vector<Reflection::ReflectionPtr<Component>>&& definition_components);
         void save(ObjectInstanceRes& out_object_instance_res);
 
         GObjectID getID() const { return m_id; }
@@ -35,37 +46,39 @@ namespace Piccolo
 
         std::vector<Reflection::ReflectionPtr<Component>> getComponents() { return m_components; }
 
+        // constant time lookups through the generated component type indices
         template<typename TComponent>
-        TComponent* tryGetComponent(const std::string& compenent_type_name)
+        TComponent* tryGetComponent()
         {
-            for (auto& component : m_components)
-            {
-                if (component.getTypeName() == compenent_type_name)
-                {
-                    return static_cast<TComponent*>(component.operator->());
-                }
-            }
-
-            return nullptr;
+            const ComponentTypeIndex type_index = ComponentTypeTrait<std::remove_const_t<TComponent>>::index;
+            if (!hasComponentType(type_index))
+                return nullptr;
+
+            return static_cast<TComponent*>(m_components[m_component_slots[type_index]].operator->());
         }
 
         template<typename TComponent>
-        const TComponent* tryGetComponentConst(const std::string& compenent_type_name) const
+        const TComponent* tryGetComponentConst() const
         {
-            for (const auto& component : m_components)
-            {
-                if (component.getTypeName() == compenent_type_name)
-                {
-                    return static_cast<const TComponent*>(component.operator->());
-                }
-            }
-            return nullptr;
+            const ComponentTypeIndex type_index = ComponentTypeTrait<std::remove_const_t<TComponent>>::index;
+            if (!hasComponentType(type_index))
+                return nullptr;
+
+            return static_cast<const TComponent*>(m_components[m_component_slots[type_index]].operator->());
         }
 
-#define tryGetComponent(COMPONENT_TYPE) tryGetComponent<COMPONENT_TYPE>(#COMPONENT_TYPE)
-#define tryGetComponentConst(COMPONENT_TYPE) tryGetComponentConst<const COMPONENT_TYPE>(#COMPONENT_TYPE)
+#define tryGetComponent(COMPONENT_TYPE) tryGetComponent<COMPONENT_TYPE>()
+#define tryGetComponentConst(COMPONENT_TYPE) tryGetComponentConst<const COMPONENT_TYPE>()
 
     protected:
+        bool hasComponentType(ComponentTypeIndex type_index) const
+        {
+            return type_index < k_max_component_type_count && (m_component_type_mask >> type_index) & 1;
+        }
+
+        // must be called whenever m_components changes
+        void rebuildComponentTypeTable();
+
         GObjectID   m_id {k_invalid_gobject_id};
         std::string m_name;
         std::string m_definition_url;
@@ -73,5 +86,10 @@ namespace Piccolo
         // we have to use the ReflectionPtr due to that the components need to be reflected 
         // in editor, and it's polymorphism
         std::vector<Reflection::ReflectionPtr<Component>> m_components;
+
+        // bit i is set if the object has a component of type index i, m_component_slots[i] is its index in
+        // m_components then
+        uint64_t                                         m_component_type_mask {0};
+        std::array<uint8_t, k_max_component_type_count> m_component_slots {};
     };
 } // namespace Piccolo
@@ -13,6 +13,12 @@
 
 namespace Piccolo
 {
+    namespace
+    {
+        // objects committed to a streamed level per frame, the reads of the objects don't block the frame
+        constexpr size_t k_level_commit_batch_size = 64;
+    } // namespace
+
     WorldManager::~WorldManager() { clear(); }
 
     void WorldManager::initialize()
@@ -30,6 +36,12 @@ namespace Piccolo
 
     void WorldManager::clear()
     {
+        if (m_loading_level)
+        {
+            m_loading_level->unload();
+            m_loading_level.reset();
+        }
+
         // unload all loaded levels
         for (auto level_pair : m_loaded_levels)
         {
@@ -55,6 +67,8 @@ namespace Piccolo
             loadWorld(m_current_world_url);
         }
 
+        tickLevelLoading();
+
         // tick the active level
         std::shared_ptr<Level> active_level = m_current_active_level.lock();
         if (active_level)
@@ -87,17 +101,8 @@ namespace Piccolo
 
         m_current_world_resource = std::make_shared<WorldRes>(world_res);
 
-        const bool is_level_load_success = loadLevel(world_res.m_default_level_url);
-        if (!is_level_load_success)
-        {
-            return false;
-        }
-
-        // set the default level to be active level
-        auto iter = m_loaded_levels.find(world_res.m_default_level_url);
-        ASSERT(iter != m_loaded_levels.end());
-
-        m_current_active_level = iter->second;
+        // the default level becomes the active level, it's streamed in over the next frames
+        loadLevel(world_res.m_default_level_url);
 
         m_is_world_loaded = true;
 
@@ -105,21 +110,31 @@ namespace Piccolo
         return true;
     }
 
-    bool WorldManager::loadLevel(const std::string& level_url)
+    void WorldManager::loadLevel(const std::string& level_url)
     {
-        std::shared_ptr<Level> level = std::make_shared<Level>();
-        // set current level temporary
-        m_current_active_level       = level;
+        m_loading_level = std::make_shared<Level>();
+        m_loading_level->beginLoad(level_url);
 
-        const bool is_level_load_success = level->load(level_url);
-        if (is_level_load_success == false)
-        {
-            return false;
-        }
+        m_current_active_level = m_loading_level;
+    }
 
-        m_loaded_levels.emplace(level_url, level);
+    void WorldManager::tickLevelLoading()
+    {
+        if (!m_loading_level)
+            return;
 
-        return true;
+        const LevelLoadState load_state = m_loading_level->tickLoad(k_level_commit_batch_size);
+        if (load_state == LevelLoadState::loaded)
+        {
+            m_loaded_levels.emplace(m_loading_level->getLevelResUrl(), m_loading_level);
+            m_loading_level.reset();
+        }
+        else if (load_state == LevelLoadState::failed)
+        {
+            LOG_ERROR("load level failed {}", m_loading_level->getLevelResUrl());
+            m_loading_level->unload();
+            m_loading_level.reset();
+        }
     }
 
     void WorldManager::reloadCurrentLevel()
@@ -131,24 +146,15 @@ namespace Piccolo
             return;
         }
 
+        // the active level may still be loading
         const std::string level_url = active_level->getLevelResUrl();
         active_level->unload();
         m_loaded_levels.erase(level_url);
+        m_loading_level.reset();
 
-        const bool is_load_success = loadLevel(level_url);
-        if (!is_load_success)
-        {
-            LOG_ERROR("load level failed {}", level_url);
-            return;
-        }
-
-        // update the active level instance
-        auto iter = m_loaded_levels.find(level_url);
-        ASSERT(iter != m_loaded_levels.end());
-
-        m_current_active_level = iter->second;
+        loadLevel(level_url);
 
-        LOG_INFO("reload current evel succeed");
+        LOG_INFO("reloading current level {}", level_url);
     }
 
     void WorldManager::saveCurrentLevel()
@@ -31,7 +31,8 @@ namespace Piccolo
 
     private:
         bool loadWorld(const std::string& world_url);
-        bool loadLevel(const std::string& level_url);
+        void loadLevel(const std::string& level_url);
+        void tickLevelLoading();
 
         bool                      m_is_world_loaded {false};
         std::string               m_current_world_url;
@@ -41,6 +42,8 @@ namespace Piccolo
         std::unordered_map<std::string, std::shared_ptr<Level>> m_loaded_levels;
         // active level, currently we just support one active level
         std::weak_ptr<Level> m_current_active_level;
+        // level being streamed in, it's the active level already so that its objects find its physics scene
+        std::shared_ptr<Level> m_loading_level;
 
         //debug level
         std::shared_ptr<LevelDebugger> m_level_debugger;
@@ -1,5 +1,6 @@
 #include "runtime/function/global/global_context.h"
 
+#include "core/job/job_system.h"
 #include "core/log/log_system.h"
 
 #include "runtime/engine.h"
@@ -10,6 +11,7 @@
 #include "runtime/resource/config_manager/config_manager.h"
 
 #include "runtime/engine.h"
+#include "runtime/function/animation/animation_system.h"
 #include "runtime/function/framework/world/world_manager.h"
 #include "runtime/function/input/input_system.h"
 #include "runtime/function/particle/particle_manager.h"
@@ -32,6 +34,11 @@ namespace Piccolo
 
         m_logger_system = std::make_shared<LogSystem>();
 
+        m_job_system = std::make_shared<JobSystem>();
+        m_job_system->initialize();
+
+        AnimationManager::initialize(m_job_system);
+
         m_asset_manager = std::make_shared<AssetManager>();
 
         m_physics_manager = std::make_shared<PhysicsManager>();
@@ -75,6 +82,8 @@ namespace Piccolo
         m_world_manager->clear();
         m_world_manager.reset();
 
+        AnimationManager::clear();
+
         m_physics_manager->clear();
         m_physics_manager.reset();
 
@@ -83,6 +92,9 @@ namespace Piccolo
 
         m_asset_manager.reset();
 
+        m_job_system->clear();
+        m_job_system.reset();
+
         m_logger_system.reset();
 
         m_file_system.reset();
@@ -127,8 +127,8 @@ namespace Piccolo
             return;
         }
 
-        std::shared_ptr<RenderCamera> render_camera = g_runtime_global_context.m_render_system->getRenderCamera();
-        const Vector2&                fov           = render_camera->getFOV();
+        // the render camera belongs to the render thread in the pipelined mode
+        const Vector2 fov = g_runtime_global_context.m_render_system->getCameraFOV();
 
         Radian cursor_delta_x(Math::degreesToRadians(m_cursor_delta_x));
         Radian cursor_delta_y(Math::degreesToRadians(m_cursor_delta_y));
@@ -0,0 +1,128 @@
+#include "runtime/function/physics/jolt/jolt_job_system.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/job/job_system.h"
+
+#include <thread>
+
+namespace Piccolo
+{
+    JoltJobSystem::JoltJobSystem(std::shared_ptr<Piccolo::JobSystem> job_system) : m_job_system(job_system)
+    {
+        ASSERT(m_job_system);
+    }
+
+    int JoltJobSystem::GetMaxConcurrency() const { return static_cast<int>(m_job_system->getMaxConcurrency()); }
+
+    JPH::JobHandle JoltJobSystem::CreateJob(const char*        inName,
+                                            JPH::ColorArg      inColor,
+                                            const JobFunction& inJobFunction,
+                                            JPH::uint32        inNumDependencies)
+    {
+        Job* job = new Job(inName, inColor, this, inJobFunction, inNumDependencies);
+
+        // the handle must hold a reference before the job can be executed and released
+        JobHandle handle(job);
+        if (inNumDependencies == 0)
+        {
+            QueueJob(job);
+        }
+        return handle;
+    }
+
+    JPH::JobSystem::Barrier* JoltJobSystem::CreateBarrier() { return new BarrierImpl(); }
+
+    void JoltJobSystem::DestroyBarrier(Barrier* inBarrier) { delete static_cast<BarrierImpl*>(inBarrier); }
+
+    void JoltJobSystem::WaitForJobs(Barrier* inBarrier) { static_cast<BarrierImpl*>(inBarrier)->wait(*m_job_system); }
+
+    void JoltJobSystem::QueueJob(Job* inJob)
+    {
+        // keep the job alive while it's in the engine queue
+        inJob->AddRef();
+        m_job_system->schedule("JoltPhysicsJob", [inJob]() {
+            // no-op if the job was already picked up by a waiting barrier
+            inJob->Execute();
+            inJob->Release();
+        });
+    }
+
+    void JoltJobSystem::QueueJobs(Job** inJobs, JPH::uint inNumJobs)
+    {
+        for (JPH::uint job_index = 0; job_index < inNumJobs; ++job_index)
+        {
+            QueueJob(inJobs[job_index]);
+        }
+    }
+
+    void JoltJobSystem::FreeJob(Job* inJob) { delete inJob; }
+
+    void JoltJobSystem::BarrierImpl::AddJob(const JobHandle& inJob)
+    {
+        Job* job = inJob.GetPtr();
+
+        // count the job before it's attached, otherwise a job finishing right away could let the waiter
+        // see zero while other jobs are still running
+        m_unfinished_job_count.fetch_add(1);
+        if (job->SetBarrier(this))
+        {
+            job->AddRef();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.push_back(job);
+        }
+        else
+        {
+            // already done
+            m_unfinished_job_count.fetch_sub(1);
+        }
+    }
+
+    void JoltJobSystem::BarrierImpl::AddJobs(const JobHandle* inHandles, JPH::uint inNumHandles)
+    {
+        for (JPH::uint handle_index = 0; handle_index < inNumHandles; ++handle_index)
+        {
+            AddJob(inHandles[handle_index]);
+        }
+    }
+
+    void JoltJobSystem::BarrierImpl::OnJobFinished(Job* inJob) { m_unfinished_job_count.fetch_sub(1); }
+
+    void JoltJobSystem::BarrierImpl::wait(Piccolo::JobSystem& job_system)
+    {
+        std::vector<Job*> runnable_jobs;
+        while (m_unfinished_job_count.load() > 0)
+        {
+            // run the barrier jobs whose dependencies are resolved on this thread first
+            runnable_jobs.clear();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                for (Job* job : m_jobs)
+                {
+                    if (job->CanBeExecuted())
+                    {
+                        runnable_jobs.push_back(job);
+                    }
+                }
+            }
+
+            bool is_any_job_executed = false;
+            for (Job* job : runnable_jobs)
+            {
+                is_any_job_executed |= job->Execute() == Job::cDoneState;
+            }
+
+            if (!is_any_job_executed && !job_system.tryRunOneJob())
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (Job* job : m_jobs)
+        {
+            job->Release();
+        }
+        m_jobs.clear();
+    }
+} // namespace Piccolo
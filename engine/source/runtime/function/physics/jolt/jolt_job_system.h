@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Jolt/Jolt.h"
+
+#include "Jolt/Core/JobSystem.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Piccolo
+{
+    class JobSystem;
+
+    /// JPH::JobSystem implementation running the physics jobs on the engine job system,
+    /// so that Jolt doesn't spin up its own thread pool
+    class JoltJobSystem final : public JPH::JobSystem
+    {
+    public:
+        explicit JoltJobSystem(std::shared_ptr<Piccolo::JobSystem> job_system);
+        ~JoltJobSystem() override = default;
+
+        int       GetMaxConcurrency() const override;
+        JobHandle CreateJob(const char*        inName,
+                            JPH::ColorArg      inColor,
+                            const JobFunction& inJobFunction,
+                            JPH::uint32        inNumDependencies = 0) override;
+        Barrier*  CreateBarrier() override;
+        void      DestroyBarrier(Barrier* inBarrier) override;
+        void      WaitForJobs(Barrier* inBarrier) override;
+
+    protected:
+        void QueueJob(Job* inJob) override;
+        void QueueJobs(Job** inJobs, JPH::uint inNumJobs) override;
+        void FreeJob(Job* inJob) override;
+
+    private:
+        class BarrierImpl final : public Barrier
+        {
+        public:
+            ~BarrierImpl() override = default;
+
+            void AddJob(const JobHandle& inJob) override;
+            void AddJobs(const JobHandle* inHandles, JPH::uint inNumHandles) override;
+
+            void wait(Piccolo::JobSystem& job_system);
+
+        protected:
+            void OnJobFinished(Job* inJob) override;
+
+        private:
+            std::mutex        m_mutex;
+            std::vector<Job*> m_jobs;
+            std::atomic<int>  m_unfinished_job_count {0};
+        };
+
+        std::shared_ptr<Piccolo::JobSystem> m_job_system;
+    };
+} // namespace Piccolo
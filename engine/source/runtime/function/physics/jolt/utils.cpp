@@ -112,20 +112,22 @@ namespace Piccolo
         return Matrix4x4(cols[0], cols[1], cols[2], cols[3]).transpose();
     }
 
-    JPH::Shape* toShape(const RigidBodyShape& shape, const Vector3& scale)
+    bool getShapeDimensions(const RigidBodyShape& shape,
+                            const Vector3&        scale,
+                            RigidBodyShapeType&   out_type,
+                            Vector3&              out_dimensions)
     {
-        JPH::Shape* jph_shape = nullptr;
-
         const std::string shape_type_str = shape.m_geometry.getTypeName();
         if (shape_type_str == "Box")
         {
             const Box* box_geometry = static_cast<const Box*>(shape.m_geometry.getPtr());
             if (box_geometry)
             {
-                JPH::Vec3 jph_box(scale.x * box_geometry->m_half_extents.x,
-                                  scale.y * box_geometry->m_half_extents.y,
-                                  scale.z * box_geometry->m_half_extents.z);
-                jph_shape = new JPH::BoxShape(jph_box, 0.f);
+                out_type       = RigidBodyShapeType::box;
+                out_dimensions = Vector3(scale.x * box_geometry->m_half_extents.x,
+                                         scale.y * box_geometry->m_half_extents.y,
+                                         scale.z * box_geometry->m_half_extents.z);
+                return true;
             }
         }
         else if (shape_type_str == "Sphere")
@@ -133,8 +135,10 @@ namespace Piccolo
             const Sphere* sphere_geometry = static_cast<const Sphere*>(shape.m_geometry.getPtr());
             if (sphere_geometry)
             {
-                jph_shape = new JPH::SphereShape((scale.x + scale.y + scale.z) / 3 *
-                                                 sphere_geometry->m_radius);
+                out_type = RigidBodyShapeType::sphere;
+                out_dimensions =
+                    Vector3((scale.x + scale.y + scale.z) / 3 * sphere_geometry->m_radius, 0.f, 0.f);
+                return true;
             }
         }
         else if (shape_type_str == "Capsule")
@@ -142,8 +146,11 @@ namespace Piccolo
             const Capsule* capsule_geometry = static_cast<const Capsule*>(shape.m_geometry.getPtr());
             if (capsule_geometry)
             {
-                jph_shape = new JPH::CapsuleShape(scale.z * capsule_geometry->m_half_height,
-                                                  (scale.x + scale.y) / 2 * capsule_geometry->m_radius);
+                out_type       = RigidBodyShapeType::capsule;
+                out_dimensions = Vector3(scale.z * capsule_geometry->m_half_height,
+                                         (scale.x + scale.y) / 2 * capsule_geometry->m_radius,
+                                         0.f);
+                return true;
             }
         }
         else
@@ -151,7 +158,33 @@ namespace Piccolo
             LOG_ERROR("Unsupported Shape")
         }
 
-        return jph_shape;
+        return false;
+    }
+
+    JPH::Shape* toShape(RigidBodyShapeType type, const Vector3& dimensions)
+    {
+        switch (type)
+        {
+            case RigidBodyShapeType::box:
+                return new JPH::BoxShape(toVec3(dimensions), 0.f);
+            case RigidBodyShapeType::sphere:
+                return new JPH::SphereShape(dimensions.x);
+            case RigidBodyShapeType::capsule:
+                return new JPH::CapsuleShape(dimensions.x, dimensions.y);
+            default:
+                return nullptr;
+        }
+    }
+
+    JPH::Shape* toShape(const RigidBodyShape& shape, const Vector3& scale)
+    {
+        RigidBodyShapeType type;
+        Vector3            dimensions;
+        if (!getShapeDimensions(shape, scale, type, dimensions))
+        {
+            return nullptr;
+        }
+        return toShape(type, dimensions);
     }
 
 } // namespace Piccolo
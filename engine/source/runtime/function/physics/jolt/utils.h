@@ -17,6 +17,7 @@ namespace JPH
 namespace Piccolo
 {
     class RigidBodyShape;
+    enum class RigidBodyShapeType : unsigned char;
 
     namespace Layers
     {
@@ -84,6 +85,14 @@ namespace Piccolo
 
     Matrix4x4 toMat44(const JPH::Mat44& m);
 
+    /// parameters of the jolt shape of a rigidbody shape at a scale: the half extents of a box, the radius of a
+    /// sphere in x, the half height and the radius of a capsule in x and y
+    bool getShapeDimensions(const RigidBodyShape& shape,
+                            const Vector3&        scale,
+                            RigidBodyShapeType&   out_type,
+                            Vector3&              out_dimensions);
+
+    JPH::Shape* toShape(RigidBodyShapeType type, const Vector3& dimensions);
     JPH::Shape* toShape(const RigidBodyShape& shape, const Vector3& scale);
 
 } // namespace Piccolo
\ No newline at end of file
@@ -15,13 +15,13 @@ namespace Piccolo
         uint32_t m_max_body_pairs {65536};
         uint32_t m_max_contact_constraints {10240};
 
-        // job setting
-        uint32_t m_max_job_count {1024};
-        uint32_t m_max_barrier_count {8};
-        uint32_t m_max_concurrent_job_count {4};
+        // scratch memory of a simulation step, allocated once per scene
+        uint32_t m_temp_allocator_size {16 * 1024 * 1024};
 
         Vector3 m_gravity {0.f, 0.f, -9.8f};
 
-        float m_update_frequency {60.f};
+        // the simulation steps at a fixed rate, a slow frame runs at most m_max_step_count steps and drops the rest
+        float    m_update_frequency {60.f};
+        uint32_t m_max_step_count {4};
     };
 } // namespace Piccolo
@@ -4,10 +4,16 @@
 
 #include "runtime/function/framework/world/world_manager.h"
 #include "runtime/function/global/global_context.h"
+#include "runtime/function/physics/jolt/jolt_job_system.h"
 #include "runtime/function/physics/jolt/utils.h"
 #include "runtime/function/physics/physics_scene.h"
 #include "runtime/function/render/render_system.h"
 
+#include "Jolt/Jolt.h"
+#include "Jolt/RegisterTypes.h"
+
+#include "Jolt/Core/Factory.h"
+
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
 #include "TestFramework.h"
 
@@ -21,6 +27,14 @@ namespace Piccolo
 {
     void PhysicsManager::initialize()
     {
+        // the type registry is process wide, it's set up once rather than by every scene
+        JPH::Factory::sInstance = new JPH::Factory();
+        JPH::RegisterTypes();
+
+        // physics jobs of every scene run on the engine job system, sized to the hardware concurrency
+        m_jolt_job_system                  = new JoltJobSystem(g_runtime_global_context.m_job_system);
+        m_jolt_broad_phase_layer_interface = new BPLayerInterfaceImpl();
+
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
         std::shared_ptr<ConfigManager> config_manager = g_runtime_global_context.m_config_manager;
         ASSERT(config_manager);
@@ -46,11 +60,21 @@ namespace Piccolo
         m_font = nullptr;
         delete m_renderer;
 #endif
+
+        // the scenes are gone, nothing references the runtime anymore
+        delete m_jolt_job_system;
+        m_jolt_job_system = nullptr;
+        delete m_jolt_broad_phase_layer_interface;
+        m_jolt_broad_phase_layer_interface = nullptr;
+
+        delete JPH::Factory::sInstance;
+        JPH::Factory::sInstance = nullptr;
     }
 
     std::weak_ptr<PhysicsScene> PhysicsManager::createPhysicsScene(const Vector3& gravity)
     {
-        std::shared_ptr<PhysicsScene> physics_scene = std::make_shared<PhysicsScene>(gravity);
+        std::shared_ptr<PhysicsScene> physics_scene =
+            std::make_shared<PhysicsScene>(gravity, m_jolt_job_system, *m_jolt_broad_phase_layer_interface);
 
         m_scenes.push_back(physics_scene);
 
@@ -5,14 +5,18 @@
 #include <memory>
 #include <vector>
 
-#ifdef ENABLE_PHYSICS_DEBUG_RENDERER
-class Renderer;
-class Font;
-
 namespace JPH
 {
+    class JobSystem;
+    class BroadPhaseLayerInterface;
+#ifdef ENABLE_PHYSICS_DEBUG_RENDERER
     class DebugRenderer;
-}
+#endif
+} // namespace JPH
+
+#ifdef ENABLE_PHYSICS_DEBUG_RENDERER
+class Renderer;
+class Font;
 #endif
 
 namespace Piccolo
@@ -35,6 +39,10 @@ namespace Piccolo
     protected:
         std::vector<std::shared_ptr<PhysicsScene>> m_scenes;
 
+        // one jolt runtime for the whole process, the scenes only own their physics system and temp allocator
+        JPH::JobSystem*                m_jolt_job_system {nullptr};
+        JPH::BroadPhaseLayerInterface* m_jolt_broad_phase_layer_interface {nullptr};
+
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
         Renderer* m_renderer {nullptr};
         Font*     m_font {nullptr};
@@ -1,18 +1,18 @@
 #include "runtime/function/physics/physics_scene.h"
 
+#include "core/base/hash.h"
 #include "core/base/macro.h"
+#include "core/job/job_system.h"
 
 #include "runtime/resource/res_type/components/rigid_body.h"
 
+#include "runtime/function/global/global_context.h"
 #include "runtime/function/physics/jolt/utils.h"
 #include "runtime/function/physics/physics_config.h"
 
 #include "Jolt/Jolt.h"
-#include "Jolt/RegisterTypes.h"
 
-#include "Jolt/Core/Factory.h"
 #include "Jolt/Core/JobSystem.h"
-#include "Jolt/Core/JobSystemThreadPool.h"
 #include "Jolt/Core/TempAllocator.h"
 
 #include "Jolt/Physics/Body/BodyCreationSettings.h"
@@ -29,31 +29,230 @@
 #include "Jolt/Physics/Collision/ShapeCast.h"
 #include "Jolt/Physics/PhysicsSystem.h"
 
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
 namespace Piccolo
 {
-    PhysicsScene::PhysicsScene(const Vector3& gravity)
+    namespace
     {
-        static_assert(s_invalid_rigidbody_id == JPH::BodyID::cInvalidBodyID);
+        constexpr size_t k_query_batch_size = 16;
+        // the cache is dropped when it grows past this, the shapes still in use are kept alive by their references
+        constexpr size_t k_max_query_shape_count = 1024;
+
+        /// keeps the closest hits, once it's full the early out fraction shrinks to the farthest hit kept
+        template<typename CollectorType>
+        class ClosestHitsCollector : public CollectorType
+        {
+        public:
+            using ResultType = typename CollectorType::ResultType;
+
+            ClosestHitsCollector(uint32_t max_hit_count, std::vector<ResultType>& out_hits) :
+                m_max_hit_count(max_hit_count), m_hits(out_hits)
+            {
+                m_hits.clear();
+            }
+
+            void AddHit(const ResultType& result) override
+            {
+                if (m_hits.size() < m_max_hit_count)
+                {
+                    m_hits.push_back(result);
+                }
+                else
+                {
+                    // the collector only gets hits closer than the early out fraction, so closer than the farthest
+                    *std::max_element(m_hits.begin(), m_hits.end(), isCloser) = result;
+                }
+
+                if (m_hits.size() == m_max_hit_count)
+                {
+                    this->UpdateEarlyOutFraction(
+                        std::max_element(m_hits.begin(), m_hits.end(), isCloser)->GetEarlyOutFraction());
+                }
+            }
+
+            void sort() { std::sort(m_hits.begin(), m_hits.end(), isCloser); }
+
+        private:
+            static bool isCloser(const ResultType& lhs, const ResultType& rhs)
+            {
+                return lhs.GetEarlyOutFraction() < rhs.GetEarlyOutFraction();
+            }
+
+            uint32_t                 m_max_hit_count {0};
+            std::vector<ResultType>& m_hits;
+        };
+
+        /// the closest hits of a ray, sorted by distance
+        void castRay(const JPH::PhysicsSystem&         physics_system,
+                     const JPH::RayCast&               ray,
+                     uint32_t                          max_hit_count,
+                     std::vector<JPH::RayCastResult>& out_results)
+        {
+            ClosestHitsCollector<JPH::CastRayCollector> collector(max_hit_count, out_results);
+            physics_system.GetNarrowPhaseQuery().CastRay(ray, JPH::RayCastSettings(), collector);
+            collector.sort();
+        }
+
+        void writeRayHits(const JPH::PhysicsSystem&              physics_system,
+                          const JPH::RayCast&                    ray,
+                          float                                  ray_length,
+                          const std::vector<JPH::RayCastResult>& results,
+                          PhysicsHitInfo*                        out_hits)
+        {
+            for (size_t index = 0; index < results.size(); index++)
+            {
+                const JPH::RayCastResult& cast_result = results[index];
+
+                PhysicsHitInfo& hit = out_hits[index];
+                hit.hit_position    = toVec3(ray.mOrigin + cast_result.mFraction * ray.mDirection);
+                hit.hit_distance    = cast_result.mFraction * ray_length;
+                hit.body_id         = cast_result.mBodyID.GetIndexAndSequenceNumber();
+
+                // get hit normal
+                JPH::BodyLockRead body_lock(physics_system.GetBodyLockInterface(), cast_result.mBodyID);
+                const JPH::Body&  hit_body = body_lock.GetBody();
+
+                hit.hit_normal =
+                    toVec3(hit_body.GetWorldSpaceSurfaceNormal(cast_result.mSubShapeID2, toVec3(hit.hit_position)));
+            }
+        }
+
+        /// the closest hits of a shape sweep, sorted by distance
+        void castShape(const JPH::PhysicsSystem&           physics_system,
+                       const JPH::ShapeCast&               shape_cast,
+                       uint32_t                            max_hit_count,
+                       std::vector<JPH::ShapeCastResult>& out_results)
+        {
+            ClosestHitsCollector<JPH::CastShapeCollector> collector(max_hit_count, out_results);
+            physics_system.GetNarrowPhaseQuery().CastShape(shape_cast, JPH::ShapeCastSettings(), collector);
+            collector.sort();
+        }
+
+        void writeSweepHits(float                                    sweep_length,
+                            const std::vector<JPH::ShapeCastResult>& results,
+                            PhysicsHitInfo*                          out_hits)
+        {
+            for (size_t index = 0; index < results.size(); index++)
+            {
+                const JPH::ShapeCastResult& sweep_result = results[index];
+
+                PhysicsHitInfo& hit = out_hits[index];
+                hit.hit_position    = toVec3(sweep_result.mContactPointOn2);
+                hit.hit_normal      = toVec3(sweep_result.mPenetrationAxis.Normalized());
+                hit.hit_distance    = sweep_result.mFraction * sweep_length;
+                hit.body_id         = sweep_result.mBodyID2.GetIndexAndSequenceNumber();
+            }
+        }
+
+        JPH::ShapeCast makeShapeCast(const JPH::Shape& shape,
+                                     const Matrix4x4&  shape_global_transform,
+                                     const Vector3&    sweep_direction,
+                                     float             sweep_length)
+        {
+            return JPH::ShapeCast::sFromWorldTransform(&shape,
+                                                       JPH::Vec3::sReplicate(1.f),
+                                                       toMat44(shape_global_transform),
+                                                       toVec3(sweep_direction.normalisedCopy() * sweep_length));
+        }
+
+        /// a body overlapping the shape, s_invalid_rigidbody_id if there is none
+        uint32_t collideShape(const JPH::PhysicsSystem& physics_system,
+                              const JPH::Shape&         shape,
+                              const Matrix4x4&          shape_global_transform)
+        {
+            JPH::AnyHitCollisionCollector<JPH::CollideShapeCollector> collector;
+            physics_system.GetNarrowPhaseQuery().CollideShape(&shape,
+                                                              JPH::Vec3::sReplicate(1.0f),
+                                                              toMat44(shape_global_transform),
+                                                              JPH::CollideShapeSettings(),
+                                                              collector);
+
+            return collector.HadHit() ? collector.mHit.mBodyID2.GetIndexAndSequenceNumber() : s_invalid_rigidbody_id;
+        }
+    } // namespace
 
-        JPH::Factory::sInstance = new JPH::Factory();
-        JPH::RegisterTypes();
+    struct PhysicsScene::QueryShapeCache
+    {
+        struct Key
+        {
+            RigidBodyShapeType m_type {RigidBodyShapeType::invalid};
+            Vector3            m_dimensions;
 
-        m_physics.m_jolt_physics_system              = new JPH::PhysicsSystem();
-        m_physics.m_jolt_broad_phase_layer_interface = new BPLayerInterfaceImpl();
+            bool operator==(const Key& rhs) const { return m_type == rhs.m_type && m_dimensions == rhs.m_dimensions; }
+        };
 
-        m_physics.m_jolt_job_system =
-            new JPH::JobSystemThreadPool(m_config.m_max_job_count,
-                                         m_config.m_max_barrier_count,
-                                         static_cast<int>(m_config.m_max_concurrent_job_count));
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const
+            {
+                size_t seed = 0;
+                hash_combine(seed, static_cast<int>(key.m_type));
+                hash_combine(seed, normalizeZero(key.m_dimensions.x));
+                hash_combine(seed, normalizeZero(key.m_dimensions.y));
+                hash_combine(seed, normalizeZero(key.m_dimensions.z));
+                return seed;
+            }
 
-        // 16M temp memory
-        m_physics.m_temp_allocator = new JPH::TempAllocatorImpl(16 * 1024 * 1024);
+            // -0.0f and 0.0f compare equal, they have to hash the same
+            static float normalizeZero(float value) { return value == 0.0f ? 0.0f : value; }
+        };
+
+        /// the jolt shape of a rigidbody shape under a transform, and the global transform to place it at
+        JPH::RefConst<JPH::Shape>
+        getShape(const RigidBodyShape& shape, const Matrix4x4& transform, Matrix4x4& out_shape_global_transform)
+        {
+            out_shape_global_transform = transform * shape.m_local_transform.getMatrix();
+
+            Vector3    global_position, global_scale;
+            Quaternion global_rotation;
+            out_shape_global_transform.decomposition(global_position, global_scale, global_rotation);
+
+            Key key;
+            if (!getShapeDimensions(shape, global_scale, key.m_type, key.m_dimensions))
+            {
+                return nullptr;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto found = m_shapes.find(key);
+            if (found != m_shapes.end())
+            {
+                return found->second;
+            }
+
+            if (m_shapes.size() >= k_max_query_shape_count)
+            {
+                m_shapes.clear();
+            }
+            JPH::RefConst<JPH::Shape> jph_shape = toShape(key.m_type, key.m_dimensions);
+            m_shapes.emplace(key, jph_shape);
+            return jph_shape;
+        }
+
+        std::mutex                                                    m_mutex;
+        std::unordered_map<Key, JPH::RefConst<JPH::Shape>, KeyHash> m_shapes;
+    };
+
+    PhysicsScene::PhysicsScene(const Vector3&                       gravity,
+                               JPH::JobSystem*                      jolt_job_system,
+                               const JPH::BroadPhaseLayerInterface& jolt_broad_phase_layer_interface)
+    {
+        static_assert(s_invalid_rigidbody_id == JPH::BodyID::cInvalidBodyID);
+        ASSERT(jolt_job_system);
+
+        m_physics.m_jolt_physics_system = new JPH::PhysicsSystem();
+        m_physics.m_jolt_job_system     = jolt_job_system;
+        m_physics.m_temp_allocator      = new JPH::TempAllocatorImpl(m_config.m_temp_allocator_size);
 
         m_physics.m_jolt_physics_system->Init(m_config.m_max_body_count,
                                               m_config.m_body_mutex_count,
                                               m_config.m_max_body_pairs,
                                               m_config.m_max_contact_constraints,
-                                              *(m_physics.m_jolt_broad_phase_layer_interface),
+                                              jolt_broad_phase_layer_interface,
                                               BroadPhaseCanCollide,
                                               ObjectCanCollide);
         // use the default setting
@@ -61,17 +260,16 @@ namespace Piccolo
 
         m_physics.m_jolt_physics_system->SetGravity(toVec3(gravity));
         m_config.m_gravity = gravity;
+
+        m_query_shape_cache = std::make_unique<QueryShapeCache>();
     }
 
     PhysicsScene::~PhysicsScene()
     {
+        m_query_shape_cache.reset();
+
         delete m_physics.m_jolt_physics_system;
-        delete m_physics.m_jolt_job_system;
         delete m_physics.m_temp_allocator;
-        delete m_physics.m_jolt_broad_phase_layer_interface;
-
-        delete JPH::Factory::sInstance;
-        JPH::Factory::sInstance = nullptr;
     }
 
     uint32_t PhysicsScene::createRigidBody(const Transform&             global_transform,
@@ -116,9 +314,20 @@ namespace Piccolo
             return JPH::BodyID::cInvalidBodyID;
         }
 
-        //$TODO: currently just support static object
+        const RigidBodyActorType actor_type = static_cast<RigidBodyActorType>(rigidbody_actor_res.m_actor_type);
+
         JPH::EMotionType motion_type = JPH::EMotionType::Static;
         JPH::ObjectLayer layer       = Layers::NON_MOVING;
+        if (actor_type == RigidBodyActorType::dynamic_actor)
+        {
+            motion_type = JPH::EMotionType::Dynamic;
+            layer       = Layers::MOVING;
+        }
+        else if (actor_type == RigidBodyActorType::kinematic_actor)
+        {
+            motion_type = JPH::EMotionType::Kinematic;
+            layer       = Layers::MOVING;
+        }
 
         JPH::Ref<JPH::StaticCompoundShapeSettings> compund_shape_setting = new JPH::StaticCompoundShapeSettings;
         for (const JPHShapeData& shape_data : jph_shapes)
@@ -128,11 +337,19 @@ namespace Piccolo
                                             shape_data.shape);
         }
 
-        JPH::Body* jph_body = body_interface.CreateBody(JPH::BodyCreationSettings(compund_shape_setting,
-                                                                                  toVec3(global_transform.m_position),
-                                                                                  toQuat(global_transform.m_rotation),
-                                                                                  motion_type,
-                                                                                  layer));
+        JPH::BodyCreationSettings body_settings(compund_shape_setting,
+                                                toVec3(global_transform.m_position),
+                                                toQuat(global_transform.m_rotation),
+                                                motion_type,
+                                                layer);
+        if (motion_type == JPH::EMotionType::Dynamic && rigidbody_actor_res.m_inverse_mass > 0.f)
+        {
+            // the inertia still comes from the shapes, scaled to the given mass
+            body_settings.mOverrideMassProperties       = JPH::EOverrideMassProperties::CalculateInertia;
+            body_settings.mMassPropertiesOverride.mMass = 1.f / rigidbody_actor_res.m_inverse_mass;
+        }
+
+        JPH::Body* jph_body = body_interface.CreateBody(body_settings);
 
         if (jph_body == nullptr)
         {
@@ -148,7 +365,19 @@ namespace Piccolo
         body_interface.AddBody(jph_body->GetID(), JPH::EActivation::Activate);
         LOG_INFO("Add Body: {}", jph_body->GetID().GetIndexAndSequenceNumber());
 
-        return jph_body->GetID().GetIndexAndSequenceNumber();
+        const uint32_t body_id = jph_body->GetID().GetIndexAndSequenceNumber();
+        if (motion_type != JPH::EMotionType::Static)
+        {
+            MovingBody& moving_body         = m_moving_bodies[body_id];
+            moving_body.m_is_kinematic      = motion_type == JPH::EMotionType::Kinematic;
+            moving_body.m_previous_position = global_transform.m_position;
+            moving_body.m_previous_rotation = global_transform.m_rotation;
+            moving_body.m_current_position  = global_transform.m_position;
+            moving_body.m_current_rotation  = global_transform.m_rotation;
+            moving_body.m_step_index        = m_step_index;
+        }
+
+        return body_id;
     }
 
     void PhysicsScene::removeRigidBody(uint32_t body_id) { m_pending_remove_bodies.push_back(body_id); }
@@ -157,6 +386,27 @@ namespace Piccolo
     {
         JPH::BodyInterface& body_interface = m_physics.m_jolt_physics_system->GetBodyInterface();
 
+        auto moving_body_iter = m_moving_bodies.find(body_id);
+        if (moving_body_iter != m_moving_bodies.end())
+        {
+            MovingBody& moving_body = moving_body_iter->second;
+            if (moving_body.m_is_kinematic)
+            {
+                // teleporting would skip the contacts, the body is moved by velocity instead
+                moving_body.m_has_kinematic_target = true;
+                moving_body.m_target_position      = global_transform.m_position;
+                moving_body.m_target_rotation      = global_transform.m_rotation;
+                return;
+            }
+
+            // a teleported dynamic body is not interpolated from its old pose
+            moving_body.m_previous_position = global_transform.m_position;
+            moving_body.m_previous_rotation = global_transform.m_rotation;
+            moving_body.m_current_position  = global_transform.m_position;
+            moving_body.m_current_rotation  = global_transform.m_rotation;
+            moving_body.m_step_index        = m_step_index;
+        }
+
         body_interface.SetPositionAndRotation(JPH::BodyID(body_id),
                                               toVec3(global_transform.m_position),
                                               toQuat(global_transform.m_rotation),
@@ -167,67 +417,145 @@ namespace Piccolo
     {
         const float time_step = 1.f / m_config.m_update_frequency;
 
-        m_physics.m_jolt_physics_system->Update(time_step,
-                                                m_physics.m_collision_steps,
-                                                m_physics.m_integration_substeps,
-                                                m_physics.m_temp_allocator,
-                                                m_physics.m_jolt_job_system);
+        m_accumulated_time += delta_time;
+        uint32_t step_count = static_cast<uint32_t>(m_accumulated_time / time_step);
+        if (step_count > m_config.m_max_step_count)
+        {
+            // the simulation slows down rather than spending ever more steps to catch up
+            step_count         = m_config.m_max_step_count;
+            m_accumulated_time = static_cast<float>(step_count) * time_step;
+        }
+        m_accumulated_time -= static_cast<float>(step_count) * time_step;
 
         JPH::BodyInterface& body_interface = m_physics.m_jolt_physics_system->GetBodyInterface();
+
+        if (step_count > 0)
+        {
+            // the kinematic bodies reach their targets at the end of the steps of this tick
+            for (auto& id_body_pair : m_moving_bodies)
+            {
+                MovingBody& moving_body = id_body_pair.second;
+                if (moving_body.m_has_kinematic_target)
+                {
+                    body_interface.MoveKinematic(JPH::BodyID(id_body_pair.first),
+                                                 toVec3(moving_body.m_target_position),
+                                                 toQuat(moving_body.m_target_rotation),
+                                                 step_count * time_step);
+                }
+            }
+        }
+
+        for (uint32_t step_index = 0; step_index < step_count; step_index++)
+        {
+            m_physics.m_jolt_physics_system->Update(time_step,
+                                                    m_physics.m_collision_steps,
+                                                    m_physics.m_integration_substeps,
+                                                    m_physics.m_temp_allocator,
+                                                    m_physics.m_jolt_job_system);
+            m_step_index++;
+
+            readBackActiveBodies();
+        }
+
+        if (step_count > 0)
+        {
+            for (auto& id_body_pair : m_moving_bodies)
+            {
+                MovingBody& moving_body = id_body_pair.second;
+                if (moving_body.m_has_kinematic_target)
+                {
+                    // arrived, the body must not keep drifting with the velocity of the move
+                    body_interface.SetLinearAndAngularVelocity(
+                        JPH::BodyID(id_body_pair.first), JPH::Vec3::sZero(), JPH::Vec3::sZero());
+                    moving_body.m_has_kinematic_target = false;
+                }
+            }
+        }
+
         for (uint32_t body_id : m_pending_remove_bodies)
         {
             LOG_INFO("Remove Body {}", body_id)
             body_interface.RemoveBody(JPH::BodyID(body_id));
             body_interface.DestroyBody(JPH::BodyID(body_id));
+            m_moving_bodies.erase(body_id);
         }
         m_pending_remove_bodies.clear();
     }
 
+    void PhysicsScene::readBackActiveBodies()
+    {
+        // the simulation is not running, the bodies can be read without locking them one by one
+        const JPH::BodyInterface& body_interface = m_physics.m_jolt_physics_system->GetBodyInterfaceNoLock();
+
+        m_physics.m_jolt_physics_system->GetActiveBodies(m_physics.m_active_body_ids);
+        for (const JPH::BodyID& active_body_id : m_physics.m_active_body_ids)
+        {
+            auto moving_body_iter = m_moving_bodies.find(active_body_id.GetIndexAndSequenceNumber());
+            if (moving_body_iter == m_moving_bodies.end() || moving_body_iter->second.m_is_kinematic)
+            {
+                continue;
+            }
+
+            JPH::Vec3 position;
+            JPH::Quat rotation;
+            body_interface.GetPositionAndRotation(active_body_id, position, rotation);
+
+            // a body waking up doesn't interpolate from the pose it fell asleep at
+            MovingBody& moving_body = moving_body_iter->second;
+            const bool  was_active  = moving_body.m_step_index + 1 == m_step_index;
+            moving_body.m_previous_position = was_active ? moving_body.m_current_position : toVec3(position);
+            moving_body.m_previous_rotation = was_active ? moving_body.m_current_rotation : toQuat(rotation);
+            moving_body.m_current_position  = toVec3(position);
+            moving_body.m_current_rotation  = toQuat(rotation);
+            moving_body.m_step_index        = m_step_index;
+        }
+    }
+
+    bool PhysicsScene::getInterpolatedTransform(uint32_t    body_id,
+                                                Vector3&    out_position,
+                                                Quaternion& out_rotation) const
+    {
+        auto moving_body_iter = m_moving_bodies.find(body_id);
+        if (moving_body_iter == m_moving_bodies.end() || moving_body_iter->second.m_is_kinematic)
+        {
+            return false;
+        }
+
+        const MovingBody& moving_body = moving_body_iter->second;
+        if (moving_body.m_step_index != m_step_index)
+        {
+            // not active during the last step, it's at rest
+            out_position = moving_body.m_current_position;
+            out_rotation = moving_body.m_current_rotation;
+            return true;
+        }
+
+        const float alpha = m_accumulated_time * m_config.m_update_frequency;
+        out_position      = Vector3::lerp(moving_body.m_previous_position, moving_body.m_current_position, alpha);
+        out_rotation =
+            Quaternion::nLerp(alpha, moving_body.m_previous_rotation, moving_body.m_current_rotation, true);
+        return true;
+    }
+
     bool PhysicsScene::raycast(Vector3                      ray_origin,
                                Vector3                      ray_directory,
                                float                        ray_length,
                                std::vector<PhysicsHitInfo>& out_hits)
     {
-        const JPH::NarrowPhaseQuery& scene_query = m_physics.m_jolt_physics_system->GetNarrowPhaseQuery();
-
         JPH::RayCast ray;
         ray.mOrigin    = toVec3(ray_origin);
         ray.mDirection = toVec3(ray_directory.normalisedCopy() * ray_length);
 
-        JPH::RayCastSettings raycast_setting;
-
-        JPH::AllHitCollisionCollector<JPH::CastRayCollector> collector;
-
-        scene_query.CastRay(ray, raycast_setting, collector);
-
-        if (!collector.HadHit())
+        std::vector<JPH::RayCastResult> raycast_results;
+        castRay(*m_physics.m_jolt_physics_system, ray, std::numeric_limits<uint32_t>::max(), raycast_results);
+        if (raycast_results.empty())
         {
             return false;
         }
 
-        collector.Sort();
-
-        std::vector<JPH::RayCastResult> raycast_results(collector.mHits.begin(), collector.mHits.end());
-
         out_hits.clear();
         out_hits.resize(raycast_results.size());
-
-        for (size_t index = 0; index < raycast_results.size(); index++)
-        {
-            const JPH::RayCastResult& cast_result = raycast_results[index];
-
-            PhysicsHitInfo& hit = out_hits[index];
-            hit.hit_position    = toVec3(ray.mOrigin + cast_result.mFraction * ray.mDirection);
-            hit.hit_distance    = cast_result.mFraction * ray_length;
-            hit.body_id         = cast_result.mBodyID.GetIndexAndSequenceNumber();
-
-            // get hit normal
-            JPH::BodyLockRead body_lock(m_physics.m_jolt_physics_system->GetBodyLockInterface(), cast_result.mBodyID);
-            const JPH::Body&  hit_body = body_lock.GetBody();
-
-            hit.hit_normal =
-                toVec3(hit_body.GetWorldSpaceSurfaceNormal(cast_result.mSubShapeID2, toVec3(hit.hit_position)));
-        }
+        writeRayHits(*m_physics.m_jolt_physics_system, ray, ray_length, raycast_results, out_hits.data());
 
         return true;
     }
@@ -238,82 +566,140 @@ namespace Piccolo
                              float                        sweep_length,
                              std::vector<PhysicsHitInfo>& out_hits)
     {
-        const JPH::NarrowPhaseQuery& scene_query = m_physics.m_jolt_physics_system->GetNarrowPhaseQuery();
-
-        const Matrix4x4 shape_global_transform = shape_transform * shape.m_local_transform.getMatrix();
-
-        Vector3    global_position, global_scale;
-        Quaternion global_rotation;
-
-        shape_global_transform.decomposition(global_position, global_scale, global_rotation);
-
-        JPH::Shape* jph_shape = toShape(shape, global_scale);
-
+        Matrix4x4                 shape_global_transform;
+        JPH::RefConst<JPH::Shape> jph_shape =
+            m_query_shape_cache->getShape(shape, shape_transform, shape_global_transform);
         if (jph_shape == nullptr)
         {
             return false;
         }
 
-        JPH::ShapeCast shape_cast =
-            JPH::ShapeCast::sFromWorldTransform(jph_shape,
-                                                JPH::Vec3::sReplicate(1.f),
-                                                toMat44(shape_global_transform),
-                                                toVec3(sweep_direction.normalisedCopy() * sweep_length));
-
-        JPH::AllHitCollisionCollector<JPH::CastShapeCollector> collector;
-        scene_query.CastShape(shape_cast, JPH::ShapeCastSettings(), collector);
-        if (!collector.HadHit())
+        std::vector<JPH::ShapeCastResult> sweep_results;
+        castShape(*m_physics.m_jolt_physics_system,
+                  makeShapeCast(*jph_shape, shape_global_transform, sweep_direction, sweep_length),
+                  std::numeric_limits<uint32_t>::max(),
+                  sweep_results);
+        if (sweep_results.empty())
         {
             return false;
         }
 
-        collector.Sort();
-
-        std::vector<JPH::ShapeCastResult> sweep_results(collector.mHits.begin(), collector.mHits.end());
-
         out_hits.clear();
         out_hits.resize(sweep_results.size());
-
-        for (size_t index = 0; index < sweep_results.size(); index++)
-        {
-            const JPH::ShapeCastResult& sweep_result = sweep_results[index];
-
-            PhysicsHitInfo& hit = out_hits[index];
-            hit.hit_position    = toVec3(sweep_result.mContactPointOn2);
-            hit.hit_normal      = toVec3(sweep_result.mPenetrationAxis.Normalized());
-            hit.hit_distance    = sweep_result.mFraction * sweep_length;
-            hit.body_id         = sweep_result.mBodyID2.GetIndexAndSequenceNumber();
-        }
+        writeSweepHits(sweep_length, sweep_results, out_hits.data());
 
         return true;
     }
 
     bool PhysicsScene::isOverlap(const RigidBodyShape& shape, const Matrix4x4& global_transform)
     {
-        const JPH::NarrowPhaseQuery& scene_query = m_physics.m_jolt_physics_system->GetNarrowPhaseQuery();
-
-        const Matrix4x4 shape_global_transform = global_transform * shape.m_local_transform.getMatrix();
-
-        Vector3    global_position, global_scale;
-        Quaternion global_rotation;
-
-        shape_global_transform.decomposition(global_position, global_scale, global_rotation);
-
-        JPH::Shape* jph_shape = toShape(shape, global_scale);
-
+        Matrix4x4                 shape_global_transform;
+        JPH::RefConst<JPH::Shape> jph_shape =
+            m_query_shape_cache->getShape(shape, global_transform, shape_global_transform);
         if (jph_shape == nullptr)
         {
             return false;
         }
 
-        JPH::AnyHitCollisionCollector<JPH::CollideShapeCollector> collector;
-        scene_query.CollideShape(jph_shape,
-                                 JPH::Vec3::sReplicate(1.0f),
-                                 toMat44(shape_global_transform),
-                                 JPH::CollideShapeSettings(),
-                                 collector);
+        return collideShape(*m_physics.m_jolt_physics_system, *jph_shape, shape_global_transform) !=
+               s_invalid_rigidbody_id;
+    }
+
+    void PhysicsScene::raycastBatch(const PhysicsRaycastQuery* queries,
+                                    size_t                     query_count,
+                                    uint32_t                   max_hit_count_per_query,
+                                    PhysicsHitInfo*            out_hits,
+                                    uint32_t*                  out_hit_counts)
+    {
+        const JPH::PhysicsSystem& physics_system = *m_physics.m_jolt_physics_system;
+
+        g_runtime_global_context.m_job_system->parallelFor(
+            "PhysicsRaycastBatch", query_count, k_query_batch_size, [&](size_t begin, size_t end) {
+                // reused by the queries of the batch
+                std::vector<JPH::RayCastResult> raycast_results;
+                for (size_t query_index = begin; query_index < end; query_index++)
+                {
+                    const PhysicsRaycastQuery& query = queries[query_index];
+
+                    out_hit_counts[query_index] = 0;
+                    if (max_hit_count_per_query == 0)
+                    {
+                        continue;
+                    }
+
+                    JPH::RayCast ray;
+                    ray.mOrigin    = toVec3(query.m_origin);
+                    ray.mDirection = toVec3(query.m_direction.normalisedCopy() * query.m_length);
+
+                    castRay(physics_system, ray, max_hit_count_per_query, raycast_results);
+                    writeRayHits(physics_system,
+                                 ray,
+                                 query.m_length,
+                                 raycast_results,
+                                 out_hits + query_index * max_hit_count_per_query);
+                    out_hit_counts[query_index] = static_cast<uint32_t>(raycast_results.size());
+                }
+            });
+    }
+
+    void PhysicsScene::sweepBatch(const PhysicsSweepQuery* queries,
+                                  size_t                   query_count,
+                                  uint32_t                 max_hit_count_per_query,
+                                  PhysicsHitInfo*          out_hits,
+                                  uint32_t*                out_hit_counts)
+    {
+        const JPH::PhysicsSystem& physics_system = *m_physics.m_jolt_physics_system;
+
+        g_runtime_global_context.m_job_system->parallelFor(
+            "PhysicsSweepBatch", query_count, k_query_batch_size, [&](size_t begin, size_t end) {
+                std::vector<JPH::ShapeCastResult> sweep_results;
+                for (size_t query_index = begin; query_index < end; query_index++)
+                {
+                    const PhysicsSweepQuery& query = queries[query_index];
+
+                    out_hit_counts[query_index] = 0;
+                    if (max_hit_count_per_query == 0)
+                    {
+                        continue;
+                    }
+
+                    Matrix4x4                 shape_global_transform;
+                    JPH::RefConst<JPH::Shape> jph_shape =
+                        m_query_shape_cache->getShape(*query.m_shape, query.m_shape_transform, shape_global_transform);
+                    if (jph_shape == nullptr)
+                    {
+                        continue;
+                    }
+
+                    castShape(physics_system,
+                              makeShapeCast(*jph_shape, shape_global_transform, query.m_direction, query.m_length),
+                              max_hit_count_per_query,
+                              sweep_results);
+                    writeSweepHits(query.m_length, sweep_results, out_hits + query_index * max_hit_count_per_query);
+                    out_hit_counts[query_index] = static_cast<uint32_t>(sweep_results.size());
+                }
+            });
+    }
 
-        return collector.HadHit();
+    void PhysicsScene::overlapBatch(const PhysicsOverlapQuery* queries, size_t query_count, uint32_t* out_body_ids)
+    {
+        const JPH::PhysicsSystem& physics_system = *m_physics.m_jolt_physics_system;
+
+        g_runtime_global_context.m_job_system->parallelFor(
+            "PhysicsOverlapBatch", query_count, k_query_batch_size, [&](size_t begin, size_t end) {
+                for (size_t query_index = begin; query_index < end; query_index++)
+                {
+                    const PhysicsOverlapQuery& query = queries[query_index];
+
+                    Matrix4x4                 shape_global_transform;
+                    JPH::RefConst<JPH::Shape> jph_shape =
+                        m_query_shape_cache->getShape(*query.m_shape, query.m_global_transform, shape_global_transform);
+
+                    out_body_ids[query_index] =
+                        jph_shape ? collideShape(physics_system, *jph_shape, shape_global_transform) :
+                                    s_invalid_rigidbody_id;
+                }
+            });
     }
 
     void PhysicsScene::getShapeBoundingBoxes(uint32_t body_id, std::vector<AxisAlignedBox>& out_bounding_boxes) const
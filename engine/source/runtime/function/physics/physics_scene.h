@@ -1,11 +1,19 @@
 #pragma once
 
 #include "runtime/core/math/axis_aligned.h"
+#include "runtime/core/math/matrix4.h"
+#include "runtime/core/math/quaternion.h"
 
 #include "runtime/function/physics/physics_config.h"
 
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 namespace JPH
 {
+    class BodyID;
     class PhysicsSystem;
     class JobSystem;
     class TempAllocator;
@@ -31,21 +39,69 @@ namespace Piccolo
         uint32_t body_id {s_invalid_rigidbody_id};
     };
 
+    struct PhysicsRaycastQuery
+    {
+        Vector3 m_origin;
+        Vector3 m_direction;
+        float   m_length {0.f};
+    };
+
+    struct PhysicsSweepQuery
+    {
+        // must outlive the batch
+        const RigidBodyShape* m_shape {nullptr};
+        Matrix4x4             m_shape_transform;
+        Vector3               m_direction;
+        float                 m_length {0.f};
+    };
+
+    struct PhysicsOverlapQuery
+    {
+        // must outlive the batch
+        const RigidBodyShape* m_shape {nullptr};
+        Matrix4x4             m_global_transform;
+    };
+
     class PhysicsScene
     {
         struct JoltPhysics
         {
-            JPH::PhysicsSystem*            m_jolt_physics_system {nullptr};
-            JPH::JobSystem*                m_jolt_job_system {nullptr};
-            JPH::TempAllocator*            m_temp_allocator {nullptr};
-            JPH::BroadPhaseLayerInterface* m_jolt_broad_phase_layer_interface {nullptr};
+            JPH::PhysicsSystem* m_jolt_physics_system {nullptr};
+            // shared by all the scenes, owned by the physics manager
+            JPH::JobSystem* m_jolt_job_system {nullptr};
+            // scratch memory of a step, one per scene since scenes may step concurrently
+            JPH::TempAllocator* m_temp_allocator {nullptr};
 
             int m_collision_steps {1};
             int m_integration_substeps {1};
+
+            // read back after every step
+            std::vector<JPH::BodyID> m_active_body_ids;
+        };
+
+        struct MovingBody
+        {
+            bool m_is_kinematic {false};
+
+            // poses of a dynamic body at the last two steps it was active
+            Vector3    m_previous_position;
+            Quaternion m_previous_rotation;
+            Vector3    m_current_position;
+            Quaternion m_current_rotation;
+            uint64_t   m_step_index {0};
+
+            // pose a kinematic body moves to during the next steps
+            bool       m_has_kinematic_target {false};
+            Vector3    m_target_position;
+            Quaternion m_target_rotation;
         };
 
     public:
-        PhysicsScene(const Vector3& gravity);
+        /// the job system and the layer interface are shared by the scenes and must outlive them, the jolt types
+        /// are registered beforehand
+        PhysicsScene(const Vector3&                       gravity,
+                     JPH::JobSystem*                      jolt_job_system,
+                     const JPH::BroadPhaseLayerInterface& jolt_broad_phase_layer_interface);
         virtual ~PhysicsScene();
 
         const Vector3& getGravity() const { return m_config.m_gravity; }
@@ -53,10 +109,16 @@ namespace Piccolo
         uint32_t createRigidBody(const Transform& global_transform, const RigidBodyComponentRes& rigidbody_actor_res);
         void     removeRigidBody(uint32_t body_id);
 
+        /// teleport static and dynamic bodies, kinematic bodies move to the transform during the next steps
         void updateRigidBodyGlobalTransform(uint32_t body_id, const Transform& global_transform);
 
+        /// run the fixed steps the accumulated time allows, then read the poses of the active dynamic bodies back
         void tick(float delta_time);
 
+        /// pose of a dynamic body interpolated between its last two steps, by the time accumulated since the last one
+        /// @return: false if the body is not dynamic
+        bool getInterpolatedTransform(uint32_t body_id, Vector3& out_position, Quaternion& out_rotation) const;
+
         /// cast a ray and find the hits
         /// @ray_origin: origin of ray
         /// @ray_direction: ray direction
@@ -84,6 +146,22 @@ namespace Piccolo
         /// @return: true if overlapped with any rigidbodies
         bool isOverlap(const RigidBodyShape& shape, const Matrix4x4& global_transform);
 
+        /// batched versions of the queries above, fanned out over the job system
+        /// query i writes its closest hits, sorted by distance, to out_hits[i * max_hit_count_per_query] and their
+        /// count to out_hit_counts[i], further hits are dropped
+        void raycastBatch(const PhysicsRaycastQuery* queries,
+                          size_t                     query_count,
+                          uint32_t                   max_hit_count_per_query,
+                          PhysicsHitInfo*            out_hits,
+                          uint32_t*                  out_hit_counts);
+        void sweepBatch(const PhysicsSweepQuery* queries,
+                        size_t                   query_count,
+                        uint32_t                 max_hit_count_per_query,
+                        PhysicsHitInfo*          out_hits,
+                        uint32_t*                out_hit_counts);
+        /// out_body_ids[i] is a body overlapping query i, s_invalid_rigidbody_id if there is none
+        void overlapBatch(const PhysicsOverlapQuery* queries, size_t query_count, uint32_t* out_body_ids);
+
         void getShapeBoundingBoxes(uint32_t body_id, std::vector<AxisAlignedBox>& out_bounding_boxes) const;
 
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
@@ -91,11 +169,24 @@ namespace Piccolo
 #endif
 
     protected:
+        struct QueryShapeCache;
+
+        void readBackActiveBodies();
+
         // we use single Jolt physics system for each scene
         JoltPhysics m_physics;
 
         PhysicsConfig m_config;
 
         std::vector<uint32_t> m_pending_remove_bodies;
+
+        // dynamic and kinematic bodies by id
+        std::unordered_map<uint32_t, MovingBody> m_moving_bodies;
+
+        float    m_accumulated_time {0.f};
+        uint64_t m_step_index {0};
+
+        // jolt shapes of the query shapes by type and scaled dimensions
+        std::unique_ptr<QueryShapeCache> m_query_shape_cache;
     };
 } // namespace Piccolo
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <GLFW/glfw3.h>
 #include <vk_mem_alloc.h>
 
+#include <filesystem>
 #include <memory>
 #include <vector>
 #include <functional>
@@ -16,6 +17,8 @@ namespace Piccolo
     struct RHIInitInfo
     {
         std::shared_ptr<WindowSystem> window_system;
+        // where the pipeline cache of the device is kept between runs, not kept when empty
+        std::filesystem::path pipeline_cache_folder;
     };
     
     class RHI
@@ -27,6 +30,10 @@ namespace Piccolo
         virtual void prepareContext() = 0;
 
         virtual bool isPointLightShadowEnabled() = 0;
+        // the indirect draws of the gpu driven path address their instances through firstInstance
+        virtual bool isDrawIndirectFirstInstanceEnabled() = 0;
+        // the materials index their textures in one partially bound descriptor array updated after bind
+        virtual bool isBindlessEnabled() = 0;
         // allocate and create
         virtual bool allocateCommandBuffers(const RHICommandBufferAllocateInfo* pAllocateInfo, RHICommandBuffer* &pCommandBuffers) = 0;
         virtual bool allocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* &pDescriptorSets) = 0;
@@ -59,6 +66,7 @@ namespace Piccolo
         virtual void createImageView(RHIImage* image, RHIFormat format, RHIImageAspectFlags image_aspect_flags, RHIImageViewType view_type, uint32_t layout_count, uint32_t miplevels,
             RHIImageView* &image_view) = 0;
         virtual void createGlobalImage(RHIImage* &image, RHIImageView* &image_view, VmaAllocation& image_allocation, uint32_t texture_image_width, uint32_t texture_image_height, void* texture_image_pixels, RHIFormat texture_image_format, uint32_t miplevels = 0) = 0;
+        virtual void createSampledImage(RHIImage* &image, RHIImageView* &image_view, VmaAllocation& image_allocation, uint32_t texture_image_width, uint32_t texture_image_height, RHIFormat texture_image_format, uint32_t miplevels) = 0;
         virtual void createCubeMap(RHIImage* &image, RHIImageView* &image_view, VmaAllocation& image_allocation, uint32_t texture_image_width, uint32_t texture_image_height, std::array<void*, 6> texture_image_pixels, RHIFormat texture_image_format, uint32_t miplevels) = 0;
         virtual void createCommandPool() = 0;
         virtual bool createCommandPool(const RHICommandPoolCreateInfo* pCreateInfo, RHICommandPool*& pCommandPool) = 0;
@@ -66,6 +74,7 @@ namespace Piccolo
         virtual bool createDescriptorSetLayout(const RHIDescriptorSetLayoutCreateInfo* pCreateInfo, RHIDescriptorSetLayout* &pSetLayout) = 0;
         virtual bool createFence(const RHIFenceCreateInfo* pCreateInfo, RHIFence* &pFence) = 0;
         virtual bool createFramebuffer(const RHIFramebufferCreateInfo* pCreateInfo, RHIFramebuffer* &pFramebuffer) = 0;
+        // a null pipeline cache means the persistent cache of the device, the pipelines may be created concurrently
         virtual bool createGraphicsPipelines(RHIPipelineCache* pipelineCache, uint32_t createInfoCount, const RHIGraphicsPipelineCreateInfo* pCreateInfos, RHIPipeline* &pPipelines) = 0;
         virtual bool createComputePipelines(RHIPipelineCache* pipelineCache, uint32_t createInfoCount, const RHIComputePipelineCreateInfo* pCreateInfos, RHIPipeline* &pPipelines) = 0;
         virtual bool createPipelineLayout(const RHIPipelineLayoutCreateInfo* pCreateInfo, RHIPipelineLayout* &pPipelineLayout) = 0;
@@ -76,6 +85,7 @@ namespace Piccolo
         // command and command write
         virtual bool waitForFencesPFN(uint32_t fenceCount, RHIFence* const* pFence, RHIBool32 waitAll, uint64_t timeout) = 0;
         virtual bool resetFencesPFN(uint32_t fenceCount, RHIFence* const* pFences) = 0;
+        virtual bool getFenceStatus(RHIFence* fence) = 0;
         virtual bool resetCommandPoolPFN(RHICommandPool* commandPool, RHICommandPoolResetFlags flags) = 0;
         virtual bool beginCommandBufferPFN(RHICommandBuffer* commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo) = 0;
         virtual bool endCommandBufferPFN(RHICommandBuffer* commandBuffer) = 0;
@@ -106,11 +116,14 @@ namespace Piccolo
 
         virtual bool beginCommandBuffer(RHICommandBuffer* commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo) = 0;
         virtual void cmdCopyImageToBuffer(RHICommandBuffer* commandBuffer, RHIImage* srcImage, RHIImageLayout srcImageLayout, RHIBuffer* dstBuffer, uint32_t regionCount, const RHIBufferImageCopy* pRegions) = 0;
+        virtual void cmdCopyBufferToImage(RHICommandBuffer* commandBuffer, RHIBuffer* srcBuffer, RHIImage* dstImage, RHIImageLayout dstImageLayout, uint32_t regionCount, const RHIBufferImageCopy* pRegions) = 0;
         virtual void cmdCopyImageToImage(RHICommandBuffer* commandBuffer, RHIImage* srcImage, RHIImageAspectFlagBits srcFlag, RHIImage* dstImage, RHIImageAspectFlagBits dstFlag, uint32_t width, uint32_t height) = 0;
         virtual void cmdCopyBuffer(RHICommandBuffer* commandBuffer, RHIBuffer* srcBuffer, RHIBuffer* dstBuffer, uint32_t regionCount, RHIBufferCopy* pRegions) = 0;
         virtual void cmdDraw(RHICommandBuffer* commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) = 0;
         virtual void cmdDispatch(RHICommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) = 0;
         virtual void cmdDispatchIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset) = 0;
+        virtual void cmdDrawIndexedIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride) = 0;
+        virtual void cmdDrawIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride) = 0;
         virtual void cmdPipelineBarrier(RHICommandBuffer* commandBuffer, RHIPipelineStageFlags srcStageMask, RHIPipelineStageFlags dstStageMask, RHIDependencyFlags dependencyFlags, uint32_t memoryBarrierCount, const RHIMemoryBarrier* pMemoryBarriers, uint32_t bufferMemoryBarrierCount, const RHIBufferMemoryBarrier* pBufferMemoryBarriers, uint32_t imageMemoryBarrierCount, const RHIImageMemoryBarrier* pImageMemoryBarriers) = 0;
         virtual bool endCommandBuffer(RHICommandBuffer* commandBuffer) = 0;
         virtual void updateDescriptorSets(uint32_t descriptorWriteCount, const RHIWriteDescriptorSet* pDescriptorWrites, uint32_t descriptorCopyCount, const RHICopyDescriptorSet* pDescriptorCopies) = 0;
@@ -129,6 +142,7 @@ namespace Piccolo
         virtual QueueFamilyIndices getQueueFamilyIndices() const = 0;
         virtual RHIQueue* getGraphicsQueue() const = 0;
         virtual RHIQueue* getComputeQueue() const = 0;
+        virtual RHIQueue* getTransferQueue() const = 0;
         virtual RHISwapChainDesc getSwapchainInfo() = 0;
         virtual RHIDepthImageDesc getDepthImageInfo() const = 0;
         virtual uint8_t getMaxFramesInFlight() const = 0;
@@ -159,7 +173,10 @@ namespace Piccolo
         virtual void destroyDevice() = 0;
         virtual void destroyCommandPool(RHICommandPool* commandPool) = 0;
         virtual void destroyBuffer(RHIBuffer* &buffer) = 0;
+        virtual void destroyDescriptorSetLayout(RHIDescriptorSetLayout* &descriptorSetLayout) = 0;
+        virtual void destroyDescriptorPool(RHIDescriptorPool* &descriptorPool) = 0;
         virtual void freeCommandBuffers(RHICommandPool* commandPool, uint32_t commandBufferCount, RHICommandBuffer* pCommandBuffers) = 0;
+        virtual void freeDescriptorSet(RHIDescriptorPool* descriptorPool, RHIDescriptorSet* &descriptorSet) = 0;
 
         // memory
         virtual void freeMemory(RHIDeviceMemory* &memory) = 0;
@@ -170,6 +187,8 @@ namespace Piccolo
 
         //semaphores
         virtual RHISemaphore* &getTextureCopySemaphore(uint32_t index) = 0;
+        // the next submitRendering waits on the semaphore before the given stages, for work submitted to other queues
+        virtual void addRenderingWaitSemaphore(RHISemaphore* semaphore, RHIPipelineStageFlags wait_stage) = 0;
 
     private:
     };
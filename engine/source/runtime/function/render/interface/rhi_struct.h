@@ -60,6 +60,8 @@ namespace Piccolo
     struct RHIDescriptorSetAllocateInfo;
     struct RHIDescriptorSetLayoutBinding;
     struct RHIDescriptorSetLayoutCreateInfo;
+    struct RHIDescriptorSetLayoutBindingFlagsCreateInfo;
+    struct RHIDescriptorSetVariableDescriptorCountAllocateInfo;
     struct RHIDeviceCreateInfo;
     struct RHIDeviceQueueCreateInfo;
     struct RHIExtensionProperties;
@@ -355,6 +357,22 @@ namespace Piccolo
         const RHIDescriptorSetLayoutBinding* pBindings;
     };
 
+    struct RHIDescriptorSetLayoutBindingFlagsCreateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        uint32_t bindingCount;
+        const RHIDescriptorBindingFlags* pBindingFlags;
+    };
+
+    struct RHIDescriptorSetVariableDescriptorCountAllocateInfo
+    {
+        RHIStructureType sType;
+        const void* pNext;
+        uint32_t descriptorSetCount;
+        const uint32_t* pDescriptorCounts;
+    };
+
     struct RHIDeviceCreateInfo
     {
         RHIStructureType sType;
@@ -1121,6 +1139,8 @@ namespace Piccolo
         std::optional<uint32_t> graphics_family;
         std::optional<uint32_t> present_family;
         std::optional<uint32_t> m_compute_family;
+        // a family dedicated to copies when the device has one, the graphics family otherwise
+        std::optional<uint32_t> m_transfer_family;
 
         bool isComplete() { return graphics_family.has_value() && present_family.has_value() && m_compute_family.has_value();; }
     };
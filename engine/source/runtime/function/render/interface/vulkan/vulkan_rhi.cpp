@@ -1,10 +1,12 @@
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
+#include "runtime/function/render/interface/vulkan/vulkan_scratch_arena.h"
 #include "runtime/function/render/interface/vulkan/vulkan_util.h"
 
 #include "runtime/function/render/window_system.h"
 #include "runtime/core/base/macro.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 
 // https://gcc.gnu.org/onlinedocs/cpp/Stringizing.html
@@ -68,7 +70,9 @@
 #error Unknown Compiler
 #endif
 
+#include <cstddef>
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <set>
 #include <stdexcept>
@@ -76,6 +80,48 @@
 
 namespace Piccolo
 {
+    namespace
+    {
+        // the RHI structs mirror the Vk ones, those with the same layout are handed to Vulkan as they are
+        template<typename VkType, typename RHIType>
+        const VkType* passThrough(const RHIType* rhi_structs)
+        {
+            static_assert(sizeof(VkType) == sizeof(RHIType) && alignof(VkType) == alignof(RHIType),
+                          "the RHI struct must be laid out like the Vk one");
+            return reinterpret_cast<const VkType*>(rhi_structs);
+        }
+
+        static_assert(offsetof(RHIRect2D, extent) == offsetof(VkRect2D, extent));
+        static_assert(offsetof(RHIClearValue, depthStencil) == offsetof(VkClearValue, depthStencil));
+        static_assert(offsetof(RHIClearAttachment, clearValue) == offsetof(VkClearAttachment, clearValue));
+        static_assert(offsetof(RHIClearRect, baseArrayLayer) == offsetof(VkClearRect, baseArrayLayer));
+        static_assert(offsetof(RHIBufferImageCopy, imageSubresource) == offsetof(VkBufferImageCopy, imageSubresource));
+        static_assert(offsetof(RHIBufferImageCopy, imageExtent) == offsetof(VkBufferImageCopy, imageExtent));
+        static_assert(offsetof(RHIMemoryBarrier, srcAccessMask) == offsetof(VkMemoryBarrier, srcAccessMask));
+
+        // the descriptor indexing structs are chained through pNext, which is handed to Vulkan as it is
+        static_assert(sizeof(RHIDescriptorSetLayoutBindingFlagsCreateInfo) ==
+                          sizeof(VkDescriptorSetLayoutBindingFlagsCreateInfoEXT) &&
+                      offsetof(RHIDescriptorSetLayoutBindingFlagsCreateInfo, pBindingFlags) ==
+                          offsetof(VkDescriptorSetLayoutBindingFlagsCreateInfoEXT, pBindingFlags));
+        static_assert(sizeof(RHIDescriptorSetVariableDescriptorCountAllocateInfo) ==
+                          sizeof(VkDescriptorSetVariableDescriptorCountAllocateInfoEXT) &&
+                      offsetof(RHIDescriptorSetVariableDescriptorCountAllocateInfo, pDescriptorCounts) ==
+                          offsetof(VkDescriptorSetVariableDescriptorCountAllocateInfoEXT, pDescriptorCounts));
+
+        // the Vk handles of an array of RHI resources, in the scratch arena of the calling thread
+        template<typename VulkanType, typename VkType, typename RHIType>
+        const VkType* translateHandles(RHIType* const* rhi_resources, uint32_t count)
+        {
+            VkType* vk_handles = VulkanScratchArena::get().allocate<VkType>(count);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                vk_handles[i] = ((VulkanType*)rhi_resources[i])->getResource();
+            }
+            return vk_handles;
+        }
+    } // namespace
+
     VulkanRHI::~VulkanRHI()
     {
         // TODO
@@ -83,7 +129,9 @@ namespace Piccolo
 
     void VulkanRHI::initialize(RHIInitInfo init_info)
     {
-        m_window = init_info.window_system->getWindow();
+        m_window           = init_info.window_system->getWindow();
+        m_window_thread_id = std::this_thread::get_id();
+        m_window_system    = init_info.window_system;
 
         std::array<int, 2> window_size = init_info.window_system->getWindowSize();
 
@@ -152,6 +200,8 @@ namespace Piccolo
         createFramebufferImageAndView();
 
         createAssetAllocator();
+
+        createPipelineCache(init_info.pipeline_cache_folder);
     }
 
     void VulkanRHI::prepareContext()
@@ -162,6 +212,13 @@ namespace Piccolo
 
     void VulkanRHI::clear()
     {
+        savePipelineCache();
+        if (m_vk_pipeline_cache != VK_NULL_HANDLE)
+        {
+            vkDestroyPipelineCache(m_device, m_vk_pipeline_cache, nullptr);
+            m_vk_pipeline_cache = VK_NULL_HANDLE;
+        }
+
         if (m_enable_validation_Layers)
         {
             destroyDebugUtilsMessengerEXT(m_instance, m_debug_messenger, nullptr);
@@ -180,18 +237,12 @@ namespace Piccolo
 
     bool VulkanRHI::waitForFences(uint32_t fenceCount, const RHIFence* const* pFences, RHIBool32 waitAll, uint64_t timeout)
     {
-        //fence
-        int fence_size = fenceCount;
-        std::vector<VkFence> vk_fence_list(fence_size);
-        for (int i = 0; i < fence_size; ++i)
-        {
-            const auto& rhi_fence_element = pFences[i];
-            auto& vk_fence_element = vk_fence_list[i];
+        VulkanScratchArena::Scope scratch_scope(VulkanScratchArena::get());
 
-            vk_fence_element = ((VulkanFence*)rhi_fence_element)->getResource();
-        };
+        //fence
+        const VkFence* vk_fence_list = translateHandles<VulkanFence, VkFence>(pFences, fenceCount);
 
-        VkResult result = vkWaitForFences(m_device, fenceCount, vk_fence_list.data(), waitAll, timeout);
+        VkResult result = vkWaitForFences(m_device, fenceCount, vk_fence_list, waitAll, timeout);
 
         if (result == VK_SUCCESS)
         {
@@ -453,18 +504,6 @@ namespace Piccolo
         VkSemaphore semaphores[2] = { ((VulkanSemaphore*)m_image_available_for_texturescopy_semaphores[m_current_frame_index])->getResource(),
                                      m_image_finished_for_presentation_semaphores[m_current_frame_index] };
 
-        // submit command buffer
-        VkPipelineStageFlags wait_stages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-        VkSubmitInfo         submit_info   = {};
-        submit_info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submit_info.waitSemaphoreCount     = 1;
-        submit_info.pWaitSemaphores        = &m_image_available_for_render_semaphores[m_current_frame_index];
-        submit_info.pWaitDstStageMask      = wait_stages;
-        submit_info.commandBufferCount     = 1;
-        submit_info.pCommandBuffers        = &m_vk_command_buffers[m_current_frame_index];
-        submit_info.signalSemaphoreCount = 2;
-        submit_info.pSignalSemaphores = semaphores;
-
         VkResult res_reset_fences = _vkResetFences(m_device, 1, &m_is_frame_in_flight_fences[m_current_frame_index]);
 
         if (VK_SUCCESS != res_reset_fences)
@@ -472,9 +511,28 @@ namespace Piccolo
             LOG_ERROR("_vkResetFences failed!");
             return;
         }
+
+        // the swapchain image first, then the work of the other queues read by this frame
+        m_rendering_wait_semaphores.insert(m_rendering_wait_semaphores.begin(),
+                                           m_image_available_for_render_semaphores[m_current_frame_index]);
+        m_rendering_wait_stages.insert(m_rendering_wait_stages.begin(), VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+
+        // submit command buffer
+        VkSubmitInfo submit_info           = {};
+        submit_info.sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.waitSemaphoreCount     = static_cast<uint32_t>(m_rendering_wait_semaphores.size());
+        submit_info.pWaitSemaphores        = m_rendering_wait_semaphores.data();
+        submit_info.pWaitDstStageMask      = m_rendering_wait_stages.data();
+        submit_info.commandBufferCount     = 1;
+        submit_info.pCommandBuffers        = &m_vk_command_buffers[m_current_frame_index];
+        submit_info.signalSemaphoreCount = 2;
+        submit_info.pSignalSemaphores = semaphores;
+
         VkResult res_queue_submit =
             vkQueueSubmit(((VulkanQueue*)m_graphics_queue)->getResource(), 1, &submit_info, m_is_frame_in_flight_fences[m_current_frame_index]);
-        
+        m_rendering_wait_semaphores.clear();
+        m_rendering_wait_stages.clear();
+
         if (VK_SUCCESS != res_queue_submit)
         {
             LOG_ERROR("vkQueueSubmit failed!");
@@ -593,6 +651,22 @@ namespace Piccolo
 
 #if defined(__MACH__)
         extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+        m_enable_physical_device_properties_2 = true;
+#else
+        // optional, the descriptor indexing support of the device is queried through it
+        uint32_t instance_extension_count = 0;
+        vkEnumerateInstanceExtensionProperties(nullptr, &instance_extension_count, nullptr);
+        std::vector<VkExtensionProperties> instance_extensions(instance_extension_count);
+        vkEnumerateInstanceExtensionProperties(nullptr, &instance_extension_count, instance_extensions.data());
+        for (const auto& extension : instance_extensions)
+        {
+            if (strcmp(extension.extensionName, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) == 0)
+            {
+                extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+                m_enable_physical_device_properties_2 = true;
+                break;
+            }
+        }
 #endif
 
         return extensions;
@@ -763,7 +837,8 @@ namespace Piccolo
         std::vector<VkDeviceQueueCreateInfo> queue_create_infos; // all queues that need to be created
         std::set<uint32_t>                   queue_families = {m_queue_indices.graphics_family.value(),
                                              m_queue_indices.present_family.value(),
-                                             m_queue_indices.m_compute_family.value()};
+                                             m_queue_indices.m_compute_family.value(),
+                                             m_queue_indices.m_transfer_family.value()};
 
         float queue_priority = 1.0f;
         for (uint32_t queue_family : queue_families) // for every queue family
@@ -794,14 +869,31 @@ namespace Piccolo
             physical_device_features.geometryShader = VK_TRUE;
         }
 
+        // support gpu driven rendering, optional since the draws can still be recorded on the cpu
+        VkPhysicalDeviceFeatures supported_features;
+        vkGetPhysicalDeviceFeatures(m_physical_device, &supported_features);
+        m_enable_draw_indirect_first_instance = (supported_features.drawIndirectFirstInstance == VK_TRUE);
+        physical_device_features.drawIndirectFirstInstance = supported_features.drawIndirectFirstInstance;
+
+        // support bindless materials, optional since the materials can still be bound one descriptor set at a time
+        std::vector<char const*>                      device_extensions = m_device_extensions;
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptor_indexing_features {};
+        m_enable_bindless = checkBindlessSupport(descriptor_indexing_features);
+        if (m_enable_bindless)
+        {
+            device_extensions.push_back(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+            device_extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+        }
+
         // device create info
         VkDeviceCreateInfo device_create_info {};
         device_create_info.sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        device_create_info.pNext                   = m_enable_bindless ? &descriptor_indexing_features : nullptr;
         device_create_info.pQueueCreateInfos       = queue_create_infos.data();
         device_create_info.queueCreateInfoCount    = static_cast<uint32_t>(queue_create_infos.size());
         device_create_info.pEnabledFeatures        = &physical_device_features;
-        device_create_info.enabledExtensionCount   = static_cast<uint32_t>(m_device_extensions.size());
-        device_create_info.ppEnabledExtensionNames = m_device_extensions.data();
+        device_create_info.enabledExtensionCount   = static_cast<uint32_t>(device_extensions.size());
+        device_create_info.ppEnabledExtensionNames = device_extensions.data();
         device_create_info.enabledLayerCount       = 0;
 
         if (vkCreateDevice(m_physical_device, &device_create_info, nullptr, &m_device) != VK_SUCCESS)
@@ -822,6 +914,12 @@ namespace Piccolo
         m_compute_queue = new VulkanQueue();
         ((VulkanQueue*)m_compute_queue)->setResource(vk_compute_queue);
 
+        // the only queue of its family unless the copies share the graphics queue
+        VkQueue vk_transfer_queue;
+        vkGetDeviceQueue(m_device, m_queue_indices.m_transfer_family.value(), 0, &vk_transfer_queue);
+        m_transfer_queue = new VulkanQueue();
+        ((VulkanQueue*)m_transfer_queue)->setResource(vk_transfer_queue);
+
         // more efficient pointer
         _vkResetCommandPool      = (PFN_vkResetCommandPool)vkGetDeviceProcAddr(m_device, "vkResetCommandPool");
         _vkBeginCommandBuffer    = (PFN_vkBeginCommandBuffer)vkGetDeviceProcAddr(m_device, "vkBeginCommandBuffer");
@@ -1387,7 +1485,7 @@ namespace Piccolo
 
         pPipelines = new VulkanPipeline();
         VkPipeline vk_pipelines;
-        VkPipelineCache vk_pipeline_cache = VK_NULL_HANDLE;
+        VkPipelineCache vk_pipeline_cache = m_vk_pipeline_cache;
         if (pipelineCache != nullptr)
         {
             vk_pipeline_cache = ((VulkanPipelineCache*)pipelineCache)->getResource();
@@ -1443,7 +1541,7 @@ namespace Piccolo
 
         pPipelines = new VulkanPipeline();
         VkPipeline vk_pipelines;
-        VkPipelineCache vk_pipeline_cache = VK_NULL_HANDLE;
+        VkPipelineCache vk_pipeline_cache = m_vk_pipeline_cache;
         if (pipelineCache != nullptr)
         {
             vk_pipeline_cache = ((VulkanPipelineCache*)pipelineCache)->getResource();
@@ -1714,18 +1812,12 @@ namespace Piccolo
 
     bool VulkanRHI::waitForFencesPFN(uint32_t fenceCount, RHIFence* const* pFences, RHIBool32 waitAll, uint64_t timeout)
     {
-        //fence
-        int fence_size = fenceCount;
-        std::vector<VkFence> vk_fence_list(fence_size);
-        for (int i = 0; i < fence_size; ++i)
-        {
-            const auto& rhi_fence_element = pFences[i];
-            auto& vk_fence_element = vk_fence_list[i];
+        VulkanScratchArena::Scope scratch_scope(VulkanScratchArena::get());
 
-            vk_fence_element = ((VulkanFence*)rhi_fence_element)->getResource();
-        };
+        //fence
+        const VkFence* vk_fence_list = translateHandles<VulkanFence, VkFence>(pFences, fenceCount);
 
-        VkResult result = _vkWaitForFences(m_device, fenceCount, vk_fence_list.data(), waitAll, timeout);
+        VkResult result = _vkWaitForFences(m_device, fenceCount, vk_fence_list, waitAll, timeout);
 
         if (result == VK_SUCCESS)
         {
@@ -1740,18 +1832,12 @@ namespace Piccolo
 
     bool VulkanRHI::resetFencesPFN(uint32_t fenceCount, RHIFence* const* pFences)
     {
-        //fence
-        int fence_size = fenceCount;
-        std::vector<VkFence> vk_fence_list(fence_size);
-        for (int i = 0; i < fence_size; ++i)
-        {
-            const auto& rhi_fence_element = pFences[i];
-            auto& vk_fence_element = vk_fence_list[i];
+        VulkanScratchArena::Scope scratch_scope(VulkanScratchArena::get());
 
-            vk_fence_element = ((VulkanFence*)rhi_fence_element)->getResource();
-        };
+        //fence
+        const VkFence* vk_fence_list = translateHandles<VulkanFence, VkFence>(pFences, fenceCount);
 
-        VkResult result = _vkResetFences(m_device, fenceCount, vk_fence_list.data());
+        VkResult result = _vkResetFences(m_device, fenceCount, vk_fence_list);
 
         if (result == VK_SUCCESS)
         {
@@ -1764,6 +1850,11 @@ namespace Piccolo
         }
     }
 
+    bool VulkanRHI::getFenceStatus(RHIFence* fence)
+    {
+        return vkGetFenceStatus(m_device, ((VulkanFence*)fence)->getResource()) == VK_SUCCESS;
+    }
+
     bool VulkanRHI::resetCommandPoolPFN(RHICommandPool* commandPool, RHICommandPoolResetFlags flags)
     {
         VkResult result = _vkResetCommandPool(m_device, ((VulkanCommandPool*)commandPool)->getResource(), (VkCommandPoolResetFlags)flags);
@@ -1832,57 +1923,14 @@ namespace Piccolo
 
     void VulkanRHI::cmdBeginRenderPassPFN(RHICommandBuffer* commandBuffer, const RHIRenderPassBeginInfo* pRenderPassBegin, RHISubpassContents contents)
     {
-        VkOffset2D offset_2d{};
-        offset_2d.x = pRenderPassBegin->renderArea.offset.x;
-        offset_2d.y = pRenderPassBegin->renderArea.offset.y;
-
-        VkExtent2D extent_2d{};
-        extent_2d.width = pRenderPassBegin->renderArea.extent.width;
-        extent_2d.height = pRenderPassBegin->renderArea.extent.height;
-
-        VkRect2D rect_2d{};
-        rect_2d.offset = offset_2d;
-        rect_2d.extent = extent_2d;
-
-        //clear_values
-        int clear_value_size = pRenderPassBegin->clearValueCount;
-        std::vector<VkClearValue> vk_clear_value_list(clear_value_size);
-        for (int i = 0; i < clear_value_size; ++i)
-        {
-            const auto& rhi_clear_value_element = pRenderPassBegin->pClearValues[i];
-            auto& vk_clear_value_element = vk_clear_value_list[i];
-
-            VkClearColorValue vk_clear_color_value;
-            vk_clear_color_value.float32[0] = rhi_clear_value_element.color.float32[0];
-            vk_clear_color_value.float32[1] = rhi_clear_value_element.color.float32[1];
-            vk_clear_color_value.float32[2] = rhi_clear_value_element.color.float32[2];
-            vk_clear_color_value.float32[3] = rhi_clear_value_element.color.float32[3];
-            vk_clear_color_value.int32[0] = rhi_clear_value_element.color.int32[0];
-            vk_clear_color_value.int32[1] = rhi_clear_value_element.color.int32[1];
-            vk_clear_color_value.int32[2] = rhi_clear_value_element.color.int32[2];
-            vk_clear_color_value.int32[3] = rhi_clear_value_element.color.int32[3];
-            vk_clear_color_value.uint32[0] = rhi_clear_value_element.color.uint32[0];
-            vk_clear_color_value.uint32[1] = rhi_clear_value_element.color.uint32[1];
-            vk_clear_color_value.uint32[2] = rhi_clear_value_element.color.uint32[2];
-            vk_clear_color_value.uint32[3] = rhi_clear_value_element.color.uint32[3];
-
-            VkClearDepthStencilValue vk_clear_depth_stencil_value;
-            vk_clear_depth_stencil_value.depth = rhi_clear_value_element.depthStencil.depth;
-            vk_clear_depth_stencil_value.stencil = rhi_clear_value_element.depthStencil.stencil;
-
-            vk_clear_value_element.color = vk_clear_color_value;
-            vk_clear_value_element.depthStencil = vk_clear_depth_stencil_value;
-
-        };
-
         VkRenderPassBeginInfo vk_render_pass_begin_info{};
         vk_render_pass_begin_info.sType = (VkStructureType)pRenderPassBegin->sType;
         vk_render_pass_begin_info.pNext = pRenderPassBegin->pNext;
         vk_render_pass_begin_info.renderPass = ((VulkanRenderPass*)pRenderPassBegin->renderPass)->getResource();
         vk_render_pass_begin_info.framebuffer = ((VulkanFramebuffer*)pRenderPassBegin->framebuffer)->getResource();
-        vk_render_pass_begin_info.renderArea = rect_2d;
+        vk_render_pass_begin_info.renderArea = *passThrough<VkRect2D>(&pRenderPassBegin->renderArea);
         vk_render_pass_begin_info.clearValueCount = pRenderPassBegin->clearValueCount;
-        vk_render_pass_begin_info.pClearValues = vk_clear_value_list.data();
+        vk_render_pass_begin_info.pClearValues = passThrough<VkClearValue>(pRenderPassBegin->pClearValues);
 
         return _vkCmdBeginRenderPass(((VulkanCommandBuffer*)commandBuffer)->getResource(), &vk_render_pass_begin_info, (VkSubpassContents)contents);
     }
@@ -1904,49 +1952,12 @@ namespace Piccolo
 
     void VulkanRHI::cmdSetViewportPFN(RHICommandBuffer* commandBuffer, uint32_t firstViewport, uint32_t viewportCount, const RHIViewport* pViewports)
     {
-        //viewport
-        int viewport_size = viewportCount;
-        std::vector<VkViewport> vk_viewport_list(viewport_size);
-        for (int i = 0; i < viewport_size; ++i)
-        {
-            const auto& rhi_viewport_element = pViewports[i];
-            auto& vk_viewport_element = vk_viewport_list[i];
-
-            vk_viewport_element.x = rhi_viewport_element.x;
-            vk_viewport_element.y = rhi_viewport_element.y;
-            vk_viewport_element.width = rhi_viewport_element.width;
-            vk_viewport_element.height = rhi_viewport_element.height;
-            vk_viewport_element.minDepth = rhi_viewport_element.minDepth;
-            vk_viewport_element.maxDepth = rhi_viewport_element.maxDepth;
-        };
-
-        return _vkCmdSetViewport(((VulkanCommandBuffer*)commandBuffer)->getResource(), firstViewport, viewportCount, vk_viewport_list.data());
+        return _vkCmdSetViewport(((VulkanCommandBuffer*)commandBuffer)->getResource(), firstViewport, viewportCount, passThrough<VkViewport>(pViewports));
     }
 
     void VulkanRHI::cmdSetScissorPFN(RHICommandBuffer* commandBuffer, uint32_t firstScissor, uint32_t scissorCount, const RHIRect2D* pScissors)
     {
-        //rect_2d
-        int rect_2d_size = scissorCount;
-        std::vector<VkRect2D> vk_rect_2d_list(rect_2d_size);
-        for (int i = 0; i < rect_2d_size; ++i)
-        {
-            const auto& rhi_rect_2d_element = pScissors[i];
-            auto& vk_rect_2d_element = vk_rect_2d_list[i];
-
-            VkOffset2D offset_2d{};
-            offset_2d.x = rhi_rect_2d_element.offset.x;
-            offset_2d.y = rhi_rect_2d_element.offset.y;
-
-            VkExtent2D extent_2d{};
-            extent_2d.width = rhi_rect_2d_element.extent.width;
-            extent_2d.height = rhi_rect_2d_element.extent.height;
-
-            vk_rect_2d_element.offset = (VkOffset2D)offset_2d;
-            vk_rect_2d_element.extent = (VkExtent2D)extent_2d;
-
-        };
-
-        return _vkCmdSetScissor(((VulkanCommandBuffer*)commandBuffer)->getResource(), firstScissor, scissorCount, vk_rect_2d_list.data());
+        return _vkCmdSetScissor(((VulkanCommandBuffer*)commandBuffer)->getResource(), firstScissor, scissorCount, passThrough<VkRect2D>(pScissors));
     }
 
     void VulkanRHI::cmdBindVertexBuffersPFN(
@@ -1956,29 +1967,12 @@ namespace Piccolo
         RHIBuffer* const* pBuffers,
         const RHIDeviceSize* pOffsets)
     {
-        //buffer
-        int buffer_size = bindingCount;
-        std::vector<VkBuffer> vk_buffer_list(buffer_size);
-        for (int i = 0; i < buffer_size; ++i)
-        {
-            const auto& rhi_buffer_element = pBuffers[i];
-            auto& vk_buffer_element = vk_buffer_list[i];
+        VulkanScratchArena::Scope scratch_scope(VulkanScratchArena::get());
 
-            vk_buffer_element = ((VulkanBuffer*)rhi_buffer_element)->getResource();
-        };
-
-        //offset
-        int offset_size = bindingCount;
-        std::vector<VkDeviceSize> vk_device_size_list(offset_size);
-        for (int i = 0; i < offset_size; ++i)
-        {
-            const auto& rhi_offset_element = pOffsets[i];
-            auto& vk_offset_element = vk_device_size_list[i];
-
-            vk_offset_element = rhi_offset_element;
-        };
+        //buffer
+        const VkBuffer* vk_buffer_list = translateHandles<VulkanBuffer, VkBuffer>(pBuffers, bindingCount);
 
-        return _vkCmdBindVertexBuffers(((VulkanCommandBuffer*)commandBuffer)->getResource(), firstBinding, bindingCount, vk_buffer_list.data(), vk_device_size_list.data());
+        return _vkCmdBindVertexBuffers(((VulkanCommandBuffer*)commandBuffer)->getResource(), firstBinding, bindingCount, vk_buffer_list, passThrough<VkDeviceSize>(pOffsets));
     }
 
     void VulkanRHI::cmdBindIndexBufferPFN(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, RHIIndexType indexType)
@@ -1996,36 +1990,20 @@ namespace Piccolo
         uint32_t dynamicOffsetCount,
         const uint32_t* pDynamicOffsets)
     {
-        //descriptor_set
-        int descriptor_set_size = descriptorSetCount;
-        std::vector<VkDescriptorSet> vk_descriptor_set_list(descriptor_set_size);
-        for (int i = 0; i < descriptor_set_size; ++i)
-        {
-            const auto& rhi_descriptor_set_element = pDescriptorSets[i];
-            auto& vk_descriptor_set_element = vk_descriptor_set_list[i];
+        VulkanScratchArena::Scope scratch_scope(VulkanScratchArena::get());
 
-            vk_descriptor_set_element = ((VulkanDescriptorSet*)rhi_descriptor_set_element)->getResource();
-        };
-
-        //offset
-        int offset_size = dynamicOffsetCount;
-        std::vector<uint32_t> vk_offset_list(offset_size);
-        for (int i = 0; i < offset_size; ++i)
-        {
-            const auto& rhi_offset_element = pDynamicOffsets[i];
-            auto& vk_offset_element = vk_offset_list[i];
-
-            vk_offset_element = rhi_offset_element;
-        };
+        //descriptor_set
+        const VkDescriptorSet* vk_descriptor_set_list =
+            translateHandles<VulkanDescriptorSet, VkDescriptorSet>(pDescriptorSets, descriptorSetCount);
 
         return _vkCmdBindDescriptorSets(
             ((VulkanCommandBuffer*)commandBuffer)->getResource(),
             (VkPipelineBindPoint)pipelineBindPoint,
             ((VulkanPipelineLayout*)layout)->getResource(),
             firstSet, descriptorSetCount,
-            vk_descriptor_set_list.data(),
+            vk_descriptor_set_list,
             dynamicOffsetCount,
-            vk_offset_list.data());
+            pDynamicOffsets);
     }
 
     void VulkanRHI::cmdDrawIndexedPFN(RHICommandBuffer* commandBuffer, uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
@@ -2040,66 +2018,12 @@ namespace Piccolo
         uint32_t rectCount,
         const RHIClearRect* pRects)
     {
-        //clear_attachment
-        int clear_attachment_size = attachmentCount;
-        std::vector<VkClearAttachment> vk_clear_attachment_list(clear_attachment_size);
-        for (int i = 0; i < clear_attachment_size; ++i)
-        {
-            const auto& rhi_clear_attachment_element = pAttachments[i];
-            auto& vk_clear_attachment_element = vk_clear_attachment_list[i];
-
-            VkClearColorValue vk_clear_color_value;
-            vk_clear_color_value.float32[0] = rhi_clear_attachment_element.clearValue.color.float32[0];
-            vk_clear_color_value.float32[1] = rhi_clear_attachment_element.clearValue.color.float32[1];
-            vk_clear_color_value.float32[2] = rhi_clear_attachment_element.clearValue.color.float32[2];
-            vk_clear_color_value.float32[3] = rhi_clear_attachment_element.clearValue.color.float32[3];
-            vk_clear_color_value.int32[0] = rhi_clear_attachment_element.clearValue.color.int32[0];
-            vk_clear_color_value.int32[1] = rhi_clear_attachment_element.clearValue.color.int32[1];
-            vk_clear_color_value.int32[2] = rhi_clear_attachment_element.clearValue.color.int32[2];
-            vk_clear_color_value.int32[3] = rhi_clear_attachment_element.clearValue.color.int32[3];
-            vk_clear_color_value.uint32[0] = rhi_clear_attachment_element.clearValue.color.uint32[0];
-            vk_clear_color_value.uint32[1] = rhi_clear_attachment_element.clearValue.color.uint32[1];
-            vk_clear_color_value.uint32[2] = rhi_clear_attachment_element.clearValue.color.uint32[2];
-            vk_clear_color_value.uint32[3] = rhi_clear_attachment_element.clearValue.color.uint32[3];
-
-            VkClearDepthStencilValue vk_clear_depth_stencil_value;
-            vk_clear_depth_stencil_value.depth = rhi_clear_attachment_element.clearValue.depthStencil.depth;
-            vk_clear_depth_stencil_value.stencil = rhi_clear_attachment_element.clearValue.depthStencil.stencil;
-
-            vk_clear_attachment_element.clearValue.color = vk_clear_color_value;
-            vk_clear_attachment_element.clearValue.depthStencil = vk_clear_depth_stencil_value;
-            vk_clear_attachment_element.aspectMask = rhi_clear_attachment_element.aspectMask;
-            vk_clear_attachment_element.colorAttachment = rhi_clear_attachment_element.colorAttachment;
-        };
-
-        //clear_rect
-        int clear_rect_size = rectCount;
-        std::vector<VkClearRect> vk_clear_rect_list(clear_rect_size);
-        for (int i = 0; i < clear_rect_size; ++i)
-        {
-            const auto& rhi_clear_rect_element = pRects[i];
-            auto& vk_clear_rect_element = vk_clear_rect_list[i];
-
-            VkOffset2D offset_2d{};
-            offset_2d.x = rhi_clear_rect_element.rect.offset.x;
-            offset_2d.y = rhi_clear_rect_element.rect.offset.y;
-
-            VkExtent2D extent_2d{};
-            extent_2d.width = rhi_clear_rect_element.rect.extent.width;
-            extent_2d.height = rhi_clear_rect_element.rect.extent.height;
-
-            vk_clear_rect_element.rect.offset = (VkOffset2D)offset_2d;
-            vk_clear_rect_element.rect.extent = (VkExtent2D)extent_2d;
-            vk_clear_rect_element.baseArrayLayer = rhi_clear_rect_element.baseArrayLayer;
-            vk_clear_rect_element.layerCount = rhi_clear_rect_element.layerCount;
-        };
-
         return _vkCmdClearAttachments(
             ((VulkanCommandBuffer*)commandBuffer)->getResource(),
             attachmentCount,
-            vk_clear_attachment_list.data(),
+            passThrough<VkClearAttachment>(pAttachments),
             rectCount,
-            vk_clear_rect_list.data());
+            passThrough<VkClearRect>(pRects));
     }
 
     bool VulkanRHI::beginCommandBuffer(RHICommandBuffer* commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo)
@@ -2160,9 +2084,12 @@ namespace Piccolo
         uint32_t descriptorCopyCount,
         const RHICopyDescriptorSet* pDescriptorCopies)
     {
+        VulkanScratchArena& scratch_arena = VulkanScratchArena::get();
+        VulkanScratchArena::Scope scratch_scope(scratch_arena);
+
         //write_descriptor_set
         int write_descriptor_set_size = descriptorWriteCount;
-        std::vector<VkWriteDescriptorSet> vk_write_descriptor_set_list(write_descriptor_set_size);
+        VkWriteDescriptorSet* vk_write_descriptor_set_list = scratch_arena.allocate<VkWriteDescriptorSet>(write_descriptor_set_size);
         int image_info_count = 0;
         int buffer_info_count = 0;
         for (int i = 0; i < write_descriptor_set_size; ++i)
@@ -2177,8 +2104,8 @@ namespace Piccolo
                 buffer_info_count++;
             }
         }
-        std::vector<VkDescriptorImageInfo> vk_descriptor_image_info_list(image_info_count);
-        std::vector<VkDescriptorBufferInfo> vk_descriptor_buffer_info_list(buffer_info_count);
+        VkDescriptorImageInfo* vk_descriptor_image_info_list = scratch_arena.allocate<VkDescriptorImageInfo>(image_info_count);
+        VkDescriptorBufferInfo* vk_descriptor_buffer_info_list = scratch_arena.allocate<VkDescriptorBufferInfo>(buffer_info_count);
         int image_info_current = 0;
         int buffer_info_current = 0;
 
@@ -2239,7 +2166,7 @@ namespace Piccolo
 
         //copy_descriptor_set
         int copy_descriptor_set_size = descriptorCopyCount;
-        std::vector<VkCopyDescriptorSet> vk_copy_descriptor_set_list(copy_descriptor_set_size);
+        VkCopyDescriptorSet* vk_copy_descriptor_set_list = scratch_arena.allocate<VkCopyDescriptorSet>(copy_descriptor_set_size);
         for (int i = 0; i < copy_descriptor_set_size; ++i)
         {
             const auto& rhi_copy_descriptor_set_element = pDescriptorCopies[i];
@@ -2256,11 +2183,14 @@ namespace Piccolo
             vk_copy_descriptor_set_element.descriptorCount = rhi_copy_descriptor_set_element.descriptorCount;
         };
 
-        vkUpdateDescriptorSets(m_device, descriptorWriteCount, vk_write_descriptor_set_list.data(), descriptorCopyCount, vk_copy_descriptor_set_list.data());
+        vkUpdateDescriptorSets(m_device, descriptorWriteCount, vk_write_descriptor_set_list, descriptorCopyCount, vk_copy_descriptor_set_list);
     }
 
     bool VulkanRHI::queueSubmit(RHIQueue* queue, uint32_t submitCount, const RHISubmitInfo* pSubmits, RHIFence* fence)
     {
+        VulkanScratchArena& scratch_arena = VulkanScratchArena::get();
+        VulkanScratchArena::Scope scratch_scope(scratch_arena);
+
         //submit_info
         int command_buffer_size_total = 0;
         int semaphore_size_total = 0;
@@ -2276,10 +2206,10 @@ namespace Piccolo
             signal_semaphore_size_total += rhi_submit_info_element.signalSemaphoreCount;
             pipeline_stage_flags_size_total += rhi_submit_info_element.waitSemaphoreCount;
         }
-        std::vector<VkCommandBuffer> vk_command_buffer_list_external(command_buffer_size_total);
-        std::vector<VkSemaphore> vk_semaphore_list_external(semaphore_size_total);
-        std::vector<VkSemaphore> vk_signal_semaphore_list_external(signal_semaphore_size_total);
-        std::vector<VkPipelineStageFlags> vk_pipeline_stage_flags_list_external(pipeline_stage_flags_size_total);
+        VkCommandBuffer* vk_command_buffer_list_external = scratch_arena.allocate<VkCommandBuffer>(command_buffer_size_total);
+        VkSemaphore* vk_semaphore_list_external = scratch_arena.allocate<VkSemaphore>(semaphore_size_total);
+        VkSemaphore* vk_signal_semaphore_list_external = scratch_arena.allocate<VkSemaphore>(signal_semaphore_size_total);
+        VkPipelineStageFlags* vk_pipeline_stage_flags_list_external = scratch_arena.allocate<VkPipelineStageFlags>(pipeline_stage_flags_size_total);
 
         int command_buffer_size_current = 0;
         int semaphore_size_current = 0;
@@ -2287,7 +2217,7 @@ namespace Piccolo
         int pipeline_stage_flags_size_current = 0;
 
 
-        std::vector<VkSubmitInfo> vk_submit_info_list(submit_info_size);
+        VkSubmitInfo* vk_submit_info_list = scratch_arena.allocate<VkSubmitInfo>(submit_info_size);
         for (int i = 0; i < submit_info_size; ++i)
         {
             const auto& rhi_submit_info_element = pSubmits[i];
@@ -2380,7 +2310,7 @@ namespace Piccolo
             vk_fence = ((VulkanFence*)fence)->getResource();
         }
 
-        VkResult result = vkQueueSubmit(((VulkanQueue*)queue)->getResource(), submitCount, vk_submit_info_list.data(), vk_fence);
+        VkResult result = vkQueueSubmit(((VulkanQueue*)queue)->getResource(), submitCount, vk_submit_info_list, vk_fence);
 
         if (result == VK_SUCCESS)
         {
@@ -2419,25 +2349,12 @@ namespace Piccolo
         uint32_t imageMemoryBarrierCount,
         const RHIImageMemoryBarrier* pImageMemoryBarriers)
     {
-
-        //memory_barrier
-        int memory_barrier_size = memoryBarrierCount;
-        std::vector<VkMemoryBarrier> vk_memory_barrier_list(memory_barrier_size);
-        for (int i = 0; i < memory_barrier_size; ++i)
-        {
-            const auto& rhi_memory_barrier_element = pMemoryBarriers[i];
-            auto& vk_memory_barrier_element = vk_memory_barrier_list[i];
-
-
-            vk_memory_barrier_element.sType = (VkStructureType)rhi_memory_barrier_element.sType;
-            vk_memory_barrier_element.pNext = (const void*)rhi_memory_barrier_element.pNext;
-            vk_memory_barrier_element.srcAccessMask = (VkAccessFlags)rhi_memory_barrier_element.srcAccessMask;
-            vk_memory_barrier_element.dstAccessMask = (VkAccessFlags)rhi_memory_barrier_element.dstAccessMask;
-        };
+        VulkanScratchArena& scratch_arena = VulkanScratchArena::get();
+        VulkanScratchArena::Scope scratch_scope(scratch_arena);
 
         //buffer_memory_barrier
         int buffer_memory_barrier_size = bufferMemoryBarrierCount;
-        std::vector<VkBufferMemoryBarrier> vk_buffer_memory_barrier_list(buffer_memory_barrier_size);
+        VkBufferMemoryBarrier* vk_buffer_memory_barrier_list = scratch_arena.allocate<VkBufferMemoryBarrier>(buffer_memory_barrier_size);
         for (int i = 0; i < buffer_memory_barrier_size; ++i)
         {
             const auto& rhi_buffer_memory_barrier_element = pBufferMemoryBarriers[i];
@@ -2456,7 +2373,7 @@ namespace Piccolo
 
         //image_memory_barrier
         int image_memory_barrier_size = imageMemoryBarrierCount;
-        std::vector<VkImageMemoryBarrier> vk_image_memory_barrier_list(image_memory_barrier_size);
+        VkImageMemoryBarrier* vk_image_memory_barrier_list = scratch_arena.allocate<VkImageMemoryBarrier>(image_memory_barrier_size);
         for (int i = 0; i < image_memory_barrier_size; ++i)
         {
             const auto& rhi_image_memory_barrier_element = pImageMemoryBarriers[i];
@@ -2487,11 +2404,11 @@ namespace Piccolo
             (RHIPipelineStageFlags)dstStageMask,
             (RHIDependencyFlags)dependencyFlags,
             memoryBarrierCount,
-            vk_memory_barrier_list.data(),
+            passThrough<VkMemoryBarrier>(pMemoryBarriers),
             bufferMemoryBarrierCount,
-            vk_buffer_memory_barrier_list.data(),
+            vk_buffer_memory_barrier_list,
             imageMemoryBarrierCount,
-            vk_image_memory_barrier_list.data());
+            vk_image_memory_barrier_list);
     }
 
     void VulkanRHI::cmdDraw(RHICommandBuffer* commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
@@ -2509,6 +2426,16 @@ namespace Piccolo
         vkCmdDispatchIndirect(((VulkanCommandBuffer*)commandBuffer)->getResource(), ((VulkanBuffer*)buffer)->getResource(), offset);
     }
 
+    void VulkanRHI::cmdDrawIndexedIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride)
+    {
+        vkCmdDrawIndexedIndirect(((VulkanCommandBuffer*)commandBuffer)->getResource(), ((VulkanBuffer*)buffer)->getResource(), offset, drawCount, stride);
+    }
+
+    void VulkanRHI::cmdDrawIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride)
+    {
+        vkCmdDrawIndirect(((VulkanCommandBuffer*)commandBuffer)->getResource(), ((VulkanBuffer*)buffer)->getResource(), offset, drawCount, stride);
+    }
+
     void VulkanRHI::cmdCopyImageToBuffer(
         RHICommandBuffer* commandBuffer,
         RHIImage* srcImage,
@@ -2517,53 +2444,30 @@ namespace Piccolo
         uint32_t regionCount,
         const RHIBufferImageCopy* pRegions)
     {
-        //buffer_image_copy
-        int buffer_image_copy_size = regionCount;
-        std::vector<VkBufferImageCopy> vk_buffer_image_copy_list(buffer_image_copy_size);
-        for (int i = 0; i < buffer_image_copy_size; ++i)
-        {
-            const auto& rhi_buffer_image_copy_element = pRegions[i];
-            auto& vk_buffer_image_copy_element = vk_buffer_image_copy_list[i];
-
-            VkImageSubresourceLayers image_subresource_layers{};
-            image_subresource_layers.aspectMask = (VkImageAspectFlags)rhi_buffer_image_copy_element.imageSubresource.aspectMask;
-            image_subresource_layers.mipLevel = rhi_buffer_image_copy_element.imageSubresource.mipLevel;
-            image_subresource_layers.baseArrayLayer = rhi_buffer_image_copy_element.imageSubresource.baseArrayLayer;
-            image_subresource_layers.layerCount = rhi_buffer_image_copy_element.imageSubresource.layerCount;
-
-            VkOffset3D offset_3d{};
-            offset_3d.x = rhi_buffer_image_copy_element.imageOffset.x;
-            offset_3d.y = rhi_buffer_image_copy_element.imageOffset.y;
-            offset_3d.z = rhi_buffer_image_copy_element.imageOffset.z;
-
-            VkExtent3D extent_3d{};
-            extent_3d.width = rhi_buffer_image_copy_element.imageExtent.width;
-            extent_3d.height = rhi_buffer_image_copy_element.imageExtent.height;
-            extent_3d.depth = rhi_buffer_image_copy_element.imageExtent.depth;
-
-            VkBufferImageCopy buffer_image_copy{};
-            buffer_image_copy.bufferOffset = (VkDeviceSize)rhi_buffer_image_copy_element.bufferOffset;
-            buffer_image_copy.bufferRowLength = rhi_buffer_image_copy_element.bufferRowLength;
-            buffer_image_copy.bufferImageHeight = rhi_buffer_image_copy_element.bufferImageHeight;
-            buffer_image_copy.imageSubresource = image_subresource_layers;
-            buffer_image_copy.imageOffset = offset_3d;
-            buffer_image_copy.imageExtent = extent_3d;
-
-            vk_buffer_image_copy_element.bufferOffset = (VkDeviceSize)rhi_buffer_image_copy_element.bufferOffset;
-            vk_buffer_image_copy_element.bufferRowLength = rhi_buffer_image_copy_element.bufferRowLength;
-            vk_buffer_image_copy_element.bufferImageHeight = rhi_buffer_image_copy_element.bufferImageHeight;
-            vk_buffer_image_copy_element.imageSubresource = image_subresource_layers;
-            vk_buffer_image_copy_element.imageOffset = offset_3d;
-            vk_buffer_image_copy_element.imageExtent = extent_3d;
-        };
-
         vkCmdCopyImageToBuffer(
             ((VulkanCommandBuffer*)commandBuffer)->getResource(),
             ((VulkanImage*)srcImage)->getResource(),
             (VkImageLayout)srcImageLayout,
             ((VulkanBuffer*)dstBuffer)->getResource(),
             regionCount,
-            vk_buffer_image_copy_list.data());
+            passThrough<VkBufferImageCopy>(pRegions));
+    }
+
+    void VulkanRHI::cmdCopyBufferToImage(
+        RHICommandBuffer* commandBuffer,
+        RHIBuffer* srcBuffer,
+        RHIImage* dstImage,
+        RHIImageLayout dstImageLayout,
+        uint32_t regionCount,
+        const RHIBufferImageCopy* pRegions)
+    {
+        vkCmdCopyBufferToImage(
+            ((VulkanCommandBuffer*)commandBuffer)->getResource(),
+            ((VulkanBuffer*)srcBuffer)->getResource(),
+            ((VulkanImage*)dstImage)->getResource(),
+            (VkImageLayout)dstImageLayout,
+            regionCount,
+            passThrough<VkBufferImageCopy>(pRegions));
     }
 
     void VulkanRHI::cmdCopyImageToImage(RHICommandBuffer* commandBuffer, RHIImage* srcImage, RHIImageAspectFlagBits srcFlag, RHIImage* dstImage, RHIImageAspectFlagBits dstFlag, uint32_t width, uint32_t height)
@@ -2586,16 +2490,11 @@ namespace Piccolo
 
     void VulkanRHI::cmdCopyBuffer(RHICommandBuffer* commandBuffer, RHIBuffer* srcBuffer, RHIBuffer* dstBuffer, uint32_t regionCount, RHIBufferCopy* pRegions)
     {
-        VkBufferCopy copyRegion{};
-        copyRegion.srcOffset = pRegions->srcOffset;
-        copyRegion.dstOffset = pRegions->dstOffset;
-        copyRegion.size = pRegions->size;
-
         vkCmdCopyBuffer(((VulkanCommandBuffer*)commandBuffer)->getResource(),
             ((VulkanBuffer*)srcBuffer)->getResource(),
             ((VulkanBuffer*)dstBuffer)->getResource(),
             regionCount,
-            &copyRegion);
+            passThrough<VkBufferCopy>(pRegions));
     }
 
     void VulkanRHI::createCommandBuffers()
@@ -2627,13 +2526,14 @@ namespace Piccolo
 
         VkDescriptorPoolSize pool_sizes[7];
         pool_sizes[0].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
-        pool_sizes[0].descriptorCount = 3 + 2 + 2 + 2 + 1 + 1 + 3 + 3;
+        pool_sizes[0].descriptorCount = 3 + 2 + 2 + 2 + 1 + 1 + 3 + 3 + 2 + 2; // +mesh instance culling +mesh skinning
         pool_sizes[1].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        pool_sizes[1].descriptorCount = 1 + 1 + 1 * m_max_vertex_blending_mesh_count;
+        pool_sizes[1].descriptorCount = 1 + 1 + 1 * m_max_vertex_blending_mesh_count + 2 + 2 + 3 + 2 +
+                                        3 * m_max_vertex_blending_mesh_count; // +mesh instance +mesh skinning
         pool_sizes[2].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        pool_sizes[2].descriptorCount = 1 * m_max_material_count;
+        pool_sizes[2].descriptorCount = 2 * m_max_material_count;
         pool_sizes[3].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        pool_sizes[3].descriptorCount = 3 + 5 * m_max_material_count + 1 + 1; // ImGui_ImplVulkan_CreateDeviceObjects
+        pool_sizes[3].descriptorCount = 3 + 2 * 5 * m_max_material_count + 1 + 1; // ImGui_ImplVulkan_CreateDeviceObjects
         pool_sizes[4].type            = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
         pool_sizes[4].descriptorCount = 4 + 1 + 1 + 2;
         pool_sizes[5].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
@@ -2645,9 +2545,12 @@ namespace Piccolo
         pool_info.sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         pool_info.poolSizeCount = sizeof(pool_sizes) / sizeof(pool_sizes[0]);
         pool_info.pPoolSizes    = pool_sizes;
-        pool_info.maxSets =
-            1 + 1 + 1 + m_max_material_count + m_max_vertex_blending_mesh_count + 1 + 1; // +skybox + axis descriptor set
-        pool_info.flags = 0U;
+        // a streamed material allocates a second set once its textures are resident, see TextureStreamer
+        // +skybox + axis + mesh instance culling + mesh instance descriptor set + mesh skinning per frame and per mesh
+        pool_info.maxSets = 1 + 1 + 1 + 2 * m_max_material_count + m_max_vertex_blending_mesh_count + 1 + 1 + 2 + 1 +
+                            m_max_vertex_blending_mesh_count;
+        // the sets replaced by the streamed materials are freed back to the pool
+        pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
 
         if (vkCreateDescriptorPool(m_device, &pool_info, nullptr, &m_vk_descriptor_pool) != VK_SUCCESS)
         {
@@ -2930,6 +2833,54 @@ namespace Piccolo
         ((VulkanImageView*)image_view)->setResource(vk_image_view);
     }
 
+    void VulkanRHI::createSampledImage(RHIImage* &image, RHIImageView* &image_view, VmaAllocation& image_allocation, uint32_t texture_image_width, uint32_t texture_image_height, RHIFormat texture_image_format, uint32_t miplevels)
+    {
+        VkImageCreateInfo image_create_info {};
+        image_create_info.sType         = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        image_create_info.flags         = 0;
+        image_create_info.imageType     = VK_IMAGE_TYPE_2D;
+        image_create_info.extent.width  = texture_image_width;
+        image_create_info.extent.height = texture_image_height;
+        image_create_info.extent.depth  = 1;
+        image_create_info.mipLevels     = miplevels;
+        image_create_info.arrayLayers   = 1;
+        image_create_info.format        = (VkFormat)texture_image_format;
+        image_create_info.tiling        = VK_IMAGE_TILING_OPTIMAL;
+        image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        image_create_info.usage         = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        image_create_info.samples       = VK_SAMPLE_COUNT_1_BIT;
+        image_create_info.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+
+        // filled by the transfer queue and sampled by the graphics queue without any ownership transfer
+        uint32_t queue_family_indices[] = {m_queue_indices.graphics_family.value(),
+                                           m_queue_indices.m_transfer_family.value()};
+        if (queue_family_indices[0] != queue_family_indices[1])
+        {
+            image_create_info.sharingMode           = VK_SHARING_MODE_CONCURRENT;
+            image_create_info.queueFamilyIndexCount = 2;
+            image_create_info.pQueueFamilyIndices   = queue_family_indices;
+        }
+
+        VmaAllocationCreateInfo allocInfo = {};
+        allocInfo.usage                   = VMA_MEMORY_USAGE_GPU_ONLY;
+
+        VkImage vk_image;
+        vmaCreateImage(m_assets_allocator, &image_create_info, &allocInfo, &vk_image, &image_allocation, NULL);
+
+        VkImageView vk_image_view = VulkanUtil::createImageView(m_device,
+                                                                vk_image,
+                                                                (VkFormat)texture_image_format,
+                                                                VK_IMAGE_ASPECT_COLOR_BIT,
+                                                                VK_IMAGE_VIEW_TYPE_2D,
+                                                                1,
+                                                                miplevels);
+
+        image = new VulkanImage();
+        image_view = new VulkanImageView();
+        ((VulkanImage*)image)->setResource(vk_image);
+        ((VulkanImageView*)image_view)->setResource(vk_image_view);
+    }
+
     void VulkanRHI::createCubeMap(RHIImage* &image, RHIImageView* &image_view, VmaAllocation& image_allocation, uint32_t texture_image_width, uint32_t texture_image_height, std::array<void*, 6> texture_image_pixels, RHIFormat texture_image_format, uint32_t miplevels)
     {
         VkImage vk_image;
@@ -2979,30 +2930,125 @@ namespace Piccolo
         vmaCreateAllocator(&allocatorCreateInfo, &m_assets_allocator);
     }
 
-    // todo : more descriptorSet
-    bool VulkanRHI::allocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* &pDescriptorSets)
+    void VulkanRHI::createPipelineCache(const std::filesystem::path& pipeline_cache_folder)
     {
-        //descriptor_set_layout
-        int descriptor_set_layout_size = pAllocateInfo->descriptorSetCount;
-        std::vector<VkDescriptorSetLayout> vk_descriptor_set_layout_list(descriptor_set_layout_size);
-        for (int i = 0; i < descriptor_set_layout_size; ++i)
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(m_physical_device, &properties);
+
+        // one file per device and driver, the data another driver wrote is never handed to this one
+        std::vector<char> cache_data;
+        if (!pipeline_cache_folder.empty())
         {
-            const auto& rhi_descriptor_set_layout_element = pAllocateInfo->pSetLayouts[i];
-            auto& vk_descriptor_set_layout_element = vk_descriptor_set_layout_list[i];
+            char cache_uuid[VK_UUID_SIZE * 2 + 1] {};
+            for (uint32_t i = 0; i < VK_UUID_SIZE; ++i)
+            {
+                snprintf(&cache_uuid[i * 2], 3, "%02x", properties.pipelineCacheUUID[i]);
+            }
+            m_pipeline_cache_path = pipeline_cache_folder / (std::string("pipeline_cache_") + cache_uuid + ".bin");
 
-            vk_descriptor_set_layout_element = ((VulkanDescriptorSetLayout*)rhi_descriptor_set_layout_element)->getResource();
+            std::ifstream cache_file(m_pipeline_cache_path, std::ios::binary | std::ios::ate);
+            if (cache_file)
+            {
+                cache_data.resize(static_cast<size_t>(cache_file.tellg()));
+                cache_file.seekg(0);
+                cache_file.read(cache_data.data(), static_cast<std::streamsize>(cache_data.size()));
+                if (!cache_file)
+                {
+                    cache_data.clear();
+                }
+            }
+        }
 
-            VulkanDescriptorSetLayout* test = ((VulkanDescriptorSetLayout*)rhi_descriptor_set_layout_element);
+        // some drivers don't validate the data themselves
+        VkPipelineCacheHeaderVersionOne header {};
+        if (cache_data.size() >= sizeof(header))
+        {
+            std::memcpy(&header, cache_data.data(), sizeof(header));
+        }
+        if (header.headerSize < sizeof(header) || header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+            header.vendorID != properties.vendorID || header.deviceID != properties.deviceID ||
+            std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+        {
+            cache_data.clear();
+        }
 
-            test = nullptr;
-        };
+        VkPipelineCacheCreateInfo create_info {};
+        create_info.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        create_info.initialDataSize = cache_data.size();
+        create_info.pInitialData    = cache_data.data();
+        if (vkCreatePipelineCache(m_device, &create_info, nullptr, &m_vk_pipeline_cache) != VK_SUCCESS &&
+            !cache_data.empty())
+        {
+            LOG_WARN("pipeline cache {} rejected by the driver", m_pipeline_cache_path.generic_string());
+
+            create_info.initialDataSize = 0;
+            create_info.pInitialData    = nullptr;
+            if (vkCreatePipelineCache(m_device, &create_info, nullptr, &m_vk_pipeline_cache) != VK_SUCCESS)
+            {
+                // the pipelines are then created without a cache
+                LOG_ERROR("vkCreatePipelineCache failed!");
+                m_vk_pipeline_cache = VK_NULL_HANDLE;
+            }
+        }
+    }
+
+    void VulkanRHI::savePipelineCache()
+    {
+        if (m_vk_pipeline_cache == VK_NULL_HANDLE || m_pipeline_cache_path.empty())
+            return;
+
+        size_t data_size = 0;
+        vkGetPipelineCacheData(m_device, m_vk_pipeline_cache, &data_size, nullptr);
+        std::vector<char> cache_data(data_size);
+        if (data_size == 0 ||
+            vkGetPipelineCacheData(m_device, m_vk_pipeline_cache, &data_size, cache_data.data()) != VK_SUCCESS)
+        {
+            return;
+        }
+
+        // write next to the final file and swap, an interrupted save leaves the previous cache
+        std::error_code error;
+        std::filesystem::create_directories(m_pipeline_cache_path.parent_path(), error);
+        std::filesystem::path temp_path = m_pipeline_cache_path;
+        temp_path += ".tmp";
+        {
+            std::ofstream cache_file(temp_path, std::ios::binary | std::ios::trunc);
+            if (!cache_file)
+            {
+                LOG_WARN("open file {} failed!", temp_path.generic_string());
+                return;
+            }
+            cache_file.write(cache_data.data(), static_cast<std::streamsize>(data_size));
+            if (!cache_file)
+            {
+                LOG_WARN("write file {} failed!", temp_path.generic_string());
+                return;
+            }
+        }
+
+        std::filesystem::rename(temp_path, m_pipeline_cache_path, error);
+        if (error)
+        {
+            LOG_WARN("replace file {} failed: {}", m_pipeline_cache_path.generic_string(), error.message());
+            std::filesystem::remove(temp_path, error);
+        }
+    }
+
+    // todo : more descriptorSet
+    bool VulkanRHI::allocateDescriptorSets(const RHIDescriptorSetAllocateInfo* pAllocateInfo, RHIDescriptorSet* &pDescriptorSets)
+    {
+        VulkanScratchArena::Scope scratch_scope(VulkanScratchArena::get());
+
+        //descriptor_set_layout
+        const VkDescriptorSetLayout* vk_descriptor_set_layout_list = translateHandles<VulkanDescriptorSetLayout, VkDescriptorSetLayout>(
+            pAllocateInfo->pSetLayouts, pAllocateInfo->descriptorSetCount);
 
         VkDescriptorSetAllocateInfo descriptorset_allocate_info{};
         descriptorset_allocate_info.sType = (VkStructureType)pAllocateInfo->sType;
         descriptorset_allocate_info.pNext = (const void*)pAllocateInfo->pNext;
         descriptorset_allocate_info.descriptorPool = ((VulkanDescriptorPool*)(pAllocateInfo->descriptorPool))->getResource();
         descriptorset_allocate_info.descriptorSetCount = pAllocateInfo->descriptorSetCount;
-        descriptorset_allocate_info.pSetLayouts = vk_descriptor_set_layout_list.data();
+        descriptorset_allocate_info.pSetLayouts = vk_descriptor_set_layout_list;
 
         VkDescriptorSet vk_descriptor_set;
         pDescriptorSets = new VulkanDescriptorSet;
@@ -3208,12 +3254,32 @@ namespace Piccolo
         RHI_DELETE_PTR(buffer);
     }
 
+    void VulkanRHI::destroyDescriptorSetLayout(RHIDescriptorSetLayout* &descriptorSetLayout)
+    {
+        vkDestroyDescriptorSetLayout(
+            m_device, ((VulkanDescriptorSetLayout*)descriptorSetLayout)->getResource(), nullptr);
+        RHI_DELETE_PTR(descriptorSetLayout);
+    }
+
+    void VulkanRHI::destroyDescriptorPool(RHIDescriptorPool* &descriptorPool)
+    {
+        vkDestroyDescriptorPool(m_device, ((VulkanDescriptorPool*)descriptorPool)->getResource(), nullptr);
+        RHI_DELETE_PTR(descriptorPool);
+    }
+
     void VulkanRHI::freeCommandBuffers(RHICommandPool* commandPool, uint32_t commandBufferCount, RHICommandBuffer* pCommandBuffers)
     {
         VkCommandBuffer vk_command_buffer = ((VulkanCommandBuffer*)pCommandBuffers)->getResource();
         vkFreeCommandBuffers(m_device, ((VulkanCommandPool*)commandPool)->getResource(), commandBufferCount, &vk_command_buffer);
     }
 
+    void VulkanRHI::freeDescriptorSet(RHIDescriptorPool* descriptorPool, RHIDescriptorSet* &descriptorSet)
+    {
+        VkDescriptorSet vk_descriptor_set = ((VulkanDescriptorSet*)descriptorSet)->getResource();
+        vkFreeDescriptorSets(m_device, ((VulkanDescriptorPool*)descriptorPool)->getResource(), 1, &vk_descriptor_set);
+        RHI_DELETE_PTR(descriptorSet);
+    }
+
     void VulkanRHI::freeMemory(RHIDeviceMemory* &memory)
     {
         vkFreeMemory(m_device, ((VulkanDeviceMemory*)memory)->getResource(), nullptr);
@@ -3265,15 +3331,27 @@ namespace Piccolo
         return m_image_available_for_texturescopy_semaphores[index];
     }
 
+    void VulkanRHI::addRenderingWaitSemaphore(RHISemaphore* semaphore, RHIPipelineStageFlags wait_stage)
+    {
+        m_rendering_wait_semaphores.push_back(((VulkanSemaphore*)semaphore)->getResource());
+        m_rendering_wait_stages.push_back((VkPipelineStageFlags)wait_stage);
+    }
+
     void VulkanRHI::recreateSwapchain()
     {
-        int width  = 0;
-        int height = 0;
-        glfwGetFramebufferSize(m_window, &width, &height);
-        while (width == 0 || height == 0) // minimized 0,0, pause for now
+        std::array<int, 2> framebuffer_size = m_window_system->getFramebufferSize();
+        while (framebuffer_size[0] == 0 || framebuffer_size[1] == 0) // minimized 0,0, pause for now
         {
-            glfwGetFramebufferSize(m_window, &width, &height);
-            glfwWaitEvents();
+            if (std::this_thread::get_id() == m_window_thread_id)
+            {
+                glfwWaitEvents();
+            }
+            else
+            {
+                // on the render thread, the window thread keeps polling the events
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            framebuffer_size = m_window_system->getFramebufferSize();
         }
 
         VkResult res_wait_for_fences =
@@ -3283,6 +3361,8 @@ namespace Piccolo
             LOG_ERROR("_vkWaitForFences failed");
             return;
         }
+        // the frame fences only cover the rendering, the work on the other queues may still read the images
+        vkDeviceWaitIdle(m_device);
 
         destroyImageView(m_depth_image_view);
         vkDestroyImage(m_device, ((VulkanImage*)m_depth_image)->getResource(), NULL);
@@ -3366,6 +3446,28 @@ namespace Piccolo
             }
             i++;
         }
+
+        // prefer a family which can only copy, it's usually backed by the dma engines and runs the uploads
+        // alongside the rendering, any family without graphics comes next
+        uint32_t transfer_family_score = 0;
+        for (uint32_t family_index = 0; family_index < queue_family_count; ++family_index)
+        {
+            VkQueueFlags queue_flags = queue_families[family_index].queueFlags;
+            if (!(queue_flags & VK_QUEUE_TRANSFER_BIT) || (queue_flags & VK_QUEUE_GRAPHICS_BIT))
+                continue;
+
+            uint32_t score = (queue_flags & VK_QUEUE_COMPUTE_BIT) ? 1 : 2;
+            if (score > transfer_family_score)
+            {
+                indices.m_transfer_family = family_index;
+                transfer_family_score     = score;
+            }
+        }
+        if (!indices.m_transfer_family.has_value())
+        {
+            indices.m_transfer_family = indices.graphics_family;
+        }
+
         return indices;
     }
 
@@ -3386,6 +3488,84 @@ namespace Piccolo
         return required_extensions.empty();
     }
 
+    bool VulkanRHI::checkBindlessSupport(VkPhysicalDeviceDescriptorIndexingFeaturesEXT& features)
+    {
+        if (!m_enable_physical_device_properties_2)
+        {
+            return false;
+        }
+
+        uint32_t extension_count;
+        vkEnumerateDeviceExtensionProperties(m_physical_device, nullptr, &extension_count, nullptr);
+
+        std::vector<VkExtensionProperties> available_extensions(extension_count);
+        vkEnumerateDeviceExtensionProperties(m_physical_device, nullptr, &extension_count, available_extensions.data());
+
+        std::set<std::string> required_extensions {VK_KHR_MAINTENANCE3_EXTENSION_NAME,
+                                                   VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME};
+        for (const auto& extension : available_extensions)
+        {
+            required_extensions.erase(extension.extensionName);
+        }
+        if (!required_extensions.empty())
+        {
+            return false;
+        }
+
+        PFN_vkGetPhysicalDeviceFeatures2KHR get_features = (PFN_vkGetPhysicalDeviceFeatures2KHR)vkGetInstanceProcAddr(
+            m_instance, "vkGetPhysicalDeviceFeatures2KHR");
+        PFN_vkGetPhysicalDeviceProperties2KHR get_properties =
+            (PFN_vkGetPhysicalDeviceProperties2KHR)vkGetInstanceProcAddr(m_instance,
+                                                                         "vkGetPhysicalDeviceProperties2KHR");
+        if (get_features == nullptr || get_properties == nullptr)
+        {
+            return false;
+        }
+
+        VkPhysicalDeviceDescriptorIndexingFeaturesEXT supported_features {};
+        supported_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+        VkPhysicalDeviceFeatures2KHR physical_device_features {};
+        physical_device_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+        physical_device_features.pNext = &supported_features;
+        get_features(m_physical_device, &physical_device_features);
+
+        VkPhysicalDeviceDescriptorIndexingPropertiesEXT supported_properties {};
+        supported_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+        VkPhysicalDeviceProperties2KHR physical_device_properties {};
+        physical_device_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
+        physical_device_properties.pNext = &supported_properties;
+        get_properties(m_physical_device, &physical_device_properties);
+
+        // the fragments of one draw index different textures, which are added while the frames in flight sample
+        // the others
+        if (!supported_features.shaderSampledImageArrayNonUniformIndexing ||
+            !supported_features.runtimeDescriptorArray || !supported_features.descriptorBindingPartiallyBound ||
+            !supported_features.descriptorBindingVariableDescriptorCount ||
+            !supported_features.descriptorBindingSampledImageUpdateAfterBind ||
+            !supported_features.descriptorBindingUpdateUnusedWhilePending)
+        {
+            return false;
+        }
+
+        if (supported_properties.maxPerStageDescriptorUpdateAfterBindSamplers < k_max_bindless_texture_count ||
+            supported_properties.maxPerStageDescriptorUpdateAfterBindSampledImages < k_max_bindless_texture_count ||
+            supported_properties.maxDescriptorSetUpdateAfterBindSamplers < k_max_bindless_texture_count ||
+            supported_properties.maxDescriptorSetUpdateAfterBindSampledImages < k_max_bindless_texture_count)
+        {
+            return false;
+        }
+
+        features       = {};
+        features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+        features.shaderSampledImageArrayNonUniformIndexing    = VK_TRUE;
+        features.runtimeDescriptorArray                       = VK_TRUE;
+        features.descriptorBindingPartiallyBound              = VK_TRUE;
+        features.descriptorBindingVariableDescriptorCount     = VK_TRUE;
+        features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        features.descriptorBindingUpdateUnusedWhilePending    = VK_TRUE;
+        return true;
+    }
+
     bool VulkanRHI::isDeviceSuitable(VkPhysicalDevice physicalm_device)
     {
         auto queue_indices           = findQueueFamilies(physicalm_device);
@@ -3507,10 +3687,10 @@ namespace Piccolo
         }
         else
         {
-            int width, height;
-            glfwGetFramebufferSize(m_window, &width, &height);
+            const std::array<int, 2> framebuffer_size = m_window_system->getFramebufferSize();
 
-            VkExtent2D actualExtent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+            VkExtent2D actualExtent = {static_cast<uint32_t>(framebuffer_size[0]),
+                                       static_cast<uint32_t>(framebuffer_size[1])};
 
             actualExtent.width =
                 std::clamp(actualExtent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
@@ -3544,6 +3724,10 @@ namespace Piccolo
     }
     bool VulkanRHI::isPointLightShadowEnabled(){ return m_enable_point_light_shadow; }
 
+    bool VulkanRHI::isDrawIndirectFirstInstanceEnabled() { return m_enable_draw_indirect_first_instance; }
+
+    bool VulkanRHI::isBindlessEnabled() { return m_enable_bindless; }
+
     RHICommandBuffer* VulkanRHI::getCurrentCommandBuffer() const
     {
         return m_current_command_buffer;
@@ -3576,6 +3760,10 @@ namespace Piccolo
     {
         return m_compute_queue;
     }
+    RHIQueue* VulkanRHI::getTransferQueue() const
+    {
+        return m_transfer_queue;
+    }
     RHISwapChainDesc VulkanRHI::getSwapchainInfo()
     {
         RHISwapChainDesc desc;
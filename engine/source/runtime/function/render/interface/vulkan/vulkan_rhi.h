@@ -6,8 +6,10 @@
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
 
+#include <filesystem>
 #include <functional>
 #include <map>
+#include <thread>
 #include <vector>
 
 namespace Piccolo
@@ -53,6 +55,7 @@ namespace Piccolo
         void createImageView(RHIImage* image, RHIFormat format, RHIImageAspectFlags image_aspect_flags, RHIImageViewType view_type, uint32_t layout_count, uint32_t miplevels,
             RHIImageView* &image_view) override;
         void createGlobalImage(RHIImage* &image, RHIImageView* &image_view, VmaAllocation& image_allocation, uint32_t texture_image_width, uint32_t texture_image_height, void* texture_image_pixels, RHIFormat texture_image_format, uint32_t miplevels = 0) override;
+        void createSampledImage(RHIImage* &image, RHIImageView* &image_view, VmaAllocation& image_allocation, uint32_t texture_image_width, uint32_t texture_image_height, RHIFormat texture_image_format, uint32_t miplevels) override;
         void createCubeMap(RHIImage* &image, RHIImageView* &image_view, VmaAllocation& image_allocation, uint32_t texture_image_width, uint32_t texture_image_height, std::array<void*, 6> texture_image_pixels, RHIFormat texture_image_format, uint32_t miplevels) override;
         bool createCommandPool(const RHICommandPoolCreateInfo* pCreateInfo, RHICommandPool* &pCommandPool) override;
         bool createDescriptorPool(const RHIDescriptorPoolCreateInfo* pCreateInfo, RHIDescriptorPool* &pDescriptorPool) override;
@@ -69,6 +72,7 @@ namespace Piccolo
         // command and command write
         bool waitForFencesPFN(uint32_t fenceCount, RHIFence* const* pFence, RHIBool32 waitAll, uint64_t timeout) override;
         bool resetFencesPFN(uint32_t fenceCount, RHIFence* const* pFences) override;
+        bool getFenceStatus(RHIFence* fence) override;
         bool resetCommandPoolPFN(RHICommandPool* commandPool, RHICommandPoolResetFlags flags) override;
         bool beginCommandBufferPFN(RHICommandBuffer* commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo) override;
         bool endCommandBufferPFN(RHICommandBuffer* commandBuffer) override;
@@ -99,11 +103,14 @@ namespace Piccolo
 
         bool beginCommandBuffer(RHICommandBuffer* commandBuffer, const RHICommandBufferBeginInfo* pBeginInfo) override;
         void cmdCopyImageToBuffer(RHICommandBuffer* commandBuffer, RHIImage* srcImage, RHIImageLayout srcImageLayout, RHIBuffer* dstBuffer, uint32_t regionCount, const RHIBufferImageCopy* pRegions) override;
+        void cmdCopyBufferToImage(RHICommandBuffer* commandBuffer, RHIBuffer* srcBuffer, RHIImage* dstImage, RHIImageLayout dstImageLayout, uint32_t regionCount, const RHIBufferImageCopy* pRegions) override;
         void cmdCopyImageToImage(RHICommandBuffer* commandBuffer, RHIImage* srcImage, RHIImageAspectFlagBits srcFlag, RHIImage* dstImage, RHIImageAspectFlagBits dstFlag, uint32_t width, uint32_t height) override;
         void cmdCopyBuffer(RHICommandBuffer* commandBuffer, RHIBuffer* srcBuffer, RHIBuffer* dstBuffer, uint32_t regionCount, RHIBufferCopy* pRegions) override;
         void cmdDraw(RHICommandBuffer* commandBuffer, uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance) override;
         void cmdDispatch(RHICommandBuffer* commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) override;
         void cmdDispatchIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset) override;
+        void cmdDrawIndexedIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride) override;
+        void cmdDrawIndirect(RHICommandBuffer* commandBuffer, RHIBuffer* buffer, RHIDeviceSize offset, uint32_t drawCount, uint32_t stride) override;
         void cmdPipelineBarrier(RHICommandBuffer* commandBuffer, RHIPipelineStageFlags srcStageMask, RHIPipelineStageFlags dstStageMask, RHIDependencyFlags dependencyFlags, uint32_t memoryBarrierCount, const RHIMemoryBarrier* pMemoryBarriers, uint32_t bufferMemoryBarrierCount, const RHIBufferMemoryBarrier* pBufferMemoryBarriers, uint32_t imageMemoryBarrierCount, const RHIImageMemoryBarrier* pImageMemoryBarriers) override;
         bool endCommandBuffer(RHICommandBuffer* commandBuffer) override;
         void updateDescriptorSets(uint32_t descriptorWriteCount, const RHIWriteDescriptorSet* pDescriptorWrites, uint32_t descriptorCopyCount, const RHICopyDescriptorSet* pDescriptorCopies) override;
@@ -123,6 +130,7 @@ namespace Piccolo
         QueueFamilyIndices getQueueFamilyIndices() const override;
         RHIQueue* getGraphicsQueue() const override;
         RHIQueue* getComputeQueue() const override;
+        RHIQueue* getTransferQueue() const override;
         RHISwapChainDesc getSwapchainInfo() override;
         RHIDepthImageDesc getDepthImageInfo() const override;
         uint8_t getMaxFramesInFlight() const override;
@@ -154,7 +162,10 @@ namespace Piccolo
         void destroyDevice() override;
         void destroyCommandPool(RHICommandPool* commandPool) override;
         void destroyBuffer(RHIBuffer* &buffer) override;
+        void destroyDescriptorSetLayout(RHIDescriptorSetLayout* &descriptorSetLayout) override;
+        void destroyDescriptorPool(RHIDescriptorPool* &descriptorPool) override;
         void freeCommandBuffers(RHICommandPool* commandPool, uint32_t commandBufferCount, RHICommandBuffer* pCommandBuffers) override;
+        void freeDescriptorSet(RHIDescriptorPool* descriptorPool, RHIDescriptorSet* &descriptorSet) override;
 
         // memory
         void freeMemory(RHIDeviceMemory* &memory) override;
@@ -165,12 +176,16 @@ namespace Piccolo
         
         //semaphores
         RHISemaphore* &getTextureCopySemaphore(uint32_t index) override;
+        void addRenderingWaitSemaphore(RHISemaphore* semaphore, RHIPipelineStageFlags wait_stage) override;
     public:
         static uint8_t const k_max_frames_in_flight {3};
+        // size of the bindless texture array, the device must hold as many update after bind textures in one set
+        static uint32_t const k_max_bindless_texture_count {16384};
 
         
         RHIQueue* m_graphics_queue{ nullptr };
         RHIQueue* m_compute_queue{ nullptr };
+        RHIQueue* m_transfer_queue{ nullptr };
 
         RHIFormat m_swapchain_image_format{ RHI_FORMAT_UNDEFINED };
         std::vector<RHIImageView*> m_swapchain_imageviews;
@@ -193,6 +208,10 @@ namespace Piccolo
         QueueFamilyIndices m_queue_indices;
 
         GLFWwindow*        m_window {nullptr};
+        // glfw events may only be processed on the thread owning the window, the framebuffer size is read from the
+        // window system which caches it on that thread
+        std::thread::id               m_window_thread_id;
+        std::shared_ptr<WindowSystem> m_window_system;
         VkInstance         m_instance {nullptr};
         VkSurfaceKHR       m_surface {nullptr};
         VkPhysicalDevice   m_physical_device {nullptr};
@@ -233,6 +252,9 @@ namespace Piccolo
         // global descriptor pool
         VkDescriptorPool m_vk_descriptor_pool;
 
+        // used for the pipelines created without a cache, loaded at initialization and saved by clear
+        VkPipelineCache m_vk_pipeline_cache {VK_NULL_HANDLE};
+
         // command pool and buffers
         uint8_t              m_current_frame_index {0};
         VkCommandPool        m_command_pools[k_max_frames_in_flight];
@@ -242,6 +264,10 @@ namespace Piccolo
         RHISemaphore*        m_image_available_for_texturescopy_semaphores[k_max_frames_in_flight];
         VkFence              m_is_frame_in_flight_fences[k_max_frames_in_flight];
 
+        // waited by the next rendering submission only
+        std::vector<VkSemaphore>          m_rendering_wait_semaphores;
+        std::vector<VkPipelineStageFlags> m_rendering_wait_stages;
+
         // TODO: set
         VkCommandBuffer   m_vk_current_command_buffer;
 
@@ -258,6 +284,9 @@ namespace Piccolo
         RHISampler* m_nearest_sampler = nullptr;
         std::map<uint32_t, RHISampler*> m_mipmap_sampler_map;
 
+        // empty when the pipeline cache is not kept between runs
+        std::filesystem::path m_pipeline_cache_path;
+
     private:
         void createInstance();
         void initializeDebugMessenger();
@@ -269,14 +298,21 @@ namespace Piccolo
         void createDescriptorPool();
         void createSyncPrimitives();
         void createAssetAllocator();
+        void createPipelineCache(const std::filesystem::path& pipeline_cache_folder);
+        void savePipelineCache();
 
     public:
         bool isPointLightShadowEnabled() override;
+        bool isDrawIndirectFirstInstanceEnabled() override;
+        bool isBindlessEnabled() override;
 
     private:
         bool m_enable_validation_Layers{ true };
         bool m_enable_debug_utils_label{ true };
         bool m_enable_point_light_shadow{ true };
+        bool m_enable_draw_indirect_first_instance{ false };
+        bool m_enable_bindless{ false };
+        bool m_enable_physical_device_properties_2{ false };
 
         // used in descriptor pool creation
         uint32_t m_max_vertex_blending_mesh_count{ 256 };
@@ -297,6 +333,7 @@ namespace Piccolo
 
         QueueFamilyIndices      findQueueFamilies(VkPhysicalDevice physical_device);
         bool                    checkDeviceExtensionSupport(VkPhysicalDevice physical_device);
+        bool                    checkBindlessSupport(VkPhysicalDeviceDescriptorIndexingFeaturesEXT& features);
         bool                    isDeviceSuitable(VkPhysicalDevice physical_device);
         SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice physical_device);
 
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Piccolo
+{
+    /// Linear allocator for the Vk structs the RHI entry points translate their arguments into.
+    /// Every thread owns one arena. An entry point opens a Scope, allocates its temporaries and the scope rewinds the
+    /// arena when the call returns, so that once the largest call has been seen the translation never hits the heap.
+    class VulkanScratchArena
+    {
+    public:
+        static constexpr size_t k_block_size = 64 * 1024;
+
+        class Scope
+        {
+        public:
+            explicit Scope(VulkanScratchArena& arena) :
+                m_arena(arena), m_block_index(arena.m_block_index), m_block_offset(arena.m_block_offset)
+            {}
+            ~Scope()
+            {
+                m_arena.m_block_index  = m_block_index;
+                m_arena.m_block_offset = m_block_offset;
+            }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            VulkanScratchArena& m_arena;
+            size_t              m_block_index;
+            size_t              m_block_offset;
+        };
+
+        /// the arena of the calling thread
+        static VulkanScratchArena& get()
+        {
+            thread_local VulkanScratchArena arena;
+            return arena;
+        }
+
+        /// zero initialized, like the value initialized vectors it replaces, valid until the enclosing scope ends
+        template<typename T>
+        T* allocate(size_t count)
+        {
+            static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value,
+                          "the arena never runs destructors");
+            if (count == 0)
+            {
+                return nullptr;
+            }
+
+            void* memory = allocateBytes(sizeof(T) * count, alignof(T));
+            std::memset(memory, 0, sizeof(T) * count);
+            return static_cast<T*>(memory);
+        }
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> m_memory;
+            size_t                       m_size {0};
+        };
+
+        VulkanScratchArena()  = default;
+        ~VulkanScratchArena() = default;
+
+        void* allocateBytes(size_t size, size_t alignment)
+        {
+            while (m_block_index < m_blocks.size())
+            {
+                Block&          block   = m_blocks[m_block_index];
+                const uintptr_t base    = reinterpret_cast<uintptr_t>(block.m_memory.get());
+                const uintptr_t aligned = (base + m_block_offset + alignment - 1) & ~(uintptr_t(alignment) - 1);
+                if (aligned + size <= base + block.m_size)
+                {
+                    m_block_offset = aligned + size - base;
+                    return reinterpret_cast<void*>(aligned);
+                }
+
+                // the rest of the block is skipped, the next one is tried
+                m_block_index++;
+                m_block_offset = 0;
+            }
+
+            // the blocks are kept after a rewind, only a call larger than any before allocates
+            Block block;
+            block.m_size   = std::max(k_block_size, size + alignment);
+            block.m_memory = std::make_unique<std::byte[]>(block.m_size);
+            m_blocks.push_back(std::move(block));
+            m_block_index  = m_blocks.size() - 1;
+            m_block_offset = 0;
+            return allocateBytes(size, alignment);
+        }
+
+        std::vector<Block> m_blocks;
+        size_t             m_block_index {0};
+        size_t             m_block_offset {0};
+    };
+} // namespace Piccolo
@@ -1,4 +1,5 @@
 #include "runtime/function/render/passes/main_camera_pass.h"
+#include "runtime/function/global/global_context.h"
 #include "runtime/function/render/render_helper.h"
 #include "runtime/function/render/render_mesh.h"
 #include "runtime/function/render/render_resource.h"
@@ -13,8 +14,12 @@
 #include <axis_vert.h>
 #include <deferred_lighting_frag.h>
 #include <deferred_lighting_vert.h>
+#include <mesh_bindless_frag.h>
 #include <mesh_frag.h>
+#include <mesh_gbuffer_bindless_frag.h>
 #include <mesh_gbuffer_frag.h>
+#include <mesh_instance_culling_comp.h>
+#include <mesh_instance_vert.h>
 #include <mesh_vert.h>
 #include <skybox_frag.h>
 #include <skybox_vert.h>
@@ -25,6 +30,9 @@ namespace Piccolo
     {
         RenderPass::initialize(nullptr);
 
+        m_mesh_instances     = &std::static_pointer_cast<RenderResource>(m_render_resource)->m_mesh_instances;
+        m_bindless_materials = &std::static_pointer_cast<RenderResource>(m_render_resource)->m_bindless_materials;
+
         const MainCameraPassInitInfo* _init_info = static_cast<const MainCameraPassInitInfo*>(init_info);
         m_enable_fxaa                            = _init_info->enble_fxaa;
 
@@ -47,6 +55,12 @@ namespace Piccolo
             m_mesh_perframe_storage_buffer_object = vulkan_resource->m_mesh_perframe_storage_buffer_object;
             m_axis_storage_buffer_object          = vulkan_resource->m_axis_storage_buffer_object;
         }
+
+        // the instance buffer grew since the descriptor sets were written
+        if (m_mesh_instance_buffer_version != m_mesh_instances->getInstanceBufferVersion())
+        {
+            updateMeshInstanceDescriptorSets();
+        }
     }
 
     void MainCameraPass::setupAttachments()
@@ -601,7 +615,7 @@ namespace Piccolo
         }
 
         {
-            RHIDescriptorSetLayoutBinding mesh_global_layout_bindings[8];
+            RHIDescriptorSetLayoutBinding mesh_global_layout_bindings[9];
 
             RHIDescriptorSetLayoutBinding& mesh_global_layout_perframe_storage_buffer_binding =
                 mesh_global_layout_bindings[0];
@@ -658,6 +672,14 @@ namespace Piccolo
             mesh_global_layout_directional_light_shadow_texture_binding = mesh_global_layout_brdfLUT_texture_binding;
             mesh_global_layout_directional_light_shadow_texture_binding.binding = 7;
 
+            RHIDescriptorSetLayoutBinding& mesh_global_layout_instance_storage_buffer_binding =
+                mesh_global_layout_bindings[8];
+            mesh_global_layout_instance_storage_buffer_binding.binding            = 8;
+            mesh_global_layout_instance_storage_buffer_binding.descriptorType     = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            mesh_global_layout_instance_storage_buffer_binding.descriptorCount    = 1;
+            mesh_global_layout_instance_storage_buffer_binding.stageFlags         = RHI_SHADER_STAGE_VERTEX_BIT;
+            mesh_global_layout_instance_storage_buffer_binding.pImmutableSamplers = NULL;
+
             RHIDescriptorSetLayoutCreateInfo mesh_global_layout_create_info;
             mesh_global_layout_create_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
             mesh_global_layout_create_info.pNext = NULL;
@@ -672,6 +694,13 @@ namespace Piccolo
             }
         }
 
+        if (m_bindless_materials->isEnabled())
+        {
+            // the materials are records of the bindless material buffer and their textures are slots of its array
+            m_descriptor_infos[_mesh_bindless_material].layout = m_bindless_materials->getDescriptorSetLayout();
+        }
+
+        // the materials past the capacity of the bindless materials still have a descriptor set of their own
         {
             RHIDescriptorSetLayoutBinding mesh_material_layout_bindings[6];
 
@@ -833,14 +862,105 @@ namespace Piccolo
                 throw std::runtime_error("create deferred lighting global layout");
             }
         }
+
+        {
+            RHIDescriptorSetLayoutBinding mesh_instance_culling_layout_bindings[4];
+
+            RHIDescriptorSetLayoutBinding& mesh_instance_culling_layout_perframe_storage_buffer_binding =
+                mesh_instance_culling_layout_bindings[0];
+            mesh_instance_culling_layout_perframe_storage_buffer_binding.binding = 0;
+            mesh_instance_culling_layout_perframe_storage_buffer_binding.descriptorType =
+                RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+            mesh_instance_culling_layout_perframe_storage_buffer_binding.descriptorCount    = 1;
+            mesh_instance_culling_layout_perframe_storage_buffer_binding.stageFlags         = RHI_SHADER_STAGE_COMPUTE_BIT;
+            mesh_instance_culling_layout_perframe_storage_buffer_binding.pImmutableSamplers = NULL;
+
+            RHIDescriptorSetLayoutBinding& mesh_instance_culling_layout_instance_storage_buffer_binding =
+                mesh_instance_culling_layout_bindings[1];
+            mesh_instance_culling_layout_instance_storage_buffer_binding         = mesh_instance_culling_layout_perframe_storage_buffer_binding;
+            mesh_instance_culling_layout_instance_storage_buffer_binding.binding = 1;
+            mesh_instance_culling_layout_instance_storage_buffer_binding.descriptorType =
+                RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+
+            RHIDescriptorSetLayoutBinding& mesh_instance_culling_layout_draw_command_storage_buffer_binding =
+                mesh_instance_culling_layout_bindings[2];
+            mesh_instance_culling_layout_draw_command_storage_buffer_binding =
+                mesh_instance_culling_layout_perframe_storage_buffer_binding;
+            mesh_instance_culling_layout_draw_command_storage_buffer_binding.binding = 2;
+
+            RHIDescriptorSetLayoutBinding& mesh_instance_culling_layout_visible_instance_storage_buffer_binding =
+                mesh_instance_culling_layout_bindings[3];
+            mesh_instance_culling_layout_visible_instance_storage_buffer_binding =
+                mesh_instance_culling_layout_instance_storage_buffer_binding;
+            mesh_instance_culling_layout_visible_instance_storage_buffer_binding.binding = 3;
+
+            RHIDescriptorSetLayoutCreateInfo mesh_instance_culling_layout_create_info {};
+            mesh_instance_culling_layout_create_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            mesh_instance_culling_layout_create_info.bindingCount =
+                sizeof(mesh_instance_culling_layout_bindings) / sizeof(mesh_instance_culling_layout_bindings[0]);
+            mesh_instance_culling_layout_create_info.pBindings = mesh_instance_culling_layout_bindings;
+
+            if (RHI_SUCCESS != m_rhi->createDescriptorSetLayout(&mesh_instance_culling_layout_create_info,
+                                                                m_descriptor_infos[_mesh_instance_culling].layout))
+            {
+                throw std::runtime_error("create mesh instance culling layout");
+            }
+        }
+
+        {
+            RHIDescriptorSetLayoutBinding mesh_instance_layout_bindings[2];
+
+            // (set = 3, binding = 0 in vertex shader)
+            RHIDescriptorSetLayoutBinding& mesh_instance_layout_instance_storage_buffer_binding =
+                mesh_instance_layout_bindings[0];
+            mesh_instance_layout_instance_storage_buffer_binding.binding            = 0;
+            mesh_instance_layout_instance_storage_buffer_binding.descriptorType     = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            mesh_instance_layout_instance_storage_buffer_binding.descriptorCount    = 1;
+            mesh_instance_layout_instance_storage_buffer_binding.stageFlags         = RHI_SHADER_STAGE_VERTEX_BIT;
+            mesh_instance_layout_instance_storage_buffer_binding.pImmutableSamplers = NULL;
+
+            // (set = 3, binding = 1 in vertex shader)
+            RHIDescriptorSetLayoutBinding& mesh_instance_layout_visible_instance_storage_buffer_binding =
+                mesh_instance_layout_bindings[1];
+            mesh_instance_layout_visible_instance_storage_buffer_binding =
+                mesh_instance_layout_instance_storage_buffer_binding;
+            mesh_instance_layout_visible_instance_storage_buffer_binding.binding = 1;
+
+            RHIDescriptorSetLayoutCreateInfo mesh_instance_layout_create_info {};
+            mesh_instance_layout_create_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            mesh_instance_layout_create_info.bindingCount =
+                sizeof(mesh_instance_layout_bindings) / sizeof(mesh_instance_layout_bindings[0]);
+            mesh_instance_layout_create_info.pBindings = mesh_instance_layout_bindings;
+
+            if (RHI_SUCCESS != m_rhi->createDescriptorSetLayout(&mesh_instance_layout_create_info,
+                                                                m_descriptor_infos[_mesh_instance].layout))
+            {
+                throw std::runtime_error("create mesh instance layout");
+            }
+        }
+    }
+
+    void MainCameraPass::waitForPipelines()
+    {
+        // the jobs are forgotten before the wait rethrows the failure of a pipeline
+        std::vector<JobHandle> pipeline_jobs;
+        pipeline_jobs.swap(m_pipeline_jobs);
+        g_runtime_global_context.m_job_system->waitAll(pipeline_jobs);
     }
 
+    void MainCameraPass::schedulePipelineSetup(const char* name, std::function<void()> setup_function)
+    {
+        m_pipeline_jobs.push_back(g_runtime_global_context.m_job_system->schedule(name, std::move(setup_function)));
+    }
+
+    // every pipeline is a job of its own, the jobs only read the layouts and the render pass set up before, the
+    // pipelines are not used until waitForPipelines
     void MainCameraPass::setupPipelines()
     {
         m_render_pipelines.resize(_render_pipeline_type_count);
 
         // mesh gbuffer
-        {
+        schedulePipelineSetup("MeshGbufferPipeline", [this]() {
             RHIDescriptorSetLayout*      descriptorset_layouts[3] = {m_descriptor_infos[_mesh_global].layout,
                                                               m_descriptor_infos[_per_mesh].layout,
                                                               m_descriptor_infos[_mesh_per_material].layout};
@@ -991,12 +1111,26 @@ namespace Piccolo
                 throw std::runtime_error("create mesh gbuffer graphics pipeline");
             }
 
+            if (m_mesh_instances->isGpuDrivenSupported())
+            {
+                setupMeshInstancePipeline(_render_pipeline_type_mesh_gbuffer_indirect,
+                                          pipelineInfo,
+                                          m_descriptor_infos[_mesh_per_material].layout);
+            }
+            if (m_bindless_materials->isEnabled())
+            {
+                setupBindlessMaterialPipeline(_render_pipeline_type_mesh_gbuffer_bindless,
+                                              _render_pipeline_type_mesh_gbuffer_indirect_bindless,
+                                              pipelineInfo,
+                                              MESH_GBUFFER_BINDLESS_FRAG);
+            }
+
             m_rhi->destroyShaderModule(vert_shader_module);
             m_rhi->destroyShaderModule(frag_shader_module);
-        }
+        });
 
         // deferred lighting
-        {
+        schedulePipelineSetup("DeferredLightingPipeline", [this]() {
             RHIDescriptorSetLayout*      descriptorset_layouts[3] = {m_descriptor_infos[_mesh_global].layout,
                                                               m_descriptor_infos[_deferred_lighting].layout,
                                                               m_descriptor_infos[_skybox].layout};
@@ -1134,10 +1268,10 @@ namespace Piccolo
 
             m_rhi->destroyShaderModule(vert_shader_module);
             m_rhi->destroyShaderModule(frag_shader_module);
-        }
+        });
 
         // mesh lighting
-        {
+        schedulePipelineSetup("MeshLightingPipeline", [this]() {
             RHIDescriptorSetLayout*      descriptorset_layouts[3] = {m_descriptor_infos[_mesh_global].layout,
                                                                      m_descriptor_infos[_per_mesh].layout,
                                                                      m_descriptor_infos[_mesh_per_material].layout};
@@ -1271,12 +1405,26 @@ namespace Piccolo
                 throw std::runtime_error("create mesh lighting graphics pipeline");
             }
 
+            if (m_mesh_instances->isGpuDrivenSupported())
+            {
+                setupMeshInstancePipeline(_render_pipeline_type_mesh_lighting_indirect,
+                                          pipelineInfo,
+                                          m_descriptor_infos[_mesh_per_material].layout);
+            }
+            if (m_bindless_materials->isEnabled())
+            {
+                setupBindlessMaterialPipeline(_render_pipeline_type_mesh_lighting_bindless,
+                                              _render_pipeline_type_mesh_lighting_indirect_bindless,
+                                              pipelineInfo,
+                                              MESH_BINDLESS_FRAG);
+            }
+
             m_rhi->destroyShaderModule(vert_shader_module);
             m_rhi->destroyShaderModule(frag_shader_module);
-        }
+        });
 
         // skybox
-        {
+        schedulePipelineSetup("SkyboxPipeline", [this]() {
             RHIDescriptorSetLayout*      descriptorset_layouts[1] = {m_descriptor_infos[_skybox].layout};
             RHIPipelineLayoutCreateInfo pipeline_layout_create_info {};
             pipeline_layout_create_info.sType          = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -1410,10 +1558,10 @@ namespace Piccolo
 
             m_rhi->destroyShaderModule(vert_shader_module);
             m_rhi->destroyShaderModule(frag_shader_module);
-        }
+        });
 
         // draw axis
-        {
+        schedulePipelineSetup("AxisPipeline", [this]() {
             RHIDescriptorSetLayout*     descriptorset_layouts[1] = {m_descriptor_infos[_axis].layout};
             RHIPipelineLayoutCreateInfo pipeline_layout_create_info {};
             pipeline_layout_create_info.sType          = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
@@ -1546,7 +1694,133 @@ namespace Piccolo
 
             m_rhi->destroyShaderModule(vert_shader_module);
             m_rhi->destroyShaderModule(frag_shader_module);
+        });
+
+        // mesh instance culling
+        schedulePipelineSetup("MeshInstanceCullingPipeline", [this]() {
+            if (!m_mesh_instances->isGpuDrivenSupported())
+            {
+                return;
+            }
+
+            RHIDescriptorSetLayout*     descriptorset_layouts[1] = {m_descriptor_infos[_mesh_instance_culling].layout};
+            RHIPipelineLayoutCreateInfo pipeline_layout_create_info {};
+            pipeline_layout_create_info.sType          = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            pipeline_layout_create_info.setLayoutCount = 1;
+            pipeline_layout_create_info.pSetLayouts    = descriptorset_layouts;
+
+            if (RHI_SUCCESS !=
+                m_rhi->createPipelineLayout(&pipeline_layout_create_info,
+                                            m_render_pipelines[_render_pipeline_type_mesh_instance_culling].layout))
+            {
+                throw std::runtime_error("create mesh instance culling pipeline layout");
+            }
+
+            RHIShader* comp_shader_module = m_rhi->createShaderModule(MESH_INSTANCE_CULLING_COMP);
+
+            RHIPipelineShaderStageCreateInfo comp_pipeline_shader_stage_create_info {};
+            comp_pipeline_shader_stage_create_info.sType  = RHI_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+            comp_pipeline_shader_stage_create_info.stage  = RHI_SHADER_STAGE_COMPUTE_BIT;
+            comp_pipeline_shader_stage_create_info.module = comp_shader_module;
+            comp_pipeline_shader_stage_create_info.pName  = "main";
+
+            RHIComputePipelineCreateInfo pipelineInfo {};
+            pipelineInfo.sType   = RHI_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+            pipelineInfo.pStages = &comp_pipeline_shader_stage_create_info;
+            pipelineInfo.layout  = m_render_pipelines[_render_pipeline_type_mesh_instance_culling].layout;
+            pipelineInfo.flags   = 0;
+
+            if (RHI_SUCCESS !=
+                m_rhi->createComputePipelines(RHI_NULL_HANDLE,
+                                              1,
+                                              &pipelineInfo,
+                                              m_render_pipelines[_render_pipeline_type_mesh_instance_culling].pipeline))
+            {
+                throw std::runtime_error("create mesh instance culling compute pipeline");
+            }
+
+            m_rhi->destroyShaderModule(comp_shader_module);
+        });
+    }
+
+    void MainCameraPass::setupMeshInstancePipeline(RenderPipeLineType            type,
+                                                   RHIGraphicsPipelineCreateInfo pipeline_info,
+                                                   RHIDescriptorSetLayout*       material_layout)
+    {
+        // the layout of the cpu path plus the instances at set 3
+        RHIDescriptorSetLayout*     descriptorset_layouts[4] = {m_descriptor_infos[_mesh_global].layout,
+                                                                m_descriptor_infos[_per_mesh].layout,
+                                                                material_layout,
+                                                                m_descriptor_infos[_mesh_instance].layout};
+        RHIPipelineLayoutCreateInfo pipeline_layout_create_info {};
+        pipeline_layout_create_info.sType          = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipeline_layout_create_info.setLayoutCount = 4;
+        pipeline_layout_create_info.pSetLayouts    = descriptorset_layouts;
+
+        if (RHI_SUCCESS != m_rhi->createPipelineLayout(&pipeline_layout_create_info, m_render_pipelines[type].layout))
+        {
+            throw std::runtime_error("create mesh instance pipeline layout");
+        }
+
+        // same fragment stage, the vertex stage reads the instance through the visible instance list
+        RHIShader* vert_shader_module = m_rhi->createShaderModule(MESH_INSTANCE_VERT);
+
+        RHIPipelineShaderStageCreateInfo shader_stages[] = {pipeline_info.pStages[0], pipeline_info.pStages[1]};
+        shader_stages[0].module                          = vert_shader_module;
+
+        pipeline_info.pStages = shader_stages;
+        pipeline_info.layout  = m_render_pipelines[type].layout;
+
+        if (RHI_SUCCESS !=
+            m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE, 1, &pipeline_info, m_render_pipelines[type].pipeline))
+        {
+            throw std::runtime_error("create mesh instance graphics pipeline");
+        }
+
+        m_rhi->destroyShaderModule(vert_shader_module);
+    }
+
+    void MainCameraPass::setupBindlessMaterialPipeline(RenderPipeLineType                type,
+                                                       RenderPipeLineType                indirect_type,
+                                                       RHIGraphicsPipelineCreateInfo     pipeline_info,
+                                                       const std::vector<unsigned char>& frag_shader_code)
+    {
+        // the bindless material set at set 2 instead of the set of the material
+        RHIDescriptorSetLayout*     descriptorset_layouts[3] = {m_descriptor_infos[_mesh_global].layout,
+                                                                m_descriptor_infos[_per_mesh].layout,
+                                                                m_descriptor_infos[_mesh_bindless_material].layout};
+        RHIPipelineLayoutCreateInfo pipeline_layout_create_info {};
+        pipeline_layout_create_info.sType          = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipeline_layout_create_info.setLayoutCount = 3;
+        pipeline_layout_create_info.pSetLayouts    = descriptorset_layouts;
+
+        if (RHI_SUCCESS != m_rhi->createPipelineLayout(&pipeline_layout_create_info, m_render_pipelines[type].layout))
+        {
+            throw std::runtime_error("create mesh bindless material pipeline layout");
+        }
+
+        // same vertex stage, the fragment stage reads the material of the instance instead of the material bound
+        RHIShader* frag_shader_module = m_rhi->createShaderModule(frag_shader_code);
+
+        RHIPipelineShaderStageCreateInfo shader_stages[] = {pipeline_info.pStages[0], pipeline_info.pStages[1]};
+        shader_stages[1].module                          = frag_shader_module;
+
+        pipeline_info.pStages = shader_stages;
+        pipeline_info.layout  = m_render_pipelines[type].layout;
+
+        if (RHI_SUCCESS !=
+            m_rhi->createGraphicsPipelines(RHI_NULL_HANDLE, 1, &pipeline_info, m_render_pipelines[type].pipeline))
+        {
+            throw std::runtime_error("create mesh bindless material graphics pipeline");
         }
+
+        if (m_mesh_instances->isGpuDrivenSupported())
+        {
+            setupMeshInstancePipeline(
+                indirect_type, pipeline_info, m_descriptor_infos[_mesh_bindless_material].layout);
+        }
+
+        m_rhi->destroyShaderModule(frag_shader_module);
     }
 
     void MainCameraPass::setupDescriptorSet()
@@ -1555,6 +1829,7 @@ namespace Piccolo
         setupSkyboxDescriptorSet();
         setupAxisDescriptorSet();
         setupGbufferLightingDescriptorSet();
+        setupMeshInstanceDescriptorSet();
     }
 
     void MainCameraPass::setupModelGlobalDescriptorSet()
@@ -1626,7 +1901,12 @@ namespace Piccolo
         directional_light_shadow_texture_image_info.imageView = m_directional_light_shadow_color_image_view;
         directional_light_shadow_texture_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-        RHIWriteDescriptorSet mesh_descriptor_writes_info[8];
+        RHIDescriptorBufferInfo mesh_instance_storage_buffer_info = {};
+        mesh_instance_storage_buffer_info.offset                 = 0;
+        mesh_instance_storage_buffer_info.range                  = RHI_WHOLE_SIZE;
+        mesh_instance_storage_buffer_info.buffer                 = m_mesh_instances->getInstanceBuffer();
+
+        RHIWriteDescriptorSet mesh_descriptor_writes_info[9];
 
         mesh_descriptor_writes_info[0].sType           = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         mesh_descriptor_writes_info[0].pNext           = NULL;
@@ -1680,6 +1960,11 @@ namespace Piccolo
         mesh_descriptor_writes_info[7].dstBinding = 7;
         mesh_descriptor_writes_info[7].pImageInfo = &directional_light_shadow_texture_image_info;
 
+        mesh_descriptor_writes_info[8]                = mesh_descriptor_writes_info[0];
+        mesh_descriptor_writes_info[8].dstBinding     = 8;
+        mesh_descriptor_writes_info[8].descriptorType = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        mesh_descriptor_writes_info[8].pBufferInfo    = &mesh_instance_storage_buffer_info;
+
         m_rhi->updateDescriptorSets(sizeof(mesh_descriptor_writes_info) / sizeof(mesh_descriptor_writes_info[0]),
                                     mesh_descriptor_writes_info,
                                     0,
@@ -1802,6 +2087,135 @@ namespace Piccolo
         }
     }
 
+    void MainCameraPass::setupMeshInstanceDescriptorSet()
+    {
+        if (!m_mesh_instances->isGpuDrivenSupported())
+            return;
+
+        RHIDescriptorSetAllocateInfo mesh_instance_descriptor_set_alloc_info;
+        mesh_instance_descriptor_set_alloc_info.sType              = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        mesh_instance_descriptor_set_alloc_info.pNext              = NULL;
+        mesh_instance_descriptor_set_alloc_info.descriptorPool     = m_rhi->getDescriptorPoor();
+        mesh_instance_descriptor_set_alloc_info.descriptorSetCount = 1;
+        mesh_instance_descriptor_set_alloc_info.pSetLayouts        = &m_descriptor_infos[_mesh_instance_culling].layout;
+
+        if (RHI_SUCCESS != m_rhi->allocateDescriptorSets(&mesh_instance_descriptor_set_alloc_info,
+                                                         m_descriptor_infos[_mesh_instance_culling].descriptor_set))
+        {
+            throw std::runtime_error("allocate mesh instance culling descriptor set");
+        }
+
+        mesh_instance_descriptor_set_alloc_info.pSetLayouts = &m_descriptor_infos[_mesh_instance].layout;
+        if (RHI_SUCCESS != m_rhi->allocateDescriptorSets(&mesh_instance_descriptor_set_alloc_info,
+                                                         m_descriptor_infos[_mesh_instance].descriptor_set))
+        {
+            throw std::runtime_error("allocate mesh instance descriptor set");
+        }
+
+        RHIDescriptorBufferInfo mesh_instance_culling_perframe_storage_buffer_info = {};
+        mesh_instance_culling_perframe_storage_buffer_info.offset = 0;
+        mesh_instance_culling_perframe_storage_buffer_info.range =
+            sizeof(MeshInstanceCullingPerframeStorageBufferObject);
+        mesh_instance_culling_perframe_storage_buffer_info.buffer =
+            m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
+
+        RHIDescriptorBufferInfo mesh_instance_storage_buffer_info = {};
+        mesh_instance_storage_buffer_info.offset                 = 0;
+        mesh_instance_storage_buffer_info.range                  = RHI_WHOLE_SIZE;
+        mesh_instance_storage_buffer_info.buffer                 = m_mesh_instances->getInstanceBuffer();
+
+        // a batch has at least one instance
+        RHIDescriptorBufferInfo mesh_instance_draw_command_storage_buffer_info = {};
+        mesh_instance_draw_command_storage_buffer_info.offset = 0;
+        mesh_instance_draw_command_storage_buffer_info.range =
+            sizeof(MeshDrawIndexedIndirectCommand) * s_mesh_instance_max_count;
+        mesh_instance_draw_command_storage_buffer_info.buffer =
+            m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
+        assert(mesh_instance_draw_command_storage_buffer_info.range <
+               m_global_render_resource->_storage_buffer._max_storage_buffer_range);
+
+        RHIDescriptorBufferInfo mesh_visible_instance_storage_buffer_info = {};
+        mesh_visible_instance_storage_buffer_info.offset                 = 0;
+        mesh_visible_instance_storage_buffer_info.range                  = RHI_WHOLE_SIZE;
+        mesh_visible_instance_storage_buffer_info.buffer                 = m_mesh_instances->getVisibleInstanceBuffer();
+
+        RHIWriteDescriptorSet mesh_instance_descriptor_writes_info[6];
+
+        mesh_instance_descriptor_writes_info[0].sType           = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        mesh_instance_descriptor_writes_info[0].pNext           = NULL;
+        mesh_instance_descriptor_writes_info[0].dstSet          = m_descriptor_infos[_mesh_instance_culling].descriptor_set;
+        mesh_instance_descriptor_writes_info[0].dstBinding      = 0;
+        mesh_instance_descriptor_writes_info[0].dstArrayElement = 0;
+        mesh_instance_descriptor_writes_info[0].descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        mesh_instance_descriptor_writes_info[0].descriptorCount = 1;
+        mesh_instance_descriptor_writes_info[0].pBufferInfo     = &mesh_instance_culling_perframe_storage_buffer_info;
+
+        mesh_instance_descriptor_writes_info[1]                = mesh_instance_descriptor_writes_info[0];
+        mesh_instance_descriptor_writes_info[1].dstBinding     = 1;
+        mesh_instance_descriptor_writes_info[1].descriptorType = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        mesh_instance_descriptor_writes_info[1].pBufferInfo    = &mesh_instance_storage_buffer_info;
+
+        mesh_instance_descriptor_writes_info[2]             = mesh_instance_descriptor_writes_info[0];
+        mesh_instance_descriptor_writes_info[2].dstBinding  = 2;
+        mesh_instance_descriptor_writes_info[2].pBufferInfo = &mesh_instance_draw_command_storage_buffer_info;
+
+        mesh_instance_descriptor_writes_info[3]             = mesh_instance_descriptor_writes_info[1];
+        mesh_instance_descriptor_writes_info[3].dstBinding  = 3;
+        mesh_instance_descriptor_writes_info[3].pBufferInfo = &mesh_visible_instance_storage_buffer_info;
+
+        mesh_instance_descriptor_writes_info[4]            = mesh_instance_descriptor_writes_info[1];
+        mesh_instance_descriptor_writes_info[4].dstSet     = m_descriptor_infos[_mesh_instance].descriptor_set;
+        mesh_instance_descriptor_writes_info[4].dstBinding = 0;
+
+        mesh_instance_descriptor_writes_info[5]            = mesh_instance_descriptor_writes_info[3];
+        mesh_instance_descriptor_writes_info[5].dstSet     = m_descriptor_infos[_mesh_instance].descriptor_set;
+        mesh_instance_descriptor_writes_info[5].dstBinding = 1;
+
+        m_rhi->updateDescriptorSets(sizeof(mesh_instance_descriptor_writes_info) /
+                                        sizeof(mesh_instance_descriptor_writes_info[0]),
+                                    mesh_instance_descriptor_writes_info,
+                                    0,
+                                    NULL);
+
+        m_mesh_instance_buffer_version = m_mesh_instances->getInstanceBufferVersion();
+    }
+
+    void MainCameraPass::updateMeshInstanceDescriptorSets()
+    {
+        RHIDescriptorBufferInfo mesh_instance_storage_buffer_info = {};
+        mesh_instance_storage_buffer_info.offset                 = 0;
+        mesh_instance_storage_buffer_info.range                  = RHI_WHOLE_SIZE;
+        mesh_instance_storage_buffer_info.buffer                 = m_mesh_instances->getInstanceBuffer();
+
+        // the mesh passes, the culling and the gpu driven draws bind it
+        RHIWriteDescriptorSet mesh_instance_descriptor_writes_info[3];
+
+        mesh_instance_descriptor_writes_info[0].sType           = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        mesh_instance_descriptor_writes_info[0].pNext           = NULL;
+        mesh_instance_descriptor_writes_info[0].dstSet          = m_descriptor_infos[_mesh_global].descriptor_set;
+        mesh_instance_descriptor_writes_info[0].dstBinding      = 8;
+        mesh_instance_descriptor_writes_info[0].dstArrayElement = 0;
+        mesh_instance_descriptor_writes_info[0].descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        mesh_instance_descriptor_writes_info[0].descriptorCount = 1;
+        mesh_instance_descriptor_writes_info[0].pBufferInfo     = &mesh_instance_storage_buffer_info;
+
+        mesh_instance_descriptor_writes_info[1]            = mesh_instance_descriptor_writes_info[0];
+        mesh_instance_descriptor_writes_info[1].dstSet     = m_descriptor_infos[_mesh_instance_culling].descriptor_set;
+        mesh_instance_descriptor_writes_info[1].dstBinding = 1;
+
+        mesh_instance_descriptor_writes_info[2]            = mesh_instance_descriptor_writes_info[0];
+        mesh_instance_descriptor_writes_info[2].dstSet     = m_descriptor_infos[_mesh_instance].descriptor_set;
+        mesh_instance_descriptor_writes_info[2].dstBinding = 0;
+
+        m_rhi->updateDescriptorSets(sizeof(mesh_instance_descriptor_writes_info) /
+                                        sizeof(mesh_instance_descriptor_writes_info[0]),
+                                    mesh_instance_descriptor_writes_info,
+                                    0,
+                                    NULL);
+
+        m_mesh_instance_buffer_version = m_mesh_instances->getInstanceBufferVersion();
+    }
+
     void MainCameraPass::setupFramebufferDescriptorSet()
     {
         RHIDescriptorImageInfo gbuffer_normal_input_attachment_info = {};
@@ -1954,6 +2368,8 @@ namespace Piccolo
                               ParticlePass&     particle_pass,
                               uint32_t          current_swapchain_image_index)
     {
+        cullMeshInstances();
+
         {
             RHIRenderPassBeginInfo renderpass_begin_info {};
             renderpass_begin_info.sType             = RHI_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -2060,6 +2476,8 @@ namespace Piccolo
                                      ParticlePass&     particle_pass,
                                      uint32_t          current_swapchain_image_index)
     {
+        cullMeshInstances();
+
         {
             RHIRenderPassBeginInfo renderpass_begin_info {};
             renderpass_begin_info.sType             = RHI_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -2149,39 +2567,39 @@ namespace Piccolo
     {
         struct MeshNode
         {
-            const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
+            uint32_t instance_index {0};
         };
 
         std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> main_camera_mesh_drawcall_batch;
+        std::vector<const RenderMeshNode*>                                          pre_skinned_nodes;
+        std::vector<const RenderMeshNode*>                                          pre_skinned_bindless_nodes;
 
-        // reorganize mesh
+        // reorganize mesh, the static ones are culled and drawn on the gpu when possible
         for (RenderMeshNode& node : *(m_visiable_nodes.p_main_camera_visible_mesh_nodes))
         {
-            auto& mesh_instanced = main_camera_mesh_drawcall_batch[node.ref_material];
-            auto& mesh_nodes     = mesh_instanced[node.ref_mesh];
+            if (m_is_mesh_instances_culled && !node.enable_vertex_blending)
+                continue;
 
-            MeshNode temp;
-            temp.model_matrix = node.model_matrix;
-            if (node.enable_vertex_blending)
+            const bool is_bindless = m_bindless_materials->isBindless(*node.ref_material);
+            if (m_mesh_instances->isPreSkinned(node.instance_index))
             {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
+                (is_bindless ? pre_skinned_bindless_nodes : pre_skinned_nodes).push_back(&node);
+                continue;
             }
 
+            // the bindless materials are bound once, the nodes of a mesh are drawn together whatever their material
+            auto& mesh_instanced = main_camera_mesh_drawcall_batch[is_bindless ? nullptr : node.ref_material];
+            auto& mesh_nodes     = mesh_instanced[node.ref_mesh];
+
+            MeshNode temp;
+            temp.instance_index = node.instance_index;
+
             mesh_nodes.push_back(temp);
         }
 
         float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
         m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Mesh GBuffer", color);
 
-        m_rhi->cmdBindPipelinePFN(m_rhi->getCurrentCommandBuffer(),
-                                  RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                  m_render_pipelines[_render_pipeline_type_mesh_gbuffer].pipeline);
-        m_rhi->cmdSetViewportPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, m_rhi->getSwapchainInfo().viewport);
-        m_rhi->cmdSetScissorPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, m_rhi->getSwapchainInfo().scissor);
-
         // perframe storage buffer
         uint32_t perframe_dynamic_offset =
             roundUp(m_global_render_resource->_storage_buffer
@@ -2202,20 +2620,33 @@ namespace Piccolo
                 m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
             perframe_dynamic_offset)) = m_mesh_perframe_storage_buffer_object;
 
+        // the bindless materials sort first, the pipeline switches once to the materials past their capacity
+        RHIPipelineLayout* pipeline_layout      = nullptr;
+        bool               is_pipeline_bindless = false;
         for (auto& pair1 : main_camera_mesh_drawcall_batch)
         {
-            VulkanPBRMaterial& material       = (*pair1.first);
+            VulkanPBRMaterial* material       = pair1.first;
             auto&              mesh_instanced = pair1.second;
 
+            const bool is_bindless = (material == nullptr);
+            if (pipeline_layout == nullptr || is_bindless != is_pipeline_bindless)
+            {
+                pipeline_layout      = bindMeshPipeline(_render_pipeline_type_mesh_gbuffer, is_bindless);
+                is_pipeline_bindless = is_bindless;
+            }
+
             // bind per material
-            m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                            RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                            m_render_pipelines[_render_pipeline_type_mesh_gbuffer].layout,
-                                            2,
-                                            1,
-                                            &material.material_descriptor_set,
-                                            0,
-                                            NULL);
+            if (material)
+            {
+                m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
+                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                pipeline_layout,
+                                                2,
+                                                1,
+                                                &material->material_descriptor_set,
+                                                0,
+                                                NULL);
+            }
 
             // TODO: render from near to far
 
@@ -2230,7 +2661,7 @@ namespace Piccolo
                     // bind per mesh
                     m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
                                                     RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                    m_render_pipelines[_render_pipeline_type_mesh_gbuffer].layout,
+                                                    pipeline_layout,
                                                     1,
                                                     1,
                                                     &mesh.mesh_vertex_blending_descriptor_set,
@@ -2247,7 +2678,7 @@ namespace Piccolo
                                                    (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
                                                    vertex_buffers,
                                                    offsets);
-                    m_rhi->cmdBindIndexBufferPFN(m_rhi->getCurrentCommandBuffer(), mesh.mesh_index_buffer, 0, RHI_INDEX_TYPE_UINT16);
+                    m_rhi->cmdBindIndexBufferPFN(m_rhi->getCurrentCommandBuffer(), mesh.mesh_index_buffer, 0, mesh.mesh_index_type);
 
                     uint32_t drawcall_max_instance_count =
                         (sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances) /
@@ -2285,67 +2716,16 @@ namespace Piccolo
                                 perdrawcall_dynamic_offset));
                         for (uint32_t i = 0; i < current_instance_count; ++i)
                         {
-                            perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
-                                *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                            perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
-                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0 :
-                                                                                                              -1.0;
+                            uint32_t instance_index =
+                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i].instance_index;
+                            perdrawcall_storage_buffer_object.mesh_instances[i].instance_index = instance_index;
+                            perdrawcall_storage_buffer_object.mesh_instances[i].joint_matrix_offset =
+                                m_mesh_instances->getJointMatrixOffset(instance_index);
                         }
 
-                        // per drawcall vertex blending storage buffer
-                        uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                        bool     least_one_enable_vertex_blending = true;
-                        for (uint32_t i = 0; i < current_instance_count; ++i)
-                        {
-                            if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                            {
-                                least_one_enable_vertex_blending = false;
-                                break;
-                            }
-                        }
-                        if (least_one_enable_vertex_blending)
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset =
-                                roundUp(m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                                per_drawcall_vertex_blending_dynamic_offset +
-                                sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                       ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                                   (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-                            MeshPerdrawcallVertexBlendingStorageBufferObject&
-                                per_drawcall_vertex_blending_storage_buffer_object =
-                                    (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                                        reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                        ._global_upload_ringbuffer_memory_pointer) +
-                                        per_drawcall_vertex_blending_dynamic_offset));
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                {
-                                    for (uint32_t j = 0;
-                                         j < mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                         ++j)
-                                    {
-                                        per_drawcall_vertex_blending_storage_buffer_object
-                                            .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
-                                                .joint_matrices[j];
-                                    }
-                                }
-                            }
-                        }
-                        else
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset = 0;
-                        }
+                        // the joint matrices of the frame are shared by all the drawcalls
+                        uint32_t per_drawcall_vertex_blending_dynamic_offset =
+                            m_mesh_instances->getJointMatricesDynamicOffset();
 
                         // bind perdrawcall
                         uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
@@ -2353,7 +2733,7 @@ namespace Piccolo
                                                        per_drawcall_vertex_blending_dynamic_offset};
                         m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
                                                         RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                        m_render_pipelines[_render_pipeline_type_mesh_gbuffer].layout,
+                                                        pipeline_layout,
                                                         0,
                                                         1,
                                                         &m_descriptor_infos[_mesh_global].descriptor_set,
@@ -2371,6 +2751,35 @@ namespace Piccolo
             }
         }
 
+        // the pre-skinned instances are drawn one by one from their skinned vertices
+        if (!pre_skinned_bindless_nodes.empty())
+        {
+            m_mesh_instances->drawPreSkinnedNodes(m_rhi->getCurrentCommandBuffer(),
+                                                  m_global_render_resource->_storage_buffer,
+                                                  m_rhi->getCurrentFrameIndex(),
+                                                  bindMeshPipeline(_render_pipeline_type_mesh_gbuffer, true),
+                                                  m_descriptor_infos[_mesh_global].descriptor_set,
+                                                  perframe_dynamic_offset,
+                                                  pre_skinned_bindless_nodes,
+                                                  true);
+        }
+        if (!pre_skinned_nodes.empty())
+        {
+            m_mesh_instances->drawPreSkinnedNodes(m_rhi->getCurrentCommandBuffer(),
+                                                  m_global_render_resource->_storage_buffer,
+                                                  m_rhi->getCurrentFrameIndex(),
+                                                  bindMeshPipeline(_render_pipeline_type_mesh_gbuffer, false),
+                                                  m_descriptor_infos[_mesh_global].descriptor_set,
+                                                  perframe_dynamic_offset,
+                                                  pre_skinned_nodes,
+                                                  true);
+        }
+
+        if (m_is_mesh_instances_culled)
+        {
+            drawMeshInstances(_render_pipeline_type_mesh_gbuffer_indirect, perframe_dynamic_offset);
+        }
+
         m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
     }
 
@@ -2422,39 +2831,39 @@ namespace Piccolo
     {
         struct MeshNode
         {
-            const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
+            uint32_t instance_index {0};
         };
 
         std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> main_camera_mesh_drawcall_batch;
+        std::vector<const RenderMeshNode*>                                          pre_skinned_nodes;
+        std::vector<const RenderMeshNode*>                                          pre_skinned_bindless_nodes;
 
-        // reorganize mesh
+        // reorganize mesh, the static ones are culled and drawn on the gpu when possible
         for (RenderMeshNode& node : *(m_visiable_nodes.p_main_camera_visible_mesh_nodes))
         {
-            auto& mesh_instanced = main_camera_mesh_drawcall_batch[node.ref_material];
-            auto& mesh_nodes     = mesh_instanced[node.ref_mesh];
+            if (m_is_mesh_instances_culled && !node.enable_vertex_blending)
+                continue;
 
-            MeshNode temp;
-            temp.model_matrix = node.model_matrix;
-            if (node.enable_vertex_blending)
+            const bool is_bindless = m_bindless_materials->isBindless(*node.ref_material);
+            if (m_mesh_instances->isPreSkinned(node.instance_index))
             {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
+                (is_bindless ? pre_skinned_bindless_nodes : pre_skinned_nodes).push_back(&node);
+                continue;
             }
 
+            // the bindless materials are bound once, the nodes of a mesh are drawn together whatever their material
+            auto& mesh_instanced = main_camera_mesh_drawcall_batch[is_bindless ? nullptr : node.ref_material];
+            auto& mesh_nodes     = mesh_instanced[node.ref_mesh];
+
+            MeshNode temp;
+            temp.instance_index = node.instance_index;
+
             mesh_nodes.push_back(temp);
         }
 
         float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
         m_rhi->pushEvent(m_rhi->getCurrentCommandBuffer(), "Model", color);
 
-        m_rhi->cmdBindPipelinePFN(m_rhi->getCurrentCommandBuffer(),
-                                  RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                  m_render_pipelines[_render_pipeline_type_mesh_lighting].pipeline);
-        m_rhi->cmdSetViewportPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, m_rhi->getSwapchainInfo().viewport);
-        m_rhi->cmdSetScissorPFN(m_rhi->getCurrentCommandBuffer(), 0, 1, m_rhi->getSwapchainInfo().scissor);
-
         // perframe storage buffer
         uint32_t perframe_dynamic_offset =
             roundUp(m_global_render_resource->_storage_buffer
@@ -2475,20 +2884,33 @@ namespace Piccolo
                 m_global_render_resource->_storage_buffer._global_upload_ringbuffer_memory_pointer) +
             perframe_dynamic_offset)) = m_mesh_perframe_storage_buffer_object;
 
+        // the bindless materials sort first, the pipeline switches once to the materials past their capacity
+        RHIPipelineLayout* pipeline_layout      = nullptr;
+        bool               is_pipeline_bindless = false;
         for (auto& pair1 : main_camera_mesh_drawcall_batch)
         {
-            VulkanPBRMaterial& material       = (*pair1.first);
+            VulkanPBRMaterial* material       = pair1.first;
             auto&              mesh_instanced = pair1.second;
 
+            const bool is_bindless = (material == nullptr);
+            if (pipeline_layout == nullptr || is_bindless != is_pipeline_bindless)
+            {
+                pipeline_layout      = bindMeshPipeline(_render_pipeline_type_mesh_lighting, is_bindless);
+                is_pipeline_bindless = is_bindless;
+            }
+
             // bind per material
-            m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
-                                            RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                            m_render_pipelines[_render_pipeline_type_mesh_lighting].layout,
-                                            2,
-                                            1,
-                                            &material.material_descriptor_set,
-                                            0,
-                                            NULL);
+            if (material)
+            {
+                m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
+                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                pipeline_layout,
+                                                2,
+                                                1,
+                                                &material->material_descriptor_set,
+                                                0,
+                                                NULL);
+            }
 
             // TODO: render from near to far
 
@@ -2503,7 +2925,7 @@ namespace Piccolo
                     // bind per mesh
                     m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
                                                     RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                    m_render_pipelines[_render_pipeline_type_mesh_lighting].layout,
+                                                    pipeline_layout,
                                                     1,
                                                     1,
                                                     &mesh.mesh_vertex_blending_descriptor_set,
@@ -2519,7 +2941,7 @@ namespace Piccolo
                                                    (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
                                                    vertex_buffers,
                                                    offsets);
-                    m_rhi->cmdBindIndexBufferPFN(m_rhi->getCurrentCommandBuffer(), mesh.mesh_index_buffer, 0, RHI_INDEX_TYPE_UINT16);
+                    m_rhi->cmdBindIndexBufferPFN(m_rhi->getCurrentCommandBuffer(), mesh.mesh_index_buffer, 0, mesh.mesh_index_type);
 
                     uint32_t drawcall_max_instance_count =
                         (sizeof(MeshPerdrawcallStorageBufferObject::mesh_instances) /
@@ -2557,67 +2979,16 @@ namespace Piccolo
                                 perdrawcall_dynamic_offset));
                         for (uint32_t i = 0; i < current_instance_count; ++i)
                         {
-                            perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
-                                *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                            perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
-                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0 :
-                                                                                                              -1.0;
+                            uint32_t instance_index =
+                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i].instance_index;
+                            perdrawcall_storage_buffer_object.mesh_instances[i].instance_index = instance_index;
+                            perdrawcall_storage_buffer_object.mesh_instances[i].joint_matrix_offset =
+                                m_mesh_instances->getJointMatrixOffset(instance_index);
                         }
 
-                        // per drawcall vertex blending storage buffer
-                        uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                        bool     least_one_enable_vertex_blending = true;
-                        for (uint32_t i = 0; i < current_instance_count; ++i)
-                        {
-                            if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                            {
-                                least_one_enable_vertex_blending = false;
-                                break;
-                            }
-                        }
-                        if (least_one_enable_vertex_blending)
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset =
-                                roundUp(m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                        m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                            m_global_render_resource->_storage_buffer
-                                ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                                per_drawcall_vertex_blending_dynamic_offset +
-                                sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
-                            assert(m_global_render_resource->_storage_buffer
-                                       ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                                   (m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-                            MeshPerdrawcallVertexBlendingStorageBufferObject&
-                                per_drawcall_vertex_blending_storage_buffer_object =
-                                    (*reinterpret_cast<MeshPerdrawcallVertexBlendingStorageBufferObject*>(
-                                        reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                        ._global_upload_ringbuffer_memory_pointer) +
-                                        per_drawcall_vertex_blending_dynamic_offset));
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                {
-                                    for (uint32_t j = 0;
-                                         j < mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                         ++j)
-                                    {
-                                        per_drawcall_vertex_blending_storage_buffer_object
-                                            .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                            mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
-                                                .joint_matrices[j];
-                                    }
-                                }
-                            }
-                        }
-                        else
-                        {
-                            per_drawcall_vertex_blending_dynamic_offset = 0;
-                        }
+                        // the joint matrices of the frame are shared by all the drawcalls
+                        uint32_t per_drawcall_vertex_blending_dynamic_offset =
+                            m_mesh_instances->getJointMatricesDynamicOffset();
 
                         // bind perdrawcall
                         uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
@@ -2625,7 +2996,7 @@ namespace Piccolo
                                                        per_drawcall_vertex_blending_dynamic_offset};
                         m_rhi->cmdBindDescriptorSetsPFN(m_rhi->getCurrentCommandBuffer(),
                                                         RHI_PIPELINE_BIND_POINT_GRAPHICS,
-                                                        m_render_pipelines[_render_pipeline_type_mesh_lighting].layout,
+                                                        pipeline_layout,
                                                         0,
                                                         1,
                                                         &m_descriptor_infos[_mesh_global].descriptor_set,
@@ -2643,6 +3014,35 @@ namespace Piccolo
             }
         }
 
+        // the pre-skinned instances are drawn one by one from their skinned vertices
+        if (!pre_skinned_bindless_nodes.empty())
+        {
+            m_mesh_instances->drawPreSkinnedNodes(m_rhi->getCurrentCommandBuffer(),
+                                                  m_global_render_resource->_storage_buffer,
+                                                  m_rhi->getCurrentFrameIndex(),
+                                                  bindMeshPipeline(_render_pipeline_type_mesh_lighting, true),
+                                                  m_descriptor_infos[_mesh_global].descriptor_set,
+                                                  perframe_dynamic_offset,
+                                                  pre_skinned_bindless_nodes,
+                                                  true);
+        }
+        if (!pre_skinned_nodes.empty())
+        {
+            m_mesh_instances->drawPreSkinnedNodes(m_rhi->getCurrentCommandBuffer(),
+                                                  m_global_render_resource->_storage_buffer,
+                                                  m_rhi->getCurrentFrameIndex(),
+                                                  bindMeshPipeline(_render_pipeline_type_mesh_lighting, false),
+                                                  m_descriptor_infos[_mesh_global].descriptor_set,
+                                                  perframe_dynamic_offset,
+                                                  pre_skinned_nodes,
+                                                  true);
+        }
+
+        if (m_is_mesh_instances_culled)
+        {
+            drawMeshInstances(_render_pipeline_type_mesh_lighting_indirect, perframe_dynamic_offset);
+        }
+
         m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
     }
 
@@ -2742,7 +3142,7 @@ namespace Piccolo
         m_rhi->cmdBindIndexBufferPFN(m_rhi->getCurrentCommandBuffer(),
                                      m_visiable_nodes.p_axis_node->ref_mesh->mesh_index_buffer,
                                      0,
-                                     RHI_INDEX_TYPE_UINT16);
+                                     m_visiable_nodes.p_axis_node->ref_mesh->mesh_index_type);
         (*reinterpret_cast<AxisStorageBufferObject*>(reinterpret_cast<uintptr_t>(
             m_global_render_resource->_storage_buffer._axis_inefficient_storage_buffer_memory_pointer))) =
             m_axis_storage_buffer_object;
@@ -2757,6 +3157,243 @@ namespace Piccolo
         m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
     }
 
+    void MainCameraPass::cullMeshInstances()
+    {
+        m_is_mesh_instances_culled = m_mesh_instances->isGpuDrivenEnabled();
+        if (!m_is_mesh_instances_culled)
+            return;
+
+        RHICommandBuffer* command_buffer = m_rhi->getCurrentCommandBuffer();
+        StorageBuffer&    storage_buffer = m_global_render_resource->_storage_buffer;
+        const uint8_t     frame_index    = m_rhi->getCurrentFrameIndex();
+
+        const std::vector<MeshInstanceBatch>& batches = m_mesh_instances->getBatches();
+        if (batches.empty())
+            return;
+
+        float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        m_rhi->pushEvent(command_buffer, "Mesh Instance Culling", color);
+
+        // perframe storage buffer
+        uint32_t perframe_dynamic_offset = roundUp(storage_buffer._global_upload_ringbuffers_end[frame_index],
+                                                   storage_buffer._min_storage_buffer_offset_alignment);
+        storage_buffer._global_upload_ringbuffers_end[frame_index] =
+            perframe_dynamic_offset + sizeof(MeshInstanceCullingPerframeStorageBufferObject);
+        assert(storage_buffer._global_upload_ringbuffers_end[frame_index] <=
+               (storage_buffer._global_upload_ringbuffers_begin[frame_index] +
+                storage_buffer._global_upload_ringbuffers_size[frame_index]));
+
+        MeshInstanceCullingPerframeStorageBufferObject& perframe_storage_buffer_object =
+            (*reinterpret_cast<MeshInstanceCullingPerframeStorageBufferObject*>(
+                reinterpret_cast<uintptr_t>(storage_buffer._global_upload_ringbuffer_memory_pointer) +
+                perframe_dynamic_offset));
+
+        ClusterFrustum frustum = CreateClusterFrustumFromMatrix(
+            m_mesh_perframe_storage_buffer_object.proj_view_matrix, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
+        perframe_storage_buffer_object.frustum_planes[0] = frustum.m_plane_right;
+        perframe_storage_buffer_object.frustum_planes[1] = frustum.m_plane_left;
+        perframe_storage_buffer_object.frustum_planes[2] = frustum.m_plane_top;
+        perframe_storage_buffer_object.frustum_planes[3] = frustum.m_plane_bottom;
+        perframe_storage_buffer_object.frustum_planes[4] = frustum.m_plane_near;
+        perframe_storage_buffer_object.frustum_planes[5] = frustum.m_plane_far;
+        perframe_storage_buffer_object.instance_count    = m_mesh_instances->getInstanceCount();
+
+        // one draw per batch, the culling counts the visible instances in and the draws read them back
+        uint32_t draw_commands_dynamic_offset = roundUp(storage_buffer._global_upload_ringbuffers_end[frame_index],
+                                                        storage_buffer._min_storage_buffer_offset_alignment);
+        storage_buffer._global_upload_ringbuffers_end[frame_index] =
+            draw_commands_dynamic_offset +
+            static_cast<uint32_t>(sizeof(MeshDrawIndexedIndirectCommand) * batches.size());
+        assert(storage_buffer._global_upload_ringbuffers_end[frame_index] <=
+               (storage_buffer._global_upload_ringbuffers_begin[frame_index] +
+                storage_buffer._global_upload_ringbuffers_size[frame_index]));
+
+        MeshDrawIndexedIndirectCommand* draw_commands = reinterpret_cast<MeshDrawIndexedIndirectCommand*>(
+            reinterpret_cast<uintptr_t>(storage_buffer._global_upload_ringbuffer_memory_pointer) +
+            draw_commands_dynamic_offset);
+        for (size_t batch_index = 0; batch_index < batches.size(); ++batch_index)
+        {
+            MeshDrawIndexedIndirectCommand& draw_command = draw_commands[batch_index];
+            draw_command.index_count                     = batches[batch_index].m_mesh->mesh_index_count;
+            draw_command.instance_count                  = 0;
+            draw_command.first_index                     = 0;
+            draw_command.vertex_offset                   = 0;
+            draw_command.first_instance                  = batches[batch_index].m_first_instance;
+        }
+        m_mesh_instance_draw_commands_offset = draw_commands_dynamic_offset;
+
+        // the frames before read the visible instances in the vertex shader
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr);
+
+        m_rhi->cmdBindPipelinePFN(command_buffer,
+                                  RHI_PIPELINE_BIND_POINT_COMPUTE,
+                                  m_render_pipelines[_render_pipeline_type_mesh_instance_culling].pipeline);
+
+        uint32_t dynamic_offsets[2] = {perframe_dynamic_offset, draw_commands_dynamic_offset};
+        m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                        RHI_PIPELINE_BIND_POINT_COMPUTE,
+                                        m_render_pipelines[_render_pipeline_type_mesh_instance_culling].layout,
+                                        0,
+                                        1,
+                                        &m_descriptor_infos[_mesh_instance_culling].descriptor_set,
+                                        2,
+                                        dynamic_offsets);
+
+        // local_size_x in mesh_instance_culling.comp
+        m_rhi->cmdDispatch(command_buffer, (m_mesh_instances->getInstanceCount() + 63) / 64, 1, 1);
+
+        RHIMemoryBarrier barrier {};
+        barrier.sType         = RHI_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = RHI_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = RHI_ACCESS_INDIRECT_COMMAND_READ_BIT | RHI_ACCESS_SHADER_READ_BIT;
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  RHI_PIPELINE_STAGE_DRAW_INDIRECT_BIT | RHI_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                                  0,
+                                  1,
+                                  &barrier,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr);
+
+        m_rhi->popEvent(command_buffer);
+    }
+
+    RHIPipelineLayout* MainCameraPass::bindMeshPipeline(RenderPipeLineType type, bool is_bindless)
+    {
+        RenderPipeLineType pipeline_type = type;
+        if (is_bindless)
+        {
+            switch (type)
+            {
+                case _render_pipeline_type_mesh_gbuffer:
+                    pipeline_type = _render_pipeline_type_mesh_gbuffer_bindless;
+                    break;
+                case _render_pipeline_type_mesh_lighting:
+                    pipeline_type = _render_pipeline_type_mesh_lighting_bindless;
+                    break;
+                case _render_pipeline_type_mesh_gbuffer_indirect:
+                    pipeline_type = _render_pipeline_type_mesh_gbuffer_indirect_bindless;
+                    break;
+                case _render_pipeline_type_mesh_lighting_indirect:
+                    pipeline_type = _render_pipeline_type_mesh_lighting_indirect_bindless;
+                    break;
+                default:
+                    assert(0);
+                    break;
+            }
+        }
+
+        RHICommandBuffer* command_buffer = m_rhi->getCurrentCommandBuffer();
+
+        m_rhi->cmdBindPipelinePFN(
+            command_buffer, RHI_PIPELINE_BIND_POINT_GRAPHICS, m_render_pipelines[pipeline_type].pipeline);
+        m_rhi->cmdSetViewportPFN(command_buffer, 0, 1, m_rhi->getSwapchainInfo().viewport);
+        m_rhi->cmdSetScissorPFN(command_buffer, 0, 1, m_rhi->getSwapchainInfo().scissor);
+
+        if (is_bindless)
+        {
+            m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                            RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                            m_render_pipelines[pipeline_type].layout,
+                                            2,
+                                            1,
+                                            m_bindless_materials->getDescriptorSet(),
+                                            0,
+                                            NULL);
+        }
+
+        return m_render_pipelines[pipeline_type].layout;
+    }
+
+    void MainCameraPass::drawMeshInstances(RenderPipeLineType type, uint32_t perframe_dynamic_offset)
+    {
+        const std::vector<MeshInstanceBatch>& batches = m_mesh_instances->getBatches();
+        if (batches.empty())
+            return;
+
+        RHICommandBuffer* command_buffer = m_rhi->getCurrentCommandBuffer();
+
+        // the batches are sorted by material, the bindless batches have none and come first, the pipeline switches
+        // once to the materials past the bindless capacity
+        RHIPipelineLayout*       pipeline_layout      = nullptr;
+        bool                     is_pipeline_bindless = false;
+        const VulkanPBRMaterial* bound_material       = nullptr;
+        for (size_t batch_index = 0; batch_index < batches.size(); ++batch_index)
+        {
+            const MeshInstanceBatch& batch = batches[batch_index];
+            VulkanMesh&              mesh  = *batch.m_mesh;
+
+            const bool is_bindless = (batch.m_material == nullptr);
+            if (pipeline_layout == nullptr || is_bindless != is_pipeline_bindless)
+            {
+                pipeline_layout      = bindMeshPipeline(type, is_bindless);
+                is_pipeline_bindless = is_bindless;
+                bound_material       = nullptr;
+
+                // the per drawcall bindings are not read by the instance vertex shader
+                uint32_t dynamic_offsets[3] = {perframe_dynamic_offset, 0, 0};
+                m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                pipeline_layout,
+                                                0,
+                                                1,
+                                                &m_descriptor_infos[_mesh_global].descriptor_set,
+                                                3,
+                                                dynamic_offsets);
+                m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                pipeline_layout,
+                                                3,
+                                                1,
+                                                &m_descriptor_infos[_mesh_instance].descriptor_set,
+                                                0,
+                                                NULL);
+            }
+
+            if (!is_bindless && batch.m_material != bound_material)
+            {
+                m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                pipeline_layout,
+                                                2,
+                                                1,
+                                                &batch.m_material->material_descriptor_set,
+                                                0,
+                                                NULL);
+                bound_material = batch.m_material;
+            }
+
+            RHIBuffer*    vertex_buffers[] = {mesh.mesh_vertex_position_buffer,
+                                              mesh.mesh_vertex_varying_enable_blending_buffer,
+                                              mesh.mesh_vertex_varying_buffer};
+            RHIDeviceSize offsets[]        = {0, 0, 0};
+            m_rhi->cmdBindVertexBuffersPFN(command_buffer,
+                                           0,
+                                           (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
+                                           vertex_buffers,
+                                           offsets);
+            m_rhi->cmdBindIndexBufferPFN(command_buffer, mesh.mesh_index_buffer, 0, mesh.mesh_index_type);
+
+            m_rhi->cmdDrawIndexedIndirect(command_buffer,
+                                          m_global_render_resource->_storage_buffer._global_upload_ringbuffer,
+                                          m_mesh_instance_draw_commands_offset +
+                                              sizeof(MeshDrawIndexedIndirectCommand) * batch_index,
+                                          1,
+                                          sizeof(MeshDrawIndexedIndirectCommand));
+        }
+    }
+
     RHICommandBuffer* MainCameraPass::getRenderCommandBuffer() { return m_rhi->getCurrentCommandBuffer(); }
 
     void MainCameraPass::setupParticlePass()
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "runtime/core/job/job_system.h"
+
 #include "runtime/function/render/render_pass.h"
 
 #include "runtime/function/render/passes/color_grading_pass.h"
@@ -10,9 +12,14 @@
 #include "runtime/function/render/passes/particle_pass.h"
 #include "runtime/function/render/passes/scan_pass.h"
 
+#include <functional>
+#include <vector>
+
 namespace Piccolo
 {
     class RenderResourceBase;
+    class RenderBindlessMaterials;
+    class RenderMeshInstances;
 
     struct MainCameraPassInitInfo : RenderPassInitInfo
     {
@@ -29,6 +36,9 @@ namespace Piccolo
         // 5: axis layout
         // 6: billboard type particle layout
         // 7: gbuffer lighting
+        // 8: mesh instance culling layout
+        // 9: mesh instance layout
+        // 10: mesh bindless material layout, owned by the bindless materials
         enum LayoutType : uint8_t
         {
             _per_mesh = 0,
@@ -38,6 +48,9 @@ namespace Piccolo
             _axis,
             _particle,
             _deferred_lighting,
+            _mesh_instance_culling,
+            _mesh_instance,
+            _mesh_bindless_material,
             _layout_type_count
         };
 
@@ -45,6 +58,8 @@ namespace Piccolo
         // 2. sky box
         // 3. axis
         // 4. billboard type particle
+        // 5. gpu driven model
+        // 6. model with the bindless materials
         enum RenderPipeLineType : uint8_t
         {
             _render_pipeline_type_mesh_gbuffer = 0,
@@ -53,11 +68,22 @@ namespace Piccolo
             _render_pipeline_type_skybox,
             _render_pipeline_type_axis,
             _render_pipeline_type_particle,
+            _render_pipeline_type_mesh_instance_culling,
+            _render_pipeline_type_mesh_gbuffer_indirect,
+            _render_pipeline_type_mesh_lighting_indirect,
+            _render_pipeline_type_mesh_gbuffer_bindless,
+            _render_pipeline_type_mesh_lighting_bindless,
+            _render_pipeline_type_mesh_gbuffer_indirect_bindless,
+            _render_pipeline_type_mesh_lighting_indirect_bindless,
             _render_pipeline_type_count
         };
 
         void initialize(const RenderPassInitInfo* init_info) override final;
 
+        /// the pipelines are compiled on the job system while the other passes initialize, to wait for before the
+        /// first frame, rethrows the failure of a pipeline
+        void waitForPipelines();
+
         void preparePassData(std::shared_ptr<RenderResourceBase> render_resource) override final;
 
         void draw(ColorGradingPass& color_grading_pass,
@@ -112,6 +138,19 @@ namespace Piccolo
         void setupAxisDescriptorSet();
         void setupParticleDescriptorSet();
         void setupGbufferLightingDescriptorSet();
+        void setupMeshInstanceDescriptorSet();
+        void updateMeshInstanceDescriptorSets();
+        void setupMeshInstancePipeline(RenderPipeLineType            type,
+                                       RHIGraphicsPipelineCreateInfo pipeline_info,
+                                       RHIDescriptorSetLayout*       material_layout);
+        void setupBindlessMaterialPipeline(RenderPipeLineType                type,
+                                           RenderPipeLineType                indirect_type,
+                                           RHIGraphicsPipelineCreateInfo     pipeline_info,
+                                           const std::vector<unsigned char>& frag_shader_code);
+        /// bind the pipeline of the type or its bindless variant with the viewport and scissor, and the bindless
+        /// material set for the variant, return its layout
+        RHIPipelineLayout* bindMeshPipeline(RenderPipeLineType type, bool is_bindless);
+        void schedulePipelineSetup(const char* name, std::function<void()> setup_function);
 
         void drawMeshGbuffer();
         void drawDeferredLighting();
@@ -119,11 +158,24 @@ namespace Piccolo
         void drawSkybox();
         void drawAxis();
 
+        // gpu driven path of the static meshes, the culling has to be recorded outside of the render pass
+        void cullMeshInstances();
+        void drawMeshInstances(RenderPipeLineType type, uint32_t perframe_dynamic_offset);
+
 
 
     private:
         std::vector<RHIFramebuffer*> m_swapchain_framebuffers;
         std::shared_ptr<ParticlePass> m_particle_pass;
         std::shared_ptr<ScanPass>     m_scan_pass;
+
+        RenderMeshInstances*     m_mesh_instances {nullptr};
+        uint32_t                 m_mesh_instance_buffer_version {0};
+        RenderBindlessMaterials* m_bindless_materials {nullptr};
+        // whether the static meshes of the frame are drawn from the culled instances
+        bool     m_is_mesh_instances_culled {false};
+        uint32_t m_mesh_instance_draw_commands_offset {0};
+
+        std::vector<JobHandle> m_pipeline_jobs;
     };
 } // namespace Piccolo
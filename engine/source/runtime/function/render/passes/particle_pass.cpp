@@ -30,6 +30,7 @@ namespace Piccolo
         rhi->freeMemory(m_dead_list_memory);
         rhi->freeMemory(m_particle_component_res_memory);
         rhi->freeMemory(m_position_render_memory);
+        rhi->freeMemory(m_draw_argument_memory);
 
         rhi->destroyBuffer(m_position_render_buffer);
         rhi->destroyBuffer(m_position_device_buffer);
@@ -41,6 +42,7 @@ namespace Piccolo
         rhi->destroyBuffer(m_alive_list_next_buffer);
         rhi->destroyBuffer(m_dead_list_buffer);
         rhi->destroyBuffer(m_particle_component_res_buffer);
+        rhi->destroyBuffer(m_draw_argument_buffer);
     }
 
     void ParticlePass::copyNormalAndDepthImage()
@@ -48,7 +50,11 @@ namespace Piccolo
         uint8_t index =
             (m_rhi->getCurrentFrameIndex() + m_rhi->getMaxFramesInFlight() - 1) % m_rhi->getMaxFramesInFlight();
 
-        m_rhi->waitForFencesPFN(1, &(m_rhi->getFenceList()[index]), VK_TRUE, UINT64_MAX);
+        // the simulation of the frame waits on the copy, so its fence also tells when the copy is done
+        SimulationFrame& simulation_frame = m_simulation_frames[index];
+        m_rhi->waitForFencesPFN(1, &simulation_frame.m_fence, VK_TRUE, UINT64_MAX);
+
+        RHICommandBuffer* m_copy_command_buffer = simulation_frame.m_copy_command_buffer;
 
         RHICommandBufferBeginInfo command_buffer_begin_info {};
         command_buffer_begin_info.sType            = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -235,28 +241,36 @@ namespace Piccolo
         bool res_end_command_buffer = m_rhi->endCommandBufferPFN(m_copy_command_buffer);
         assert(RHI_SUCCESS == res_end_command_buffer);
 
-        bool res_reset_fences = m_rhi->resetFencesPFN(1, &m_rhi->getFenceList()[index]);
-        assert(RHI_SUCCESS == res_reset_fences);
-
-        RHIPipelineStageFlags wait_stages[] = {RHI_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-        RHISubmitInfo         submit_info   = {};
-        submit_info.sType                   = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
-        submit_info.waitSemaphoreCount      = 1;
-        submit_info.pWaitSemaphores         = &(m_rhi->getTextureCopySemaphore(index));
-        submit_info.pWaitDstStageMask       = wait_stages;
-        submit_info.commandBufferCount      = 1;
-        submit_info.pCommandBuffers         = &m_copy_command_buffer;
-        submit_info.signalSemaphoreCount    = 0;
-        submit_info.pSignalSemaphores       = nullptr;
-        bool res_queue_submit =
-            m_rhi->queueSubmit(m_rhi->getGraphicsQueue(), 1, &submit_info, m_rhi->getFenceList()[index]);
+        // the rendering of the frame, then the previous simulation still reading the copies
+        RHISemaphore*         wait_semaphores[2] = {m_rhi->getTextureCopySemaphore(index), nullptr};
+        RHIPipelineStageFlags wait_stages[2]     = {RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                                    RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT};
+        uint32_t              wait_count         = 1;
+        if (m_is_simulation_pending)
+        {
+            wait_semaphores[wait_count++] =
+                m_simulation_frames[m_pending_simulation_frame].m_simulation_finished_for_copy_semaphore;
+        }
+        const RHISemaphore* signal_semaphores[1] = {simulation_frame.m_copy_finished_semaphore};
+
+        RHISubmitInfo submit_info        = {};
+        submit_info.sType                = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.waitSemaphoreCount   = wait_count;
+        submit_info.pWaitSemaphores      = wait_semaphores;
+        submit_info.pWaitDstStageMask    = wait_stages;
+        submit_info.commandBufferCount   = 1;
+        submit_info.pCommandBuffers      = &m_copy_command_buffer;
+        submit_info.signalSemaphoreCount = 1;
+        submit_info.pSignalSemaphores    = signal_semaphores;
+        bool res_queue_submit = m_rhi->queueSubmit(m_rhi->getGraphicsQueue(), 1, &submit_info, nullptr);
         assert(RHI_SUCCESS == res_queue_submit);
-
-        m_rhi->queueWaitIdle(m_rhi->getGraphicsQueue());
     }
 
     void ParticlePass::updateAfterFramebufferRecreate()
     {
+        // the copies and the simulations in flight use the images
+        waitForSimulationFrames();
+
         m_rhi->destroyImage(m_dst_depth_image);
         m_rhi->freeMemory(m_dst_depth_image_memory);
 
@@ -310,6 +324,19 @@ namespace Piccolo
     {
         for (int i = 0; i < m_emitter_count; ++i)
         {
+            const ParticleEmitterBufferBatch& batch = m_emitter_buffer_batches[i];
+
+            // a simulation the rendering does not wait on yet is still writing its half, draw the previous one
+            uint32_t slot             = batch.m_simulated_slot;
+            uint32_t simulation_count = batch.m_simulation_count;
+            if (batch.m_last_simulation > m_visible_simulation)
+            {
+                slot = 1 - slot;
+                --simulation_count;
+            }
+            if (simulation_count == 0)
+                continue;
+
             float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
             m_rhi->pushEvent(m_render_command_buffer, "ParticleBillboard", color);
 
@@ -322,11 +349,13 @@ namespace Piccolo
                                             m_render_pipelines[1].layout,
                                             0,
                                             1,
-                                            &m_descriptor_infos[i * 3 + 2].descriptor_set,
+                                            &m_descriptor_infos[i * s_emitter_descriptor_set_count + 2 + slot].descriptor_set,
                                             0,
                                             NULL);
 
-            m_rhi->cmdDraw(m_render_command_buffer, 4, m_emitter_buffer_batches[i].m_num_particle, 0, 0);
+            // the instance count is the alive count copied on the device after the simulation
+            m_rhi->cmdDrawIndirect(
+                m_render_command_buffer, batch.m_draw_argument_buffer, slot * sizeof(DrawArgument), 1, sizeof(DrawArgument));
 
             m_rhi->popEvent(m_render_command_buffer);
         }
@@ -405,92 +434,100 @@ namespace Piccolo
     {
         for (int eid = 0; eid < m_emitter_count; ++eid)
         {
-            RHIDescriptorSetAllocateInfo particlebillboard_global_descriptor_set_alloc_info;
-            particlebillboard_global_descriptor_set_alloc_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-            particlebillboard_global_descriptor_set_alloc_info.pNext = NULL;
-            particlebillboard_global_descriptor_set_alloc_info.descriptorPool     = m_rhi->getDescriptorPoor();
-            particlebillboard_global_descriptor_set_alloc_info.descriptorSetCount = 1;
-            particlebillboard_global_descriptor_set_alloc_info.pSetLayouts        = &m_descriptor_infos[2].layout;
-
-            if (RHI_SUCCESS != m_rhi->allocateDescriptorSets(&particlebillboard_global_descriptor_set_alloc_info,
-                                                             m_descriptor_infos[eid * 3 + 2].descriptor_set))
+            for (uint32_t slot = 0; slot < 2; ++slot)
             {
-                throw std::runtime_error("allocate particle billboard global descriptor set");
-            }
+                RHIDescriptorSetAllocateInfo particlebillboard_global_descriptor_set_alloc_info;
+                particlebillboard_global_descriptor_set_alloc_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+                particlebillboard_global_descriptor_set_alloc_info.pNext = NULL;
+                particlebillboard_global_descriptor_set_alloc_info.descriptorPool     = m_rhi->getDescriptorPoor();
+                particlebillboard_global_descriptor_set_alloc_info.descriptorSetCount = 1;
+                particlebillboard_global_descriptor_set_alloc_info.pSetLayouts        = &m_descriptor_infos[2].layout;
+
+                RHIDescriptorSet*& billboard_descriptor_set =
+                    m_descriptor_infos[eid * s_emitter_descriptor_set_count + 2 + slot].descriptor_set;
+                if (RHI_SUCCESS != m_rhi->allocateDescriptorSets(&particlebillboard_global_descriptor_set_alloc_info,
+                                                                 billboard_descriptor_set))
+                {
+                    throw std::runtime_error("allocate particle billboard global descriptor set");
+                }
 
-            RHIDescriptorBufferInfo particlebillboard_perframe_storage_buffer_info = {};
-            particlebillboard_perframe_storage_buffer_info.offset                  = 0;
-            particlebillboard_perframe_storage_buffer_info.range                   = RHI_WHOLE_SIZE;
-            particlebillboard_perframe_storage_buffer_info.buffer = m_particle_billboard_uniform_buffer;
-
-            RHIDescriptorBufferInfo particlebillboard_perdrawcall_storage_buffer_info = {};
-            particlebillboard_perdrawcall_storage_buffer_info.offset                  = 0;
-            particlebillboard_perdrawcall_storage_buffer_info.range                   = RHI_WHOLE_SIZE;
-            particlebillboard_perdrawcall_storage_buffer_info.buffer =
-                m_emitter_buffer_batches[eid].m_position_render_buffer;
-
-            RHIWriteDescriptorSet particlebillboard_descriptor_writes_info[3];
-
-            particlebillboard_descriptor_writes_info[0].sType      = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            particlebillboard_descriptor_writes_info[0].pNext      = NULL;
-            particlebillboard_descriptor_writes_info[0].dstSet     = m_descriptor_infos[eid * 3 + 2].descriptor_set;
-            particlebillboard_descriptor_writes_info[0].dstBinding = 0;
-            particlebillboard_descriptor_writes_info[0].dstArrayElement = 0;
-            particlebillboard_descriptor_writes_info[0].descriptorType  = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            particlebillboard_descriptor_writes_info[0].descriptorCount = 1;
-            particlebillboard_descriptor_writes_info[0].pBufferInfo = &particlebillboard_perframe_storage_buffer_info;
-
-            particlebillboard_descriptor_writes_info[1].sType      = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            particlebillboard_descriptor_writes_info[1].pNext      = NULL;
-            particlebillboard_descriptor_writes_info[1].dstSet     = m_descriptor_infos[eid * 3 + 2].descriptor_set;
-            particlebillboard_descriptor_writes_info[1].dstBinding = 1;
-            particlebillboard_descriptor_writes_info[1].dstArrayElement = 0;
-            particlebillboard_descriptor_writes_info[1].descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-            particlebillboard_descriptor_writes_info[1].descriptorCount = 1;
-            particlebillboard_descriptor_writes_info[1].pBufferInfo =
-                &particlebillboard_perdrawcall_storage_buffer_info;
-
-            RHISampler*          sampler;
-            RHISamplerCreateInfo samplerCreateInfo {};
-            samplerCreateInfo.sType            = RHI_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-            samplerCreateInfo.maxAnisotropy    = 1.0f;
-            samplerCreateInfo.anisotropyEnable = true;
-            samplerCreateInfo.magFilter        = RHI_FILTER_LINEAR;
-            samplerCreateInfo.minFilter        = RHI_FILTER_LINEAR;
-            samplerCreateInfo.mipmapMode       = RHI_SAMPLER_MIPMAP_MODE_LINEAR;
-            samplerCreateInfo.addressModeU     = RHI_SAMPLER_ADDRESS_MODE_REPEAT;
-            samplerCreateInfo.addressModeV     = RHI_SAMPLER_ADDRESS_MODE_REPEAT;
-            samplerCreateInfo.addressModeW     = RHI_SAMPLER_ADDRESS_MODE_REPEAT;
-            samplerCreateInfo.mipLodBias       = 0.0f;
-            samplerCreateInfo.compareOp        = RHI_COMPARE_OP_NEVER;
-            samplerCreateInfo.minLod           = 0.0f;
-            samplerCreateInfo.maxLod           = 0.0f;
-            samplerCreateInfo.borderColor      = RHI_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
-            if (RHI_SUCCESS != m_rhi->createSampler(&samplerCreateInfo, sampler))
-            {
-                throw std::runtime_error("create sampler error");
-            }
+                RHIDescriptorBufferInfo particlebillboard_perframe_storage_buffer_info = {};
+                particlebillboard_perframe_storage_buffer_info.offset                  = 0;
+                particlebillboard_perframe_storage_buffer_info.range                   = RHI_WHOLE_SIZE;
+                particlebillboard_perframe_storage_buffer_info.buffer = m_particle_billboard_uniform_buffer;
+
+                RHIDescriptorBufferInfo particlebillboard_perdrawcall_storage_buffer_info = {};
+                particlebillboard_perdrawcall_storage_buffer_info.offset = slot * s_max_particles * sizeof(Particle);
+                particlebillboard_perdrawcall_storage_buffer_info.range  = s_max_particles * sizeof(Particle);
+                particlebillboard_perdrawcall_storage_buffer_info.buffer =
+                    m_emitter_buffer_batches[eid].m_position_render_buffer;
+
+                RHIWriteDescriptorSet particlebillboard_descriptor_writes_info[3];
+
+                particlebillboard_descriptor_writes_info[0].sType      = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                particlebillboard_descriptor_writes_info[0].pNext      = NULL;
+                particlebillboard_descriptor_writes_info[0].dstSet     = billboard_descriptor_set;
+                particlebillboard_descriptor_writes_info[0].dstBinding = 0;
+                particlebillboard_descriptor_writes_info[0].dstArrayElement = 0;
+                particlebillboard_descriptor_writes_info[0].descriptorType  = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                particlebillboard_descriptor_writes_info[0].descriptorCount = 1;
+                particlebillboard_descriptor_writes_info[0].pBufferInfo = &particlebillboard_perframe_storage_buffer_info;
+
+                particlebillboard_descriptor_writes_info[1].sType      = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                particlebillboard_descriptor_writes_info[1].pNext      = NULL;
+                particlebillboard_descriptor_writes_info[1].dstSet     = billboard_descriptor_set;
+                particlebillboard_descriptor_writes_info[1].dstBinding = 1;
+                particlebillboard_descriptor_writes_info[1].dstArrayElement = 0;
+                particlebillboard_descriptor_writes_info[1].descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                particlebillboard_descriptor_writes_info[1].descriptorCount = 1;
+                particlebillboard_descriptor_writes_info[1].pBufferInfo =
+                    &particlebillboard_perdrawcall_storage_buffer_info;
+
+                RHISampler*          sampler;
+                RHISamplerCreateInfo samplerCreateInfo {};
+                samplerCreateInfo.sType            = RHI_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+                samplerCreateInfo.maxAnisotropy    = 1.0f;
+                samplerCreateInfo.anisotropyEnable = true;
+                samplerCreateInfo.magFilter        = RHI_FILTER_LINEAR;
+                samplerCreateInfo.minFilter        = RHI_FILTER_LINEAR;
+                samplerCreateInfo.mipmapMode       = RHI_SAMPLER_MIPMAP_MODE_LINEAR;
+                samplerCreateInfo.addressModeU     = RHI_SAMPLER_ADDRESS_MODE_REPEAT;
+                samplerCreateInfo.addressModeV     = RHI_SAMPLER_ADDRESS_MODE_REPEAT;
+                samplerCreateInfo.addressModeW     = RHI_SAMPLER_ADDRESS_MODE_REPEAT;
+                samplerCreateInfo.mipLodBias       = 0.0f;
+                samplerCreateInfo.compareOp        = RHI_COMPARE_OP_NEVER;
+                samplerCreateInfo.minLod           = 0.0f;
+                samplerCreateInfo.maxLod           = 0.0f;
+                samplerCreateInfo.borderColor      = RHI_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
+                if (RHI_SUCCESS != m_rhi->createSampler(&samplerCreateInfo, sampler))
+                {
+                    throw std::runtime_error("create sampler error");
+                }
 
-            RHIDescriptorImageInfo particle_texture_image_info = {};
-            particle_texture_image_info.sampler                = sampler;
-            particle_texture_image_info.imageView              = m_particle_billboard_texture_image_view;
-            particle_texture_image_info.imageLayout            = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-            particlebillboard_descriptor_writes_info[2].sType      = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            particlebillboard_descriptor_writes_info[2].pNext      = NULL;
-            particlebillboard_descriptor_writes_info[2].dstSet     = m_descriptor_infos[eid * 3 + 2].descriptor_set;
-            particlebillboard_descriptor_writes_info[2].dstBinding = 2;
-            particlebillboard_descriptor_writes_info[2].dstArrayElement = 0;
-            particlebillboard_descriptor_writes_info[2].descriptorType  = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            particlebillboard_descriptor_writes_info[2].descriptorCount = 1;
-            particlebillboard_descriptor_writes_info[2].pImageInfo      = &particle_texture_image_info;
-
-            m_rhi->updateDescriptorSets(3, particlebillboard_descriptor_writes_info, 0, NULL);
+                RHIDescriptorImageInfo particle_texture_image_info = {};
+                particle_texture_image_info.sampler                = sampler;
+                particle_texture_image_info.imageView              = m_particle_billboard_texture_image_view;
+                particle_texture_image_info.imageLayout            = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+                particlebillboard_descriptor_writes_info[2].sType      = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                particlebillboard_descriptor_writes_info[2].pNext      = NULL;
+                particlebillboard_descriptor_writes_info[2].dstSet     = billboard_descriptor_set;
+                particlebillboard_descriptor_writes_info[2].dstBinding = 2;
+                particlebillboard_descriptor_writes_info[2].dstArrayElement = 0;
+                particlebillboard_descriptor_writes_info[2].descriptorType  = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                particlebillboard_descriptor_writes_info[2].descriptorCount = 1;
+                particlebillboard_descriptor_writes_info[2].pImageInfo      = &particle_texture_image_info;
+
+                m_rhi->updateDescriptorSets(3, particlebillboard_descriptor_writes_info, 0, NULL);
+            }
         }
     }
 
     void ParticlePass::setEmitterCount(int count)
     {
+        // the simulations in flight still use the buffers
+        waitForSimulationFrames();
+
         for (int i = 0; i < m_emitter_buffer_batches.size(); ++i)
         {
             m_emitter_buffer_batches[i].freeUpBatch(m_rhi);
@@ -659,7 +696,8 @@ namespace Piccolo
         // fill in data
         {
 
-            m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            // updated from the uniform staging buffer of the frame, see recordUniformUpload
+            m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
                                              RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
                                                  RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                                              m_emitter_buffer_batches[id].m_particle_component_res_buffer,
@@ -668,14 +706,15 @@ namespace Piccolo
                                              &m_emitter_buffer_batches[id].m_emitter_desc,
                                              sizeof(ParticleEmitterDesc));
 
-            if (RHI_SUCCESS != m_rhi->mapMemory(m_emitter_buffer_batches[id].m_particle_component_res_memory,
-                                                0,
-                                                RHI_WHOLE_SIZE,
-                                                0,
-                                                &m_emitter_buffer_batches[id].m_emitter_desc_mapped))
-            {
-                throw std::runtime_error("map emitter component res buffer");
-            }
+            // nothing is drawn before the first simulation, the instance count is written by the simulations
+            DrawArgument draw_arguments[2] = {{4, 0, 0, 0}, {4, 0, 0, 0}};
+            m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_INDIRECT_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                             RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+                                             m_emitter_buffer_batches[id].m_draw_argument_buffer,
+                                             m_emitter_buffer_batches[id].m_draw_argument_memory,
+                                             sizeof(draw_arguments),
+                                             draw_arguments,
+                                             sizeof(draw_arguments));
 
             m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_TRANSFER_SRC_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
                                              RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
@@ -699,12 +738,13 @@ namespace Piccolo
                                              m_emitter_buffer_batches[id].m_position_device_memory,
                                              staggingBuferSize);
 
+            // one half per slot, see ParticleEmitterBufferBatch
             m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_SRC_BIT |
                                                  RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
                                              RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
                                              m_emitter_buffer_batches[id].m_position_render_buffer,
                                              m_emitter_buffer_batches[id].m_position_render_memory,
-                                             staggingBuferSize);
+                                             2 * staggingBuferSize);
 
             // Copy to staging buffer
             RHICommandBufferAllocateInfo cmdBufAllocateInfo {};
@@ -769,6 +809,7 @@ namespace Piccolo
 
     void ParticlePass::initializeEmitters()
     {
+        resizeUniformStagingBuffer();
         allocateDescriptorSet();
         updateDescriptorSet();
         setupParticleDescriptorSet();
@@ -780,22 +821,79 @@ namespace Piccolo
         setupDescriptorSetLayout();
         setupPipelines();
         setupAttachments();
+        setupSimulationFrames();
+        resizeUniformStagingBuffer();
+    }
 
+    void ParticlePass::setupSimulationFrames()
+    {
         RHICommandBufferAllocateInfo cmdBufAllocateInfo {};
         cmdBufAllocateInfo.sType              = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
         cmdBufAllocateInfo.commandPool        = m_rhi->getCommandPoor();
         cmdBufAllocateInfo.level              = RHI_COMMAND_BUFFER_LEVEL_PRIMARY;
         cmdBufAllocateInfo.commandBufferCount = 1;
-        if (RHI_SUCCESS != m_rhi->allocateCommandBuffers(&cmdBufAllocateInfo, m_compute_command_buffer))
-            throw std::runtime_error("alloc compute command buffer");
-        if (RHI_SUCCESS != m_rhi->allocateCommandBuffers(&cmdBufAllocateInfo, m_copy_command_buffer))
-            throw std::runtime_error("alloc copy command buffer");
 
+        // signaled, the first frames have nothing to wait on
         RHIFenceCreateInfo fenceCreateInfo {};
         fenceCreateInfo.sType = RHI_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceCreateInfo.flags = 0;
-        if (RHI_SUCCESS != m_rhi->createFence(&fenceCreateInfo, m_fence))
-            throw std::runtime_error("create fence");
+        fenceCreateInfo.flags = RHI_FENCE_CREATE_SIGNALED_BIT;
+
+        RHISemaphoreCreateInfo semaphoreCreateInfo {};
+        semaphoreCreateInfo.sType = RHI_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        m_simulation_frames.resize(m_rhi->getMaxFramesInFlight());
+        for (SimulationFrame& frame : m_simulation_frames)
+        {
+            if (RHI_SUCCESS != m_rhi->allocateCommandBuffers(&cmdBufAllocateInfo, frame.m_compute_command_buffer))
+                throw std::runtime_error("alloc compute command buffer");
+            if (RHI_SUCCESS != m_rhi->allocateCommandBuffers(&cmdBufAllocateInfo, frame.m_copy_command_buffer))
+                throw std::runtime_error("alloc copy command buffer");
+            if (RHI_SUCCESS != m_rhi->createFence(&fenceCreateInfo, frame.m_fence))
+                throw std::runtime_error("create fence");
+            if (RHI_SUCCESS != m_rhi->createSemaphore(&semaphoreCreateInfo, frame.m_copy_finished_semaphore) ||
+                RHI_SUCCESS != m_rhi->createSemaphore(&semaphoreCreateInfo,
+                                                      frame.m_simulation_finished_for_copy_semaphore) ||
+                RHI_SUCCESS != m_rhi->createSemaphore(&semaphoreCreateInfo,
+                                                      frame.m_simulation_finished_for_render_semaphore))
+                throw std::runtime_error("create particle simulation semaphore");
+        }
+    }
+
+    void ParticlePass::resizeUniformStagingBuffer()
+    {
+        const size_t stride = sizeof(m_ubo) + sizeof(ParticleCollisionPerframeStorageBufferObject) +
+                              sizeof(ParticleEmitterDesc) * static_cast<size_t>(m_emitter_count);
+        if (m_uniform_staging_buffer != nullptr && stride <= m_uniform_staging_stride)
+            return;
+
+        // the frames in flight may still copy from the buffer
+        waitForSimulationFrames();
+        if (m_uniform_staging_buffer != nullptr)
+        {
+            m_rhi->unmapMemory(m_uniform_staging_memory);
+            m_rhi->destroyBuffer(m_uniform_staging_buffer);
+            m_rhi->freeMemory(m_uniform_staging_memory);
+        }
+
+        m_uniform_staging_stride = stride;
+        m_rhi->createBuffer(m_uniform_staging_stride * m_simulation_frames.size(),
+                            RHI_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                            RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                            m_uniform_staging_buffer,
+                            m_uniform_staging_memory);
+
+        void* mapped = nullptr;
+        if (RHI_SUCCESS != m_rhi->mapMemory(m_uniform_staging_memory, 0, RHI_WHOLE_SIZE, 0, &mapped))
+            throw std::runtime_error("map particle uniform staging buffer");
+        m_uniform_staging_mapped = static_cast<uint8_t*>(mapped);
+    }
+
+    void ParticlePass::waitForSimulationFrames()
+    {
+        for (SimulationFrame& frame : m_simulation_frames)
+        {
+            m_rhi->waitForFencesPFN(1, &frame.m_fence, RHI_TRUE, UINT64_MAX);
+        }
     }
 
     void ParticlePass::initialize(const RenderPassInitInfo* init_info)
@@ -1010,16 +1108,6 @@ namespace Piccolo
                 throw std::runtime_error("create compute pass pipe layout");
             LOG_INFO("compute pipe layout done");
         }
-        /*
-        VkPipelineCache           pipelineCache;
-        VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
-        pipelineCacheCreateInfo.sType                     = RHI_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-        if (RHI_SUCCESS != vkCreatePipelineCache(m_vulkan_rhi->m_device, &pipelineCacheCreateInfo, nullptr,
-        &pipelineCache))
-        {
-            throw std::runtime_error("create particle cache");
-        }*/
-
         struct SpecializationData
         {
             uint32_t BUFFER_ELEMENT_COUNT = 32;
@@ -1227,7 +1315,7 @@ namespace Piccolo
         particle_descriptor_set_alloc_info.sType          = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
         particle_descriptor_set_alloc_info.descriptorPool = m_rhi->getDescriptorPoor();
 
-        m_descriptor_infos.resize(3 * m_emitter_count);
+        m_descriptor_infos.resize(s_emitter_descriptor_set_count * m_emitter_count);
         for (int eid = 0; eid < m_emitter_count; ++eid)
         {
             particle_descriptor_set_alloc_info.pSetLayouts        = &m_descriptor_infos[0].layout;
@@ -1235,14 +1323,14 @@ namespace Piccolo
             particle_descriptor_set_alloc_info.pNext              = NULL;
 
             if (RHI_SUCCESS != m_rhi->allocateDescriptorSets(&particle_descriptor_set_alloc_info,
-                                                             m_descriptor_infos[eid * 3].descriptor_set))
+                                                             m_descriptor_infos[eid * s_emitter_descriptor_set_count].descriptor_set))
                 throw std::runtime_error("allocate compute descriptor set");
             particle_descriptor_set_alloc_info.pSetLayouts        = &m_descriptor_infos[1].layout;
             particle_descriptor_set_alloc_info.descriptorSetCount = 1;
             particle_descriptor_set_alloc_info.pNext              = NULL;
 
             if (RHI_SUCCESS != m_rhi->allocateDescriptorSets(&particle_descriptor_set_alloc_info,
-                                                             m_descriptor_infos[eid * 3 + 1].descriptor_set))
+                                                             m_descriptor_infos[eid * s_emitter_descriptor_set_count + 1].descriptor_set))
                 LOG_INFO("allocate normal and depth descriptor set done");
         }
     }
@@ -1260,7 +1348,7 @@ namespace Piccolo
                 {
                     RHIWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[0];
                     descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    descriptorset.dstSet                 = m_descriptor_infos[eid * 3].descriptor_set;
+                    descriptorset.dstSet                 = m_descriptor_infos[eid * s_emitter_descriptor_set_count].descriptor_set;
                     descriptorset.descriptorType         = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
                     descriptorset.dstBinding             = 0;
                     descriptorset.pBufferInfo            = &uniformbufferDescriptor;
@@ -1272,7 +1360,7 @@ namespace Piccolo
                 {
                     RHIWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[1];
                     descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    descriptorset.dstSet                 = m_descriptor_infos[eid * 3].descriptor_set;
+                    descriptorset.dstSet                 = m_descriptor_infos[eid * s_emitter_descriptor_set_count].descriptor_set;
                     descriptorset.descriptorType         = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
                     descriptorset.dstBinding             = 1;
                     descriptorset.pBufferInfo            = &positionBufferDescriptor;
@@ -1284,7 +1372,7 @@ namespace Piccolo
                 {
                     RHIWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[2];
                     descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    descriptorset.dstSet                 = m_descriptor_infos[eid * 3].descriptor_set;
+                    descriptorset.dstSet                 = m_descriptor_infos[eid * s_emitter_descriptor_set_count].descriptor_set;
                     descriptorset.descriptorType         = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
                     descriptorset.dstBinding             = 2;
                     descriptorset.pBufferInfo            = &counterBufferDescriptor;
@@ -1296,7 +1384,7 @@ namespace Piccolo
                 {
                     RHIWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[3];
                     descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    descriptorset.dstSet                 = m_descriptor_infos[eid * 3].descriptor_set;
+                    descriptorset.dstSet                 = m_descriptor_infos[eid * s_emitter_descriptor_set_count].descriptor_set;
                     descriptorset.descriptorType         = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
                     descriptorset.dstBinding             = 3;
                     descriptorset.pBufferInfo            = &indirectArgumentBufferDescriptor;
@@ -1308,7 +1396,7 @@ namespace Piccolo
                 {
                     RHIWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[4];
                     descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    descriptorset.dstSet                 = m_descriptor_infos[eid * 3].descriptor_set;
+                    descriptorset.dstSet                 = m_descriptor_infos[eid * s_emitter_descriptor_set_count].descriptor_set;
                     descriptorset.descriptorType         = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
                     descriptorset.dstBinding             = 4;
                     descriptorset.pBufferInfo            = &aliveListBufferDescriptor;
@@ -1320,7 +1408,7 @@ namespace Piccolo
                 {
                     RHIWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[5];
                     descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    descriptorset.dstSet                 = m_descriptor_infos[eid * 3].descriptor_set;
+                    descriptorset.dstSet                 = m_descriptor_infos[eid * s_emitter_descriptor_set_count].descriptor_set;
                     descriptorset.descriptorType         = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
                     descriptorset.dstBinding             = 5;
                     descriptorset.pBufferInfo            = &deadListBufferDescriptor;
@@ -1332,7 +1420,7 @@ namespace Piccolo
                 {
                     RHIWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[6];
                     descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    descriptorset.dstSet                 = m_descriptor_infos[eid * 3].descriptor_set;
+                    descriptorset.dstSet                 = m_descriptor_infos[eid * s_emitter_descriptor_set_count].descriptor_set;
                     descriptorset.descriptorType         = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
                     descriptorset.dstBinding             = 6;
                     descriptorset.pBufferInfo            = &aliveListNextBufferDescriptor;
@@ -1344,7 +1432,7 @@ namespace Piccolo
                 {
                     RHIWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[7];
                     descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    descriptorset.dstSet                 = m_descriptor_infos[eid * 3].descriptor_set;
+                    descriptorset.dstSet                 = m_descriptor_infos[eid * s_emitter_descriptor_set_count].descriptor_set;
                     descriptorset.descriptorType         = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
                     descriptorset.dstBinding             = 7;
                     descriptorset.pBufferInfo            = &particleComponentResBufferDescriptor;
@@ -1356,7 +1444,7 @@ namespace Piccolo
                 {
                     RHIWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[8];
                     descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    descriptorset.dstSet                 = m_descriptor_infos[eid * 3].descriptor_set;
+                    descriptorset.dstSet                 = m_descriptor_infos[eid * s_emitter_descriptor_set_count].descriptor_set;
                     descriptorset.descriptorType         = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
                     descriptorset.dstBinding             = 8;
                     descriptorset.pBufferInfo            = &particleSceneUniformBufferDescriptor;
@@ -1368,7 +1456,7 @@ namespace Piccolo
                 {
                     RHIWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[9];
                     descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    descriptorset.dstSet                 = m_descriptor_infos[eid * 3].descriptor_set;
+                    descriptorset.dstSet                 = m_descriptor_infos[eid * s_emitter_descriptor_set_count].descriptor_set;
                     descriptorset.descriptorType         = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
                     descriptorset.dstBinding             = 9;
                     descriptorset.pBufferInfo            = &positionRenderbufferDescriptor;
@@ -1405,7 +1493,7 @@ namespace Piccolo
                 {
                     RHIWriteDescriptorSet& descriptorset = computeWriteDescriptorSets[10];
                     descriptorset.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    descriptorset.dstSet                 = m_descriptor_infos[eid * 3].descriptor_set;
+                    descriptorset.dstSet                 = m_descriptor_infos[eid * s_emitter_descriptor_set_count].descriptor_set;
                     descriptorset.descriptorType         = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
                     descriptorset.dstBinding             = 10;
                     descriptorset.pImageInfo             = &piccolo_texture_image_info;
@@ -1432,7 +1520,7 @@ namespace Piccolo
                         RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
                     gbuffer_normal_descriptor_input_attachment_write_info.pNext = NULL;
                     gbuffer_normal_descriptor_input_attachment_write_info.dstSet =
-                        m_descriptor_infos[eid * 3 + 1].descriptor_set;
+                        m_descriptor_infos[eid * s_emitter_descriptor_set_count + 1].descriptor_set;
                     gbuffer_normal_descriptor_input_attachment_write_info.dstBinding      = 0;
                     gbuffer_normal_descriptor_input_attachment_write_info.dstArrayElement = 0;
                     gbuffer_normal_descriptor_input_attachment_write_info.descriptorType =
@@ -1474,7 +1562,7 @@ namespace Piccolo
                     depth_descriptor_input_attachment_write_info.sType = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
                     depth_descriptor_input_attachment_write_info.pNext = NULL;
                     depth_descriptor_input_attachment_write_info.dstSet =
-                        m_descriptor_infos[eid * 3 + 1].descriptor_set;
+                        m_descriptor_infos[eid * s_emitter_descriptor_set_count + 1].descriptor_set;
                     depth_descriptor_input_attachment_write_info.dstBinding      = 1;
                     depth_descriptor_input_attachment_write_info.dstArrayElement = 0;
                     depth_descriptor_input_attachment_write_info.descriptorType =
@@ -1494,361 +1582,385 @@ namespace Piccolo
 
     void ParticlePass::simulate()
     {
-        for (auto i : m_emitter_tick_indices)
+        uint8_t index =
+            (m_rhi->getCurrentFrameIndex() + m_rhi->getMaxFramesInFlight() - 1) % m_rhi->getMaxFramesInFlight();
+        SimulationFrame& simulation_frame = m_simulation_frames[index];
+
+        // the rendering submitted next reads what the pending simulation wrote, the one submitted now is drawn a
+        // frame later so that it overlaps the rendering of the next frame
+        if (m_is_simulation_pending)
         {
+            m_rhi->addRenderingWaitSemaphore(
+                m_simulation_frames[m_pending_simulation_frame].m_simulation_finished_for_render_semaphore,
+                RHI_PIPELINE_STAGE_DRAW_INDIRECT_BIT | RHI_PIPELINE_STAGE_VERTEX_SHADER_BIT);
+            m_visible_simulation    = m_simulation_sequence;
+            m_is_simulation_pending = false;
+        }
+
+        // all the ticked emitters in one command buffer, submitted without waiting on the host
+        bool is_simulating = !m_emitter_tick_indices.empty();
+        if (is_simulating)
+        {
+            RHICommandBuffer* command_buffer = simulation_frame.m_compute_command_buffer;
+
             RHICommandBufferBeginInfo cmdBufInfo {};
             cmdBufInfo.sType = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-
-            // particle compute pass
-            if (RHI_SUCCESS != m_rhi->beginCommandBuffer(m_compute_command_buffer, &cmdBufInfo))
+            if (RHI_SUCCESS != m_rhi->beginCommandBuffer(command_buffer, &cmdBufInfo))
             {
                 throw std::runtime_error("begin command buffer");
             }
 
             float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
-            m_rhi->pushEvent(m_compute_command_buffer, "Particle compute", color);
-            m_rhi->pushEvent(m_compute_command_buffer, "Particle Kickoff", color);
-
-            m_rhi->cmdBindPipelinePFN(m_compute_command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_kickoff_pipeline);
-            RHIDescriptorSet* descriptorsets[2] = {m_descriptor_infos[i * 3].descriptor_set,
-                                                   m_descriptor_infos[i * 3 + 1].descriptor_set};
-            m_rhi->cmdBindDescriptorSetsPFN(m_compute_command_buffer,
-                                            RHI_PIPELINE_BIND_POINT_COMPUTE,
-                                            m_render_pipelines[0].layout,
-                                            0,
-                                            2,
-                                            descriptorsets,
-                                            0,
-                                            0);
-
-
-            m_rhi->cmdDispatch(m_compute_command_buffer, 1, 1, 1);
-
-            m_rhi->popEvent(m_compute_command_buffer); // end particle kickoff label
-
-            RHIBufferMemoryBarrier bufferBarrier {};
-            bufferBarrier.sType               = RHI_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_counter_device_buffer;
-            bufferBarrier.size                = RHI_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = RHI_ACCESS_SHADER_READ_BIT;
-            bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
-                                      RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                      RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                      0,
-                                      0,
-                                      nullptr,
-                                      1,
-                                      &bufferBarrier,
-                                      0,
-                                      nullptr);
-
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_indirect_dispatch_argument_buffer;
-            bufferBarrier.size                = RHI_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = RHI_ACCESS_INDIRECT_COMMAND_READ_BIT | RHI_ACCESS_SHADER_READ_BIT;
-            bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
-                                      RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                      RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                      0,
-                                      0,
-                                      nullptr,
-                                      1,
-                                      &bufferBarrier,
-                                      0,
-                                      nullptr);
-
-            m_rhi->pushEvent(m_compute_command_buffer, "Particle Emit", color);
-
-            m_rhi->cmdBindPipelinePFN(m_compute_command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_emit_pipeline);
-
-            m_rhi->cmdDispatchIndirect(m_compute_command_buffer,
-                                       m_emitter_buffer_batches[i].m_indirect_dispatch_argument_buffer,
-                                       s_argument_offset_emit);
-
-            m_rhi->popEvent(m_compute_command_buffer); // end particle emit label
-
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_position_device_buffer;
-            bufferBarrier.size                = RHI_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = RHI_ACCESS_SHADER_READ_BIT;
-            bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
-                                      RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                      RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                      0,
-                                      0,
-                                      nullptr,
-                                      1,
-                                      &bufferBarrier,
-                                      0,
-                                      nullptr);
-
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_position_render_buffer;
-            bufferBarrier.size                = RHI_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = RHI_ACCESS_SHADER_READ_BIT;
-            bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
-                                      RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                      RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                      0,
-                                      0,
-                                      nullptr,
-                                      1,
-                                      &bufferBarrier,
-                                      0,
-                                      nullptr);
-
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_counter_device_buffer;
-            bufferBarrier.size                = RHI_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = RHI_ACCESS_SHADER_READ_BIT;
-            bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
-                                      RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                      RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                      0,
-                                      0,
-                                      nullptr,
-                                      1,
-                                      &bufferBarrier,
-                                      0,
-                                      nullptr);
-
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_alive_list_buffer;
-            bufferBarrier.size                = RHI_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = RHI_ACCESS_SHADER_READ_BIT;
-            bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
-                                      RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                      RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                      0,
-                                      0,
-                                      nullptr,
-                                      1,
-                                      &bufferBarrier,
-                                      0,
-                                      nullptr);
-
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_dead_list_buffer;
-            bufferBarrier.size                = RHI_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = RHI_ACCESS_SHADER_READ_BIT;
-            bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
-                                      RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                      RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                      0,
+            m_rhi->pushEvent(command_buffer, "Particle compute", color);
+
+            // the previous simulations on the queue wrote the buffers read and written below
+            RHIMemoryBarrier memoryBarrier {};
+            memoryBarrier.sType         = RHI_STRUCTURE_TYPE_MEMORY_BARRIER;
+            memoryBarrier.srcAccessMask = RHI_ACCESS_SHADER_WRITE_BIT | RHI_ACCESS_TRANSFER_WRITE_BIT;
+            memoryBarrier.dstAccessMask = RHI_ACCESS_SHADER_READ_BIT | RHI_ACCESS_SHADER_WRITE_BIT |
+                                          RHI_ACCESS_INDIRECT_COMMAND_READ_BIT | RHI_ACCESS_TRANSFER_READ_BIT |
+                                          RHI_ACCESS_TRANSFER_WRITE_BIT;
+            m_rhi->cmdPipelineBarrier(command_buffer,
+                                      RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT | RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                                      RHI_PIPELINE_STAGE_DRAW_INDIRECT_BIT | RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                                          RHI_PIPELINE_STAGE_TRANSFER_BIT,
                                       0,
-                                      nullptr,
                                       1,
-                                      &bufferBarrier,
-                                      0,
-                                      nullptr);
-
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_alive_list_next_buffer;
-            bufferBarrier.size                = RHI_WHOLE_SIZE;
-            bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = RHI_ACCESS_SHADER_READ_BIT;
-            bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
-                                      RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                      RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                                      0,
+                                      &memoryBarrier,
                                       0,
                                       nullptr,
-                                      1,
-                                      &bufferBarrier,
                                       0,
                                       nullptr);
 
-            m_rhi->pushEvent(m_compute_command_buffer, "Particle Simulate", color);
-
-            m_rhi->cmdBindPipelinePFN(m_compute_command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_simulate_pipeline);
-            m_rhi->cmdDispatchIndirect(m_compute_command_buffer,
-                                       m_emitter_buffer_batches[i].m_indirect_dispatch_argument_buffer,
-                                       s_argument_offset_simulate);
-
-            m_rhi->popEvent(m_compute_command_buffer); // end particle simulate label
+            recordUniformUpload(command_buffer, index);
 
-            if (RHI_SUCCESS != m_rhi->endCommandBuffer(m_compute_command_buffer))
+            for (ParticleEmitterID emitter_index : m_emitter_tick_indices)
             {
-                throw std::runtime_error("end command buffer");
+                recordEmitterSimulation(command_buffer, emitter_index);
             }
-            m_rhi->resetFencesPFN(1, &m_fence);
 
-            RHISubmitInfo computeSubmitInfo {};
-            computeSubmitInfo.sType              = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
-            computeSubmitInfo.pWaitDstStageMask  = 0;
-            computeSubmitInfo.commandBufferCount = 1;
-            computeSubmitInfo.pCommandBuffers    = &m_compute_command_buffer;
+            m_rhi->popEvent(command_buffer); // end particle compute label
 
-            if (RHI_SUCCESS != m_rhi->queueSubmit(m_rhi->getComputeQueue(), 1, &computeSubmitInfo, m_fence))
+            if (RHI_SUCCESS != m_rhi->endCommandBuffer(command_buffer))
             {
-                throw std::runtime_error("compute queue submit");
+                throw std::runtime_error("end command buffer");
             }
+        }
 
-            if (RHI_SUCCESS != m_rhi->waitForFencesPFN(1, &m_fence, RHI_TRUE, UINT64_MAX))
-            {
-                throw std::runtime_error("wait for fence");
-            }
+        // submitted even when nothing is simulated, so that the fence of the frame also covers its copy
+        m_rhi->resetFencesPFN(1, &simulation_frame.m_fence);
+
+        RHISemaphore*         wait_semaphores[1] = {simulation_frame.m_copy_finished_semaphore};
+        RHIPipelineStageFlags wait_stages[1]     = {RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT};
+        const RHISemaphore*   signal_semaphores[2] = {simulation_frame.m_simulation_finished_for_copy_semaphore,
+                                                      simulation_frame.m_simulation_finished_for_render_semaphore};
+
+        RHISubmitInfo computeSubmitInfo {};
+        computeSubmitInfo.sType                = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
+        computeSubmitInfo.waitSemaphoreCount   = 1;
+        computeSubmitInfo.pWaitSemaphores      = wait_semaphores;
+        computeSubmitInfo.pWaitDstStageMask    = wait_stages;
+        computeSubmitInfo.commandBufferCount   = is_simulating ? 1 : 0;
+        computeSubmitInfo.pCommandBuffers      = is_simulating ? &simulation_frame.m_compute_command_buffer : nullptr;
+        computeSubmitInfo.signalSemaphoreCount = is_simulating ? 2 : 0;
+        computeSubmitInfo.pSignalSemaphores    = is_simulating ? signal_semaphores : nullptr;
+
+        if (RHI_SUCCESS !=
+            m_rhi->queueSubmit(m_rhi->getComputeQueue(), 1, &computeSubmitInfo, simulation_frame.m_fence))
+        {
+            throw std::runtime_error("compute queue submit");
+        }
 
-            if (RHI_SUCCESS != m_rhi->beginCommandBuffer(m_compute_command_buffer, &cmdBufInfo))
-            {
-                throw std::runtime_error("begin command buffer");
-            }
+        if (is_simulating)
+        {
+            ++m_simulation_sequence;
+            m_is_simulation_pending    = true;
+            m_pending_simulation_frame = index;
+        }
 
-            m_rhi->pushEvent(m_compute_command_buffer, "Copy Particle Counter Buffer", color);
+        m_emitter_tick_indices.clear();
+        m_emitter_transform_indices.clear();
+    }
 
-            // Barrier to ensure that shader writes are finished before buffer is read back from GPU
-            bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = RHI_ACCESS_TRANSFER_READ_BIT;
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_counter_device_buffer;
-            bufferBarrier.size                = RHI_WHOLE_SIZE;
-            bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+    void ParticlePass::recordUniformUpload(RHICommandBuffer* command_buffer, uint8_t frame_index)
+    {
+        const RHIDeviceSize frame_offset = m_uniform_staging_stride * frame_index;
 
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
-                                      RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                                      RHI_PIPELINE_STAGE_TRANSFER_BIT,
-                                      0,
-                                      0,
-                                      nullptr,
-                                      1,
-                                      &bufferBarrier,
-                                      0,
-                                      nullptr);
-            // Read back to host visible buffer
+        RHIBufferCopy copyRegion {};
+        copyRegion.srcOffset = frame_offset;
+        copyRegion.dstOffset = 0;
+        copyRegion.size      = sizeof(m_ubo);
+        m_rhi->cmdCopyBuffer(command_buffer, m_uniform_staging_buffer, m_compute_uniform_buffer, 1, &copyRegion);
 
-            RHIBufferCopy copyRegion {};
-            copyRegion.srcOffset = 0;
-            copyRegion.dstOffset = 0;
-            copyRegion.size      = sizeof(ParticleCounter);
+        copyRegion.srcOffset += copyRegion.size;
+        copyRegion.size = sizeof(ParticleCollisionPerframeStorageBufferObject);
+        m_rhi->cmdCopyBuffer(command_buffer, m_uniform_staging_buffer, m_scene_uniform_buffer, 1, &copyRegion);
 
-            m_rhi->cmdCopyBuffer(m_compute_command_buffer,
-                                 m_emitter_buffer_batches[i].m_counter_device_buffer,
-                                 m_emitter_buffer_batches[i].m_counter_host_buffer,
+        copyRegion.srcOffset += copyRegion.size;
+        copyRegion.size = sizeof(ParticleEmitterDesc);
+        for (int i = 0; i < m_emitter_count; ++i)
+        {
+            m_rhi->cmdCopyBuffer(command_buffer,
+                                 m_uniform_staging_buffer,
+                                 m_emitter_buffer_batches[i].m_particle_component_res_buffer,
                                  1,
                                  &copyRegion);
+            copyRegion.srcOffset += copyRegion.size;
+        }
 
-            // Barrier to ensure that buffer copy is finished before host reading from it
-            bufferBarrier.srcAccessMask       = RHI_ACCESS_TRANSFER_WRITE_BIT;
-            bufferBarrier.dstAccessMask       = RHI_ACCESS_HOST_READ_BIT;
-            bufferBarrier.buffer              = m_emitter_buffer_batches[i].m_counter_host_buffer;
-            bufferBarrier.size                = RHI_WHOLE_SIZE;
-            bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-            bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
-
-            m_rhi->cmdPipelineBarrier(m_compute_command_buffer,
-                                      RHI_PIPELINE_STAGE_TRANSFER_BIT,
-                                      RHI_PIPELINE_STAGE_HOST_BIT,
-                                      0,
-                                      0,
-                                      nullptr,
-                                      1,
-                                      &bufferBarrier,
-                                      0,
-                                      nullptr);
-
-            m_rhi->popEvent(m_compute_command_buffer); // end particle counter copy label
-
-            m_rhi->popEvent(m_compute_command_buffer); // end particle compute label
-
-            if (RHI_SUCCESS != m_rhi->endCommandBuffer(m_compute_command_buffer))
-            {
-                throw std::runtime_error("end command buffer");
-            }
-
-            // Submit compute work
-            m_rhi->resetFencesPFN(1, &m_fence);
-            computeSubmitInfo                        = {};
-            const VkPipelineStageFlags waitStageMask = RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-            computeSubmitInfo.sType                  = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
-            computeSubmitInfo.pWaitDstStageMask      = &waitStageMask;
-            computeSubmitInfo.commandBufferCount     = 1;
-            computeSubmitInfo.pCommandBuffers        = &m_compute_command_buffer;
-
-            if (RHI_SUCCESS != m_rhi->queueSubmit(m_rhi->getComputeQueue(), 1, &computeSubmitInfo, m_fence))
-            {
-                throw std::runtime_error("compute queue submit");
-            }
+        RHIMemoryBarrier memoryBarrier {};
+        memoryBarrier.sType         = RHI_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memoryBarrier.srcAccessMask = RHI_ACCESS_TRANSFER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = RHI_ACCESS_UNIFORM_READ_BIT | RHI_ACCESS_SHADER_READ_BIT;
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  0,
+                                  1,
+                                  &memoryBarrier,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr);
+    }
 
-            if (RHI_SUCCESS != m_rhi->waitForFencesPFN(1, &m_fence, RHI_TRUE, UINT64_MAX))
-            {
-                throw std::runtime_error("wait for fence");
-            }
+    void ParticlePass::recordEmitterSimulation(RHICommandBuffer* command_buffer, ParticleEmitterID emitter_index)
+    {
+        ParticleEmitterBufferBatch& batch = m_emitter_buffer_batches[emitter_index];
 
-            m_rhi->queueWaitIdle(m_rhi->getComputeQueue());
+        // mirrors the flip of alive_flap_bit by the kickoff
+        batch.m_simulated_slot = 1 - batch.m_simulated_slot;
 
-            // Make device writes visible to the host
-            void* mapped;
-            m_rhi->mapMemory(m_emitter_buffer_batches[i].m_counter_host_memory, 0, RHI_WHOLE_SIZE, 0, &mapped);
-
-            m_rhi->invalidateMappedMemoryRanges(
-                nullptr, m_emitter_buffer_batches[i].m_counter_host_memory, 0, RHI_WHOLE_SIZE);
-
-            // Copy to output
-            ParticleCounter counterNext {};
-            memcpy(&counterNext, mapped, sizeof(ParticleCounter));
-            m_rhi->unmapMemory(m_emitter_buffer_batches[i].m_counter_host_memory);
-
-            if constexpr (s_verbose_particle_alive_info)
-                LOG_INFO("{} {} {} {}",
-                         counterNext.dead_count,
-                         counterNext.alive_count,
-                         counterNext.alive_count_after_sim,
-                         counterNext.emit_count);
-            m_emitter_buffer_batches[i].m_num_particle = counterNext.alive_count_after_sim;
-        }
-        m_emitter_tick_indices.clear();
-        m_emitter_transform_indices.clear();
+        float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        m_rhi->pushEvent(command_buffer, "Particle Kickoff", color);
+
+        m_rhi->cmdBindPipelinePFN(command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_kickoff_pipeline);
+        RHIDescriptorSet* descriptorsets[2] = {
+            m_descriptor_infos[emitter_index * s_emitter_descriptor_set_count].descriptor_set,
+            m_descriptor_infos[emitter_index * s_emitter_descriptor_set_count + 1].descriptor_set};
+        m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                        RHI_PIPELINE_BIND_POINT_COMPUTE,
+                                        m_render_pipelines[0].layout,
+                                        0,
+                                        2,
+                                        descriptorsets,
+                                        0,
+                                        0);
+
+
+        m_rhi->cmdDispatch(command_buffer, 1, 1, 1);
+
+        m_rhi->popEvent(command_buffer); // end particle kickoff label
+
+        RHIBufferMemoryBarrier bufferBarrier {};
+        bufferBarrier.sType               = RHI_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        bufferBarrier.buffer              = batch.m_counter_device_buffer;
+        bufferBarrier.size                = RHI_WHOLE_SIZE;
+        bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
+        bufferBarrier.dstAccessMask       = RHI_ACCESS_SHADER_READ_BIT;
+        bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  1,
+                                  &bufferBarrier,
+                                  0,
+                                  nullptr);
+
+        bufferBarrier.buffer              = batch.m_indirect_dispatch_argument_buffer;
+        bufferBarrier.size                = RHI_WHOLE_SIZE;
+        bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
+        bufferBarrier.dstAccessMask       = RHI_ACCESS_INDIRECT_COMMAND_READ_BIT | RHI_ACCESS_SHADER_READ_BIT;
+        bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  1,
+                                  &bufferBarrier,
+                                  0,
+                                  nullptr);
+
+        m_rhi->pushEvent(command_buffer, "Particle Emit", color);
+
+        m_rhi->cmdBindPipelinePFN(command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_emit_pipeline);
+
+        m_rhi->cmdDispatchIndirect(
+            command_buffer, batch.m_indirect_dispatch_argument_buffer, s_argument_offset_emit);
+
+        m_rhi->popEvent(command_buffer); // end particle emit label
+
+        bufferBarrier.buffer              = batch.m_position_device_buffer;
+        bufferBarrier.size                = RHI_WHOLE_SIZE;
+        bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
+        bufferBarrier.dstAccessMask       = RHI_ACCESS_SHADER_READ_BIT;
+        bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  1,
+                                  &bufferBarrier,
+                                  0,
+                                  nullptr);
+
+        bufferBarrier.buffer              = batch.m_position_render_buffer;
+        bufferBarrier.size                = RHI_WHOLE_SIZE;
+        bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
+        bufferBarrier.dstAccessMask       = RHI_ACCESS_SHADER_READ_BIT;
+        bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  1,
+                                  &bufferBarrier,
+                                  0,
+                                  nullptr);
+
+        bufferBarrier.buffer              = batch.m_counter_device_buffer;
+        bufferBarrier.size                = RHI_WHOLE_SIZE;
+        bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
+        bufferBarrier.dstAccessMask       = RHI_ACCESS_SHADER_READ_BIT;
+        bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  1,
+                                  &bufferBarrier,
+                                  0,
+                                  nullptr);
+
+        bufferBarrier.buffer              = batch.m_alive_list_buffer;
+        bufferBarrier.size                = RHI_WHOLE_SIZE;
+        bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
+        bufferBarrier.dstAccessMask       = RHI_ACCESS_SHADER_READ_BIT;
+        bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  1,
+                                  &bufferBarrier,
+                                  0,
+                                  nullptr);
+
+        bufferBarrier.buffer              = batch.m_dead_list_buffer;
+        bufferBarrier.size                = RHI_WHOLE_SIZE;
+        bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
+        bufferBarrier.dstAccessMask       = RHI_ACCESS_SHADER_READ_BIT;
+        bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  1,
+                                  &bufferBarrier,
+                                  0,
+                                  nullptr);
+
+        bufferBarrier.buffer              = batch.m_alive_list_next_buffer;
+        bufferBarrier.size                = RHI_WHOLE_SIZE;
+        bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
+        bufferBarrier.dstAccessMask       = RHI_ACCESS_SHADER_READ_BIT;
+        bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  RHI_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  1,
+                                  &bufferBarrier,
+                                  0,
+                                  nullptr);
+
+        m_rhi->pushEvent(command_buffer, "Particle Simulate", color);
+
+        m_rhi->cmdBindPipelinePFN(command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_simulate_pipeline);
+        m_rhi->cmdDispatchIndirect(command_buffer,
+                                   batch.m_indirect_dispatch_argument_buffer,
+                                   s_argument_offset_simulate);
+
+        m_rhi->popEvent(command_buffer); // end particle simulate label
+
+        // the alive count becomes the instance count of the billboard draw of the slot
+        bufferBarrier.srcAccessMask       = RHI_ACCESS_SHADER_WRITE_BIT;
+        bufferBarrier.dstAccessMask       = RHI_ACCESS_TRANSFER_READ_BIT;
+        bufferBarrier.buffer              = batch.m_counter_device_buffer;
+        bufferBarrier.size                = RHI_WHOLE_SIZE;
+        bufferBarrier.srcQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = RHI_QUEUE_FAMILY_IGNORED;
+
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  1,
+                                  &bufferBarrier,
+                                  0,
+                                  nullptr);
+
+        RHIBufferCopy copyRegion {};
+        copyRegion.srcOffset = offsetof(ParticleCounter, alive_count_after_sim);
+        copyRegion.dstOffset = batch.m_simulated_slot * sizeof(DrawArgument) + offsetof(DrawArgument, instance_count);
+        copyRegion.size      = sizeof(uint32_t);
+        m_rhi->cmdCopyBuffer(command_buffer, batch.m_counter_device_buffer, batch.m_draw_argument_buffer, 1, &copyRegion);
+
+        ++batch.m_simulation_count;
+        batch.m_last_simulation = m_simulation_sequence + 1;
     }
 
     void ParticlePass::prepareUniformBuffer()
     {
+        // both are written on the compute queue from the uniform staging buffer, see recordUniformUpload
         RHIDeviceMemory* d_mem;
         m_rhi->createBuffer(sizeof(m_particle_collision_perframe_storage_buffer_object),
-                            RHI_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                            RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                            RHI_BUFFER_USAGE_UNIFORM_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
+                            RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
                             m_scene_uniform_buffer,
                             d_mem);
 
-        if (RHI_SUCCESS != m_rhi->mapMemory(d_mem, 0, RHI_WHOLE_SIZE, 0, &m_scene_uniform_buffer_mapped))
-        {
-            throw std::runtime_error("map billboard uniform buffer");
-        }
         RHIDeviceMemory* d_uniformdmemory;
-
-        m_rhi->createBufferAndInitialize(RHI_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                                         RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                         m_compute_uniform_buffer,
-                                         d_uniformdmemory,
-                                         sizeof(m_ubo));
-
-        if (RHI_SUCCESS != m_rhi->mapMemory(d_uniformdmemory, 0, RHI_WHOLE_SIZE, 0, &m_particle_compute_buffer_mapped))
-        {
-            throw std::runtime_error("map buffer");
-        }
+        m_rhi->createBuffer(sizeof(m_ubo),
+                            RHI_BUFFER_USAGE_UNIFORM_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
+                            RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                            m_compute_uniform_buffer,
+                            d_uniformdmemory);
 
         const GlobalParticleRes& global_res = m_particle_manager->getGlobalParticleRes();
 
@@ -1873,8 +1985,6 @@ namespace Piccolo
         m_ubo.extent.x    = m_rhi->getSwapchainInfo().scissor->extent.width;
         m_ubo.extent.y    = m_rhi->getSwapchainInfo().scissor->extent.height;
 
-        memcpy(m_particle_compute_buffer_mapped, &m_ubo, sizeof(m_ubo));
-
         {
             RHIDeviceMemory* d_mem;
             m_rhi->createBuffer(sizeof(m_particlebillboard_perframe_storage_buffer_object),
@@ -1898,10 +2008,6 @@ namespace Piccolo
             int index                                                 = transform_desc.m_id;
             m_emitter_buffer_batches[index].m_emitter_desc.m_position = transform_desc.m_position;
             m_emitter_buffer_batches[index].m_emitter_desc.m_rotation = transform_desc.m_rotation;
-
-            memcpy(m_emitter_buffer_batches[index].m_emitter_desc_mapped,
-                   &m_emitter_buffer_batches[index].m_emitter_desc,
-                   sizeof(ParticleEmitterDesc));
         }
     }
 
@@ -1924,7 +2030,6 @@ namespace Piccolo
 
         m_ubo.extent.z = g_runtime_global_context.m_render_system->getRenderCamera()->m_znear;
         m_ubo.extent.w = g_runtime_global_context.m_render_system->getRenderCamera()->m_zfar;
-        memcpy(m_particle_compute_buffer_mapped, &m_ubo, sizeof(m_ubo));
     }
 
     void ParticlePass::preparePassData(std::shared_ptr<RenderResourceBase> render_resource)
@@ -1934,9 +2039,6 @@ namespace Piccolo
         {
             m_particle_collision_perframe_storage_buffer_object =
                 vulkan_resource->m_particle_collision_perframe_storage_buffer_object;
-            memcpy(m_scene_uniform_buffer_mapped,
-                   &m_particle_collision_perframe_storage_buffer_object,
-                   sizeof(ParticleCollisionPerframeStorageBufferObject));
 
             m_particlebillboard_perframe_storage_buffer_object =
                 vulkan_resource->m_particlebillboard_perframe_storage_buffer_object;
@@ -1947,6 +2049,23 @@ namespace Piccolo
             m_viewport_params = *m_rhi->getSwapchainInfo().viewport;
             updateUniformBuffer();
             updateEmitterTransform();
+
+            // the staging of the frame is free once the simulation which last copied from it is done
+            const uint8_t frame_index = m_rhi->getCurrentFrameIndex();
+            m_rhi->waitForFencesPFN(1, &m_simulation_frames[frame_index].m_fence, RHI_TRUE, UINT64_MAX);
+
+            uint8_t* staging = m_uniform_staging_mapped + m_uniform_staging_stride * frame_index;
+            memcpy(staging, &m_ubo, sizeof(m_ubo));
+            staging += sizeof(m_ubo);
+            memcpy(staging,
+                   &m_particle_collision_perframe_storage_buffer_object,
+                   sizeof(ParticleCollisionPerframeStorageBufferObject));
+            staging += sizeof(ParticleCollisionPerframeStorageBufferObject);
+            for (int i = 0; i < m_emitter_count; ++i)
+            {
+                memcpy(staging, &m_emitter_buffer_batches[i].m_emitter_desc, sizeof(ParticleEmitterDesc));
+                staging += sizeof(ParticleEmitterDesc);
+            }
         }
     }
 
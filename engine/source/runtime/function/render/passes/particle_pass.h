@@ -25,6 +25,7 @@ namespace Piccolo
         RHIBuffer* m_alive_list_next_buffer = nullptr;
         RHIBuffer* m_dead_list_buffer = nullptr;
         RHIBuffer* m_particle_component_res_buffer = nullptr;
+        RHIBuffer* m_draw_argument_buffer = nullptr;
 
         RHIDeviceMemory* m_counter_host_memory = nullptr;
         RHIDeviceMemory* m_position_host_memory = nullptr;
@@ -36,12 +37,17 @@ namespace Piccolo
         RHIDeviceMemory* m_dead_list_memory = nullptr;
         RHIDeviceMemory* m_particle_component_res_memory = nullptr;
         RHIDeviceMemory* m_position_render_memory = nullptr;
-
-        void* m_emitter_desc_mapped {nullptr};
+        RHIDeviceMemory* m_draw_argument_memory = nullptr;
 
         ParticleEmitterDesc m_emitter_desc;
 
         uint32_t m_num_particle {0};
+
+        // the render buffer and the draw arguments are double buffered, a simulation writes the half selected by
+        // alive_flap_bit once the kickoff flipped it, so the half the renderer reads is never written meanwhile
+        uint32_t m_simulated_slot {1};
+        uint32_t m_simulation_count {0};
+        uint64_t m_last_simulation {0};
         void     freeUpBatch(std::shared_ptr<RHI> rhi);
     };
 
@@ -54,8 +60,10 @@ namespace Piccolo
 
         void draw() override final;
 
+        /// submit the simulation of the ticked emitters to the compute queue, after copyNormalAndDepthImage
         void simulate();
 
+        /// submit the copy of the depth and normal images of the frame just submitted, read by the simulation
         void copyNormalAndDepthImage();
 
         void setDepthAndNormalImage(RHIImage* depth_image, RHIImage* normal_image);
@@ -97,13 +105,21 @@ namespace Piccolo
 
         void setupParticleDescriptorSet();
 
+        void setupSimulationFrames();
+
+        void resizeUniformStagingBuffer();
+
+        void recordUniformUpload(RHICommandBuffer* command_buffer, uint8_t frame_index);
+
+        void recordEmitterSimulation(RHICommandBuffer* command_buffer, ParticleEmitterID emitter_index);
+
+        void waitForSimulationFrames();
+
         RHIPipeline* m_kickoff_pipeline = nullptr;
         RHIPipeline* m_emit_pipeline = nullptr;
         RHIPipeline* m_simulate_pipeline = nullptr;
 
-        RHICommandBuffer* m_compute_command_buffer = nullptr;
         RHICommandBuffer* m_render_command_buffer = nullptr;
-        RHICommandBuffer* m_copy_command_buffer = nullptr;
 
         RHIBuffer* m_scene_uniform_buffer = nullptr;
         RHIBuffer* m_compute_uniform_buffer = nullptr;
@@ -111,7 +127,33 @@ namespace Piccolo
 
         RHIViewport m_viewport_params;
 
-        RHIFence* m_fence = nullptr;
+        // the copy and the simulation of a frame, reused once the fence of the simulation is signaled
+        struct SimulationFrame
+        {
+            RHICommandBuffer* m_copy_command_buffer {nullptr};
+            RHICommandBuffer* m_compute_command_buffer {nullptr};
+            RHIFence*         m_fence {nullptr};
+            RHISemaphore*     m_copy_finished_semaphore {nullptr};
+            RHISemaphore*     m_simulation_finished_for_copy_semaphore {nullptr};
+            RHISemaphore*     m_simulation_finished_for_render_semaphore {nullptr};
+        };
+
+        // one per frame in flight, indexed like the frames
+        std::vector<SimulationFrame> m_simulation_frames;
+
+        // the simulations are numbered from 1, the renderer only reads the ones up to m_visible_simulation since
+        // the rendering waits on their semaphores, see simulate
+        uint64_t m_simulation_sequence {0};
+        uint64_t m_visible_simulation {0};
+        // a simulation whose semaphores are not waited yet
+        bool m_is_simulation_pending {false};
+        int  m_pending_simulation_frame {0};
+
+        // the uniforms of each frame in flight, copied on the compute queue before the simulation reads them
+        RHIBuffer*       m_uniform_staging_buffer {nullptr};
+        RHIDeviceMemory* m_uniform_staging_memory {nullptr};
+        uint8_t*         m_uniform_staging_mapped {nullptr};
+        size_t           m_uniform_staging_stride {0};
 
         RHIImage*        m_src_depth_image = nullptr;
         RHIImage*        m_dst_normal_image = nullptr;
@@ -138,9 +180,7 @@ namespace Piccolo
         ParticleBillboardPerframeStorageBufferObject m_particlebillboard_perframe_storage_buffer_object;
         ParticleCollisionPerframeStorageBufferObject m_particle_collision_perframe_storage_buffer_object;
 
-        void* m_particle_compute_buffer_mapped {nullptr};
         void* m_particle_billboard_uniform_buffer_mapped {nullptr};
-        void* m_scene_uniform_buffer_mapped {nullptr};
 
         struct uvec4
         {
@@ -192,12 +232,24 @@ namespace Piccolo
             int emit_count;
         };
 
+        // VkDrawIndirectCommand of a billboard draw
+        struct DrawArgument
+        {
+            uint32_t vertex_count;
+            uint32_t instance_count;
+            uint32_t first_vertex;
+            uint32_t first_instance;
+        };
+
+        // compute, normal and depth, then a billboard set per half of the render buffer
+        static constexpr int s_emitter_descriptor_set_count {4};
+
         std::vector<ParticleEmitterBufferBatch> m_emitter_buffer_batches;
         std::shared_ptr<ParticleManager>        m_particle_manager;
 
         DefaultRNG m_random_engine;
 
-        int m_emitter_count;
+        int m_emitter_count {0};
 
         static constexpr bool s_verbose_particle_alive_info {false};
 
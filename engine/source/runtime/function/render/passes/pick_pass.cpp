@@ -433,8 +433,8 @@ namespace Piccolo
 
         std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> main_camera_mesh_drawcall_batch;
 
-        // reorganize mesh
-        for (RenderMeshNode& node : *(m_visiable_nodes.p_main_camera_visible_mesh_nodes))
+        // reorganize mesh, only the meshes under the cursor can be picked
+        for (RenderMeshNode& node : *(m_visiable_nodes.p_pick_candidate_mesh_nodes))
         {
             auto& mesh_instanced = main_camera_mesh_drawcall_batch[node.ref_material];
             auto& model_nodes    = mesh_instanced[node.ref_mesh];
@@ -577,7 +577,7 @@ namespace Piccolo
                     m_rhi->cmdBindIndexBufferPFN(m_rhi->getCurrentCommandBuffer(),
                                                  mesh.mesh_index_buffer,
                                                  0,
-                                                 RHI_INDEX_TYPE_UINT16);
+                                                 mesh.mesh_index_type);
 
                     uint32_t drawcall_max_instance_count =
                         (sizeof(MeshInefficientPickPerdrawcallStorageBufferObject::model_matrices) /
@@ -2,6 +2,7 @@
 
 #include "runtime/function/render/render_helper.h"
 #include "runtime/function/render/render_mesh.h"
+#include "runtime/function/render/render_resource.h"
 #include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
 #include "runtime/function/render/interface/vulkan/vulkan_util.h"
 
@@ -19,6 +20,8 @@ namespace Piccolo
     {
         RenderPass::initialize(nullptr);
 
+        m_mesh_instances = &std::static_pointer_cast<RenderResource>(m_render_resource)->m_mesh_instances;
+
         setupAttachments();
         setupRenderPass();
         setupFramebuffer();
@@ -37,6 +40,12 @@ namespace Piccolo
             m_mesh_point_light_shadow_perframe_storage_buffer_object =
                 vulkan_resource->m_mesh_point_light_shadow_perframe_storage_buffer_object;
         }
+
+        // the instance buffer grew since the descriptor set was written
+        if (m_mesh_instance_buffer_version != m_mesh_instances->getInstanceBufferVersion())
+        {
+            updateMeshInstanceDescriptorSet();
+        }
     }
     void PointLightShadowPass::draw()
     {
@@ -182,7 +191,7 @@ namespace Piccolo
     {
         m_descriptor_infos.resize(1);
 
-        RHIDescriptorSetLayoutBinding mesh_point_light_shadow_global_layout_bindings[3];
+        RHIDescriptorSetLayoutBinding mesh_point_light_shadow_global_layout_bindings[4];
 
         RHIDescriptorSetLayoutBinding& mesh_point_light_shadow_global_layout_perframe_storage_buffer_binding =
             mesh_point_light_shadow_global_layout_bindings[0];
@@ -212,6 +221,15 @@ namespace Piccolo
         mesh_point_light_shadow_global_layout_per_drawcall_vertex_blending_storage_buffer_binding.stageFlags =
             RHI_SHADER_STAGE_VERTEX_BIT;
 
+        RHIDescriptorSetLayoutBinding& mesh_point_light_shadow_global_layout_instance_storage_buffer_binding =
+            mesh_point_light_shadow_global_layout_bindings[3];
+        mesh_point_light_shadow_global_layout_instance_storage_buffer_binding.binding         = 3;
+        mesh_point_light_shadow_global_layout_instance_storage_buffer_binding.descriptorType =
+            RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        mesh_point_light_shadow_global_layout_instance_storage_buffer_binding.descriptorCount = 1;
+        mesh_point_light_shadow_global_layout_instance_storage_buffer_binding.stageFlags =
+            RHI_SHADER_STAGE_VERTEX_BIT;
+
         RHIDescriptorSetLayoutCreateInfo mesh_point_light_shadow_global_layout_create_info;
         mesh_point_light_shadow_global_layout_create_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
         mesh_point_light_shadow_global_layout_create_info.pNext = NULL;
@@ -420,9 +438,14 @@ namespace Piccolo
         assert(mesh_point_light_shadow_per_drawcall_vertex_blending_storage_buffer_info.range <
                m_global_render_resource->_storage_buffer._max_storage_buffer_range);
 
+        RHIDescriptorBufferInfo mesh_point_light_shadow_instance_storage_buffer_info = {};
+        mesh_point_light_shadow_instance_storage_buffer_info.offset = 0;
+        mesh_point_light_shadow_instance_storage_buffer_info.range  = RHI_WHOLE_SIZE;
+        mesh_point_light_shadow_instance_storage_buffer_info.buffer = m_mesh_instances->getInstanceBuffer();
+
         RHIDescriptorSet* descriptor_set_to_write = m_descriptor_infos[0].descriptor_set;
 
-        RHIWriteDescriptorSet descriptor_writes[3];
+        RHIWriteDescriptorSet descriptor_writes[4];
 
         RHIWriteDescriptorSet& mesh_point_light_shadow_perframe_storage_buffer_write_info = descriptor_writes[0];
         mesh_point_light_shadow_perframe_storage_buffer_write_info.sType      = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -462,35 +485,70 @@ namespace Piccolo
         mesh_point_light_shadow_per_drawcall_vertex_blending_storage_buffer_write_info.pBufferInfo =
             &mesh_point_light_shadow_per_drawcall_vertex_blending_storage_buffer_info;
 
+        RHIWriteDescriptorSet& mesh_point_light_shadow_instance_storage_buffer_write_info = descriptor_writes[3];
+        mesh_point_light_shadow_instance_storage_buffer_write_info.sType =
+            RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        mesh_point_light_shadow_instance_storage_buffer_write_info.pNext           = NULL;
+        mesh_point_light_shadow_instance_storage_buffer_write_info.dstSet          = descriptor_set_to_write;
+        mesh_point_light_shadow_instance_storage_buffer_write_info.dstBinding      = 3;
+        mesh_point_light_shadow_instance_storage_buffer_write_info.dstArrayElement = 0;
+        mesh_point_light_shadow_instance_storage_buffer_write_info.descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        mesh_point_light_shadow_instance_storage_buffer_write_info.descriptorCount = 1;
+        mesh_point_light_shadow_instance_storage_buffer_write_info.pBufferInfo =
+            &mesh_point_light_shadow_instance_storage_buffer_info;
+
         m_rhi->updateDescriptorSets((sizeof(descriptor_writes) / sizeof(descriptor_writes[0])),
                                descriptor_writes,
                                0,
                                NULL);
+
+        m_mesh_instance_buffer_version = m_mesh_instances->getInstanceBufferVersion();
+    }
+    void PointLightShadowPass::updateMeshInstanceDescriptorSet()
+    {
+        RHIDescriptorBufferInfo mesh_instance_storage_buffer_info = {};
+        mesh_instance_storage_buffer_info.offset                 = 0;
+        mesh_instance_storage_buffer_info.range                  = RHI_WHOLE_SIZE;
+        mesh_instance_storage_buffer_info.buffer                 = m_mesh_instances->getInstanceBuffer();
+
+        RHIWriteDescriptorSet mesh_instance_storage_buffer_write_info = {};
+        mesh_instance_storage_buffer_write_info.sType           = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        mesh_instance_storage_buffer_write_info.pNext           = NULL;
+        mesh_instance_storage_buffer_write_info.dstSet          = m_descriptor_infos[0].descriptor_set;
+        mesh_instance_storage_buffer_write_info.dstBinding      = 3;
+        mesh_instance_storage_buffer_write_info.dstArrayElement = 0;
+        mesh_instance_storage_buffer_write_info.descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        mesh_instance_storage_buffer_write_info.descriptorCount = 1;
+        mesh_instance_storage_buffer_write_info.pBufferInfo     = &mesh_instance_storage_buffer_info;
+
+        m_rhi->updateDescriptorSets(1, &mesh_instance_storage_buffer_write_info, 0, NULL);
+
+        m_mesh_instance_buffer_version = m_mesh_instances->getInstanceBufferVersion();
     }
     void PointLightShadowPass::drawModel()
     {
         struct MeshNode
         {
-            const Matrix4x4* model_matrix {nullptr};
-            const Matrix4x4* joint_matrices {nullptr};
-            uint32_t         joint_count {0};
+            uint32_t instance_index {0};
         };
 
         std::map<VulkanPBRMaterial*, std::map<VulkanMesh*, std::vector<MeshNode>>> point_lights_mesh_drawcall_batch;
+        std::vector<const RenderMeshNode*>                                          pre_skinned_nodes;
 
         // reorganize mesh
         for (RenderMeshNode& node : *(m_visiable_nodes.p_point_lights_visible_mesh_nodes))
         {
+            if (m_mesh_instances->isPreSkinned(node.instance_index))
+            {
+                pre_skinned_nodes.push_back(&node);
+                continue;
+            }
+
             auto& mesh_instanced = point_lights_mesh_drawcall_batch[node.ref_material];
             auto& mesh_nodes     = mesh_instanced[node.ref_mesh];
 
             MeshNode temp;
-            temp.model_matrix = node.model_matrix;
-            if (node.enable_vertex_blending)
-            {
-                temp.joint_matrices = node.joint_matrices;
-                temp.joint_count    = node.joint_count;
-            }
+            temp.instance_index = node.instance_index;
 
             mesh_nodes.push_back(temp);
         }
@@ -568,7 +626,7 @@ namespace Piccolo
                         m_rhi->cmdBindVertexBuffersPFN(
                             m_rhi->getCurrentCommandBuffer(), 0, 1, vertex_buffers, offsets);
                         m_rhi->cmdBindIndexBufferPFN(
-                            m_rhi->getCurrentCommandBuffer(), mesh.mesh_index_buffer, 0, RHI_INDEX_TYPE_UINT16);
+                            m_rhi->getCurrentCommandBuffer(), mesh.mesh_index_buffer, 0, mesh.mesh_index_type);
 
                         uint32_t drawcall_max_instance_count =
                             (sizeof(MeshPointLightShadowPerdrawcallStorageBufferObject::mesh_instances) /
@@ -605,69 +663,16 @@ namespace Piccolo
                                     perdrawcall_dynamic_offset));
                             for (uint32_t i = 0; i < current_instance_count; ++i)
                             {
-                                perdrawcall_storage_buffer_object.mesh_instances[i].model_matrix =
-                                    *mesh_nodes[drawcall_max_instance_count * drawcall_index + i].model_matrix;
-                                perdrawcall_storage_buffer_object.mesh_instances[i].enable_vertex_blending =
-                                    mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices ? 1.0 :
-                                                                                                                  -1.0;
+                                uint32_t instance_index =
+                                    mesh_nodes[drawcall_max_instance_count * drawcall_index + i].instance_index;
+                                perdrawcall_storage_buffer_object.mesh_instances[i].instance_index = instance_index;
+                                perdrawcall_storage_buffer_object.mesh_instances[i].joint_matrix_offset =
+                                    m_mesh_instances->getJointMatrixOffset(instance_index);
                             }
 
-                            // per drawcall vertex blending storage buffer
-                            uint32_t per_drawcall_vertex_blending_dynamic_offset;
-                            bool     least_one_enable_vertex_blending = true;
-                            for (uint32_t i = 0; i < current_instance_count; ++i)
-                            {
-                                if (!mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                {
-                                    least_one_enable_vertex_blending = false;
-                                    break;
-                                }
-                            }
-                            if (mesh.enable_vertex_blending)
-                            {
-                                per_drawcall_vertex_blending_dynamic_offset = roundUp(
-                                    m_global_render_resource->_storage_buffer
-                                        ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()],
-                                    m_global_render_resource->_storage_buffer._min_storage_buffer_offset_alignment);
-                                m_global_render_resource->_storage_buffer
-                                    ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] =
-                                    per_drawcall_vertex_blending_dynamic_offset +
-                                    sizeof(MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject);
-                                assert(m_global_render_resource->_storage_buffer
-                                           ._global_upload_ringbuffers_end[m_rhi->getCurrentFrameIndex()] <=
-                                       (m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_begin[m_rhi->getCurrentFrameIndex()] +
-                                        m_global_render_resource->_storage_buffer
-                                            ._global_upload_ringbuffers_size[m_rhi->getCurrentFrameIndex()]));
-
-                                MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject&
-                                    per_drawcall_vertex_blending_storage_buffer_object =
-                                        (*reinterpret_cast<
-                                            MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject*>(
-                                            reinterpret_cast<uintptr_t>(m_global_render_resource->_storage_buffer
-                                                                            ._global_upload_ringbuffer_memory_pointer) +
-                                            per_drawcall_vertex_blending_dynamic_offset));
-                                for (uint32_t i = 0; i < current_instance_count; ++i)
-                                {
-                                    if (mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_matrices)
-                                    {
-                                        for (uint32_t j = 0;
-                                             j <
-                                             mesh_nodes[drawcall_max_instance_count * drawcall_index + i].joint_count;
-                                             ++j)
-                                        {
-                                            per_drawcall_vertex_blending_storage_buffer_object
-                                                .joint_matrices[s_mesh_vertex_blending_max_joint_count * i + j] =
-                                                mesh_nodes[drawcall_max_instance_count * drawcall_index + i]
-                                                    .joint_matrices[j];
-                                        }
-                                    }
-                                }
-                            }
-                            else
-                            {
-                                per_drawcall_vertex_blending_dynamic_offset = 0;
-                            }
+                            // the joint matrices of the frame are shared by all the drawcalls
+                            uint32_t per_drawcall_vertex_blending_dynamic_offset =
+                                m_mesh_instances->getJointMatricesDynamicOffset();
 
                             // bind perdrawcall
                             uint32_t dynamic_offsets[3] = {perframe_dynamic_offset,
@@ -693,6 +698,16 @@ namespace Piccolo
                 }
             }
 
+            // the pre-skinned instances are drawn one by one from their skinned vertices
+            m_mesh_instances->drawPreSkinnedNodes(m_rhi->getCurrentCommandBuffer(),
+                                                  m_global_render_resource->_storage_buffer,
+                                                  m_rhi->getCurrentFrameIndex(),
+                                                  m_render_pipelines[0].layout,
+                                                  m_descriptor_infos[0].descriptor_set,
+                                                  perframe_dynamic_offset,
+                                                  pre_skinned_nodes,
+                                                  false);
+
             m_rhi->popEvent(m_rhi->getCurrentCommandBuffer());
         }
 
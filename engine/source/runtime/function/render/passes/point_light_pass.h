@@ -5,6 +5,7 @@
 namespace Piccolo
 {
     class RenderResourceBase;
+    class RenderMeshInstances;
 
     class PointLightShadowPass : public RenderPass
     {
@@ -23,10 +24,13 @@ namespace Piccolo
         void setupDescriptorSetLayout();
         void setupPipelines();
         void setupDescriptorSet();
+        void updateMeshInstanceDescriptorSet();
         void drawModel();
 
     private:
         RHIDescriptorSetLayout* m_per_mesh_layout;
+        RenderMeshInstances*    m_mesh_instances {nullptr};
+        uint32_t                m_mesh_instance_buffer_version {0};
         MeshPointLightShadowPerframeStorageBufferObject m_mesh_point_light_shadow_perframe_storage_buffer_object;
     };
 } // namespace Piccolo
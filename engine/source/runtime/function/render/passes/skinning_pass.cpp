@@ -0,0 +1,360 @@
+#include "runtime/function/render/passes/skinning_pass.h"
+
+#include "runtime/function/render/render_helper.h"
+#include "runtime/function/render/render_mesh_instances.h"
+#include "runtime/function/render/render_resource.h"
+#include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
+
+#include <mesh_skinning_comp.h>
+
+#include <stdexcept>
+
+namespace Piccolo
+{
+    void SkinningPass::initialize(const RenderPassInitInfo* init_info)
+    {
+        RenderPass::initialize(nullptr);
+
+        m_mesh_instances = &std::static_pointer_cast<RenderResource>(m_render_resource)->m_mesh_instances;
+        m_mesh_instances->initializePreSkinning();
+
+        setupDescriptorSetLayout();
+        setupPipelines();
+        setupDescriptorSet();
+    }
+
+    void SkinningPass::setupDescriptorSetLayout()
+    {
+        m_descriptor_infos.resize(_layout_type_count);
+
+        {
+            RHIDescriptorSetLayoutBinding mesh_skinning_per_frame_layout_bindings[4];
+
+            RHIDescriptorSetLayoutBinding& mesh_skinning_per_frame_layout_joint_matrices_binding =
+                mesh_skinning_per_frame_layout_bindings[0];
+            mesh_skinning_per_frame_layout_joint_matrices_binding.binding = 0;
+            mesh_skinning_per_frame_layout_joint_matrices_binding.descriptorType =
+                RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+            mesh_skinning_per_frame_layout_joint_matrices_binding.descriptorCount    = 1;
+            mesh_skinning_per_frame_layout_joint_matrices_binding.stageFlags         = RHI_SHADER_STAGE_COMPUTE_BIT;
+            mesh_skinning_per_frame_layout_joint_matrices_binding.pImmutableSamplers = NULL;
+
+            RHIDescriptorSetLayoutBinding& mesh_skinning_per_frame_layout_per_dispatch_binding =
+                mesh_skinning_per_frame_layout_bindings[1];
+            mesh_skinning_per_frame_layout_per_dispatch_binding = mesh_skinning_per_frame_layout_joint_matrices_binding;
+            mesh_skinning_per_frame_layout_per_dispatch_binding.binding = 1;
+
+            RHIDescriptorSetLayoutBinding& mesh_skinning_per_frame_layout_skinned_position_binding =
+                mesh_skinning_per_frame_layout_bindings[2];
+            mesh_skinning_per_frame_layout_skinned_position_binding =
+                mesh_skinning_per_frame_layout_joint_matrices_binding;
+            mesh_skinning_per_frame_layout_skinned_position_binding.binding        = 2;
+            mesh_skinning_per_frame_layout_skinned_position_binding.descriptorType = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+
+            RHIDescriptorSetLayoutBinding& mesh_skinning_per_frame_layout_skinned_varying_binding =
+                mesh_skinning_per_frame_layout_bindings[3];
+            mesh_skinning_per_frame_layout_skinned_varying_binding =
+                mesh_skinning_per_frame_layout_skinned_position_binding;
+            mesh_skinning_per_frame_layout_skinned_varying_binding.binding = 3;
+
+            RHIDescriptorSetLayoutCreateInfo mesh_skinning_per_frame_layout_create_info {};
+            mesh_skinning_per_frame_layout_create_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            mesh_skinning_per_frame_layout_create_info.bindingCount =
+                sizeof(mesh_skinning_per_frame_layout_bindings) / sizeof(mesh_skinning_per_frame_layout_bindings[0]);
+            mesh_skinning_per_frame_layout_create_info.pBindings = mesh_skinning_per_frame_layout_bindings;
+
+            if (RHI_SUCCESS != m_rhi->createDescriptorSetLayout(&mesh_skinning_per_frame_layout_create_info,
+                                                                m_descriptor_infos[_per_frame].layout))
+            {
+                throw std::runtime_error("create mesh skinning per frame layout");
+            }
+        }
+
+        {
+            RHIDescriptorSetLayoutBinding mesh_skinning_per_mesh_layout_bindings[3];
+
+            RHIDescriptorSetLayoutBinding& mesh_skinning_per_mesh_layout_joint_binding_binding =
+                mesh_skinning_per_mesh_layout_bindings[0];
+            mesh_skinning_per_mesh_layout_joint_binding_binding.binding = 0;
+            mesh_skinning_per_mesh_layout_joint_binding_binding.descriptorType = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            mesh_skinning_per_mesh_layout_joint_binding_binding.descriptorCount    = 1;
+            mesh_skinning_per_mesh_layout_joint_binding_binding.stageFlags         = RHI_SHADER_STAGE_COMPUTE_BIT;
+            mesh_skinning_per_mesh_layout_joint_binding_binding.pImmutableSamplers = NULL;
+
+            RHIDescriptorSetLayoutBinding& mesh_skinning_per_mesh_layout_position_binding =
+                mesh_skinning_per_mesh_layout_bindings[1];
+            mesh_skinning_per_mesh_layout_position_binding = mesh_skinning_per_mesh_layout_joint_binding_binding;
+            mesh_skinning_per_mesh_layout_position_binding.binding = 1;
+
+            RHIDescriptorSetLayoutBinding& mesh_skinning_per_mesh_layout_varying_binding =
+                mesh_skinning_per_mesh_layout_bindings[2];
+            mesh_skinning_per_mesh_layout_varying_binding         = mesh_skinning_per_mesh_layout_joint_binding_binding;
+            mesh_skinning_per_mesh_layout_varying_binding.binding = 2;
+
+            RHIDescriptorSetLayoutCreateInfo mesh_skinning_per_mesh_layout_create_info {};
+            mesh_skinning_per_mesh_layout_create_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+            mesh_skinning_per_mesh_layout_create_info.bindingCount =
+                sizeof(mesh_skinning_per_mesh_layout_bindings) / sizeof(mesh_skinning_per_mesh_layout_bindings[0]);
+            mesh_skinning_per_mesh_layout_create_info.pBindings = mesh_skinning_per_mesh_layout_bindings;
+
+            if (RHI_SUCCESS != m_rhi->createDescriptorSetLayout(&mesh_skinning_per_mesh_layout_create_info,
+                                                                m_descriptor_infos[_per_mesh].layout))
+            {
+                throw std::runtime_error("create mesh skinning per mesh layout");
+            }
+        }
+    }
+
+    void SkinningPass::setupPipelines()
+    {
+        m_render_pipelines.resize(1);
+
+        RHIDescriptorSetLayout* descriptorset_layouts[2] = {m_descriptor_infos[_per_frame].layout,
+                                                            m_descriptor_infos[_per_mesh].layout};
+        RHIPipelineLayoutCreateInfo pipeline_layout_create_info {};
+        pipeline_layout_create_info.sType          = RHI_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipeline_layout_create_info.setLayoutCount = sizeof(descriptorset_layouts) / sizeof(descriptorset_layouts[0]);
+        pipeline_layout_create_info.pSetLayouts    = descriptorset_layouts;
+
+        if (RHI_SUCCESS != m_rhi->createPipelineLayout(&pipeline_layout_create_info, m_render_pipelines[0].layout))
+        {
+            throw std::runtime_error("create mesh skinning pipeline layout");
+        }
+
+        RHIShader* comp_shader_module = m_rhi->createShaderModule(MESH_SKINNING_COMP);
+
+        RHIPipelineShaderStageCreateInfo comp_pipeline_shader_stage_create_info {};
+        comp_pipeline_shader_stage_create_info.sType  = RHI_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        comp_pipeline_shader_stage_create_info.stage  = RHI_SHADER_STAGE_COMPUTE_BIT;
+        comp_pipeline_shader_stage_create_info.module = comp_shader_module;
+        comp_pipeline_shader_stage_create_info.pName  = "main";
+
+        RHIComputePipelineCreateInfo pipelineInfo {};
+        pipelineInfo.sType   = RHI_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.pStages = &comp_pipeline_shader_stage_create_info;
+        pipelineInfo.layout  = m_render_pipelines[0].layout;
+        pipelineInfo.flags   = 0;
+
+        if (RHI_SUCCESS !=
+            m_rhi->createComputePipelines(RHI_NULL_HANDLE, 1, &pipelineInfo, m_render_pipelines[0].pipeline))
+        {
+            throw std::runtime_error("create mesh skinning compute pipeline");
+        }
+
+        m_rhi->destroyShaderModule(comp_shader_module);
+    }
+
+    void SkinningPass::setupDescriptorSet()
+    {
+        RHIDescriptorSetAllocateInfo mesh_skinning_descriptor_set_alloc_info;
+        mesh_skinning_descriptor_set_alloc_info.sType              = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        mesh_skinning_descriptor_set_alloc_info.pNext              = NULL;
+        mesh_skinning_descriptor_set_alloc_info.descriptorPool     = m_rhi->getDescriptorPoor();
+        mesh_skinning_descriptor_set_alloc_info.descriptorSetCount = 1;
+        mesh_skinning_descriptor_set_alloc_info.pSetLayouts        = &m_descriptor_infos[_per_frame].layout;
+
+        if (RHI_SUCCESS != m_rhi->allocateDescriptorSets(&mesh_skinning_descriptor_set_alloc_info,
+                                                         m_descriptor_infos[_per_frame].descriptor_set))
+        {
+            throw std::runtime_error("allocate mesh skinning per frame descriptor set");
+        }
+
+        RHIDescriptorBufferInfo mesh_skinning_joint_matrices_storage_buffer_info = {};
+        mesh_skinning_joint_matrices_storage_buffer_info.offset                 = 0;
+        mesh_skinning_joint_matrices_storage_buffer_info.range =
+            sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
+        mesh_skinning_joint_matrices_storage_buffer_info.buffer =
+            m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
+        assert(mesh_skinning_joint_matrices_storage_buffer_info.range <
+               m_global_render_resource->_storage_buffer._max_storage_buffer_range);
+
+        RHIDescriptorBufferInfo mesh_skinning_per_dispatch_storage_buffer_info = {};
+        mesh_skinning_per_dispatch_storage_buffer_info.offset                 = 0;
+        mesh_skinning_per_dispatch_storage_buffer_info.range = sizeof(MeshSkinningPerdispatchStorageBufferObject);
+        mesh_skinning_per_dispatch_storage_buffer_info.buffer =
+            m_global_render_resource->_storage_buffer._global_upload_ringbuffer;
+
+        RHIDescriptorBufferInfo mesh_skinning_skinned_position_storage_buffer_info = {};
+        mesh_skinning_skinned_position_storage_buffer_info.offset                 = 0;
+        mesh_skinning_skinned_position_storage_buffer_info.range                  = RHI_WHOLE_SIZE;
+        mesh_skinning_skinned_position_storage_buffer_info.buffer = m_mesh_instances->getSkinnedPositionBuffer();
+
+        RHIDescriptorBufferInfo mesh_skinning_skinned_varying_storage_buffer_info = {};
+        mesh_skinning_skinned_varying_storage_buffer_info.offset                 = 0;
+        mesh_skinning_skinned_varying_storage_buffer_info.range                  = RHI_WHOLE_SIZE;
+        mesh_skinning_skinned_varying_storage_buffer_info.buffer = m_mesh_instances->getSkinnedVaryingBuffer();
+
+        RHIWriteDescriptorSet mesh_skinning_descriptor_writes_info[4];
+
+        mesh_skinning_descriptor_writes_info[0].sType           = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        mesh_skinning_descriptor_writes_info[0].pNext           = NULL;
+        mesh_skinning_descriptor_writes_info[0].dstSet          = m_descriptor_infos[_per_frame].descriptor_set;
+        mesh_skinning_descriptor_writes_info[0].dstBinding      = 0;
+        mesh_skinning_descriptor_writes_info[0].dstArrayElement = 0;
+        mesh_skinning_descriptor_writes_info[0].descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        mesh_skinning_descriptor_writes_info[0].descriptorCount = 1;
+        mesh_skinning_descriptor_writes_info[0].pBufferInfo     = &mesh_skinning_joint_matrices_storage_buffer_info;
+
+        mesh_skinning_descriptor_writes_info[1]             = mesh_skinning_descriptor_writes_info[0];
+        mesh_skinning_descriptor_writes_info[1].dstBinding  = 1;
+        mesh_skinning_descriptor_writes_info[1].pBufferInfo = &mesh_skinning_per_dispatch_storage_buffer_info;
+
+        mesh_skinning_descriptor_writes_info[2]                = mesh_skinning_descriptor_writes_info[0];
+        mesh_skinning_descriptor_writes_info[2].dstBinding     = 2;
+        mesh_skinning_descriptor_writes_info[2].descriptorType = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        mesh_skinning_descriptor_writes_info[2].pBufferInfo    = &mesh_skinning_skinned_position_storage_buffer_info;
+
+        mesh_skinning_descriptor_writes_info[3]             = mesh_skinning_descriptor_writes_info[2];
+        mesh_skinning_descriptor_writes_info[3].dstBinding  = 3;
+        mesh_skinning_descriptor_writes_info[3].pBufferInfo = &mesh_skinning_skinned_varying_storage_buffer_info;
+
+        m_rhi->updateDescriptorSets(sizeof(mesh_skinning_descriptor_writes_info) /
+                                        sizeof(mesh_skinning_descriptor_writes_info[0]),
+                                    mesh_skinning_descriptor_writes_info,
+                                    0,
+                                    NULL);
+    }
+
+    RHIDescriptorSet* SkinningPass::getMeshDescriptorSet(VulkanMesh* mesh)
+    {
+        auto find_it = m_mesh_descriptor_sets.find(mesh);
+        if (find_it != m_mesh_descriptor_sets.end())
+        {
+            return find_it->second;
+        }
+
+        RHIDescriptorSetAllocateInfo mesh_skinning_per_mesh_descriptor_set_alloc_info;
+        mesh_skinning_per_mesh_descriptor_set_alloc_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        mesh_skinning_per_mesh_descriptor_set_alloc_info.pNext          = NULL;
+        mesh_skinning_per_mesh_descriptor_set_alloc_info.descriptorPool = m_rhi->getDescriptorPoor();
+        mesh_skinning_per_mesh_descriptor_set_alloc_info.descriptorSetCount = 1;
+        mesh_skinning_per_mesh_descriptor_set_alloc_info.pSetLayouts        = &m_descriptor_infos[_per_mesh].layout;
+
+        RHIDescriptorSet* descriptor_set = nullptr;
+        if (RHI_SUCCESS != m_rhi->allocateDescriptorSets(&mesh_skinning_per_mesh_descriptor_set_alloc_info,
+                                                         descriptor_set))
+        {
+            throw std::runtime_error("allocate mesh skinning per mesh descriptor set");
+        }
+
+        RHIDescriptorBufferInfo mesh_skinning_per_mesh_storage_buffer_infos[3] = {};
+        mesh_skinning_per_mesh_storage_buffer_infos[0].buffer = mesh->mesh_vertex_joint_binding_buffer;
+        mesh_skinning_per_mesh_storage_buffer_infos[1].buffer = mesh->mesh_vertex_position_buffer;
+        mesh_skinning_per_mesh_storage_buffer_infos[2].buffer = mesh->mesh_vertex_varying_enable_blending_buffer;
+
+        RHIWriteDescriptorSet mesh_skinning_per_mesh_descriptor_writes_info[3];
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            mesh_skinning_per_mesh_storage_buffer_infos[i].offset = 0;
+            mesh_skinning_per_mesh_storage_buffer_infos[i].range  = RHI_WHOLE_SIZE;
+
+            mesh_skinning_per_mesh_descriptor_writes_info[i].sType           = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            mesh_skinning_per_mesh_descriptor_writes_info[i].pNext           = NULL;
+            mesh_skinning_per_mesh_descriptor_writes_info[i].dstSet          = descriptor_set;
+            mesh_skinning_per_mesh_descriptor_writes_info[i].dstBinding      = i;
+            mesh_skinning_per_mesh_descriptor_writes_info[i].dstArrayElement = 0;
+            mesh_skinning_per_mesh_descriptor_writes_info[i].descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            mesh_skinning_per_mesh_descriptor_writes_info[i].descriptorCount = 1;
+            mesh_skinning_per_mesh_descriptor_writes_info[i].pBufferInfo =
+                &mesh_skinning_per_mesh_storage_buffer_infos[i];
+        }
+
+        m_rhi->updateDescriptorSets(sizeof(mesh_skinning_per_mesh_descriptor_writes_info) /
+                                        sizeof(mesh_skinning_per_mesh_descriptor_writes_info[0]),
+                                    mesh_skinning_per_mesh_descriptor_writes_info,
+                                    0,
+                                    NULL);
+
+        m_mesh_descriptor_sets[mesh] = descriptor_set;
+        return descriptor_set;
+    }
+
+    void SkinningPass::draw()
+    {
+        const std::vector<PreSkinnedInstance>& pre_skinned_instances = m_mesh_instances->getPreSkinnedInstances();
+        if (pre_skinned_instances.empty())
+            return;
+
+        RHICommandBuffer* command_buffer = m_rhi->getCurrentCommandBuffer();
+        StorageBuffer&    storage_buffer = m_global_render_resource->_storage_buffer;
+        const uint8_t     frame_index    = m_rhi->getCurrentFrameIndex();
+
+        float color[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+        m_rhi->pushEvent(command_buffer, "Mesh Skinning", color);
+
+        // the frames before read the skinned vertices in the mesh passes
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr);
+
+        m_rhi->cmdBindPipelinePFN(command_buffer, RHI_PIPELINE_BIND_POINT_COMPUTE, m_render_pipelines[0].pipeline);
+
+        for (const PreSkinnedInstance& pre_skinned_instance : pre_skinned_instances)
+        {
+            // per dispatch storage buffer
+            uint32_t per_dispatch_dynamic_offset = roundUp(storage_buffer._global_upload_ringbuffers_end[frame_index],
+                                                           storage_buffer._min_storage_buffer_offset_alignment);
+            storage_buffer._global_upload_ringbuffers_end[frame_index] =
+                per_dispatch_dynamic_offset + sizeof(MeshSkinningPerdispatchStorageBufferObject);
+            assert(storage_buffer._global_upload_ringbuffers_end[frame_index] <=
+                   (storage_buffer._global_upload_ringbuffers_begin[frame_index] +
+                    storage_buffer._global_upload_ringbuffers_size[frame_index]));
+
+            MeshSkinningPerdispatchStorageBufferObject& per_dispatch_storage_buffer_object =
+                (*reinterpret_cast<MeshSkinningPerdispatchStorageBufferObject*>(
+                    reinterpret_cast<uintptr_t>(storage_buffer._global_upload_ringbuffer_memory_pointer) +
+                    per_dispatch_dynamic_offset));
+            per_dispatch_storage_buffer_object.vertex_count        = pre_skinned_instance.m_mesh->mesh_vertex_count;
+            per_dispatch_storage_buffer_object.joint_matrix_offset = pre_skinned_instance.m_joint_matrix_offset;
+            per_dispatch_storage_buffer_object.first_vertex        = pre_skinned_instance.m_first_vertex;
+
+            uint32_t dynamic_offsets[2] = {m_mesh_instances->getJointMatricesDynamicOffset(),
+                                           per_dispatch_dynamic_offset};
+            m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                            RHI_PIPELINE_BIND_POINT_COMPUTE,
+                                            m_render_pipelines[0].layout,
+                                            0,
+                                            1,
+                                            &m_descriptor_infos[_per_frame].descriptor_set,
+                                            (sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0])),
+                                            dynamic_offsets);
+
+            RHIDescriptorSet* mesh_descriptor_set = getMeshDescriptorSet(pre_skinned_instance.m_mesh);
+            m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                            RHI_PIPELINE_BIND_POINT_COMPUTE,
+                                            m_render_pipelines[0].layout,
+                                            1,
+                                            1,
+                                            &mesh_descriptor_set,
+                                            0,
+                                            NULL);
+
+            // local_size_x in mesh_skinning.comp
+            m_rhi->cmdDispatch(command_buffer, (pre_skinned_instance.m_mesh->mesh_vertex_count + 63) / 64, 1, 1);
+        }
+
+        RHIMemoryBarrier barrier {};
+        barrier.sType         = RHI_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = RHI_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = RHI_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                  RHI_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                                  0,
+                                  1,
+                                  &barrier,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr);
+
+        m_rhi->popEvent(command_buffer);
+    }
+} // namespace Piccolo
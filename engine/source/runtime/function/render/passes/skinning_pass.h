@@ -0,0 +1,39 @@
+#pragma once
+
+#include "runtime/function/render/render_pass.h"
+
+#include <unordered_map>
+
+namespace Piccolo
+{
+    class RenderMeshInstances;
+
+    /// Skins the vertices of the skinned instances once per frame into the skinned vertex buffers of
+    /// RenderMeshInstances, the shadow and main camera passes then read them instead of skinning in their vertex
+    /// shaders. To record after RenderMeshInstances::recordUpload, outside of a render pass.
+    class SkinningPass : public RenderPass
+    {
+    public:
+        enum LayoutType : uint8_t
+        {
+            _per_frame = 0,
+            _per_mesh,
+            _layout_type_count
+        };
+
+        void initialize(const RenderPassInitInfo* init_info) override final;
+        void draw() override final;
+
+    private:
+        void setupDescriptorSetLayout();
+        void setupPipelines();
+        void setupDescriptorSet();
+
+        RHIDescriptorSet* getMeshDescriptorSet(VulkanMesh* mesh);
+
+        RenderMeshInstances* m_mesh_instances {nullptr};
+
+        // the source vertices of the meshes, allocated when a mesh is first skinned
+        std::unordered_map<VulkanMesh*, RHIDescriptorSet*> m_mesh_descriptor_sets;
+    };
+} // namespace Piccolo
@@ -30,6 +30,7 @@ namespace Piccolo
         init_info.QueueFamily               = m_rhi->getQueueFamilyIndices().graphics_family.value();
         init_info.Queue                     = ((VulkanQueue*)m_rhi->getGraphicsQueue())->getResource();
         init_info.DescriptorPool            = std::static_pointer_cast<VulkanRHI>(m_rhi)->m_vk_descriptor_pool;
+        init_info.PipelineCache             = std::static_pointer_cast<VulkanRHI>(m_rhi)->m_vk_pipeline_cache;
         init_info.Subpass                   = _main_camera_subpass_ui;
         
         // may be different from the real swapchain image count
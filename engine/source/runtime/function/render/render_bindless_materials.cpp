@@ -0,0 +1,436 @@
+#include "runtime/function/render/render_bindless_materials.h"
+
+#include "runtime/core/base/macro.h"
+
+#include "runtime/function/render/interface/vulkan/vulkan_rhi.h"
+#include "runtime/function/render/render_helper.h"
+#include "runtime/function/render/render_resource.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace Piccolo
+{
+    namespace
+    {
+        uint32_t const k_invalid_texture_slot = 0xFFFFFFFF;
+    } // namespace
+
+    void RenderBindlessMaterials::initialize(std::shared_ptr<RHI> rhi)
+    {
+        // the global resources are uploaded again with every level, the materials outlive the levels
+        if (isEnabled() || !rhi->isBindlessEnabled())
+            return;
+
+        m_rhi = rhi;
+
+        const uint32_t texture_count = VulkanRHI::k_max_bindless_texture_count;
+
+        RHIDescriptorSetLayoutBinding layout_bindings[2] {};
+
+        // (set = 2, binding = 0 in the bindless fragment shaders)
+        RHIDescriptorSetLayoutBinding& material_binding = layout_bindings[0];
+        material_binding.binding                        = 0;
+        material_binding.descriptorType                 = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        material_binding.descriptorCount                = 1;
+        material_binding.stageFlags                     = RHI_SHADER_STAGE_FRAGMENT_BIT;
+
+        // (set = 2, binding = 1 in the bindless fragment shaders)
+        RHIDescriptorSetLayoutBinding& texture_binding = layout_bindings[1];
+        texture_binding.binding                        = 1;
+        texture_binding.descriptorType                 = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        texture_binding.descriptorCount                = texture_count;
+        texture_binding.stageFlags                     = RHI_SHADER_STAGE_FRAGMENT_BIT;
+
+        // the slots are written while the frames in flight sample the others, those never written are never sampled
+        RHIDescriptorBindingFlags binding_flags[2] = {
+            0,
+            RHI_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | RHI_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
+                RHI_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | RHI_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT};
+
+        RHIDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_create_info {};
+        binding_flags_create_info.sType         = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        binding_flags_create_info.bindingCount  = 2;
+        binding_flags_create_info.pBindingFlags = binding_flags;
+
+        RHIDescriptorSetLayoutCreateInfo layout_create_info {};
+        layout_create_info.sType        = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layout_create_info.pNext        = &binding_flags_create_info;
+        layout_create_info.flags        = RHI_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        layout_create_info.bindingCount = 2;
+        layout_create_info.pBindings    = layout_bindings;
+
+        if (RHI_SUCCESS != m_rhi->createDescriptorSetLayout(&layout_create_info, m_descriptor_set_layout))
+        {
+            throw std::runtime_error("create bindless material layout");
+        }
+
+        RHIDescriptorPoolSize pool_sizes[2];
+        pool_sizes[0].type            = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        pool_sizes[0].descriptorCount = 1;
+        pool_sizes[1].type            = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        pool_sizes[1].descriptorCount = texture_count;
+
+        RHIDescriptorPoolCreateInfo pool_create_info {};
+        pool_create_info.sType         = RHI_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_create_info.flags         = RHI_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        pool_create_info.maxSets       = 1;
+        pool_create_info.poolSizeCount = 2;
+        pool_create_info.pPoolSizes    = pool_sizes;
+
+        if (RHI_SUCCESS != m_rhi->createDescriptorPool(&pool_create_info, m_descriptor_pool))
+        {
+            throw std::runtime_error("create bindless material descriptor pool");
+        }
+
+        RHIDescriptorSetVariableDescriptorCountAllocateInfo variable_count_allocate_info {};
+        variable_count_allocate_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
+        variable_count_allocate_info.descriptorSetCount = 1;
+        variable_count_allocate_info.pDescriptorCounts  = &texture_count;
+
+        RHIDescriptorSetAllocateInfo set_allocate_info {};
+        set_allocate_info.sType              = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        set_allocate_info.pNext              = &variable_count_allocate_info;
+        set_allocate_info.descriptorPool     = m_descriptor_pool;
+        set_allocate_info.descriptorSetCount = 1;
+        set_allocate_info.pSetLayouts        = &m_descriptor_set_layout;
+
+        if (RHI_SUCCESS != m_rhi->allocateDescriptorSets(&set_allocate_info, m_descriptor_set))
+        {
+            throw std::runtime_error("allocate bindless material descriptor set");
+        }
+
+        const RHIDeviceSize material_buffer_size =
+            sizeof(MeshBindlessMaterialStorageBufferObject) * s_mesh_bindless_material_max_count;
+        m_rhi->createBuffer(material_buffer_size,
+                            RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
+                            RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                            m_material_buffer,
+                            m_material_buffer_memory);
+
+        RHIDescriptorBufferInfo material_buffer_info {};
+        material_buffer_info.buffer = m_material_buffer;
+        material_buffer_info.offset = 0;
+        material_buffer_info.range  = material_buffer_size;
+
+        RHIWriteDescriptorSet material_buffer_write {};
+        material_buffer_write.sType           = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        material_buffer_write.dstSet          = m_descriptor_set;
+        material_buffer_write.dstBinding      = 0;
+        material_buffer_write.dstArrayElement = 0;
+        material_buffer_write.descriptorType  = RHI_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        material_buffer_write.descriptorCount = 1;
+        material_buffer_write.pBufferInfo     = &material_buffer_info;
+        m_rhi->updateDescriptorSets(1, &material_buffer_write, 0, nullptr);
+
+        m_retired_texture_slots.resize(m_rhi->getMaxFramesInFlight());
+    }
+
+    void RenderBindlessMaterials::clear()
+    {
+        if (m_material_buffer)
+        {
+            m_rhi->destroyBuffer(m_material_buffer);
+            m_rhi->freeMemory(m_material_buffer_memory);
+            m_material_buffer = nullptr;
+        }
+        // the set goes with its pool
+        if (m_descriptor_pool)
+        {
+            m_rhi->destroyDescriptorPool(m_descriptor_pool);
+            RHI_DELETE_PTR(m_descriptor_set);
+        }
+        if (m_descriptor_set_layout)
+        {
+            m_rhi->destroyDescriptorSetLayout(m_descriptor_set_layout);
+        }
+        m_rhi.reset();
+
+        m_materials.clear();
+        m_material_texture_views.clear();
+        m_dirty_materials.clear();
+        m_fallback_material_count = 0;
+        m_texture_slots.clear();
+        m_texture_slot_count = 0;
+        m_free_texture_slots.clear();
+        m_released_texture_slots.clear();
+        m_retired_texture_slots.clear();
+    }
+
+    bool RenderBindlessMaterials::updateMaterialFactors(VulkanPBRMaterial&                        material,
+                                                        const MeshPerMaterialUniformBufferObject& factors)
+    {
+        if (material.material_index == s_mesh_bindless_invalid_material)
+        {
+            if (m_materials.size() >= s_mesh_bindless_material_max_count)
+            {
+                if (m_fallback_material_count == 0)
+                {
+                    LOG_WARN("more than {} materials, the others get a descriptor set of their own",
+                             s_mesh_bindless_material_max_count);
+                }
+                ++m_fallback_material_count;
+                return false;
+            }
+
+            material.material_index = static_cast<uint32_t>(m_materials.size());
+            m_materials.emplace_back();
+            m_material_texture_views.resize(m_materials.size() * k_texture_count_per_material, nullptr);
+        }
+
+        MeshBindlessMaterialStorageBufferObject& record = m_materials[material.material_index];
+        record.baseColorFactor                          = factors.baseColorFactor;
+        record.metallicFactor                           = factors.metallicFactor;
+        record.roughnessFactor                          = factors.roughnessFactor;
+        record.normalScale                              = factors.normalScale;
+        record.occlusionStrength                        = factors.occlusionStrength;
+        record.emissiveFactor                           = factors.emissiveFactor;
+        record.is_blend                                 = factors.is_blend;
+        record.is_double_sided                          = factors.is_double_sided;
+
+        m_dirty_materials.push_back(material.material_index);
+        return true;
+    }
+
+    bool RenderBindlessMaterials::updateMaterialTextures(VulkanPBRMaterial&      material,
+                                                         RHIDescriptorImageInfo* texture_image_infos)
+    {
+        if (material.material_index == s_mesh_bindless_invalid_material)
+            return false;
+
+        uint32_t texture_slots[k_texture_count_per_material];
+        bool     is_new_slots[k_texture_count_per_material];
+        for (uint32_t texture_index = 0; texture_index < k_texture_count_per_material; ++texture_index)
+        {
+            texture_slots[texture_index] =
+                acquireTextureSlot(texture_image_infos[texture_index], is_new_slots[texture_index]);
+            if (texture_slots[texture_index] != k_invalid_texture_slot)
+                continue;
+
+            // all the textures or none, the slots acquired were not written yet
+            for (uint32_t acquired_index = 0; acquired_index < texture_index; ++acquired_index)
+            {
+                releaseTextureSlot(texture_image_infos[acquired_index].imageView);
+            }
+            return false;
+        }
+
+        RHIWriteDescriptorSet texture_writes[k_texture_count_per_material] {};
+        uint32_t              texture_write_count = 0;
+        for (uint32_t texture_index = 0; texture_index < k_texture_count_per_material; ++texture_index)
+        {
+            if (!is_new_slots[texture_index])
+                continue;
+
+            RHIWriteDescriptorSet& texture_write = texture_writes[texture_write_count++];
+            texture_write.sType                  = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            texture_write.dstSet                 = m_descriptor_set;
+            texture_write.dstBinding             = 1;
+            texture_write.dstArrayElement        = texture_slots[texture_index];
+            texture_write.descriptorType         = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            texture_write.descriptorCount        = 1;
+            texture_write.pImageInfo             = &texture_image_infos[texture_index];
+        }
+        if (texture_write_count > 0)
+        {
+            m_rhi->updateDescriptorSets(texture_write_count, texture_writes, 0, nullptr);
+        }
+
+        // released after the new ones are acquired, a texture the material keeps keeps its slot
+        RHIImageView** texture_views =
+            &m_material_texture_views[material.material_index * k_texture_count_per_material];
+        for (uint32_t texture_index = 0; texture_index < k_texture_count_per_material; ++texture_index)
+        {
+            if (texture_views[texture_index])
+            {
+                releaseTextureSlot(texture_views[texture_index]);
+            }
+            texture_views[texture_index] = texture_image_infos[texture_index].imageView;
+        }
+
+        MeshBindlessMaterialStorageBufferObject& record = m_materials[material.material_index];
+        record.base_color_texture_index                 = texture_slots[0];
+        record.metallic_roughness_texture_index         = texture_slots[1];
+        record.normal_texture_index                     = texture_slots[2];
+        record.occlusion_texture_index                  = texture_slots[3];
+        record.emissive_texture_index                   = texture_slots[4];
+
+        m_dirty_materials.push_back(material.material_index);
+        return true;
+    }
+
+    MeshPerMaterialUniformBufferObject RenderBindlessMaterials::releaseMaterial(VulkanPBRMaterial& material)
+    {
+        assert(material.material_index != s_mesh_bindless_invalid_material);
+
+        const MeshBindlessMaterialStorageBufferObject& record = m_materials[material.material_index];
+
+        MeshPerMaterialUniformBufferObject factors;
+        factors.baseColorFactor   = record.baseColorFactor;
+        factors.metallicFactor    = record.metallicFactor;
+        factors.roughnessFactor   = record.roughnessFactor;
+        factors.normalScale       = record.normalScale;
+        factors.occlusionStrength = record.occlusionStrength;
+        factors.emissiveFactor    = record.emissiveFactor;
+        factors.is_blend          = record.is_blend;
+        factors.is_double_sided   = record.is_double_sided;
+
+        RHIImageView** texture_views =
+            &m_material_texture_views[material.material_index * k_texture_count_per_material];
+        for (uint32_t texture_index = 0; texture_index < k_texture_count_per_material; ++texture_index)
+        {
+            if (texture_views[texture_index])
+            {
+                releaseTextureSlot(texture_views[texture_index]);
+                texture_views[texture_index] = nullptr;
+            }
+        }
+
+        // the record stays unused, the instances stop reading it once their batches are rebuilt
+        material.material_index = s_mesh_bindless_invalid_material;
+        ++m_fallback_material_count;
+        return factors;
+    }
+
+    uint32_t RenderBindlessMaterials::acquireTextureSlot(const RHIDescriptorImageInfo& texture_image_info,
+                                                         bool&                         out_is_new)
+    {
+        // the sampler follows the size of the view, a view is always written with the same one
+        auto found = m_texture_slots.find(texture_image_info.imageView);
+        if (found != m_texture_slots.end())
+        {
+            found->second.m_reference_count++;
+            out_is_new = false;
+            return found->second.m_slot;
+        }
+
+        uint32_t slot = k_invalid_texture_slot;
+        if (!m_free_texture_slots.empty())
+        {
+            slot = m_free_texture_slots.back();
+            m_free_texture_slots.pop_back();
+        }
+        else if (m_texture_slot_count < VulkanRHI::k_max_bindless_texture_count)
+        {
+            slot = m_texture_slot_count++;
+        }
+        else
+        {
+            LOG_WARN("more than {} material textures, the materials sampling the others get a descriptor set of "
+                     "their own",
+                     VulkanRHI::k_max_bindless_texture_count);
+            out_is_new = false;
+            return k_invalid_texture_slot;
+        }
+
+        TextureSlot& texture_slot      = m_texture_slots[texture_image_info.imageView];
+        texture_slot.m_slot            = slot;
+        texture_slot.m_reference_count = 1;
+        out_is_new                     = true;
+        return slot;
+    }
+
+    void RenderBindlessMaterials::releaseTextureSlot(RHIImageView* image_view)
+    {
+        auto found = m_texture_slots.find(image_view);
+        assert(found != m_texture_slots.end());
+
+        if (--found->second.m_reference_count == 0)
+        {
+            m_released_texture_slots.push_back(found->second.m_slot);
+            m_texture_slots.erase(found);
+        }
+    }
+
+    void RenderBindlessMaterials::recordUpload(RHICommandBuffer* command_buffer,
+                                               StorageBuffer&    storage_buffer,
+                                               uint8_t           frame_index)
+    {
+        if (!isEnabled())
+            return;
+
+        // the fence of the frame was waited, the frames recorded before it no longer sample the slots retired then
+        std::vector<uint32_t>& retired_texture_slots = m_retired_texture_slots[frame_index];
+        m_free_texture_slots.insert(
+            m_free_texture_slots.end(), retired_texture_slots.begin(), retired_texture_slots.end());
+        // the records copied below stop pointing to the slots released since the previous upload
+        retired_texture_slots.swap(m_released_texture_slots);
+        m_released_texture_slots.clear();
+
+        if (m_dirty_materials.empty())
+            return;
+
+        std::sort(m_dirty_materials.begin(), m_dirty_materials.end());
+        m_dirty_materials.erase(std::unique(m_dirty_materials.begin(), m_dirty_materials.end()),
+                                m_dirty_materials.end());
+
+        uint32_t upload_offset = roundUp(storage_buffer._global_upload_ringbuffers_end[frame_index],
+                                         storage_buffer._min_storage_buffer_offset_alignment);
+        storage_buffer._global_upload_ringbuffers_end[frame_index] =
+            upload_offset +
+            static_cast<uint32_t>(sizeof(MeshBindlessMaterialStorageBufferObject) * m_dirty_materials.size());
+        assert(storage_buffer._global_upload_ringbuffers_end[frame_index] <=
+               (storage_buffer._global_upload_ringbuffers_begin[frame_index] +
+                storage_buffer._global_upload_ringbuffers_size[frame_index]));
+
+        MeshBindlessMaterialStorageBufferObject* upload_materials =
+            reinterpret_cast<MeshBindlessMaterialStorageBufferObject*>(
+                reinterpret_cast<uintptr_t>(storage_buffer._global_upload_ringbuffer_memory_pointer) + upload_offset);
+
+        // one copy per run of consecutive materials
+        m_upload_regions.clear();
+        for (size_t i = 0; i < m_dirty_materials.size(); ++i)
+        {
+            const uint32_t material_index = m_dirty_materials[i];
+            upload_materials[i]           = m_materials[material_index];
+
+            if (i > 0 && m_dirty_materials[i - 1] + 1 == material_index)
+            {
+                m_upload_regions.back().size += sizeof(MeshBindlessMaterialStorageBufferObject);
+            }
+            else
+            {
+                RHIBufferCopy region;
+                region.srcOffset = upload_offset + sizeof(MeshBindlessMaterialStorageBufferObject) * i;
+                region.dstOffset = sizeof(MeshBindlessMaterialStorageBufferObject) * material_index;
+                region.size      = sizeof(MeshBindlessMaterialStorageBufferObject);
+                m_upload_regions.push_back(region);
+            }
+        }
+        m_dirty_materials.clear();
+
+        // the frames before read the materials in the fragment shaders
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                  RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr);
+
+        m_rhi->cmdCopyBuffer(command_buffer,
+                             storage_buffer._global_upload_ringbuffer,
+                             m_material_buffer,
+                             static_cast<uint32_t>(m_upload_regions.size()),
+                             m_upload_regions.data());
+
+        RHIMemoryBarrier barrier {};
+        barrier.sType         = RHI_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = RHI_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = RHI_ACCESS_SHADER_READ_BIT;
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                                  RHI_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                  0,
+                                  1,
+                                  &barrier,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr);
+    }
+} // namespace Piccolo
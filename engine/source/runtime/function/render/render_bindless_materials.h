@@ -0,0 +1,101 @@
+#pragma once
+
+#include "runtime/function/render/render_common.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Piccolo
+{
+    class RHI;
+    class RHIBuffer;
+    class RHICommandBuffer;
+    class RHIDescriptorPool;
+    class RHIDescriptorSet;
+    class RHIDescriptorSetLayout;
+    class RHIDeviceMemory;
+    class RHIImageView;
+    struct RHIDescriptorImageInfo;
+    struct StorageBuffer;
+
+    /// The materials of the mesh passes in one descriptor set, bound once per pass instead of once per material.
+    /// A material is a record in a persistent device buffer addressed by the material index of the instances, the
+    /// record holds the factors of the material and the slots of its textures in one partially bound texture array.
+    /// Only the records changed since the previous frame are copied to the device through the upload ring of the
+    /// frame. A texture slot is shared by the materials sampling the same image view, new slots are written while
+    /// the frames in flight sample the others, and a released slot is reused once the frames which may still sample
+    /// it have completed.
+    /// The materials past the capacity of the buffer or of the texture array are left to the per material path,
+    /// with a uniform buffer and a descriptor set of their own, see isBindless.
+    class RenderBindlessMaterials
+    {
+    public:
+        void initialize(std::shared_ptr<RHI> rhi);
+        void clear();
+
+        /// false when the device can't index the textures, the materials get a descriptor set of their own then
+        bool isEnabled() const { return m_descriptor_set != nullptr; }
+
+        /// whether the material is drawn through the bindless descriptor set rather than one of its own
+        bool isBindless(const VulkanPBRMaterial& material) const
+        {
+            return isEnabled() && material.material_index != s_mesh_bindless_invalid_material;
+        }
+        /// changes when a material leaves the bindless descriptor set, the batches holding it are rebuilt then
+        uint32_t getFallbackMaterialCount() const { return m_fallback_material_count; }
+
+        RHIDescriptorSetLayout*  getDescriptorSetLayout() const { return m_descriptor_set_layout; }
+        RHIDescriptorSet* const* getDescriptorSet() const { return &m_descriptor_set; }
+
+        /// write the factors of the material, its material index is assigned on the first update, false when the
+        /// material buffer is full
+        bool updateMaterialFactors(VulkanPBRMaterial& material, const MeshPerMaterialUniformBufferObject& factors);
+        /// point the material to its five textures, in the order of the bindings of the material descriptor set,
+        /// false when the material has no record or when the texture array can't hold its textures
+        bool updateMaterialTextures(VulkanPBRMaterial& material, RHIDescriptorImageInfo* texture_image_infos);
+        /// move a material out of the bindless descriptor set, return its factors for its own uniform buffer
+        MeshPerMaterialUniformBufferObject releaseMaterial(VulkanPBRMaterial& material);
+
+        /// copy the changed records to the device buffer and recycle the texture slots of the completed frames,
+        /// to record outside of a render pass before any pass reads them
+        void recordUpload(RHICommandBuffer* command_buffer, StorageBuffer& storage_buffer, uint8_t frame_index);
+
+    private:
+        static constexpr uint32_t k_texture_count_per_material = 5;
+
+        struct TextureSlot
+        {
+            uint32_t m_slot {0};
+            uint32_t m_reference_count {0};
+        };
+
+        uint32_t acquireTextureSlot(const RHIDescriptorImageInfo& texture_image_info, bool& out_is_new);
+        void     releaseTextureSlot(RHIImageView* image_view);
+
+        std::shared_ptr<RHI> m_rhi;
+
+        RHIDescriptorSetLayout* m_descriptor_set_layout {nullptr};
+        RHIDescriptorPool*      m_descriptor_pool {nullptr};
+        RHIDescriptorSet*       m_descriptor_set {nullptr};
+        RHIBuffer*              m_material_buffer {nullptr};
+        RHIDeviceMemory*        m_material_buffer_memory {nullptr};
+
+        std::vector<MeshBindlessMaterialStorageBufferObject> m_materials;
+        // k_texture_count_per_material per material, the views holding the slots of its record
+        std::vector<RHIImageView*> m_material_texture_views;
+        // records not copied to the device buffer yet
+        std::vector<uint32_t>      m_dirty_materials;
+        std::vector<RHIBufferCopy> m_upload_regions;
+        uint32_t                   m_fallback_material_count {0};
+
+        std::unordered_map<RHIImageView*, TextureSlot> m_texture_slots;
+        uint32_t                                       m_texture_slot_count {0};
+        std::vector<uint32_t>                          m_free_texture_slots;
+        // released since the previous upload, the records still pointing to them are copied by the next one
+        std::vector<uint32_t> m_released_texture_slots;
+        // by frame index, the slots no longer sampled once the frame is complete
+        std::vector<std::vector<uint32_t>> m_retired_texture_slots;
+    };
+} // namespace Piccolo
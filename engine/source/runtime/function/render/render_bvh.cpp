@@ -0,0 +1,386 @@
+#include "runtime/function/render/render_bvh.h"
+
+#include <algorithm>
+
+namespace Piccolo
+{
+    namespace
+    {
+        // the fattened bounds grow by this ratio of the extent plus a minimum margin on each side
+        constexpr float k_fat_bounds_ratio      = 0.1f;
+        constexpr float k_fat_bounds_min_margin = 0.05f;
+
+        BoundingBox unionBounds(const BoundingBox& a, const BoundingBox& b)
+        {
+            BoundingBox result = a;
+            result.merge(b);
+            return result;
+        }
+
+        float surfaceArea(const BoundingBox& bounds)
+        {
+            const Vector3 extent = bounds.max_bound - bounds.min_bound;
+            return 2.f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+        }
+
+        bool containsBounds(const BoundingBox& outer, const BoundingBox& inner)
+        {
+            return outer.min_bound.x <= inner.min_bound.x && outer.min_bound.y <= inner.min_bound.y &&
+                   outer.min_bound.z <= inner.min_bound.z && inner.max_bound.x <= outer.max_bound.x &&
+                   inner.max_bound.y <= outer.max_bound.y && inner.max_bound.z <= outer.max_bound.z;
+        }
+
+        BoundingBox fattenBounds(const BoundingBox& bounds)
+        {
+            const Vector3 extent = bounds.max_bound - bounds.min_bound;
+            const Vector3 margin = extent * k_fat_bounds_ratio +
+                                   Vector3(k_fat_bounds_min_margin, k_fat_bounds_min_margin, k_fat_bounds_min_margin);
+            return BoundingBox(bounds.min_bound - margin, bounds.max_bound + margin);
+        }
+    } // namespace
+
+    void RenderEntityBVH::clear()
+    {
+        m_nodes.clear();
+        m_root      = k_null_node;
+        m_free_list = k_null_node;
+        m_leaf_nodes.clear();
+    }
+
+    void RenderEntityBVH::insert(uint32_t instance_id, uint32_t entity_index, const BoundingBox& bounds)
+    {
+        if (contains(instance_id))
+        {
+            setEntityIndex(instance_id, entity_index);
+            update(instance_id, bounds);
+            return;
+        }
+
+        const int32_t leaf           = allocateNode();
+        m_nodes[leaf].m_bounds       = bounds;
+        m_nodes[leaf].m_fat_bounds   = fattenBounds(bounds);
+        m_nodes[leaf].m_height       = 0;
+        m_nodes[leaf].m_instance_id  = instance_id;
+        m_nodes[leaf].m_entity_index = entity_index;
+
+        insertLeaf(leaf);
+        m_leaf_nodes[instance_id] = leaf;
+    }
+
+    void RenderEntityBVH::update(uint32_t instance_id, const BoundingBox& bounds)
+    {
+        auto iter = m_leaf_nodes.find(instance_id);
+        if (iter == m_leaf_nodes.end())
+            return;
+
+        const int32_t leaf = iter->second;
+        Node&         node = m_nodes[leaf];
+        node.m_bounds      = bounds;
+
+        if (containsBounds(node.m_fat_bounds, bounds))
+        {
+            // the tree structure is still good enough, only the ancestor bounds change
+            refitAncestors(node.m_parent, false);
+            return;
+        }
+
+        removeLeaf(leaf);
+        m_nodes[leaf].m_fat_bounds = fattenBounds(bounds);
+        insertLeaf(leaf);
+    }
+
+    void RenderEntityBVH::remove(uint32_t instance_id)
+    {
+        auto iter = m_leaf_nodes.find(instance_id);
+        if (iter == m_leaf_nodes.end())
+            return;
+
+        removeLeaf(iter->second);
+        freeNode(iter->second);
+        m_leaf_nodes.erase(iter);
+    }
+
+    bool RenderEntityBVH::contains(uint32_t instance_id) const
+    {
+        return m_leaf_nodes.find(instance_id) != m_leaf_nodes.end();
+    }
+
+    bool RenderEntityBVH::tryGetEntityIndex(uint32_t instance_id, uint32_t& out_entity_index) const
+    {
+        auto iter = m_leaf_nodes.find(instance_id);
+        if (iter == m_leaf_nodes.end())
+            return false;
+
+        out_entity_index = m_nodes[iter->second].m_entity_index;
+        return true;
+    }
+
+    void RenderEntityBVH::setEntityIndex(uint32_t instance_id, uint32_t entity_index)
+    {
+        auto iter = m_leaf_nodes.find(instance_id);
+        if (iter != m_leaf_nodes.end())
+        {
+            m_nodes[iter->second].m_entity_index = entity_index;
+        }
+    }
+
+    BoundingBox RenderEntityBVH::getRootBounds() const
+    {
+        return m_root != k_null_node ? m_nodes[m_root].m_bounds : BoundingBox();
+    }
+
+    void RenderEntityBVH::query(const NodeTest&           node_test,
+                                std::vector<uint32_t>&    out_accepted_entities,
+                                std::vector<uint32_t>&    out_candidate_entities,
+                                std::vector<BoundingBox>& out_candidate_bounds) const
+    {
+        if (m_root == k_null_node)
+            return;
+
+        // the subtrees of inside nodes are walked without testing them, they are pushed with the accepted flag
+        struct StackEntry
+        {
+            int32_t m_node_index;
+            bool    m_is_accepted;
+        };
+        std::vector<StackEntry> stack;
+        stack.reserve(64);
+        stack.push_back({m_root, false});
+        while (!stack.empty())
+        {
+            const StackEntry entry = stack.back();
+            const Node&      node  = m_nodes[entry.m_node_index];
+            stack.pop_back();
+
+            if (node.isLeaf())
+            {
+                // the exact leaf tests are left to the caller, which batches them
+                if (entry.m_is_accepted)
+                {
+                    out_accepted_entities.push_back(node.m_entity_index);
+                }
+                else
+                {
+                    out_candidate_entities.push_back(node.m_entity_index);
+                    out_candidate_bounds.push_back(node.m_bounds);
+                }
+                continue;
+            }
+
+            bool is_accepted = entry.m_is_accepted;
+            if (!is_accepted)
+            {
+                const BVHNodeTestResult result = node_test(node.m_bounds);
+                if (result == BVHNodeTestResult::outside)
+                    continue;
+                is_accepted = result == BVHNodeTestResult::inside;
+            }
+
+            stack.push_back({node.m_children[0], is_accepted});
+            stack.push_back({node.m_children[1], is_accepted});
+        }
+    }
+
+    int32_t RenderEntityBVH::allocateNode()
+    {
+        if (m_free_list == k_null_node)
+        {
+            m_nodes.emplace_back();
+            return static_cast<int32_t>(m_nodes.size() - 1);
+        }
+
+        const int32_t node_index = m_free_list;
+        m_free_list              = m_nodes[node_index].m_parent;
+        m_nodes[node_index]      = Node();
+        return node_index;
+    }
+
+    void RenderEntityBVH::freeNode(int32_t node_index)
+    {
+        m_nodes[node_index].m_parent = m_free_list;
+        m_nodes[node_index].m_height = -1;
+        m_free_list                  = node_index;
+    }
+
+    void RenderEntityBVH::insertLeaf(int32_t leaf)
+    {
+        if (m_root == k_null_node)
+        {
+            m_root                 = leaf;
+            m_nodes[leaf].m_parent = k_null_node;
+            return;
+        }
+
+        // descend to the sibling with the lowest surface area cost
+        const BoundingBox leaf_bounds = m_nodes[leaf].m_bounds;
+        int32_t           sibling     = m_root;
+        while (!m_nodes[sibling].isLeaf())
+        {
+            const Node& node = m_nodes[sibling];
+
+            const float area          = surfaceArea(node.m_bounds);
+            const float combined_area = surfaceArea(unionBounds(node.m_bounds, leaf_bounds));
+
+            // cost of a new parent for this node and the leaf, and the minimum cost of pushing the leaf down
+            const float cost             = 2.f * combined_area;
+            const float inheritance_cost = 2.f * (combined_area - area);
+
+            float child_costs[2];
+            for (int child = 0; child < 2; ++child)
+            {
+                const Node& child_node = m_nodes[node.m_children[child]];
+                child_costs[child] = surfaceArea(unionBounds(leaf_bounds, child_node.m_bounds)) + inheritance_cost;
+                if (!child_node.isLeaf())
+                {
+                    child_costs[child] -= surfaceArea(child_node.m_bounds);
+                }
+            }
+
+            if (cost < child_costs[0] && cost < child_costs[1])
+                break;
+
+            sibling = child_costs[0] < child_costs[1] ? node.m_children[0] : node.m_children[1];
+        }
+
+        // the allocation may move the nodes, only indices are kept across it
+        const int32_t old_parent = m_nodes[sibling].m_parent;
+        const int32_t new_parent = allocateNode();
+
+        m_nodes[new_parent].m_parent      = old_parent;
+        m_nodes[new_parent].m_bounds      = unionBounds(leaf_bounds, m_nodes[sibling].m_bounds);
+        m_nodes[new_parent].m_height      = m_nodes[sibling].m_height + 1;
+        m_nodes[new_parent].m_children[0] = sibling;
+        m_nodes[new_parent].m_children[1] = leaf;
+        m_nodes[sibling].m_parent         = new_parent;
+        m_nodes[leaf].m_parent            = new_parent;
+
+        if (old_parent != k_null_node)
+        {
+            Node& old_parent_node = m_nodes[old_parent];
+            old_parent_node.m_children[old_parent_node.m_children[0] == sibling ? 0 : 1] = new_parent;
+        }
+        else
+        {
+            m_root = new_parent;
+        }
+
+        refitAncestors(new_parent, true);
+    }
+
+    void RenderEntityBVH::removeLeaf(int32_t leaf)
+    {
+        if (leaf == m_root)
+        {
+            m_root = k_null_node;
+            return;
+        }
+
+        const int32_t parent       = m_nodes[leaf].m_parent;
+        const int32_t grand_parent = m_nodes[parent].m_parent;
+        const int32_t sibling =
+            m_nodes[parent].m_children[0] == leaf ? m_nodes[parent].m_children[1] : m_nodes[parent].m_children[0];
+
+        // the sibling takes the place of the parent
+        if (grand_parent != k_null_node)
+        {
+            Node& grand_parent_node = m_nodes[grand_parent];
+            grand_parent_node.m_children[grand_parent_node.m_children[0] == parent ? 0 : 1] = sibling;
+            m_nodes[sibling].m_parent                                                        = grand_parent;
+            freeNode(parent);
+
+            refitAncestors(grand_parent, true);
+        }
+        else
+        {
+            m_root                    = sibling;
+            m_nodes[sibling].m_parent = k_null_node;
+            freeNode(parent);
+        }
+
+        m_nodes[leaf].m_parent = k_null_node;
+    }
+
+    void RenderEntityBVH::refitAncestors(int32_t node_index, bool should_balance)
+    {
+        while (node_index != k_null_node)
+        {
+            if (should_balance)
+            {
+                node_index = balance(node_index);
+            }
+
+            Node&       node   = m_nodes[node_index];
+            const Node& child0 = m_nodes[node.m_children[0]];
+            const Node& child1 = m_nodes[node.m_children[1]];
+
+            node.m_bounds = unionBounds(child0.m_bounds, child1.m_bounds);
+            node.m_height = 1 + std::max(child0.m_height, child1.m_height);
+
+            node_index = node.m_parent;
+        }
+    }
+
+    int32_t RenderEntityBVH::balance(int32_t a_index)
+    {
+        // rotate the higher child up if the heights of the children differ by more than one, see
+        // "Box2D b2DynamicTree::Balance"
+        Node& a = m_nodes[a_index];
+        if (a.isLeaf() || a.m_height < 2)
+            return a_index;
+
+        const int32_t b_index = a.m_children[0];
+        const int32_t c_index = a.m_children[1];
+        Node&         b       = m_nodes[b_index];
+        Node&         c       = m_nodes[c_index];
+
+        const int32_t height_balance = c.m_height - b.m_height;
+        if (height_balance > -2 && height_balance < 2)
+            return a_index;
+
+        // the higher child is promoted, the lower one stays a child of a
+        const bool    is_c_promoted = height_balance > 1;
+        const int32_t up_index      = is_c_promoted ? c_index : b_index;
+        const int32_t low_index     = is_c_promoted ? b_index : c_index;
+        Node&         up            = m_nodes[up_index];
+        Node&         low           = m_nodes[low_index];
+
+        const int32_t f_index = up.m_children[0];
+        const int32_t g_index = up.m_children[1];
+        Node&         f       = m_nodes[f_index];
+        Node&         g       = m_nodes[g_index];
+
+        // swap a and the promoted child
+        up.m_children[0] = a_index;
+        up.m_parent      = a.m_parent;
+        a.m_parent       = up_index;
+
+        if (up.m_parent != k_null_node)
+        {
+            Node& parent = m_nodes[up.m_parent];
+            parent.m_children[parent.m_children[0] == a_index ? 0 : 1] = up_index;
+        }
+        else
+        {
+            m_root = up_index;
+        }
+
+        // the higher grandchild stays under the promoted node, the other one moves under a
+        const bool    is_f_kept   = f.m_height > g.m_height;
+        const int32_t kept_index  = is_f_kept ? f_index : g_index;
+        const int32_t moved_index = is_f_kept ? g_index : f_index;
+        Node&         kept        = m_nodes[kept_index];
+        Node&         moved       = m_nodes[moved_index];
+        const int     a_slot      = is_c_promoted ? 1 : 0;
+
+        up.m_children[1]     = kept_index;
+        a.m_children[a_slot] = moved_index;
+        moved.m_parent       = a_index;
+
+        a.m_bounds  = unionBounds(low.m_bounds, moved.m_bounds);
+        a.m_height  = 1 + std::max(low.m_height, moved.m_height);
+        up.m_bounds = unionBounds(a.m_bounds, kept.m_bounds);
+        up.m_height = 1 + std::max(a.m_height, kept.m_height);
+
+        return up_index;
+    }
+} // namespace Piccolo
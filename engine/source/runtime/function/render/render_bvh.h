@@ -0,0 +1,84 @@
+#pragma once
+
+#include "runtime/function/render/render_helper.h"
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace Piccolo
+{
+    enum class BVHNodeTestResult : uint8_t
+    {
+        outside,
+        intersecting,
+        inside
+    };
+
+    /// Dynamic bounding volume hierarchy over the render entities, keyed by instance id.
+    /// Leaves keep the exact world bounds of their entity and the internal nodes the union of their children.
+    /// A leaf moving within its fattened bounds only refits its ancestors, otherwise it's reinserted, tree
+    /// rotations keep the hierarchy balanced.
+    class RenderEntityBVH
+    {
+    public:
+        using NodeTest = std::function<BVHNodeTestResult(const BoundingBox&)>;
+
+        void clear();
+
+        void insert(uint32_t instance_id, uint32_t entity_index, const BoundingBox& bounds);
+        void update(uint32_t instance_id, const BoundingBox& bounds);
+        void remove(uint32_t instance_id);
+
+        bool contains(uint32_t instance_id) const;
+        bool tryGetEntityIndex(uint32_t instance_id, uint32_t& out_entity_index) const;
+        void setEntityIndex(uint32_t instance_id, uint32_t entity_index);
+
+        size_t getLeafCount() const { return m_leaf_nodes.size(); }
+        /// union of all leaf bounds, an empty box if there is no leaf
+        BoundingBox getRootBounds() const;
+
+        /// walk the tree with a conservative node test: the entities of inside subtrees are accepted without
+        /// further tests, the leaves reached through intersecting nodes are returned as candidates along with
+        /// their bounds, they still need an exact test
+        void query(const NodeTest&           node_test,
+                   std::vector<uint32_t>&    out_accepted_entities,
+                   std::vector<uint32_t>&    out_candidate_entities,
+                   std::vector<BoundingBox>& out_candidate_bounds) const;
+
+    private:
+        static constexpr int32_t k_null_node = -1;
+
+        struct Node
+        {
+            BoundingBox m_bounds;
+            // leaves only, a move within it doesn't restructure the tree
+            BoundingBox m_fat_bounds;
+
+            int32_t m_parent {k_null_node}; // next free node when the node is free
+            int32_t m_children[2] {k_null_node, k_null_node};
+            // leaves have height 0, free nodes -1
+            int32_t m_height {-1};
+
+            uint32_t m_instance_id {0};
+            uint32_t m_entity_index {0};
+
+            bool isLeaf() const { return m_children[0] == k_null_node; }
+        };
+
+        int32_t allocateNode();
+        void    freeNode(int32_t node_index);
+
+        void    insertLeaf(int32_t leaf);
+        void    removeLeaf(int32_t leaf);
+        void    refitAncestors(int32_t node_index, bool should_balance);
+        int32_t balance(int32_t node_index);
+
+        std::vector<Node> m_nodes;
+        int32_t           m_root {k_null_node};
+        int32_t           m_free_list {k_null_node};
+
+        std::unordered_map<uint32_t, int32_t> m_leaf_nodes;
+    };
+} // namespace Piccolo
@@ -53,20 +53,20 @@ namespace Piccolo
         Matrix4x4                   directional_light_proj_view;
     };
 
-    struct VulkanMeshInstance
+    // an instance drawn by a drawcall, the instance data is read from the persistent instance buffer
+    struct VulkanMeshInstanceReference
     {
-        float     enable_vertex_blending;
-        float     _padding_enable_vertex_blending_1;
-        float     _padding_enable_vertex_blending_2;
-        float     _padding_enable_vertex_blending_3;
-        Matrix4x4 model_matrix;
+        uint32_t instance_index;
+        // in the joint matrices of the frame, s_mesh_instance_no_joint_matrices if the instance is not skinned
+        uint32_t joint_matrix_offset;
     };
 
     struct MeshPerdrawcallStorageBufferObject
     {
-        VulkanMeshInstance mesh_instances[s_mesh_per_drawcall_max_instance_count];
+        VulkanMeshInstanceReference mesh_instances[s_mesh_per_drawcall_max_instance_count];
     };
 
+    // the joint matrices of all the skinned instances of the frame
     struct MeshPerdrawcallVertexBlendingStorageBufferObject
     {
         Matrix4x4 joint_matrices[s_mesh_vertex_blending_max_joint_count * s_mesh_per_drawcall_max_instance_count];
@@ -97,7 +97,7 @@ namespace Piccolo
 
     struct MeshPointLightShadowPerdrawcallStorageBufferObject
     {
-        VulkanMeshInstance mesh_instances[s_mesh_per_drawcall_max_instance_count];
+        VulkanMeshInstanceReference mesh_instances[s_mesh_per_drawcall_max_instance_count];
     };
 
     struct MeshPointLightShadowPerdrawcallVertexBlendingStorageBufferObject
@@ -112,7 +112,7 @@ namespace Piccolo
 
     struct MeshDirectionalLightShadowPerdrawcallStorageBufferObject
     {
-        VulkanMeshInstance mesh_instances[s_mesh_per_drawcall_max_instance_count];
+        VulkanMeshInstanceReference mesh_instances[s_mesh_per_drawcall_max_instance_count];
     };
 
     struct MeshDirectionalLightShadowPerdrawcallVertexBlendingStorageBufferObject
@@ -120,6 +120,86 @@ namespace Piccolo
         Matrix4x4 joint_matrices[s_mesh_vertex_blending_max_joint_count * s_mesh_per_drawcall_max_instance_count];
     };
 
+    // capacity of the gpu driven mesh rendering, the persistent instance buffer starts with it and grows past it
+    static uint32_t const s_mesh_instance_max_count = 65536;
+    // batch index of the instances not drawn by the gpu driven path
+    static uint32_t const s_mesh_instance_invalid_batch = 0xFFFFFFFF;
+    // joint matrix offset of the instances not skinned
+    static uint32_t const s_mesh_instance_no_joint_matrices = 0xFFFFFFFF;
+
+    // compute pre-skinning, the skinned vertices of the frame share one buffer read by all the mesh passes
+    static uint32_t const s_mesh_skinning_max_vertex_count = 1 << 20;
+    // first skinned vertex of the instances skinned in the vertex shader
+    static uint32_t const s_mesh_skinning_no_first_vertex = 0xFFFFFFFF;
+
+    // bindless materials, the material records live in a persistent device buffer and the textures in one
+    // descriptor array indexed by the records
+    static uint32_t const s_mesh_bindless_material_max_count = 16384;
+    // material index of the materials without a bindless record yet
+    static uint32_t const s_mesh_bindless_invalid_material = 0xFFFFFFFF;
+
+    // MeshPerMaterialUniformBufferObject followed by the slots of the five textures in the bindless texture array
+    struct MeshBindlessMaterialStorageBufferObject
+    {
+        Vector4 baseColorFactor {0.0f, 0.0f, 0.0f, 0.0f};
+
+        float metallicFactor    = 0.0f;
+        float roughnessFactor   = 0.0f;
+        float normalScale       = 0.0f;
+        float occlusionStrength = 0.0f;
+
+        Vector3  emissiveFactor  = {0.0f, 0.0f, 0.0f};
+        uint32_t is_blend        = 0;
+        uint32_t is_double_sided = 0;
+
+        uint32_t base_color_texture_index         = 0;
+        uint32_t metallic_roughness_texture_index = 0;
+        uint32_t normal_texture_index             = 0;
+        uint32_t occlusion_texture_index          = 0;
+        uint32_t emissive_texture_index           = 0;
+        uint32_t _padding_texture_index_1         = 0;
+        uint32_t _padding_texture_index_2         = 0;
+    };
+
+    struct MeshSkinningPerdispatchStorageBufferObject
+    {
+        uint32_t vertex_count;
+        uint32_t joint_matrix_offset;
+        uint32_t first_vertex;
+        uint32_t _padding_first_vertex;
+    };
+
+    struct VulkanMeshInstanceData
+    {
+        Matrix4x4 model_matrix;
+        // local space bounds
+        Vector3  bounding_box_center;
+        uint32_t batch_index;
+        Vector3  bounding_box_half_extent;
+        // in the bindless material buffer, unused when the materials are bound one descriptor set at a time
+        uint32_t material_index;
+    };
+
+    struct MeshInstanceCullingPerframeStorageBufferObject
+    {
+        // normals pointing outward, in the order of ClusterFrustum
+        Vector4  frustum_planes[6];
+        uint32_t instance_count;
+        uint32_t _padding_instance_count_1;
+        uint32_t _padding_instance_count_2;
+        uint32_t _padding_instance_count_3;
+    };
+
+    // layout of VkDrawIndexedIndirectCommand
+    struct MeshDrawIndexedIndirectCommand
+    {
+        uint32_t index_count;
+        uint32_t instance_count;
+        uint32_t first_index;
+        int32_t  vertex_offset;
+        uint32_t first_instance;
+    };
+
     struct AxisStorageBufferObject
     {
         Matrix4x4 model_matrix  = Matrix4x4::IDENTITY;
@@ -193,7 +273,8 @@ namespace Piccolo
         RHIBuffer*    mesh_vertex_varying_buffer;
         VmaAllocation mesh_vertex_varying_buffer_allocation;
 
-        uint32_t mesh_index_count;
+        uint32_t     mesh_index_count;
+        RHIIndexType mesh_index_type;
 
         RHIBuffer*    mesh_index_buffer;
         VmaAllocation mesh_index_buffer_allocation;
@@ -225,7 +306,9 @@ namespace Piccolo
         RHIBuffer*      material_uniform_buffer;
         VmaAllocation   material_uniform_buffer_allocation;
 
-        RHIDescriptorSet* material_descriptor_set;
+        // nullptr with bindless materials, the material is then addressed by its index in the bindless buffer
+        RHIDescriptorSet* material_descriptor_set {nullptr};
+        uint32_t          material_index {s_mesh_bindless_invalid_material};
     };
 
     // nodes
@@ -237,6 +320,8 @@ namespace Piccolo
         VulkanMesh*        ref_mesh {nullptr};
         VulkanPBRMaterial* ref_material {nullptr};
         uint32_t           node_id;
+        // index of the entity in the render scene, and of its instance in the persistent instance buffer
+        uint32_t           instance_index {0};
         bool               enable_vertex_blending {false};
     };
 
@@ -0,0 +1,423 @@
+#include "runtime/function/render/render_culling.h"
+
+#include "runtime/core/job/job_system.h"
+
+#include "runtime/function/global/global_context.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <functional>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define PICCOLO_CULLING_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PICCOLO_CULLING_SSE
+#endif
+
+namespace Piccolo
+{
+    namespace
+    {
+        // the bounds arrays are padded to this, so that no batch width needs a scalar tail
+        constexpr size_t k_bounds_padding = 8;
+        // boxes per job system batch
+        constexpr size_t k_culling_batch_size = 512;
+
+#if defined(PICCOLO_CULLING_AVX)
+        struct FloatBatch
+        {
+            static constexpr size_t k_width = 8;
+            __m256                  m_value;
+        };
+        struct MaskBatch
+        {
+            __m256 m_value;
+        };
+
+        inline FloatBatch load(const float* values) { return {_mm256_loadu_ps(values)}; }
+        inline FloatBatch broadcast(float value) { return {_mm256_set1_ps(value)}; }
+        inline FloatBatch operator+(FloatBatch a, FloatBatch b) { return {_mm256_add_ps(a.m_value, b.m_value)}; }
+        inline FloatBatch operator-(FloatBatch a, FloatBatch b) { return {_mm256_sub_ps(a.m_value, b.m_value)}; }
+        inline FloatBatch operator*(FloatBatch a, FloatBatch b) { return {_mm256_mul_ps(a.m_value, b.m_value)}; }
+        inline MaskBatch  lessThan(FloatBatch a, FloatBatch b)
+        {
+            return {_mm256_cmp_ps(a.m_value, b.m_value, _CMP_LT_OQ)};
+        }
+        inline MaskBatch greaterThan(FloatBatch a, FloatBatch b)
+        {
+            return {_mm256_cmp_ps(a.m_value, b.m_value, _CMP_GT_OQ)};
+        }
+        inline MaskBatch allMask() { return {_mm256_castsi256_ps(_mm256_set1_epi32(-1))}; }
+        inline MaskBatch operator&(MaskBatch a, MaskBatch b) { return {_mm256_and_ps(a.m_value, b.m_value)}; }
+        inline MaskBatch operator|(MaskBatch a, MaskBatch b) { return {_mm256_or_ps(a.m_value, b.m_value)}; }
+        // a & ~b
+        inline MaskBatch andNot(MaskBatch a, MaskBatch b) { return {_mm256_andnot_ps(b.m_value, a.m_value)}; }
+        inline uint32_t  toBits(MaskBatch a) { return static_cast<uint32_t>(_mm256_movemask_ps(a.m_value)); }
+#elif defined(PICCOLO_CULLING_SSE)
+        struct FloatBatch
+        {
+            static constexpr size_t k_width = 4;
+            __m128                  m_value;
+        };
+        struct MaskBatch
+        {
+            __m128 m_value;
+        };
+
+        inline FloatBatch load(const float* values) { return {_mm_loadu_ps(values)}; }
+        inline FloatBatch broadcast(float value) { return {_mm_set1_ps(value)}; }
+        inline FloatBatch operator+(FloatBatch a, FloatBatch b) { return {_mm_add_ps(a.m_value, b.m_value)}; }
+        inline FloatBatch operator-(FloatBatch a, FloatBatch b) { return {_mm_sub_ps(a.m_value, b.m_value)}; }
+        inline FloatBatch operator*(FloatBatch a, FloatBatch b) { return {_mm_mul_ps(a.m_value, b.m_value)}; }
+        inline MaskBatch  lessThan(FloatBatch a, FloatBatch b) { return {_mm_cmplt_ps(a.m_value, b.m_value)}; }
+        inline MaskBatch  greaterThan(FloatBatch a, FloatBatch b) { return {_mm_cmpgt_ps(a.m_value, b.m_value)}; }
+        inline MaskBatch  allMask() { return {_mm_castsi128_ps(_mm_set1_epi32(-1))}; }
+        inline MaskBatch  operator&(MaskBatch a, MaskBatch b) { return {_mm_and_ps(a.m_value, b.m_value)}; }
+        inline MaskBatch  operator|(MaskBatch a, MaskBatch b) { return {_mm_or_ps(a.m_value, b.m_value)}; }
+        // a & ~b
+        inline MaskBatch andNot(MaskBatch a, MaskBatch b) { return {_mm_andnot_ps(b.m_value, a.m_value)}; }
+        inline uint32_t  toBits(MaskBatch a) { return static_cast<uint32_t>(_mm_movemask_ps(a.m_value)); }
+#else
+        struct FloatBatch
+        {
+            static constexpr size_t k_width = 1;
+            float                   m_value;
+        };
+        struct MaskBatch
+        {
+            bool m_value;
+        };
+
+        inline FloatBatch load(const float* values) { return {*values}; }
+        inline FloatBatch broadcast(float value) { return {value}; }
+        inline FloatBatch operator+(FloatBatch a, FloatBatch b) { return {a.m_value + b.m_value}; }
+        inline FloatBatch operator-(FloatBatch a, FloatBatch b) { return {a.m_value - b.m_value}; }
+        inline FloatBatch operator*(FloatBatch a, FloatBatch b) { return {a.m_value * b.m_value}; }
+        inline MaskBatch  lessThan(FloatBatch a, FloatBatch b) { return {a.m_value < b.m_value}; }
+        inline MaskBatch  greaterThan(FloatBatch a, FloatBatch b) { return {a.m_value > b.m_value}; }
+        inline MaskBatch  allMask() { return {true}; }
+        inline MaskBatch  operator&(MaskBatch a, MaskBatch b) { return {a.m_value && b.m_value}; }
+        inline MaskBatch  operator|(MaskBatch a, MaskBatch b) { return {a.m_value || b.m_value}; }
+        // a & ~b
+        inline MaskBatch andNot(MaskBatch a, MaskBatch b) { return {a.m_value && !b.m_value}; }
+        inline uint32_t  toBits(MaskBatch a) { return a.m_value ? 1u : 0u; }
+#endif
+
+
+        // candidate bounds as structure of arrays, padded with empty boxes at the origin whose lanes are never
+        // written out
+        struct CandidateBounds
+        {
+            size_t             m_count {0};
+            std::vector<float> m_min[3];
+            std::vector<float> m_max[3];
+
+            explicit CandidateBounds(const std::vector<BoundingBox>& bounds) : m_count(bounds.size())
+            {
+                const size_t padded_count = (m_count + k_bounds_padding - 1) / k_bounds_padding * k_bounds_padding;
+                for (size_t axis = 0; axis < 3; ++axis)
+                {
+                    m_min[axis].assign(padded_count, 0.f);
+                    m_max[axis].assign(padded_count, 0.f);
+                }
+
+                for (size_t index = 0; index < m_count; ++index)
+                {
+                    for (size_t axis = 0; axis < 3; ++axis)
+                    {
+                        m_min[axis][index] = bounds[index].min_bound[axis];
+                        m_max[axis][index] = bounds[index].max_bound[axis];
+                    }
+                }
+            }
+        };
+
+        // write the lanes of a batch that map to real bounds
+        void storeVisibility(MaskBatch visible, size_t first, size_t bounds_count, uint8_t* out_visibility)
+        {
+            const uint32_t bits       = toBits(visible);
+            const size_t   lane_count = std::min(FloatBatch::k_width, bounds_count - first);
+
+            for (size_t lane = 0; lane < lane_count; ++lane)
+            {
+                out_visibility[first + lane] = (bits >> lane) & 1;
+            }
+        }
+
+        // run function(begin, end) over batches of bounds, on the job system when there are enough of them
+        void forEachBoundsBatch(const char* name, size_t count, const std::function<void(size_t, size_t)>& function)
+        {
+            std::shared_ptr<JobSystem> job_system = g_runtime_global_context.m_job_system;
+            if (!job_system)
+            {
+                function(0, count);
+                return;
+            }
+
+            job_system->parallelFor(name, count, k_culling_batch_size, function);
+        }
+
+        // the accepted entities plus the visible candidates, sorted so that the draw order follows the scene
+        void gatherVisibleEntities(const std::vector<uint32_t>& accepted_entities,
+                                   const std::vector<uint32_t>& candidate_entities,
+                                   const std::vector<uint8_t>&  candidate_visibility,
+                                   std::vector<uint32_t>&       out_visible_entities)
+        {
+            out_visible_entities = accepted_entities;
+            for (size_t index = 0; index < candidate_entities.size(); ++index)
+            {
+                if (candidate_visibility[index])
+                {
+                    out_visible_entities.push_back(candidate_entities[index]);
+                }
+            }
+            std::sort(out_visible_entities.begin(), out_visible_entities.end());
+        }
+
+        bool segmentIntersectsBox(const Vector3& begin, const Vector3& delta, const BoundingBox& bounds)
+        {
+            float t_min = 0.f;
+            float t_max = 1.f;
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                if (std::fabs(delta[axis]) < FLT_EPSILON)
+                {
+                    if (begin[axis] < bounds.min_bound[axis] || begin[axis] > bounds.max_bound[axis])
+                        return false;
+                    continue;
+                }
+
+                const float inverse_delta = 1.f / delta[axis];
+                float       t_enter       = (bounds.min_bound[axis] - begin[axis]) * inverse_delta;
+                float       t_exit        = (bounds.max_bound[axis] - begin[axis]) * inverse_delta;
+                if (t_enter > t_exit)
+                {
+                    std::swap(t_enter, t_exit);
+                }
+
+                t_min = std::max(t_min, t_enter);
+                t_max = std::min(t_max, t_exit);
+                if (t_min > t_max)
+                    return false;
+            }
+            return true;
+        }
+    } // namespace
+
+    void RenderCulling::clear() { m_bvh.clear(); }
+
+    void RenderCulling::addOrUpdateEntity(const RenderEntity& entity, uint32_t entity_index)
+    {
+        const BoundingBox world_bounds = computeWorldBounds(entity);
+        if (m_bvh.contains(entity.m_instance_id))
+        {
+            m_bvh.setEntityIndex(entity.m_instance_id, entity_index);
+            m_bvh.update(entity.m_instance_id, world_bounds);
+        }
+        else
+        {
+            m_bvh.insert(entity.m_instance_id, entity_index, world_bounds);
+        }
+    }
+
+    void RenderCulling::removeEntity(uint32_t instance_id) { m_bvh.remove(instance_id); }
+
+    bool RenderCulling::tryGetEntityIndex(uint32_t instance_id, uint32_t& out_entity_index) const
+    {
+        return m_bvh.tryGetEntityIndex(instance_id, out_entity_index);
+    }
+
+    void RenderCulling::setEntityIndex(uint32_t instance_id, uint32_t entity_index)
+    {
+        m_bvh.setEntityIndex(instance_id, entity_index);
+    }
+
+    BoundingBox RenderCulling::computeWorldBounds(const RenderEntity& entity)
+    {
+        // model matrices are affine
+        AxisAlignedBox world_box;
+        entity.m_model_matrix.transformAxisAlignedBoxes(&entity.m_bounding_box, &world_box, 1);
+
+        return BoundingBox(world_box.getMinCorner(), world_box.getMaxCorner());
+    }
+
+    RenderCullingStats RenderCulling::cullFrustum(const ClusterFrustum&  frustum,
+                                                  std::vector<uint32_t>& out_visible_entities) const
+    {
+        const Vector4 planes[6] = {frustum.m_plane_right,
+                                   frustum.m_plane_left,
+                                   frustum.m_plane_top,
+                                   frustum.m_plane_bottom,
+                                   frustum.m_plane_near,
+                                   frustum.m_plane_far};
+
+        // a node is outside if it's entirely in front of one plane, inside if it's entirely behind all of them
+        std::vector<uint32_t>    accepted_entities;
+        std::vector<uint32_t>    candidate_entities;
+        std::vector<BoundingBox> candidate_bounds;
+        m_bvh.query(
+            [&planes](const BoundingBox& bounds) {
+                const Vector3 center = (bounds.max_bound + bounds.min_bound) * 0.5f;
+                const Vector3 extent = (bounds.max_bound - bounds.min_bound) * 0.5f;
+
+                bool is_inside = true;
+                for (const Vector4& plane : planes)
+                {
+                    const float signed_distance =
+                        plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+                    const float projected_radius = std::fabs(plane.x) * extent.x + std::fabs(plane.y) * extent.y +
+                                                   std::fabs(plane.z) * extent.z;
+                    if (signed_distance >= projected_radius)
+                        return BVHNodeTestResult::outside;
+
+                    is_inside = is_inside && signed_distance + projected_radius < 0.f;
+                }
+                return is_inside ? BVHNodeTestResult::inside : BVHNodeTestResult::intersecting;
+            },
+            accepted_entities,
+            candidate_entities,
+            candidate_bounds);
+
+        const CandidateBounds candidates(candidate_bounds);
+        std::vector<uint8_t>  candidate_visibility(candidates.m_count);
+        forEachBoundsBatch("RenderCullingFrustum", candidates.m_count, [&](size_t begin, size_t end) {
+            const FloatBatch half = broadcast(0.5f);
+
+            // batch boundaries are multiples of the padding, the last batch may read into it
+            for (size_t first = begin; first < end; first += FloatBatch::k_width)
+            {
+                const FloatBatch min_x = load(&candidates.m_min[0][first]);
+                const FloatBatch min_y = load(&candidates.m_min[1][first]);
+                const FloatBatch min_z = load(&candidates.m_min[2][first]);
+                const FloatBatch max_x = load(&candidates.m_max[0][first]);
+                const FloatBatch max_y = load(&candidates.m_max[1][first]);
+                const FloatBatch max_z = load(&candidates.m_max[2][first]);
+
+                const FloatBatch center_x = (max_x + min_x) * half;
+                const FloatBatch center_y = (max_y + min_y) * half;
+                const FloatBatch center_z = (max_z + min_z) * half;
+                const FloatBatch extent_x = (max_x - min_x) * half;
+                const FloatBatch extent_y = (max_y - min_y) * half;
+                const FloatBatch extent_z = (max_z - min_z) * half;
+
+                // same test as TiledFrustumIntersectBox: inside or intersecting every plane
+                MaskBatch visible = allMask();
+                for (const Vector4& plane : planes)
+                {
+                    const FloatBatch signed_distance = broadcast(plane.x) * center_x + broadcast(plane.y) * center_y +
+                                                       broadcast(plane.z) * center_z + broadcast(plane.w);
+                    const FloatBatch projected_radius = broadcast(std::fabs(plane.x)) * extent_x +
+                                                        broadcast(std::fabs(plane.y)) * extent_y +
+                                                        broadcast(std::fabs(plane.z)) * extent_z;
+                    visible = visible & lessThan(signed_distance, projected_radius);
+                }
+
+                storeVisibility(visible, first, candidates.m_count, candidate_visibility.data());
+            }
+        });
+
+        gatherVisibleEntities(accepted_entities, candidate_entities, candidate_visibility, out_visible_entities);
+
+        return {static_cast<uint32_t>(m_bvh.getLeafCount()),
+                static_cast<uint32_t>(out_visible_entities.size()),
+                static_cast<uint32_t>(candidates.m_count)};
+    }
+
+    RenderCullingStats RenderCulling::cullSpheres(const std::vector<BoundingSphere>& spheres,
+                                                  std::vector<uint32_t>&             out_visible_entities) const
+    {
+        // a node is outside if it's separated from one sphere, inside if it fits in the bounds of every sphere
+        std::vector<uint32_t>    accepted_entities;
+        std::vector<uint32_t>    candidate_entities;
+        std::vector<BoundingBox> candidate_bounds;
+        m_bvh.query(
+            [&spheres](const BoundingBox& bounds) {
+                bool is_inside = true;
+                for (const BoundingSphere& sphere : spheres)
+                {
+                    for (size_t axis = 0; axis < 3; ++axis)
+                    {
+                        const float to_min = bounds.min_bound[axis] - sphere.m_center[axis];
+                        const float to_max = sphere.m_center[axis] - bounds.max_bound[axis];
+                        if (to_min > sphere.m_radius || to_max > sphere.m_radius)
+                            return BVHNodeTestResult::outside;
+
+                        is_inside = is_inside && -to_min <= sphere.m_radius && -to_max <= sphere.m_radius;
+                    }
+                }
+                return is_inside ? BVHNodeTestResult::inside : BVHNodeTestResult::intersecting;
+            },
+            accepted_entities,
+            candidate_entities,
+            candidate_bounds);
+
+        const CandidateBounds candidates(candidate_bounds);
+        std::vector<uint8_t>  candidate_visibility(candidates.m_count);
+        forEachBoundsBatch("RenderCullingSpheres", candidates.m_count, [&](size_t begin, size_t end) {
+            for (size_t first = begin; first < end; first += FloatBatch::k_width)
+            {
+                const FloatBatch min_bounds[3] = {load(&candidates.m_min[0][first]),
+                                                  load(&candidates.m_min[1][first]),
+                                                  load(&candidates.m_min[2][first])};
+                const FloatBatch max_bounds[3] = {load(&candidates.m_max[0][first]),
+                                                  load(&candidates.m_max[1][first]),
+                                                  load(&candidates.m_max[2][first])};
+
+                // same test as BoxIntersectsWithSphere, a box is separated from a sphere if the center is farther
+                // than the radius outside of the box on any axis
+                MaskBatch visible = allMask();
+                for (const BoundingSphere& sphere : spheres)
+                {
+                    const FloatBatch radius = broadcast(sphere.m_radius);
+                    for (size_t axis = 0; axis < 3; ++axis)
+                    {
+                        const FloatBatch center    = broadcast(sphere.m_center[axis]);
+                        const MaskBatch  separated = greaterThan(min_bounds[axis] - center, radius) |
+                                                    greaterThan(center - max_bounds[axis], radius);
+                        visible = andNot(visible, separated);
+                    }
+                }
+
+                storeVisibility(visible, first, candidates.m_count, candidate_visibility.data());
+            }
+        });
+
+        gatherVisibleEntities(accepted_entities, candidate_entities, candidate_visibility, out_visible_entities);
+
+        return {static_cast<uint32_t>(m_bvh.getLeafCount()),
+                static_cast<uint32_t>(out_visible_entities.size()),
+                static_cast<uint32_t>(candidates.m_count)};
+    }
+
+    void RenderCulling::querySegment(const Vector3&         begin,
+                                     const Vector3&         end,
+                                     std::vector<uint32_t>& out_entities) const
+    {
+        const Vector3 delta = end - begin;
+
+        std::vector<uint32_t>    accepted_entities;
+        std::vector<uint32_t>    candidate_entities;
+        std::vector<BoundingBox> candidate_bounds;
+        m_bvh.query(
+            [&begin, &delta](const BoundingBox& bounds) {
+                return segmentIntersectsBox(begin, delta, bounds) ? BVHNodeTestResult::intersecting :
+                                                                    BVHNodeTestResult::outside;
+            },
+            accepted_entities,
+            candidate_entities,
+            candidate_bounds);
+
+        out_entities.clear();
+        for (size_t index = 0; index < candidate_entities.size(); ++index)
+        {
+            if (segmentIntersectsBox(begin, delta, candidate_bounds[index]))
+            {
+                out_entities.push_back(candidate_entities[index]);
+            }
+        }
+        std::sort(out_entities.begin(), out_entities.end());
+    }
+} // namespace Piccolo
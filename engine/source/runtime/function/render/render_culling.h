@@ -0,0 +1,57 @@
+#pragma once
+
+#include "runtime/function/render/render_bvh.h"
+#include "runtime/function/render/render_entity.h"
+#include "runtime/function/render/render_helper.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Piccolo
+{
+    struct RenderCullingStats
+    {
+        uint32_t m_tested_count {0};
+        uint32_t m_visible_count {0};
+        // leaves reached through partially visible nodes, the only ones tested one by one
+        uint32_t m_candidate_count {0};
+
+        uint32_t getCulledCount() const { return m_tested_count - m_visible_count; }
+    };
+
+    /// World space bounds of the render entities kept in a bounding volume hierarchy, so that the queries only
+    /// visit the subtrees intersecting the query volume. The leaves of partially visible subtrees are tested
+    /// as structure of arrays, several boxes per instruction (8 with AVX, 4 with SSE, 1 otherwise), split into
+    /// batches over the engine job system when there are many of them.
+    class RenderCulling
+    {
+    public:
+        void clear();
+
+        /// insert the entity or move it to its current world bounds, entity_index is its position in the
+        /// render scene entity array
+        void addOrUpdateEntity(const RenderEntity& entity, uint32_t entity_index);
+        void removeEntity(uint32_t instance_id);
+
+        bool tryGetEntityIndex(uint32_t instance_id, uint32_t& out_entity_index) const;
+        void setEntityIndex(uint32_t instance_id, uint32_t entity_index);
+
+        size_t getEntityCount() const { return m_bvh.getLeafCount(); }
+        /// union of all world bounds
+        BoundingBox getSceneBounds() const { return m_bvh.getRootBounds(); }
+
+        /// out_visible_entities gets the sorted indices of the entities intersecting the frustum
+        RenderCullingStats cullFrustum(const ClusterFrustum&  frustum,
+                                       std::vector<uint32_t>& out_visible_entities) const;
+        /// out_visible_entities gets the sorted indices of the entities intersecting every sphere
+        RenderCullingStats cullSpheres(const std::vector<BoundingSphere>& spheres,
+                                       std::vector<uint32_t>&             out_visible_entities) const;
+        /// out_entities gets the sorted indices of the entities whose bounds intersect the segment
+        void querySegment(const Vector3& begin, const Vector3& end, std::vector<uint32_t>& out_entities) const;
+
+        static BoundingBox computeWorldBounds(const RenderEntity& entity);
+
+    private:
+        RenderEntityBVH m_bvh;
+    };
+} // namespace Piccolo
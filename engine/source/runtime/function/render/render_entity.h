@@ -8,6 +8,8 @@
 
 namespace Piccolo
 {
+    constexpr uint32_t k_invalid_joint_palette = UINT32_MAX;
+
     class RenderEntity
     {
     public:
@@ -15,10 +17,10 @@ namespace Piccolo
         Matrix4x4 m_model_matrix {Matrix4x4::IDENTITY};
 
         // mesh
-        size_t                 m_mesh_asset_id {0};
-        bool                   m_enable_vertex_blending {false};
-        std::vector<Matrix4x4> m_joint_matrices;
-        AxisAlignedBox         m_bounding_box;
+        size_t         m_mesh_asset_id {0};
+        bool           m_enable_vertex_blending {false};
+        uint32_t       m_joint_palette {k_invalid_joint_palette}; // shared by the parts of the game object
+        AxisAlignedBox m_bounding_box;
 
         // material
         size_t  m_material_asset_id {0};
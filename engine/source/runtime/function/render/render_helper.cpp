@@ -210,13 +210,16 @@ namespace Piccolo
         Vector3 max;
 
         // Compute and transform the corners and find new min/max bounds.
+        Vector3 corners[CORNER_COUNT];
         for (size_t i = 0; i < CORNER_COUNT; ++i)
         {
-            Vector3 corner_before = extents * g_BoxOffset[i] + center;
-            Vector4 corner_with_w = m * Vector4(corner_before.x, corner_before.y, corner_before.z, 1.0);
-            Vector3 corner        = Vector3(corner_with_w.x / corner_with_w.w,
-                                         corner_with_w.y / corner_with_w.w,
-                                         corner_with_w.z / corner_with_w.w);
+            corners[i] = extents * g_BoxOffset[i] + center;
+        }
+        m.transformPoints(corners, corners, CORNER_COUNT);
+
+        for (size_t i = 0; i < CORNER_COUNT; ++i)
+        {
+            Vector3 const& corner = corners[i];
 
             if (0 == i)
             {
@@ -300,21 +303,8 @@ namespace Piccolo
             }
         }
 
-        BoundingBox scene_bounding_box;
-        {
-            scene_bounding_box.min_bound = Vector3(FLT_MAX, FLT_MAX, FLT_MAX);
-            scene_bounding_box.max_bound = Vector3(FLT_MIN, FLT_MIN, FLT_MIN);
-
-            for (const RenderEntity& entity : scene.m_render_entities)
-            {
-                BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
-                                                     entity.m_bounding_box.getMaxCorner()};
-
-                BoundingBox mesh_bounding_box_world =
-                    BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix);
-                scene_bounding_box.merge(mesh_bounding_box_world);
-            }
-        }
+        // the world bounds were already computed for the culling
+        BoundingBox scene_bounding_box = scene.getCulling().getSceneBounds();
 
         // CascadedShadowMaps11 / ComputeNearAndFar
         Matrix4x4 light_view;
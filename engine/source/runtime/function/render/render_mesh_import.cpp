@@ -0,0 +1,744 @@
+#include "runtime/function/render/render_mesh_import.h"
+
+#include "runtime/core/base/macro.h"
+#include "runtime/core/math/vector2.h"
+
+#include "runtime/platform/file_service/mapped_file.h"
+
+#include "runtime/resource/config_manager/config_manager.h"
+
+#include "runtime/function/global/global_context.h"
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+namespace Piccolo
+{
+    namespace
+    {
+        struct MeshCacheHeader
+        {
+            static constexpr uint32_t k_magic = 0x48534d50; // "PMSH"
+            // bump whenever the import or the optimization changes, so that the caches are rebuilt
+            static constexpr uint32_t k_format_version = 1;
+
+            uint32_t m_magic {k_magic};
+            uint32_t m_format_version {k_format_version};
+            uint32_t m_vertex_count {0};
+            uint32_t m_index_count {0};
+            uint32_t m_index_type {RHI_INDEX_TYPE_UINT16};
+            float    m_bounding_min[3] {0.f, 0.f, 0.f};
+            float    m_bounding_max[3] {0.f, 0.f, 0.f};
+        };
+
+        // position, normal and uv, the tangents are computed once the vertices are welded
+        struct VertexKey
+        {
+            float m_values[8];
+
+            bool operator==(const VertexKey& rhs) const
+            {
+                return std::memcmp(m_values, rhs.m_values, sizeof(m_values)) == 0;
+            }
+        };
+
+        struct VertexKeyHash
+        {
+            size_t operator()(const VertexKey& key) const noexcept
+            {
+                // FNV-1a over the bits of the values
+                uint64_t hash = 14695981039346656037ull;
+                for (float value : key.m_values)
+                {
+                    uint32_t bits;
+                    std::memcpy(&bits, &value, sizeof(bits));
+                    hash = (hash ^ bits) * 1099511628211ull;
+                }
+                return static_cast<size_t>(hash);
+            }
+        };
+
+        // Forsyth, "Linear-Speed Vertex Cache Optimisation"
+        constexpr uint32_t k_vertex_cache_size      = 32;
+        constexpr float    k_cache_decay_power      = 1.5f;
+        constexpr float    k_last_triangle_score    = 0.75f;
+        constexpr float    k_valence_boost_scale    = 2.0f;
+        constexpr float    k_valence_boost_power    = 0.5f;
+        constexpr uint32_t k_overdraw_cache_size    = 16;
+        constexpr size_t   k_min_cluster_triangles  = 64;
+        constexpr uint32_t k_invalid_vertex_index   = std::numeric_limits<uint32_t>::max();
+        constexpr size_t   k_max_uint16_index_count = std::numeric_limits<uint16_t>::max();
+
+        float computeVertexScore(int32_t cache_position, uint32_t remaining_valence)
+        {
+            // no triangle left to draw, never pick it again
+            if (remaining_valence == 0)
+                return -1.f;
+
+            float score = 0.f;
+            if (cache_position >= 0)
+            {
+                // the vertices of the last triangle get a fixed score so that it's not drawn again in strips
+                if (cache_position < 3)
+                {
+                    score = k_last_triangle_score;
+                }
+                else
+                {
+                    const float scaler = 1.f / static_cast<float>(k_vertex_cache_size - 3);
+                    score = std::pow(1.f - static_cast<float>(cache_position - 3) * scaler, k_cache_decay_power);
+                }
+            }
+
+            // favour the vertices with few triangles left, they don't stay around for long
+            score += k_valence_boost_scale * std::pow(static_cast<float>(remaining_valence), -k_valence_boost_power);
+            return score;
+        }
+
+        void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertex_count)
+        {
+            const size_t triangle_count = indices.size() / 3;
+            if (triangle_count == 0)
+                return;
+
+            // triangles of every vertex, the still undrawn ones first
+            std::vector<uint32_t> vertex_triangle_offsets(vertex_count + 1, 0);
+            for (uint32_t index : indices)
+            {
+                ++vertex_triangle_offsets[index + 1];
+            }
+            for (size_t vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
+            {
+                vertex_triangle_offsets[vertex_index + 1] += vertex_triangle_offsets[vertex_index];
+            }
+
+            std::vector<uint32_t> remaining_valences(vertex_count, 0);
+            std::vector<uint32_t> vertex_triangles(indices.size());
+            for (size_t index_index = 0; index_index < indices.size(); ++index_index)
+            {
+                const uint32_t vertex_index = indices[index_index];
+                vertex_triangles[vertex_triangle_offsets[vertex_index] + remaining_valences[vertex_index]] =
+                    static_cast<uint32_t>(index_index / 3);
+                ++remaining_valences[vertex_index];
+            }
+
+            std::vector<int32_t> cache_positions(vertex_count, -1);
+            std::vector<float>   vertex_scores(vertex_count);
+            for (size_t vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
+            {
+                vertex_scores[vertex_index] = computeVertexScore(-1, remaining_valences[vertex_index]);
+            }
+
+            std::vector<float> triangle_scores(triangle_count);
+            std::vector<bool>  is_triangle_drawn(triangle_count, false);
+            for (size_t triangle_index = 0; triangle_index < triangle_count; ++triangle_index)
+            {
+                triangle_scores[triangle_index] = vertex_scores[indices[triangle_index * 3 + 0]] +
+                                                  vertex_scores[indices[triangle_index * 3 + 1]] +
+                                                  vertex_scores[indices[triangle_index * 3 + 2]];
+            }
+
+            std::vector<uint32_t> output_indices;
+            output_indices.reserve(indices.size());
+
+            std::vector<uint32_t> cache;
+            std::vector<uint32_t> next_cache;
+            cache.reserve(k_vertex_cache_size + 3);
+            next_cache.reserve(k_vertex_cache_size + 3);
+
+            size_t best_triangle = static_cast<size_t>(
+                std::max_element(triangle_scores.begin(), triangle_scores.end()) - triangle_scores.begin());
+            // the undrawn triangles before it are the fallback when no triangle in the cache is left
+            size_t next_undrawn_triangle = 0;
+
+            for (size_t drawn_count = 0; drawn_count < triangle_count; ++drawn_count)
+            {
+                if (best_triangle == triangle_count)
+                {
+                    while (is_triangle_drawn[next_undrawn_triangle])
+                    {
+                        ++next_undrawn_triangle;
+                    }
+                    best_triangle = next_undrawn_triangle;
+                }
+
+                is_triangle_drawn[best_triangle] = true;
+
+                // emit the triangle, it goes to the front of the cache
+                next_cache.clear();
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t vertex_index = indices[best_triangle * 3 + corner];
+                    output_indices.push_back(vertex_index);
+                    next_cache.push_back(vertex_index);
+
+                    uint32_t* triangles = vertex_triangles.data() + vertex_triangle_offsets[vertex_index];
+                    uint32_t& valence   = remaining_valences[vertex_index];
+                    for (uint32_t triangle_slot = 0; triangle_slot < valence; ++triangle_slot)
+                    {
+                        if (triangles[triangle_slot] == best_triangle)
+                        {
+                            std::swap(triangles[triangle_slot], triangles[valence - 1]);
+                            break;
+                        }
+                    }
+                    --valence;
+                }
+
+                for (uint32_t vertex_index : cache)
+                {
+                    if (std::find(next_cache.begin(), next_cache.end(), vertex_index) == next_cache.end())
+                    {
+                        next_cache.push_back(vertex_index);
+                    }
+                }
+
+                // the vertices pushed out of the cache lose their cache score
+                for (size_t cache_index = k_vertex_cache_size; cache_index < next_cache.size(); ++cache_index)
+                {
+                    cache_positions[next_cache[cache_index]] = -1;
+                }
+                next_cache.resize(std::min<size_t>(next_cache.size(), k_vertex_cache_size));
+                cache.swap(next_cache);
+
+                for (size_t cache_index = 0; cache_index < cache.size(); ++cache_index)
+                {
+                    cache_positions[cache[cache_index]] = static_cast<int32_t>(cache_index);
+                }
+
+                // rescore the vertices whose cache position or valence changed, those pushed out of the cache
+                // were in the previous one
+                for (const std::vector<uint32_t>* changed_vertices : {&next_cache, &cache})
+                {
+                    for (uint32_t vertex_index : *changed_vertices)
+                    {
+                        const float score =
+                            computeVertexScore(cache_positions[vertex_index], remaining_valences[vertex_index]);
+                        const float delta           = score - vertex_scores[vertex_index];
+                        vertex_scores[vertex_index] = score;
+
+                        const uint32_t* triangles = vertex_triangles.data() + vertex_triangle_offsets[vertex_index];
+                        for (uint32_t slot = 0; slot < remaining_valences[vertex_index]; ++slot)
+                        {
+                            triangle_scores[triangles[slot]] += delta;
+                        }
+                    }
+                }
+
+                // the next triangle is the best one using a cached vertex
+                best_triangle    = triangle_count;
+                float best_score = -1.f;
+                for (uint32_t vertex_index : cache)
+                {
+                    const uint32_t* triangles = vertex_triangles.data() + vertex_triangle_offsets[vertex_index];
+                    for (uint32_t slot = 0; slot < remaining_valences[vertex_index]; ++slot)
+                    {
+                        const uint32_t triangle_index = triangles[slot];
+                        if (triangle_scores[triangle_index] > best_score)
+                        {
+                            best_score    = triangle_scores[triangle_index];
+                            best_triangle = triangle_index;
+                        }
+                    }
+                }
+            }
+
+            indices.swap(output_indices);
+        }
+
+        // Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw": the cache ordered
+        // triangles are cut where the cache has to start over anyway, and the clusters facing away from the
+        // center of the mesh are drawn first since they are the most likely to occlude the others
+        void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<MeshVertexDataDefinition>& vertices)
+        {
+            const size_t triangle_count = indices.size() / 3;
+            if (triangle_count <= k_min_cluster_triangles)
+                return;
+
+            std::vector<size_t>   cluster_begins;
+            std::vector<uint32_t> fifo_timestamps(vertices.size(), 0);
+            uint32_t              fifo_time = k_overdraw_cache_size + 1;
+            size_t                cluster_begin = 0;
+            for (size_t triangle_index = 0; triangle_index < triangle_count; ++triangle_index)
+            {
+                uint32_t miss_count = 0;
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t vertex_index = indices[triangle_index * 3 + corner];
+                    if (fifo_time - fifo_timestamps[vertex_index] > k_overdraw_cache_size)
+                    {
+                        fifo_timestamps[vertex_index] = fifo_time++;
+                        ++miss_count;
+                    }
+                }
+
+                if (triangle_index == 0 ||
+                    (miss_count == 3 && triangle_index - cluster_begin >= k_min_cluster_triangles))
+                {
+                    cluster_begins.push_back(triangle_index);
+                    cluster_begin = triangle_index;
+                }
+            }
+            cluster_begins.push_back(triangle_count);
+
+            const size_t cluster_count = cluster_begins.size() - 1;
+            if (cluster_count <= 1)
+                return;
+
+            auto getPosition = [&](uint32_t vertex_index) {
+                const MeshVertexDataDefinition& vertex = vertices[vertex_index];
+                return Vector3(vertex.x, vertex.y, vertex.z);
+            };
+
+            // area weighted centers and normals
+            std::vector<Vector3> cluster_centers(cluster_count, Vector3::ZERO);
+            std::vector<Vector3> cluster_normals(cluster_count, Vector3::ZERO);
+            std::vector<float>   cluster_areas(cluster_count, 0.f);
+            Vector3              mesh_center  = Vector3::ZERO;
+            float                mesh_area    = 0.f;
+            for (size_t cluster_index = 0; cluster_index < cluster_count; ++cluster_index)
+            {
+                for (size_t triangle_index = cluster_begins[cluster_index];
+                     triangle_index < cluster_begins[cluster_index + 1];
+                     ++triangle_index)
+                {
+                    const Vector3 p0 = getPosition(indices[triangle_index * 3 + 0]);
+                    const Vector3 p1 = getPosition(indices[triangle_index * 3 + 1]);
+                    const Vector3 p2 = getPosition(indices[triangle_index * 3 + 2]);
+
+                    const Vector3 normal = (p1 - p0).crossProduct(p2 - p0);
+                    const float   area   = normal.length();
+
+                    cluster_centers[cluster_index] += (p0 + p1 + p2) * (area / 3.f);
+                    cluster_normals[cluster_index] += normal;
+                    cluster_areas[cluster_index] += area;
+                }
+
+                mesh_center += cluster_centers[cluster_index];
+                mesh_area += cluster_areas[cluster_index];
+            }
+            if (mesh_area > 0.f)
+            {
+                mesh_center /= mesh_area;
+            }
+
+            std::vector<float> cluster_sort_keys(cluster_count, 0.f);
+            for (size_t cluster_index = 0; cluster_index < cluster_count; ++cluster_index)
+            {
+                if (cluster_areas[cluster_index] <= 0.f)
+                    continue;
+
+                const Vector3 center = cluster_centers[cluster_index] / cluster_areas[cluster_index];
+                cluster_sort_keys[cluster_index] =
+                    (center - mesh_center).dotProduct(cluster_normals[cluster_index].normalisedCopy());
+            }
+
+            std::vector<size_t> cluster_order(cluster_count);
+            for (size_t cluster_index = 0; cluster_index < cluster_count; ++cluster_index)
+            {
+                cluster_order[cluster_index] = cluster_index;
+            }
+            std::stable_sort(cluster_order.begin(), cluster_order.end(), [&](size_t lhs, size_t rhs) {
+                return cluster_sort_keys[lhs] > cluster_sort_keys[rhs];
+            });
+
+            std::vector<uint32_t> output_indices;
+            output_indices.reserve(indices.size());
+            for (size_t cluster_index : cluster_order)
+            {
+                output_indices.insert(output_indices.end(),
+                                      indices.begin() + cluster_begins[cluster_index] * 3,
+                                      indices.begin() + cluster_begins[cluster_index + 1] * 3);
+            }
+            indices.swap(output_indices);
+        }
+
+        // renumber the vertices in the order of their first use, so that the vertex fetches walk the buffer
+        void optimizeVertexFetch(ImportedMesh& mesh)
+        {
+            std::vector<uint32_t> remap(mesh.m_vertices.size(), k_invalid_vertex_index);
+
+            std::vector<MeshVertexDataDefinition> vertices;
+            vertices.reserve(mesh.m_vertices.size());
+            for (uint32_t& index : mesh.m_indices)
+            {
+                if (remap[index] == k_invalid_vertex_index)
+                {
+                    remap[index] = static_cast<uint32_t>(vertices.size());
+                    vertices.push_back(mesh.m_vertices[index]);
+                }
+                index = remap[index];
+            }
+            mesh.m_vertices.swap(vertices);
+        }
+
+        void computeTangents(ImportedMesh& mesh)
+        {
+            std::vector<Vector3> tangents(mesh.m_vertices.size(), Vector3::ZERO);
+            for (size_t index_index = 0; index_index + 2 < mesh.m_indices.size(); index_index += 3)
+            {
+                const MeshVertexDataDefinition& v0 = mesh.m_vertices[mesh.m_indices[index_index + 0]];
+                const MeshVertexDataDefinition& v1 = mesh.m_vertices[mesh.m_indices[index_index + 1]];
+                const MeshVertexDataDefinition& v2 = mesh.m_vertices[mesh.m_indices[index_index + 2]];
+
+                const Vector3 edge1(v1.x - v0.x, v1.y - v0.y, v1.z - v0.z);
+                const Vector3 edge2(v2.x - v0.x, v2.y - v0.y, v2.z - v0.z);
+                const Vector2 delta_uv1(v1.u - v0.u, v1.v - v0.v);
+                const Vector2 delta_uv2(v2.u - v0.u, v2.v - v0.v);
+
+                // no uv mapping, the tangent is made up below
+                const float divide = delta_uv1.x * delta_uv2.y - delta_uv2.x * delta_uv1.y;
+                if (std::fabs(divide) < 1e-12f)
+                    continue;
+
+                // not normalized, so that the large triangles weight more
+                const Vector3 tangent = (edge1 * delta_uv2.y - edge2 * delta_uv1.y) / divide;
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    tangents[mesh.m_indices[index_index + corner]] += tangent;
+                }
+            }
+
+            for (size_t vertex_index = 0; vertex_index < mesh.m_vertices.size(); ++vertex_index)
+            {
+                MeshVertexDataDefinition& vertex = mesh.m_vertices[vertex_index];
+                const Vector3             normal(vertex.nx, vertex.ny, vertex.nz);
+
+                // Gram-Schmidt, the tangent has to be orthogonal to the normal
+                Vector3 tangent = tangents[vertex_index] - normal * normal.dotProduct(tangents[vertex_index]);
+                if (tangent.squaredLength() < 1e-12f)
+                {
+                    const Vector3 axis = std::fabs(normal.x) < 0.9f ? Vector3::UNIT_X : Vector3::UNIT_Y;
+                    tangent            = axis - normal * normal.dotProduct(axis);
+                }
+                tangent.normalise();
+
+                vertex.tx = tangent.x;
+                vertex.ty = tangent.y;
+                vertex.tz = tangent.z;
+            }
+        }
+    } // namespace
+
+    bool importObjMesh(const std::string& obj_file, ImportedMesh& out_mesh)
+    {
+        tinyobj::ObjReader       reader;
+        tinyobj::ObjReaderConfig reader_config;
+        reader_config.vertex_color = false;
+        if (!reader.ParseFromFile(obj_file, reader_config))
+        {
+            if (!reader.Error().empty())
+            {
+                LOG_ERROR("loadMesh {} failed, error: {}", obj_file, reader.Error());
+            }
+            return false;
+        }
+
+        if (!reader.Warning().empty())
+        {
+            LOG_WARN("loadMesh {} warning, warning: {}", obj_file, reader.Warning());
+        }
+
+        auto& attrib = reader.GetAttrib();
+        auto& shapes = reader.GetShapes();
+
+        size_t index_count = 0;
+        for (const auto& shape : shapes)
+        {
+            index_count += shape.mesh.indices.size();
+        }
+
+        out_mesh.m_vertices.clear();
+        out_mesh.m_indices.clear();
+        out_mesh.m_indices.reserve(index_count);
+
+        std::unordered_map<VertexKey, uint32_t, VertexKeyHash> welded_vertices;
+        welded_vertices.reserve(index_count);
+
+        for (size_t s = 0; s < shapes.size(); s++)
+        {
+            size_t index_offset = 0;
+            for (size_t f = 0; f < shapes[s].mesh.num_face_vertices.size(); f++)
+            {
+                size_t fv = size_t(shapes[s].mesh.num_face_vertices[f]);
+
+                // only deals with triangle faces
+                if (fv != 3)
+                {
+                    index_offset += fv;
+                    continue;
+                }
+
+                bool with_normal   = true;
+                bool with_texcoord = true;
+
+                Vector3 vertex[3];
+                Vector3 normal[3];
+                Vector2 uv[3];
+
+                for (size_t v = 0; v < fv; v++)
+                {
+                    auto idx = shapes[s].mesh.indices[index_offset + v];
+
+                    vertex[v].x = static_cast<float>(attrib.vertices[3 * size_t(idx.vertex_index) + 0]);
+                    vertex[v].y = static_cast<float>(attrib.vertices[3 * size_t(idx.vertex_index) + 1]);
+                    vertex[v].z = static_cast<float>(attrib.vertices[3 * size_t(idx.vertex_index) + 2]);
+
+                    if (idx.normal_index >= 0)
+                    {
+                        normal[v].x = static_cast<float>(attrib.normals[3 * size_t(idx.normal_index) + 0]);
+                        normal[v].y = static_cast<float>(attrib.normals[3 * size_t(idx.normal_index) + 1]);
+                        normal[v].z = static_cast<float>(attrib.normals[3 * size_t(idx.normal_index) + 2]);
+                    }
+                    else
+                    {
+                        with_normal = false;
+                    }
+
+                    if (idx.texcoord_index >= 0)
+                    {
+                        uv[v].x = static_cast<float>(attrib.texcoords[2 * size_t(idx.texcoord_index) + 0]);
+                        uv[v].y = static_cast<float>(attrib.texcoords[2 * size_t(idx.texcoord_index) + 1]);
+                    }
+                    else
+                    {
+                        with_texcoord = false;
+                    }
+                }
+                index_offset += fv;
+
+                if (!with_normal)
+                {
+                    Vector3 v0 = vertex[1] - vertex[0];
+                    Vector3 v1 = vertex[2] - vertex[1];
+                    normal[0]  = v0.crossProduct(v1).normalisedCopy();
+                    normal[1]  = normal[0];
+                    normal[2]  = normal[0];
+                }
+
+                if (!with_texcoord)
+                {
+                    uv[0] = Vector2(0.5f, 0.5f);
+                    uv[1] = Vector2(0.5f, 0.5f);
+                    uv[2] = Vector2(0.5f, 0.5f);
+                }
+
+                uint32_t triangle[3];
+                for (size_t v = 0; v < 3; v++)
+                {
+                    const VertexKey key {{vertex[v].x,
+                                          vertex[v].y,
+                                          vertex[v].z,
+                                          normal[v].x,
+                                          normal[v].y,
+                                          normal[v].z,
+                                          uv[v].x,
+                                          uv[v].y}};
+
+                    auto iter = welded_vertices.emplace(key, static_cast<uint32_t>(out_mesh.m_vertices.size())).first;
+                    if (iter->second == out_mesh.m_vertices.size())
+                    {
+                        MeshVertexDataDefinition mesh_vert {};
+
+                        mesh_vert.x = vertex[v].x;
+                        mesh_vert.y = vertex[v].y;
+                        mesh_vert.z = vertex[v].z;
+
+                        mesh_vert.nx = normal[v].x;
+                        mesh_vert.ny = normal[v].y;
+                        mesh_vert.nz = normal[v].z;
+
+                        mesh_vert.u = uv[v].x;
+                        mesh_vert.v = uv[v].y;
+
+                        out_mesh.m_vertices.push_back(mesh_vert);
+                        out_mesh.m_bounding_box.merge(vertex[v]);
+                    }
+                    triangle[v] = iter->second;
+                }
+
+                // collapsed by the welding, it would never produce a pixel
+                if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[2] == triangle[0])
+                    continue;
+
+                out_mesh.m_indices.insert(out_mesh.m_indices.end(), triangle, triangle + 3);
+            }
+        }
+
+        computeTangents(out_mesh);
+        return true;
+    }
+
+    void optimizeMesh(ImportedMesh& mesh)
+    {
+        optimizeVertexCache(mesh.m_indices, mesh.m_vertices.size());
+        optimizeOverdraw(mesh.m_indices, mesh.m_vertices);
+        optimizeVertexFetch(mesh);
+    }
+
+    StaticMeshData createStaticMeshData(const ImportedMesh& mesh)
+    {
+        StaticMeshData mesh_data;
+
+        const size_t vertex_buffer_size = mesh.m_vertices.size() * sizeof(MeshVertexDataDefinition);
+        mesh_data.m_vertex_buffer       = std::make_shared<BufferData>(vertex_buffer_size);
+        std::memcpy(mesh_data.m_vertex_buffer->m_data, mesh.m_vertices.data(), vertex_buffer_size);
+
+        if (mesh.m_vertices.size() <= k_max_uint16_index_count)
+        {
+            mesh_data.m_index_type   = RHI_INDEX_TYPE_UINT16;
+            mesh_data.m_index_buffer = std::make_shared<BufferData>(mesh.m_indices.size() * sizeof(uint16_t));
+
+            uint16_t* indices = static_cast<uint16_t*>(mesh_data.m_index_buffer->m_data);
+            for (size_t index_index = 0; index_index < mesh.m_indices.size(); ++index_index)
+            {
+                indices[index_index] = static_cast<uint16_t>(mesh.m_indices[index_index]);
+            }
+        }
+        else
+        {
+            mesh_data.m_index_type   = RHI_INDEX_TYPE_UINT32;
+            mesh_data.m_index_buffer = std::make_shared<BufferData>(mesh.m_indices.size() * sizeof(uint32_t));
+            std::memcpy(mesh_data.m_index_buffer->m_data,
+                        mesh.m_indices.data(),
+                        mesh.m_indices.size() * sizeof(uint32_t));
+        }
+
+        return mesh_data;
+    }
+
+    std::filesystem::path getMeshCachePath(const std::string& mesh_file)
+    {
+        const std::filesystem::path root_folder =
+            std::filesystem::absolute(g_runtime_global_context.m_config_manager->getRootFolder());
+        const std::filesystem::path mesh_path = std::filesystem::absolute(mesh_file).lexically_normal();
+
+        // the caches mirror the asset tree, a mesh outside of it is told apart by the hash of its path
+        std::filesystem::path relative_path = mesh_path.lexically_relative(root_folder);
+        if (relative_path.empty() || *relative_path.begin() == "..")
+        {
+            relative_path = std::filesystem::path("external") /
+                            (std::to_string(std::hash<std::string> {}(mesh_path.generic_string())) + "_" +
+                             mesh_path.filename().string());
+        }
+
+        std::filesystem::path cache_path = root_folder / "cache" / "mesh" / relative_path;
+        cache_path += ".bin";
+        return cache_path;
+    }
+
+    bool loadMeshCache(const std::string& mesh_file, StaticMeshData& out_mesh_data, AxisAlignedBox& out_bounding_box)
+    {
+        const std::filesystem::path cache_path = getMeshCachePath(mesh_file);
+
+        std::error_code error;
+        const auto      cache_time = std::filesystem::last_write_time(cache_path, error);
+        if (error)
+            return false;
+        const auto mesh_time = std::filesystem::last_write_time(mesh_file, error);
+        if (!error && mesh_time > cache_time)
+            return false;
+
+        MappedFile cache_file;
+        if (!cache_file.open(cache_path) || cache_file.getSize() < sizeof(MeshCacheHeader))
+            return false;
+
+        MeshCacheHeader header;
+        std::memcpy(&header, cache_file.getData(), sizeof(MeshCacheHeader));
+        if (header.m_magic != MeshCacheHeader::k_magic ||
+            header.m_format_version != MeshCacheHeader::k_format_version ||
+            (header.m_index_type != RHI_INDEX_TYPE_UINT16 && header.m_index_type != RHI_INDEX_TYPE_UINT32))
+        {
+            LOG_WARN("mesh cache {} is out of date, importing {} instead", cache_path.generic_string(), mesh_file);
+            return false;
+        }
+
+        const size_t index_stride       = header.m_index_type == RHI_INDEX_TYPE_UINT32 ? 4 : 2;
+        const size_t vertex_buffer_size = size_t(header.m_vertex_count) * sizeof(MeshVertexDataDefinition);
+        const size_t index_buffer_size  = size_t(header.m_index_count) * index_stride;
+        if (cache_file.getSize() != sizeof(MeshCacheHeader) + vertex_buffer_size + index_buffer_size)
+        {
+            LOG_WARN("mesh cache {} is corrupted, importing {} instead", cache_path.generic_string(), mesh_file);
+            return false;
+        }
+
+        const uint8_t* data          = cache_file.getData() + sizeof(MeshCacheHeader);
+        out_mesh_data.m_index_type    = static_cast<RHIIndexType>(header.m_index_type);
+        out_mesh_data.m_vertex_buffer = std::make_shared<BufferData>(vertex_buffer_size);
+        out_mesh_data.m_index_buffer  = std::make_shared<BufferData>(index_buffer_size);
+        std::memcpy(out_mesh_data.m_vertex_buffer->m_data, data, vertex_buffer_size);
+        std::memcpy(out_mesh_data.m_index_buffer->m_data, data + vertex_buffer_size, index_buffer_size);
+
+        out_bounding_box = AxisAlignedBox();
+        if (header.m_vertex_count > 0)
+        {
+            out_bounding_box.merge(Vector3(header.m_bounding_min));
+            out_bounding_box.merge(Vector3(header.m_bounding_max));
+        }
+        return true;
+    }
+
+    bool saveMeshCache(const std::string&    mesh_file,
+                       const StaticMeshData& mesh_data,
+                       const AxisAlignedBox& bounding_box)
+    {
+        const size_t index_stride = mesh_data.m_index_type == RHI_INDEX_TYPE_UINT32 ? 4 : 2;
+
+        MeshCacheHeader header;
+        header.m_vertex_count =
+            static_cast<uint32_t>(mesh_data.m_vertex_buffer->m_size / sizeof(MeshVertexDataDefinition));
+        header.m_index_count = static_cast<uint32_t>(mesh_data.m_index_buffer->m_size / index_stride);
+        header.m_index_type  = mesh_data.m_index_type;
+        std::memcpy(header.m_bounding_min, bounding_box.getMinCorner().ptr(), sizeof(header.m_bounding_min));
+        std::memcpy(header.m_bounding_max, bounding_box.getMaxCorner().ptr(), sizeof(header.m_bounding_max));
+
+        // write next to the final file and swap, a concurrent load never maps a half written cache
+        const std::filesystem::path cache_path = getMeshCachePath(mesh_file);
+        std::filesystem::path       temp_path  = cache_path;
+        temp_path += ".tmp";
+
+        std::error_code error;
+        std::filesystem::create_directories(cache_path.parent_path(), error);
+        if (error)
+        {
+            LOG_WARN("create folder {} failed: {}", cache_path.parent_path().generic_string(), error.message());
+            return false;
+        }
+        {
+            std::ofstream cache_file(temp_path, std::ios::binary | std::ios::trunc);
+            if (!cache_file)
+            {
+                LOG_WARN("open file {} failed!", temp_path.generic_string());
+                return false;
+            }
+            cache_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            cache_file.write(static_cast<const char*>(mesh_data.m_vertex_buffer->m_data),
+                             static_cast<std::streamsize>(mesh_data.m_vertex_buffer->m_size));
+            cache_file.write(static_cast<const char*>(mesh_data.m_index_buffer->m_data),
+                             static_cast<std::streamsize>(mesh_data.m_index_buffer->m_size));
+            if (!cache_file)
+            {
+                LOG_WARN("write file {} failed!", temp_path.generic_string());
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temp_path, cache_path, error);
+        if (error)
+        {
+            LOG_WARN("replace file {} failed: {}", cache_path.generic_string(), error.message());
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+        return true;
+    }
+} // namespace Piccolo
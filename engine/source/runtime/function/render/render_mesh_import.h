@@ -0,0 +1,40 @@
+#pragma once
+
+#include "runtime/core/math/axis_aligned.h"
+
+#include "runtime/function/render/render_type.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Piccolo
+{
+    /// Indexed triangle list read from a mesh source file.
+    struct ImportedMesh
+    {
+        std::vector<MeshVertexDataDefinition> m_vertices;
+        std::vector<uint32_t>                 m_indices;
+        AxisAlignedBox                        m_bounding_box;
+    };
+
+    /// read the triangles of an obj file, the vertices sharing position, normal and uv are welded and their
+    /// tangents averaged over all the triangles using them, degenerate triangles are dropped
+    bool importObjMesh(const std::string& obj_file, ImportedMesh& out_mesh);
+
+    /// reorder the triangles for the post transform vertex cache, then clusters of them from the outside in to
+    /// reduce overdraw, and finally the vertices in the order the triangles first use them
+    void optimizeMesh(ImportedMesh& mesh);
+
+    /// 16 bit indices unless there are more vertices than they can address
+    StaticMeshData createStaticMeshData(const ImportedMesh& mesh);
+
+    /// the cache of a mesh is a binary file under <root>/cache/mesh at the path of its source file, ignored once the
+    /// source file is newer
+    std::filesystem::path getMeshCachePath(const std::string& mesh_file);
+    bool loadMeshCache(const std::string& mesh_file, StaticMeshData& out_mesh_data, AxisAlignedBox& out_bounding_box);
+    bool saveMeshCache(const std::string&    mesh_file,
+                       const StaticMeshData& mesh_data,
+                       const AxisAlignedBox& bounding_box);
+} // namespace Piccolo
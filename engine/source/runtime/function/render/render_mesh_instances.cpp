@@ -0,0 +1,554 @@
+#include "runtime/function/render/render_mesh_instances.h"
+
+#include "runtime/core/base/macro.h"
+
+#include "runtime/function/render/interface/rhi.h"
+#include "runtime/function/render/render_helper.h"
+#include "runtime/function/render/render_mesh.h"
+#include "runtime/function/render/render_resource.h"
+#include "runtime/function/render/render_scene.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <tuple>
+
+namespace Piccolo
+{
+    void RenderMeshInstances::initialize(std::shared_ptr<RHI> rhi)
+    {
+        m_rhi = rhi;
+
+        // the source of the copy when the buffer grows
+        m_instance_capacity = s_mesh_instance_max_count;
+        m_rhi->createBuffer(sizeof(VulkanMeshInstanceData) * m_instance_capacity,
+                            RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
+                            RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                            m_instance_buffer,
+                            m_instance_buffer_memory);
+
+        // written by the culling each frame, a batch gets as many slots as it has instances
+        if (m_rhi->isDrawIndirectFirstInstanceEnabled())
+        {
+            m_rhi->createBuffer(sizeof(uint32_t) * s_mesh_instance_max_count,
+                                RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                m_visible_instance_buffer,
+                                m_visible_instance_buffer_memory);
+        }
+    }
+
+    void RenderMeshInstances::initializePreSkinning()
+    {
+        m_rhi->createBuffer(sizeof(MeshVertex::VulkanMeshVertexPostition) * s_mesh_skinning_max_vertex_count,
+                            RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                            RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                            m_skinned_position_buffer,
+                            m_skinned_position_buffer_memory);
+        m_rhi->createBuffer(sizeof(MeshVertex::VulkanMeshVertexVaryingEnableBlending) *
+                                s_mesh_skinning_max_vertex_count,
+                            RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                            RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                            m_skinned_varying_buffer,
+                            m_skinned_varying_buffer_memory);
+    }
+
+    void RenderMeshInstances::clear()
+    {
+        if (m_instance_buffer)
+        {
+            m_rhi->destroyBuffer(m_instance_buffer);
+            m_rhi->freeMemory(m_instance_buffer_memory);
+            m_instance_buffer = nullptr;
+        }
+        if (m_visible_instance_buffer)
+        {
+            m_rhi->destroyBuffer(m_visible_instance_buffer);
+            m_rhi->freeMemory(m_visible_instance_buffer_memory);
+            m_visible_instance_buffer = nullptr;
+        }
+        if (m_skinned_position_buffer)
+        {
+            m_rhi->destroyBuffer(m_skinned_position_buffer);
+            m_rhi->freeMemory(m_skinned_position_buffer_memory);
+            m_skinned_position_buffer = nullptr;
+            m_rhi->destroyBuffer(m_skinned_varying_buffer);
+            m_rhi->freeMemory(m_skinned_varying_buffer_memory);
+            m_skinned_varying_buffer = nullptr;
+        }
+        m_rhi.reset();
+
+        m_instances.clear();
+        m_instance_keys.clear();
+        m_batches.clear();
+        m_dirty_instances.clear();
+        m_skinned_instances.clear();
+        m_joint_matrix_offsets.clear();
+        m_joint_palette_offsets.clear();
+        m_pre_skinned_instances.clear();
+        m_skinned_first_vertices.clear();
+        m_bindless_fallback_material_count = 0;
+    }
+
+    void RenderMeshInstances::update(RenderScene& render_scene, RenderResource& render_resource)
+    {
+        const std::vector<RenderEntity>& entities = render_scene.m_render_entities;
+        const uint32_t                   count    = static_cast<uint32_t>(entities.size());
+
+        if (count > m_instance_capacity)
+        {
+            growInstanceBuffer(count);
+        }
+
+        // added and removed entities change the batches
+        bool is_batch_dirty = (count != m_instances.size());
+        m_instances.resize(count);
+        m_instance_keys.resize(count);
+        m_joint_matrix_offsets.resize(count, s_mesh_instance_no_joint_matrices);
+        m_skinned_first_vertices.resize(count, s_mesh_skinning_no_first_vertex);
+
+        for (uint32_t entity_index : render_scene.getDirtyEntities())
+        {
+            if (entity_index >= count)
+                continue;
+
+            const RenderEntity& entity = entities[entity_index];
+
+            InstanceKey key;
+            key.m_mesh_asset_id          = entity.m_mesh_asset_id;
+            key.m_material_asset_id      = entity.m_material_asset_id;
+            key.m_enable_vertex_blending = entity.m_enable_vertex_blending;
+            if (!(key == m_instance_keys[entity_index]))
+            {
+                m_instance_keys[entity_index] = key;
+                is_batch_dirty                = true;
+            }
+
+            VulkanMeshInstanceData& instance  = m_instances[entity_index];
+            instance.model_matrix             = entity.m_model_matrix;
+            instance.bounding_box_center      = entity.m_bounding_box.getCenter();
+            instance.bounding_box_half_extent = entity.m_bounding_box.getHalfExtent();
+            instance.material_index           = 0;
+            if (render_resource.m_bindless_materials.isEnabled())
+            {
+                // the materials past the capacity of the bindless buffer are in batches of their own and bind their
+                // descriptor set, the index is not read then
+                const uint32_t material_index = render_resource.getEntityMaterial(entity).material_index;
+                instance.material_index =
+                    (material_index != s_mesh_bindless_invalid_material) ? material_index : 0;
+            }
+
+            m_dirty_instances.push_back(entity_index);
+        }
+        render_scene.clearDirtyEntities();
+
+        // a material leaving the bindless set moves its instances to batches of their own
+        const uint32_t bindless_fallback_material_count =
+            render_resource.m_bindless_materials.getFallbackMaterialCount();
+        if (bindless_fallback_material_count != m_bindless_fallback_material_count)
+        {
+            m_bindless_fallback_material_count = bindless_fallback_material_count;
+            is_batch_dirty                     = true;
+        }
+
+        m_skinned_instances.clear();
+        for (uint32_t instance_index = 0; instance_index < count; ++instance_index)
+        {
+            const RenderEntity& entity = entities[instance_index];
+            if (!entity.m_enable_vertex_blending || entity.m_joint_palette == k_invalid_joint_palette)
+                continue;
+
+            const std::vector<Matrix4x4>& joint_palette = render_scene.getJointPalette(entity.m_joint_palette);
+            if (joint_palette.empty())
+                continue;
+
+            SkinnedInstance skinned_instance;
+            skinned_instance.m_instance_index = instance_index;
+            skinned_instance.m_joint_palette  = entity.m_joint_palette;
+            skinned_instance.m_mesh           = &render_resource.getEntityMesh(entity);
+            skinned_instance.m_joint_matrices = joint_palette.data();
+            skinned_instance.m_joint_count    = static_cast<uint32_t>(joint_palette.size());
+            m_skinned_instances.push_back(skinned_instance);
+
+            if (entity.m_joint_palette >= m_joint_palette_offsets.size())
+            {
+                m_joint_palette_offsets.resize(entity.m_joint_palette + 1);
+            }
+        }
+
+        // the visible instance buffer and the draw commands of the gpu driven path keep their capacity
+        const bool is_within_capacity = (count <= s_mesh_instance_max_count);
+        if (!is_within_capacity && m_is_within_capacity && isGpuDrivenSupported())
+        {
+            LOG_WARN("{} render entities, more than the {} of the gpu driven path, the cpu path draws them",
+                     count,
+                     s_mesh_instance_max_count);
+        }
+        if (is_within_capacity && (is_batch_dirty || !m_is_within_capacity) && isGpuDrivenSupported())
+        {
+            rebuildBatches(render_scene, render_resource);
+        }
+        m_is_within_capacity = is_within_capacity;
+
+        std::sort(m_dirty_instances.begin(), m_dirty_instances.end());
+        m_dirty_instances.erase(std::unique(m_dirty_instances.begin(), m_dirty_instances.end()),
+                                m_dirty_instances.end());
+    }
+
+    void RenderMeshInstances::growInstanceBuffer(uint32_t min_capacity)
+    {
+        uint32_t capacity = m_instance_capacity;
+        while (capacity < min_capacity)
+        {
+            capacity *= 2;
+        }
+
+        // the descriptor sets of the passes can't change while a frame in flight uses them, growing is rare enough
+        // to wait for the queue
+        m_rhi->queueWaitIdle(m_rhi->getGraphicsQueue());
+
+        RHIBuffer*       instance_buffer        = nullptr;
+        RHIDeviceMemory* instance_buffer_memory = nullptr;
+        m_rhi->createBuffer(sizeof(VulkanMeshInstanceData) * capacity,
+                            RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                RHI_BUFFER_USAGE_TRANSFER_DST_BIT,
+                            RHI_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                            instance_buffer,
+                            instance_buffer_memory);
+        m_rhi->copyBuffer(
+            m_instance_buffer, instance_buffer, 0, 0, sizeof(VulkanMeshInstanceData) * m_instance_capacity);
+
+        m_rhi->destroyBuffer(m_instance_buffer);
+        m_rhi->freeMemory(m_instance_buffer_memory);
+        m_instance_buffer        = instance_buffer;
+        m_instance_buffer_memory = instance_buffer_memory;
+        m_instance_capacity      = capacity;
+        ++m_instance_buffer_version;
+    }
+
+    void RenderMeshInstances::rebuildBatches(RenderScene& render_scene, RenderResource& render_resource)
+    {
+        const std::vector<RenderEntity>& entities = render_scene.m_render_entities;
+        const uint32_t                   count    = static_cast<uint32_t>(entities.size());
+
+        // static instances sorted by material then mesh so that a material is bound once, the bindless materials
+        // are bound once per pass and the instances of a mesh share a batch whatever their material, the bindless
+        // batches come first so that the pipeline switches once for the materials past the bindless capacity
+        const RenderBindlessMaterials& bindless_materials = render_resource.m_bindless_materials;
+        std::vector<std::tuple<bool, size_t, size_t, uint32_t>> sorted_instances;
+        sorted_instances.reserve(count);
+        for (uint32_t instance_index = 0; instance_index < count; ++instance_index)
+        {
+            const InstanceKey& key = m_instance_keys[instance_index];
+            if (key.m_enable_vertex_blending)
+            {
+                m_instances[instance_index].batch_index = s_mesh_instance_invalid_batch;
+            }
+            else
+            {
+                const bool is_bindless =
+                    bindless_materials.isBindless(render_resource.getEntityMaterial(entities[instance_index]));
+                sorted_instances.emplace_back(!is_bindless,
+                                              is_bindless ? 0 : key.m_material_asset_id,
+                                              key.m_mesh_asset_id,
+                                              instance_index);
+            }
+        }
+        std::sort(sorted_instances.begin(), sorted_instances.end());
+
+        m_batches.clear();
+        for (size_t i = 0; i < sorted_instances.size(); ++i)
+        {
+            const uint32_t instance_index = std::get<3>(sorted_instances[i]);
+            if (i == 0 || std::get<0>(sorted_instances[i]) != std::get<0>(sorted_instances[i - 1]) ||
+                std::get<1>(sorted_instances[i]) != std::get<1>(sorted_instances[i - 1]) ||
+                std::get<2>(sorted_instances[i]) != std::get<2>(sorted_instances[i - 1]))
+            {
+                MeshInstanceBatch batch;
+                batch.m_mesh     = &render_resource.getEntityMesh(entities[instance_index]);
+                batch.m_material = std::get<0>(sorted_instances[i]) ?
+                                       &render_resource.getEntityMaterial(entities[instance_index]) :
+                                       nullptr;
+                batch.m_first_instance = static_cast<uint32_t>(i);
+                m_batches.push_back(batch);
+            }
+
+            m_batches.back().m_instance_count++;
+            m_instances[instance_index].batch_index = static_cast<uint32_t>(m_batches.size() - 1);
+        }
+
+        // every batch index may have moved
+        m_dirty_instances.resize(count);
+        for (uint32_t instance_index = 0; instance_index < count; ++instance_index)
+        {
+            m_dirty_instances[instance_index] = instance_index;
+        }
+    }
+
+    void RenderMeshInstances::recordUpload(RHICommandBuffer* command_buffer,
+                                           StorageBuffer&    storage_buffer,
+                                           uint8_t           frame_index)
+    {
+        if (!isInitialized())
+            return;
+
+        uploadJointMatrices(storage_buffer, frame_index);
+        assignSkinnedVertices();
+
+        if (m_dirty_instances.empty())
+            return;
+
+        uint32_t upload_offset = roundUp(storage_buffer._global_upload_ringbuffers_end[frame_index],
+                                         storage_buffer._min_storage_buffer_offset_alignment);
+        storage_buffer._global_upload_ringbuffers_end[frame_index] =
+            upload_offset + static_cast<uint32_t>(sizeof(VulkanMeshInstanceData) * m_dirty_instances.size());
+        assert(storage_buffer._global_upload_ringbuffers_end[frame_index] <=
+               (storage_buffer._global_upload_ringbuffers_begin[frame_index] +
+                storage_buffer._global_upload_ringbuffers_size[frame_index]));
+
+        VulkanMeshInstanceData* upload_instances = reinterpret_cast<VulkanMeshInstanceData*>(
+            reinterpret_cast<uintptr_t>(storage_buffer._global_upload_ringbuffer_memory_pointer) + upload_offset);
+
+        // one copy per run of consecutive instances
+        m_upload_regions.clear();
+        for (size_t i = 0; i < m_dirty_instances.size(); ++i)
+        {
+            const uint32_t instance_index = m_dirty_instances[i];
+            upload_instances[i]           = m_instances[instance_index];
+
+            if (i > 0 && m_dirty_instances[i - 1] + 1 == instance_index)
+            {
+                m_upload_regions.back().size += sizeof(VulkanMeshInstanceData);
+            }
+            else
+            {
+                RHIBufferCopy region;
+                region.srcOffset = upload_offset + sizeof(VulkanMeshInstanceData) * i;
+                region.dstOffset = sizeof(VulkanMeshInstanceData) * instance_index;
+                region.size      = sizeof(VulkanMeshInstanceData);
+                m_upload_regions.push_back(region);
+            }
+        }
+        m_dirty_instances.clear();
+
+        // the frames before read the instances in the culling and the vertex shader
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT | RHI_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                                  RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr);
+
+        m_rhi->cmdCopyBuffer(command_buffer,
+                             storage_buffer._global_upload_ringbuffer,
+                             m_instance_buffer,
+                             static_cast<uint32_t>(m_upload_regions.size()),
+                             m_upload_regions.data());
+
+        RHIMemoryBarrier barrier {};
+        barrier.sType         = RHI_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = RHI_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = RHI_ACCESS_SHADER_READ_BIT;
+        m_rhi->cmdPipelineBarrier(command_buffer,
+                                  RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                                  RHI_PIPELINE_STAGE_COMPUTE_SHADER_BIT | RHI_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                                  0,
+                                  1,
+                                  &barrier,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr);
+    }
+
+    void RenderMeshInstances::uploadJointMatrices(StorageBuffer& storage_buffer, uint8_t frame_index)
+    {
+        for (uint32_t& joint_matrix_offset : m_joint_matrix_offsets)
+        {
+            joint_matrix_offset = s_mesh_instance_no_joint_matrices;
+        }
+
+        m_joint_matrices_dynamic_offset = 0;
+        if (m_skinned_instances.empty())
+            return;
+
+        // the passes bind the joint matrices with the range of MeshPerdrawcallVertexBlendingStorageBufferObject
+        const uint32_t max_joint_count = sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject) / sizeof(Matrix4x4);
+
+        // the whole bound range is reserved so that it never reaches past the ring of the frame
+        m_joint_matrices_dynamic_offset = roundUp(storage_buffer._global_upload_ringbuffers_end[frame_index],
+                                                  storage_buffer._min_storage_buffer_offset_alignment);
+        storage_buffer._global_upload_ringbuffers_end[frame_index] =
+            m_joint_matrices_dynamic_offset + sizeof(MeshPerdrawcallVertexBlendingStorageBufferObject);
+        assert(storage_buffer._global_upload_ringbuffers_end[frame_index] <=
+               (storage_buffer._global_upload_ringbuffers_begin[frame_index] +
+                storage_buffer._global_upload_ringbuffers_size[frame_index]));
+
+        Matrix4x4* joint_matrices = reinterpret_cast<Matrix4x4*>(
+            reinterpret_cast<uintptr_t>(storage_buffer._global_upload_ringbuffer_memory_pointer) +
+            m_joint_matrices_dynamic_offset);
+
+        std::fill(m_joint_palette_offsets.begin(), m_joint_palette_offsets.end(), s_mesh_instance_no_joint_matrices);
+
+        // the parts of a game object share its palette, which is copied once, the instances which do not fit are
+        // drawn in their bind pose
+        uint32_t joint_count = 0;
+        for (const SkinnedInstance& skinned_instance : m_skinned_instances)
+        {
+            uint32_t& palette_offset = m_joint_palette_offsets[skinned_instance.m_joint_palette];
+            if (palette_offset == s_mesh_instance_no_joint_matrices)
+            {
+                if (joint_count + skinned_instance.m_joint_count > max_joint_count)
+                    continue;
+
+                std::memcpy(joint_matrices + joint_count,
+                            skinned_instance.m_joint_matrices,
+                            sizeof(Matrix4x4) * skinned_instance.m_joint_count);
+                palette_offset = joint_count;
+                joint_count += skinned_instance.m_joint_count;
+            }
+            m_joint_matrix_offsets[skinned_instance.m_instance_index] = palette_offset;
+        }
+    }
+
+    void RenderMeshInstances::assignSkinnedVertices()
+    {
+        std::fill(m_skinned_first_vertices.begin(), m_skinned_first_vertices.end(), s_mesh_skinning_no_first_vertex);
+        m_pre_skinned_instances.clear();
+
+        if (!isPreSkinningEnabled())
+            return;
+
+        // each instance gets its own skinned vertices even if it shares its palette, the instances which do not fit
+        // are skinned in the vertex shader
+        uint32_t vertex_count = 0;
+        for (const SkinnedInstance& skinned_instance : m_skinned_instances)
+        {
+            const uint32_t joint_matrix_offset = m_joint_matrix_offsets[skinned_instance.m_instance_index];
+            if (joint_matrix_offset == s_mesh_instance_no_joint_matrices ||
+                !skinned_instance.m_mesh->enable_vertex_blending)
+                continue;
+
+            const uint32_t mesh_vertex_count = skinned_instance.m_mesh->mesh_vertex_count;
+            if (vertex_count + mesh_vertex_count > s_mesh_skinning_max_vertex_count)
+                continue;
+
+            PreSkinnedInstance pre_skinned_instance;
+            pre_skinned_instance.m_mesh                = skinned_instance.m_mesh;
+            pre_skinned_instance.m_instance_index      = skinned_instance.m_instance_index;
+            pre_skinned_instance.m_joint_matrix_offset = joint_matrix_offset;
+            pre_skinned_instance.m_first_vertex        = vertex_count;
+            m_pre_skinned_instances.push_back(pre_skinned_instance);
+
+            m_skinned_first_vertices[skinned_instance.m_instance_index] = vertex_count;
+            vertex_count += mesh_vertex_count;
+        }
+    }
+
+    void RenderMeshInstances::drawPreSkinnedNodes(RHICommandBuffer*                         command_buffer,
+                                                  StorageBuffer&                            storage_buffer,
+                                                  uint8_t                                   frame_index,
+                                                  RHIPipelineLayout*                        pipeline_layout,
+                                                  RHIDescriptorSet*                         global_descriptor_set,
+                                                  uint32_t                                  perframe_dynamic_offset,
+                                                  const std::vector<const RenderMeshNode*>& nodes,
+                                                  bool                                      is_shading_pass)
+    {
+        const uint32_t node_count = static_cast<uint32_t>(nodes.size());
+        for (uint32_t first_node = 0; first_node < node_count; first_node += s_mesh_per_drawcall_max_instance_count)
+        {
+            const uint32_t current_node_count =
+                std::min(node_count - first_node, s_mesh_per_drawcall_max_instance_count);
+
+            // the per drawcall storage buffers of the mesh passes share this layout
+            uint32_t perdrawcall_dynamic_offset = roundUp(storage_buffer._global_upload_ringbuffers_end[frame_index],
+                                                          storage_buffer._min_storage_buffer_offset_alignment);
+            storage_buffer._global_upload_ringbuffers_end[frame_index] =
+                perdrawcall_dynamic_offset + sizeof(MeshPerdrawcallStorageBufferObject);
+            assert(storage_buffer._global_upload_ringbuffers_end[frame_index] <=
+                   (storage_buffer._global_upload_ringbuffers_begin[frame_index] +
+                    storage_buffer._global_upload_ringbuffers_size[frame_index]));
+
+            MeshPerdrawcallStorageBufferObject& perdrawcall_storage_buffer_object =
+                (*reinterpret_cast<MeshPerdrawcallStorageBufferObject*>(
+                    reinterpret_cast<uintptr_t>(storage_buffer._global_upload_ringbuffer_memory_pointer) +
+                    perdrawcall_dynamic_offset));
+            for (uint32_t i = 0; i < current_node_count; ++i)
+            {
+                // the vertices are already skinned
+                perdrawcall_storage_buffer_object.mesh_instances[i].instance_index =
+                    nodes[first_node + i]->instance_index;
+                perdrawcall_storage_buffer_object.mesh_instances[i].joint_matrix_offset =
+                    s_mesh_instance_no_joint_matrices;
+            }
+
+            uint32_t dynamic_offsets[3] = {
+                perframe_dynamic_offset, perdrawcall_dynamic_offset, m_joint_matrices_dynamic_offset};
+            m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                            RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                            pipeline_layout,
+                                            0,
+                                            1,
+                                            &global_descriptor_set,
+                                            (sizeof(dynamic_offsets) / sizeof(dynamic_offsets[0])),
+                                            dynamic_offsets);
+
+            // one instance per draw, gl_InstanceIndex picks its reference in the per drawcall storage buffer
+            for (uint32_t i = 0; i < current_node_count; ++i)
+            {
+                const RenderMeshNode& node         = *nodes[first_node + i];
+                VulkanMesh&           mesh         = *node.ref_mesh;
+                const uint32_t        first_vertex = m_skinned_first_vertices[node.instance_index];
+
+                m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                                RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                pipeline_layout,
+                                                1,
+                                                1,
+                                                &mesh.mesh_vertex_blending_descriptor_set,
+                                                0,
+                                                NULL);
+
+                RHIBuffer*    vertex_buffers[] = {m_skinned_position_buffer,
+                                                  m_skinned_varying_buffer,
+                                                  mesh.mesh_vertex_varying_buffer};
+                RHIDeviceSize offsets[]        = {
+                    sizeof(MeshVertex::VulkanMeshVertexPostition) * first_vertex,
+                    sizeof(MeshVertex::VulkanMeshVertexVaryingEnableBlending) * first_vertex,
+                    0};
+                if (is_shading_pass)
+                {
+                    if (node.ref_material->material_descriptor_set)
+                    {
+                        m_rhi->cmdBindDescriptorSetsPFN(command_buffer,
+                                                        RHI_PIPELINE_BIND_POINT_GRAPHICS,
+                                                        pipeline_layout,
+                                                        2,
+                                                        1,
+                                                        &node.ref_material->material_descriptor_set,
+                                                        0,
+                                                        NULL);
+                    }
+                    m_rhi->cmdBindVertexBuffersPFN(command_buffer,
+                                                   0,
+                                                   (sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
+                                                   vertex_buffers,
+                                                   offsets);
+                }
+                else
+                {
+                    // the shadow passes only read the positions
+                    m_rhi->cmdBindVertexBuffersPFN(command_buffer, 0, 1, vertex_buffers, offsets);
+                }
+                m_rhi->cmdBindIndexBufferPFN(command_buffer, mesh.mesh_index_buffer, 0, mesh.mesh_index_type);
+
+                m_rhi->cmdDrawIndexedPFN(command_buffer, mesh.mesh_index_count, 1, 0, 0, i);
+            }
+        }
+    }
+} // namespace Piccolo
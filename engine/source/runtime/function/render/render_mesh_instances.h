@@ -0,0 +1,176 @@
+#pragma once
+
+#include "runtime/function/render/render_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Piccolo
+{
+    class RHI;
+    class RHIBuffer;
+    class RHICommandBuffer;
+    class RHIDescriptorSet;
+    class RHIDeviceMemory;
+    class RHIPipelineLayout;
+    class RenderResource;
+    class RenderScene;
+    struct StorageBuffer;
+
+    /// the static instances of one mesh with one material, drawn by one indirect draw
+    struct MeshInstanceBatch
+    {
+        VulkanMesh*        m_mesh {nullptr};
+        VulkanPBRMaterial* m_material {nullptr}; // nullptr for the bindless materials, the instances index theirs
+        // where the visible instances of the batch are written in the visible instance buffer
+        uint32_t m_first_instance {0};
+        uint32_t m_instance_count {0};
+    };
+
+    /// a skinned instance whose vertices are skinned once per frame by SkinningPass
+    struct PreSkinnedInstance
+    {
+        VulkanMesh* m_mesh {nullptr};
+        uint32_t    m_instance_index {0};
+        uint32_t    m_joint_matrix_offset {0};
+        // in the skinned vertex buffers
+        uint32_t m_first_vertex {0};
+    };
+
+    /// The render entities mirrored in a persistent device buffer read by all the mesh passes.
+    /// The instance of an entity is its index in the render scene entity array, only the instances changed since
+    /// the previous frame are copied to the device through the upload ring of the frame, the passes only upload the
+    /// indices of the instances they draw. The joint palettes of the skinned instances are written once per frame
+    /// and shared by the passes and by the parts of a game object.
+    /// For the gpu driven mesh path, the static instances are grouped in batches by material then by mesh, the
+    /// batches are rebuilt when an entity is added or removed or changes its mesh or material. With the bindless
+    /// materials the instances carry their material index and are grouped by mesh only, the materials past the
+    /// bindless capacity keep batches of their own. The skinned instances are left to the cpu path.
+    /// The instance buffer doubles when there are more entities than it holds, the gpu driven path stops at
+    /// s_mesh_instance_max_count and the cpu path draws the entities past it.
+    /// With pre-skinning, the skinned instances are skinned in a compute pass into shared vertex buffers, the
+    /// mesh passes then draw them like static meshes instead of skinning them again in their vertex shaders.
+    class RenderMeshInstances
+    {
+    public:
+        void initialize(std::shared_ptr<RHI> rhi);
+        void clear();
+
+        bool isInitialized() const { return m_instance_buffer != nullptr; }
+        /// whether the device can run the gpu driven mesh path
+        bool isGpuDrivenSupported() const { return m_visible_instance_buffer != nullptr; }
+        /// false while there are more entities than s_mesh_instance_max_count, the cpu path draws everything then
+        bool isGpuDrivenEnabled() const { return isGpuDrivenSupported() && m_is_within_capacity; }
+
+        /// mirror the entities changed since the previous update on the cpu
+        void update(RenderScene& render_scene, RenderResource& render_resource);
+        /// copy the changed instances to the device buffer and the joint matrices of the frame to the upload ring,
+        /// to record outside of a render pass before any pass reads them
+        void recordUpload(RHICommandBuffer* command_buffer, StorageBuffer& storage_buffer, uint8_t frame_index);
+
+        uint32_t getInstanceCount() const { return static_cast<uint32_t>(m_instances.size()); }
+        /// changes when the instance buffer is replaced by a larger one, the passes then write it again in their
+        /// descriptor sets from preparePassData, no frame is in flight at that point
+        uint32_t getInstanceBufferVersion() const { return m_instance_buffer_version; }
+
+        /// first joint matrix of the instance from getJointMatricesDynamicOffset, s_mesh_instance_no_joint_matrices
+        /// if it is not skinned
+        uint32_t getJointMatrixOffset(uint32_t instance_index) const { return m_joint_matrix_offsets[instance_index]; }
+        /// where the joint matrices of the frame start in the upload ring
+        uint32_t getJointMatricesDynamicOffset() const { return m_joint_matrices_dynamic_offset; }
+
+        const std::vector<MeshInstanceBatch>& getBatches() const { return m_batches; }
+
+        /// create the skinned vertex buffers written by SkinningPass
+        void initializePreSkinning();
+        bool isPreSkinningEnabled() const { return m_skinned_position_buffer != nullptr; }
+        /// whether the mesh passes draw the instance from the skinned vertex buffers, valid after recordUpload
+        bool isPreSkinned(uint32_t instance_index) const
+        {
+            return m_skinned_first_vertices[instance_index] != s_mesh_skinning_no_first_vertex;
+        }
+        const std::vector<PreSkinnedInstance>& getPreSkinnedInstances() const { return m_pre_skinned_instances; }
+
+        RHIBuffer* getSkinnedPositionBuffer() const { return m_skinned_position_buffer; }
+        RHIBuffer* getSkinnedVaryingBuffer() const { return m_skinned_varying_buffer; }
+
+        /// Draw the pre-skinned nodes one instance at a time from their skinned vertices. The pass has bound its
+        /// pipeline, whose set 0 takes the perframe, per drawcall and joint matrix dynamic offsets like the mesh
+        /// passes. The shading passes also bind the normals, tangents and texcoords, and the material unless it is
+        /// bindless.
+        void drawPreSkinnedNodes(RHICommandBuffer*                         command_buffer,
+                                 StorageBuffer&                            storage_buffer,
+                                 uint8_t                                   frame_index,
+                                 RHIPipelineLayout*                        pipeline_layout,
+                                 RHIDescriptorSet*                         global_descriptor_set,
+                                 uint32_t                                  perframe_dynamic_offset,
+                                 const std::vector<const RenderMeshNode*>& nodes,
+                                 bool                                      is_shading_pass);
+
+        RHIBuffer* getInstanceBuffer() const { return m_instance_buffer; }
+        RHIBuffer* getVisibleInstanceBuffer() const { return m_visible_instance_buffer; }
+
+    private:
+        struct InstanceKey
+        {
+            size_t m_mesh_asset_id {0};
+            size_t m_material_asset_id {0};
+            bool   m_enable_vertex_blending {false};
+
+            bool operator==(const InstanceKey& other) const
+            {
+                return m_mesh_asset_id == other.m_mesh_asset_id &&
+                       m_material_asset_id == other.m_material_asset_id &&
+                       m_enable_vertex_blending == other.m_enable_vertex_blending;
+            }
+        };
+
+        struct SkinnedInstance
+        {
+            uint32_t         m_instance_index {0};
+            uint32_t         m_joint_palette {0};
+            VulkanMesh*      m_mesh {nullptr};
+            const Matrix4x4* m_joint_matrices {nullptr};
+            uint32_t         m_joint_count {0};
+        };
+
+        void growInstanceBuffer(uint32_t min_capacity);
+        void rebuildBatches(RenderScene& render_scene, RenderResource& render_resource);
+        void uploadJointMatrices(StorageBuffer& storage_buffer, uint8_t frame_index);
+        void assignSkinnedVertices();
+
+        std::shared_ptr<RHI> m_rhi;
+
+        RHIBuffer*       m_instance_buffer {nullptr};
+        RHIDeviceMemory* m_instance_buffer_memory {nullptr};
+        uint32_t         m_instance_capacity {s_mesh_instance_max_count};
+        uint32_t         m_instance_buffer_version {0};
+        RHIBuffer*       m_visible_instance_buffer {nullptr};
+        RHIDeviceMemory* m_visible_instance_buffer_memory {nullptr};
+
+        std::vector<VulkanMeshInstanceData> m_instances;
+        std::vector<InstanceKey>            m_instance_keys;
+        std::vector<MeshInstanceBatch>      m_batches;
+        bool                                m_is_within_capacity {true};
+        uint32_t                            m_bindless_fallback_material_count {0};
+
+        // instances not copied to the device buffer yet
+        std::vector<uint32_t>      m_dirty_instances;
+        std::vector<RHIBufferCopy> m_upload_regions;
+
+        // the joint matrices change with every animation update, they are gathered again each frame
+        std::vector<SkinnedInstance> m_skinned_instances;
+        std::vector<uint32_t>        m_joint_matrix_offsets;
+        std::vector<uint32_t>        m_joint_palette_offsets; // by joint palette of the render scene
+        uint32_t                     m_joint_matrices_dynamic_offset {0};
+
+        RHIBuffer*                      m_skinned_position_buffer {nullptr};
+        RHIDeviceMemory*                m_skinned_position_buffer_memory {nullptr};
+        RHIBuffer*                      m_skinned_varying_buffer {nullptr};
+        RHIDeviceMemory*                m_skinned_varying_buffer_memory {nullptr};
+        std::vector<PreSkinnedInstance> m_pre_skinned_instances;
+        std::vector<uint32_t>           m_skinned_first_vertices;
+    };
+} // namespace Piccolo
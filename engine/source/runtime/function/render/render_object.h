@@ -22,20 +22,6 @@ namespace Piccolo
         std::string m_skeleton_binding_file;
     };
 
-    REFLECTION_TYPE(SkeletonAnimationResultTransform)
-    STRUCT(SkeletonAnimationResultTransform, WhiteListFields)
-    {
-        REFLECTION_BODY(SkeletonAnimationResultTransform)
-        Matrix4x4 m_matrix;
-    };
-
-    REFLECTION_TYPE(SkeletonAnimationResult)
-    STRUCT(SkeletonAnimationResult, Fields)
-    {
-        REFLECTION_BODY(SkeletonAnimationResult)
-        std::vector<SkeletonAnimationResultTransform> m_transforms;
-    };
-
     REFLECTION_TYPE(GameObjectMaterialDesc)
     STRUCT(GameObjectMaterialDesc, Fields)
     {
@@ -64,7 +50,6 @@ namespace Piccolo
         GameObjectTransformDesc m_transform_desc;
         bool                    m_with_animation {false};
         SkeletonBindingDesc     m_skeleton_binding_desc;
-        SkeletonAnimationResult m_skeleton_animation_result;
     };
 
     constexpr size_t k_invalid_part_id = std::numeric_limits<size_t>::max();
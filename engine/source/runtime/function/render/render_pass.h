@@ -49,6 +49,7 @@ namespace Piccolo
         std::vector<RenderMeshNode>*              p_point_lights_visible_mesh_nodes {nullptr};
         std::vector<RenderMeshNode>*              p_main_camera_visible_mesh_nodes {nullptr};
         RenderAxisNode*                           p_axis_node {nullptr};
+        std::vector<RenderMeshNode>*              p_pick_candidate_mesh_nodes {nullptr};
     };
 
     class RenderPass : public RenderPassBase
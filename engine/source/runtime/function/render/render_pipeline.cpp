@@ -11,6 +11,7 @@
 #include "runtime/function/render/passes/ui_pass.h"
 #include "runtime/function/render/passes/particle_pass.h"
 #include "runtime/function/render/passes/scan_pass.h"
+#include "runtime/function/render/passes/skinning_pass.h"
 
 #include "runtime/function/render/debugdraw/debug_draw_manager.h"
 
@@ -51,6 +52,13 @@ namespace Piccolo
         m_point_light_shadow_pass->initialize(nullptr);
         m_directional_light_pass->initialize(nullptr);
 
+        if (init_info.enable_compute_skinning)
+        {
+            m_skinning_pass = std::make_shared<SkinningPass>();
+            m_skinning_pass->setCommonInfo(pass_common_info);
+            m_skinning_pass->initialize(nullptr);
+        }
+
         std::shared_ptr<MainCameraPass> main_camera_pass = std::static_pointer_cast<MainCameraPass>(m_main_camera_pass);
         std::shared_ptr<RenderPass>     _main_camera_pass = std::static_pointer_cast<RenderPass>(m_main_camera_pass);
         std::shared_ptr<ParticlePass> particle_pass = std::static_pointer_cast<ParticlePass>(m_particle_pass);
@@ -123,6 +131,8 @@ namespace Piccolo
             _main_camera_pass->getFramebufferImageViews()[_main_camera_pass_post_process_buffer_odd];
         m_fxaa_pass->initialize(&fxaa_init_info);
 
+        // the main camera pipelines were compiled while the passes above initialized
+        main_camera_pass->waitForPipelines();
     }
 
     void RenderPipeline::forwardRender(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderResourceBase> render_resource)
@@ -143,6 +153,22 @@ namespace Piccolo
             return;
         }
 
+        vulkan_resource->recycleMaterialDescriptorSets(rhi, vulkan_rhi->getCurrentFrameIndex());
+
+        // the mesh passes below read the instances, the joint matrices and the materials of the frame
+        vulkan_resource->m_mesh_instances.recordUpload(vulkan_rhi->getCurrentCommandBuffer(),
+                                                       vulkan_resource->m_global_render_resource._storage_buffer,
+                                                       vulkan_rhi->getCurrentFrameIndex());
+        vulkan_resource->m_bindless_materials.recordUpload(vulkan_rhi->getCurrentCommandBuffer(),
+                                                           vulkan_resource->m_global_render_resource._storage_buffer,
+                                                           vulkan_rhi->getCurrentFrameIndex());
+
+        // the skinned vertices of the frame, read by all the mesh passes
+        if (m_skinning_pass)
+        {
+            static_cast<SkinningPass*>(m_skinning_pass.get())->draw();
+        }
+
         static_cast<DirectionalLightShadowPass*>(m_directional_light_pass.get())->draw();
 
         static_cast<PointLightShadowPass*>(m_point_light_shadow_pass.get())->draw();
@@ -197,6 +223,22 @@ namespace Piccolo
             return;
         }
 
+        vulkan_resource->recycleMaterialDescriptorSets(rhi, vulkan_rhi->getCurrentFrameIndex());
+
+        // the mesh passes below read the instances, the joint matrices and the materials of the frame
+        vulkan_resource->m_mesh_instances.recordUpload(vulkan_rhi->getCurrentCommandBuffer(),
+                                                       vulkan_resource->m_global_render_resource._storage_buffer,
+                                                       vulkan_rhi->getCurrentFrameIndex());
+        vulkan_resource->m_bindless_materials.recordUpload(vulkan_rhi->getCurrentCommandBuffer(),
+                                                           vulkan_resource->m_global_render_resource._storage_buffer,
+                                                           vulkan_rhi->getCurrentFrameIndex());
+
+        // the skinned vertices of the frame, read by all the mesh passes
+        if (m_skinning_pass)
+        {
+            static_cast<SkinningPass*>(m_skinning_pass.get())->draw();
+        }
+
         static_cast<DirectionalLightShadowPass*>(m_directional_light_pass.get())->draw();
 
         static_cast<PointLightShadowPass*>(m_point_light_shadow_pass.get())->draw();
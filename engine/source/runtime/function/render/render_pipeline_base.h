@@ -15,6 +15,7 @@ namespace Piccolo
     struct RenderPipelineInitInfo
     {
         bool                                enable_fxaa {false};
+        bool                                enable_compute_skinning {false};
         std::shared_ptr<RenderResourceBase> render_resource;
     };
 
@@ -50,6 +51,8 @@ namespace Piccolo
         std::shared_ptr<RenderPassBase> m_combine_ui_pass;
         std::shared_ptr<RenderPassBase> m_pick_pass;
         std::shared_ptr<RenderPassBase> m_particle_pass;
+        // only created with compute skinning enabled
+        std::shared_ptr<RenderPassBase> m_skinning_pass;
 
     };
 } // namespace Piccolo
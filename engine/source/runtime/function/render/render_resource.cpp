@@ -17,6 +17,12 @@ namespace Piccolo
 {
     void RenderResource::clear()
     {
+        m_streamed_materials.clear();
+        m_released_material_descriptor_sets.clear();
+        m_retired_material_descriptor_sets.clear();
+        m_texture_streamer.reset();
+        m_mesh_instances.clear();
+        m_bindless_materials.clear();
     }
 
     void RenderResource::uploadGlobalRenderResource(std::shared_ptr<RHI> rhi, LevelResourceDesc level_resource_desc)
@@ -24,6 +30,10 @@ namespace Piccolo
         // create and map global storage buffer
         createAndMapStorageBuffer(rhi);
 
+        // the passes reference the instance buffers in their descriptor sets
+        m_mesh_instances.initialize(rhi);
+        m_bindless_materials.initialize(rhi);
+
         // sky box irradiance
         SkyBoxIrradianceMap skybox_irradiance_map        = level_resource_desc.m_ibl_resource_desc.m_skybox_irradiance_map;
         std::shared_ptr<TextureData> irradiace_pos_x_map = loadTextureHDR(skybox_irradiance_map.m_positive_x_map);
@@ -111,6 +121,86 @@ namespace Piccolo
         getOrCreateVulkanMaterial(rhi, render_entity, material_data);
     }
 
+    void RenderResource::streamGameObjectMaterial(std::shared_ptr<RHI>      rhi,
+                                                  RenderEntity              render_entity,
+                                                  const MaterialSourceDesc& material_source)
+    {
+        size_t assetid = render_entity.m_material_asset_id;
+        if (m_vulkan_pbr_materials.find(assetid) != m_vulkan_pbr_materials.end())
+            return;
+
+        TextureStreamer& texture_streamer = getOrCreateTextureStreamer(rhi);
+
+        StreamedMaterial streamed_material;
+        streamed_material.m_material_asset_id = assetid;
+        streamed_material.m_textures          = {
+            texture_streamer.requestTexture(material_source.m_base_color_file, true),
+            texture_streamer.requestTexture(material_source.m_metallic_roughness_file, false),
+            texture_streamer.requestTexture(material_source.m_normal_file, false),
+            texture_streamer.requestTexture(material_source.m_occlusion_file, false),
+            texture_streamer.requestTexture(material_source.m_emissive_file, false)};
+
+        VulkanPBRMaterial& now_material = m_vulkan_pbr_materials[assetid];
+        createMaterialUniformBuffer(rhi, render_entity, now_material);
+        createStreamedMaterialDescriptorSet(rhi, streamed_material);
+
+        // textures shared with the materials streamed before may already be resident
+        if (!isStreamedMaterialSettled(streamed_material))
+        {
+            m_streamed_materials.push_back(streamed_material);
+        }
+    }
+
+    void RenderResource::updateStreamedResources(std::shared_ptr<RHI> rhi)
+    {
+        if (!m_texture_streamer || !m_texture_streamer->tick())
+            return;
+
+        // a material moves to a new descriptor set once all its textures settled, the frames in flight keep
+        // sampling the placeholders through the previous one
+        size_t pending_count = 0;
+        for (const StreamedMaterial& streamed_material : m_streamed_materials)
+        {
+            if (isStreamedMaterialSettled(streamed_material))
+            {
+                createStreamedMaterialDescriptorSet(rhi, streamed_material);
+            }
+            else
+            {
+                m_streamed_materials[pending_count++] = streamed_material;
+            }
+        }
+        m_streamed_materials.resize(pending_count);
+    }
+
+    void RenderResource::recycleMaterialDescriptorSets(std::shared_ptr<RHI> rhi, uint8_t frame_index)
+    {
+        if (m_retired_material_descriptor_sets.empty())
+        {
+            m_retired_material_descriptor_sets.resize(rhi->getMaxFramesInFlight());
+        }
+
+        // the frames recorded before this one completed and no longer bind the sets retired at its previous use
+        std::vector<RHIDescriptorSet*>& retired_descriptor_sets = m_retired_material_descriptor_sets[frame_index];
+        for (RHIDescriptorSet*& descriptor_set : retired_descriptor_sets)
+        {
+            rhi->freeDescriptorSet(rhi->getDescriptorPoor(), descriptor_set);
+        }
+        retired_descriptor_sets.swap(m_released_material_descriptor_sets);
+        m_released_material_descriptor_sets.clear();
+    }
+
+    void RenderResource::updateMeshInstances(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderScene> render_scene)
+    {
+        if (!m_mesh_instances.isInitialized())
+        {
+            render_scene->clearDirtyEntities();
+            return;
+        }
+
+        m_mesh_instances.update(*render_scene, *this);
+    }
+
     void RenderResource::updatePerFrameBuffer(std::shared_ptr<RenderScene>  render_scene,
         std::shared_ptr<RenderCamera> camera)
     {
@@ -305,6 +395,7 @@ namespace Piccolo
                     reinterpret_cast<MeshVertexBindingDataDefinition*>(mesh_data.m_skeleton_binding_buffer->m_data);
                 updateMeshData(rhi,
                                true,
+                               mesh_data.m_static_mesh_data.m_index_type,
                                index_buffer_size,
                                index_buffer_data,
                                vertex_buffer_size,
@@ -317,6 +408,7 @@ namespace Piccolo
             {
                 updateMeshData(rhi,
                                false,
+                               mesh_data.m_static_mesh_data.m_index_type,
                                index_buffer_size,
                                index_buffer_data,
                                vertex_buffer_size,
@@ -334,8 +426,6 @@ namespace Piccolo
         RenderEntity         entity,
         RenderMaterialData   material_data)
     {
-        VulkanRHI* vulkan_context = static_cast<VulkanRHI*>(rhi.get());
-
         size_t assetid = entity.m_material_asset_id;
 
         auto it = m_vulkan_pbr_materials.find(assetid);
@@ -413,70 +503,7 @@ namespace Piccolo
 
             VulkanPBRMaterial& now_material = res.first->second;
 
-            // similiarly to the vertex/index buffer, we should allocate the uniform
-            // buffer in DEVICE_LOCAL memory and use the temp stage buffer to copy the
-            // data
-            {
-                // temporary staging buffer
-
-                RHIDeviceSize buffer_size = sizeof(MeshPerMaterialUniformBufferObject);
-
-                RHIBuffer* inefficient_staging_buffer = RHI_NULL_HANDLE;
-                RHIDeviceMemory* inefficient_staging_buffer_memory = RHI_NULL_HANDLE;
-                rhi->createBuffer(
-                    buffer_size,
-                    RHI_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                    RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                    inefficient_staging_buffer,
-                    inefficient_staging_buffer_memory);
-                // RHI_BUFFER_USAGE_TRANSFER_SRC_BIT: buffer can be used as source in a
-                // memory transfer operation
-
-                void* staging_buffer_data = nullptr;
-                rhi->mapMemory(
-                    inefficient_staging_buffer_memory,
-                    0,
-                    buffer_size,
-                    0,
-                    &staging_buffer_data);
-                
-                MeshPerMaterialUniformBufferObject& material_uniform_buffer_info =
-                    (*static_cast<MeshPerMaterialUniformBufferObject*>(staging_buffer_data));
-                material_uniform_buffer_info.is_blend = entity.m_blend;
-                material_uniform_buffer_info.is_double_sided = entity.m_double_sided;
-                material_uniform_buffer_info.baseColorFactor = entity.m_base_color_factor;
-                material_uniform_buffer_info.metallicFactor = entity.m_metallic_factor;
-                material_uniform_buffer_info.roughnessFactor = entity.m_roughness_factor;
-                material_uniform_buffer_info.normalScale = entity.m_normal_scale;
-                material_uniform_buffer_info.occlusionStrength = entity.m_occlusion_strength;
-                material_uniform_buffer_info.emissiveFactor = entity.m_emissive_factor;
-
-                rhi->unmapMemory(inefficient_staging_buffer_memory);
-
-                // use the vmaAllocator to allocate asset uniform buffer
-                RHIBufferCreateInfo bufferInfo = { RHI_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-                bufferInfo.size = buffer_size;
-                bufferInfo.usage = RHI_BUFFER_USAGE_UNIFORM_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT;
-
-                VmaAllocationCreateInfo allocInfo = {};
-                allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-
-                rhi->createBufferWithAlignmentVMA(
-                    vulkan_context->m_assets_allocator,
-                    &bufferInfo,
-                    &allocInfo,
-                    m_global_render_resource._storage_buffer._min_uniform_buffer_offset_alignment,
-                    now_material.material_uniform_buffer,
-                    &now_material.material_uniform_buffer_allocation,
-                    NULL);
-
-                // use the data from staging buffer
-                rhi->copyBuffer(inefficient_staging_buffer, now_material.material_uniform_buffer, 0, 0, buffer_size);
-
-                // release staging buffer
-                rhi->destroyBuffer(inefficient_staging_buffer);
-                rhi->freeMemory(inefficient_staging_buffer_memory);
-            }
+            createMaterialUniformBuffer(rhi, entity, now_material);
 
             TextureDataToUpdate update_texture_data;
             update_texture_data.base_color_image_pixels         = base_color_image_pixels;
@@ -503,25 +530,6 @@ namespace Piccolo
 
             updateTextureImageData(rhi, update_texture_data);
 
-            RHIDescriptorSetAllocateInfo material_descriptor_set_alloc_info;
-            material_descriptor_set_alloc_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-            material_descriptor_set_alloc_info.pNext = NULL;
-            material_descriptor_set_alloc_info.descriptorPool = vulkan_context->m_descriptor_pool;
-            material_descriptor_set_alloc_info.descriptorSetCount = 1;
-            material_descriptor_set_alloc_info.pSetLayouts        = m_material_descriptor_set_layout;
-
-            if (RHI_SUCCESS != rhi->allocateDescriptorSets(
-                &material_descriptor_set_alloc_info,
-                now_material.material_descriptor_set))
-            {
-                throw std::runtime_error("allocate material descriptor set");
-            }
-
-            RHIDescriptorBufferInfo material_uniform_buffer_info = {};
-            material_uniform_buffer_info.offset = 0;
-            material_uniform_buffer_info.range = sizeof(MeshPerMaterialUniformBufferObject);
-            material_uniform_buffer_info.buffer = now_material.material_uniform_buffer;
-
             RHIDescriptorImageInfo base_color_image_info = {};
             base_color_image_info.imageLayout = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
             base_color_image_info.imageView = now_material.base_color_image_view;
@@ -550,50 +558,215 @@ namespace Piccolo
             emissive_image_info.imageView = now_material.emissive_image_view;
             emissive_image_info.sampler = rhi->getOrCreateMipmapSampler(emissive_image_width, emissive_image_height);
 
-            RHIWriteDescriptorSet mesh_descriptor_writes_info[6];
+            RHIDescriptorImageInfo texture_image_infos[5] = {base_color_image_info,
+                                                             metallic_roughness_image_info,
+                                                             normal_roughness_image_info,
+                                                             occlusion_image_info,
+                                                             emissive_image_info};
+            createMaterialDescriptorSet(rhi, now_material, texture_image_infos);
 
-            mesh_descriptor_writes_info[0].sType = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            mesh_descriptor_writes_info[0].pNext = NULL;
-            mesh_descriptor_writes_info[0].dstSet = now_material.material_descriptor_set;
-            mesh_descriptor_writes_info[0].dstBinding = 0;
-            mesh_descriptor_writes_info[0].dstArrayElement = 0;
-            mesh_descriptor_writes_info[0].descriptorType = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-            mesh_descriptor_writes_info[0].descriptorCount = 1;
-            mesh_descriptor_writes_info[0].pBufferInfo = &material_uniform_buffer_info;
+            return now_material;
+        }
+    }
 
-            mesh_descriptor_writes_info[1].sType = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            mesh_descriptor_writes_info[1].pNext = NULL;
-            mesh_descriptor_writes_info[1].dstSet = now_material.material_descriptor_set;
-            mesh_descriptor_writes_info[1].dstBinding = 1;
-            mesh_descriptor_writes_info[1].dstArrayElement = 0;
-            mesh_descriptor_writes_info[1].descriptorType = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-            mesh_descriptor_writes_info[1].descriptorCount = 1;
-            mesh_descriptor_writes_info[1].pImageInfo = &base_color_image_info;
+    TextureStreamer& RenderResource::getOrCreateTextureStreamer(std::shared_ptr<RHI> rhi)
+    {
+        if (!m_texture_streamer)
+        {
+            m_texture_streamer = std::make_unique<TextureStreamer>(rhi);
+        }
+        return *m_texture_streamer;
+    }
+
+    bool RenderResource::isStreamedMaterialSettled(const StreamedMaterial& streamed_material) const
+    {
+        for (StreamedTextureHandle texture : streamed_material.m_textures)
+        {
+            if (!m_texture_streamer->isSettled(texture))
+                return false;
+        }
+        return true;
+    }
+
+    void RenderResource::createStreamedMaterialDescriptorSet(std::shared_ptr<RHI>    rhi,
+                                                             const StreamedMaterial& streamed_material)
+    {
+        VulkanPBRMaterial& now_material = m_vulkan_pbr_materials[streamed_material.m_material_asset_id];
+
+        const TextureStreamer::Texture& base_color = m_texture_streamer->getTexture(streamed_material.m_textures[0]);
+        now_material.base_color_texture_image    = base_color.m_image;
+        now_material.base_color_image_view       = base_color.m_image_view;
+        now_material.base_color_image_allocation = base_color.m_image_allocation;
+
+        const TextureStreamer::Texture& metallic_roughness =
+            m_texture_streamer->getTexture(streamed_material.m_textures[1]);
+        now_material.metallic_roughness_texture_image    = metallic_roughness.m_image;
+        now_material.metallic_roughness_image_view       = metallic_roughness.m_image_view;
+        now_material.metallic_roughness_image_allocation = metallic_roughness.m_image_allocation;
+
+        const TextureStreamer::Texture& normal = m_texture_streamer->getTexture(streamed_material.m_textures[2]);
+        now_material.normal_texture_image    = normal.m_image;
+        now_material.normal_image_view       = normal.m_image_view;
+        now_material.normal_image_allocation = normal.m_image_allocation;
+
+        const TextureStreamer::Texture& occlusion = m_texture_streamer->getTexture(streamed_material.m_textures[3]);
+        now_material.occlusion_texture_image    = occlusion.m_image;
+        now_material.occlusion_image_view       = occlusion.m_image_view;
+        now_material.occlusion_image_allocation = occlusion.m_image_allocation;
+
+        const TextureStreamer::Texture& emissive = m_texture_streamer->getTexture(streamed_material.m_textures[4]);
+        now_material.emissive_texture_image    = emissive.m_image;
+        now_material.emissive_image_view       = emissive.m_image_view;
+        now_material.emissive_image_allocation = emissive.m_image_allocation;
+
+        RHIDescriptorImageInfo texture_image_infos[5] = {};
+        for (size_t texture_index = 0; texture_index < streamed_material.m_textures.size(); ++texture_index)
+        {
+            const TextureStreamer::Texture& texture =
+                m_texture_streamer->getTexture(streamed_material.m_textures[texture_index]);
 
-            mesh_descriptor_writes_info[2] = mesh_descriptor_writes_info[1];
-            mesh_descriptor_writes_info[2].dstBinding = 2;
-            mesh_descriptor_writes_info[2].pImageInfo = &metallic_roughness_image_info;
+            RHIDescriptorImageInfo& image_info = texture_image_infos[texture_index];
+            image_info.imageLayout             = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            image_info.imageView               = texture.m_image_view;
+            image_info.sampler                 = rhi->getOrCreateMipmapSampler(texture.m_width, texture.m_height);
+        }
+        createMaterialDescriptorSet(rhi, now_material, texture_image_infos);
+    }
 
-            mesh_descriptor_writes_info[3] = mesh_descriptor_writes_info[1];
-            mesh_descriptor_writes_info[3].dstBinding = 3;
-            mesh_descriptor_writes_info[3].pImageInfo = &normal_roughness_image_info;
+    void RenderResource::createMaterialUniformBuffer(std::shared_ptr<RHI> rhi,
+                                                     const RenderEntity&  entity,
+                                                     VulkanPBRMaterial&   now_material)
+    {
+        MeshPerMaterialUniformBufferObject material_factors;
+        material_factors.is_blend          = entity.m_blend;
+        material_factors.is_double_sided   = entity.m_double_sided;
+        material_factors.baseColorFactor   = entity.m_base_color_factor;
+        material_factors.metallicFactor    = entity.m_metallic_factor;
+        material_factors.roughnessFactor   = entity.m_roughness_factor;
+        material_factors.normalScale       = entity.m_normal_scale;
+        material_factors.occlusionStrength = entity.m_occlusion_strength;
+        material_factors.emissiveFactor    = entity.m_emissive_factor;
+
+        // the factors are a record of the bindless material buffer, the material has no uniform buffer of its own
+        // unless the buffer is full
+        if (m_bindless_materials.isEnabled() &&
+            m_bindless_materials.updateMaterialFactors(now_material, material_factors))
+            return;
+
+        createMaterialUniformBuffer(rhi, material_factors, now_material);
+    }
 
-            mesh_descriptor_writes_info[4] = mesh_descriptor_writes_info[1];
-            mesh_descriptor_writes_info[4].dstBinding = 4;
-            mesh_descriptor_writes_info[4].pImageInfo = &occlusion_image_info;
+    void RenderResource::createMaterialUniformBuffer(std::shared_ptr<RHI>                      rhi,
+                                                     const MeshPerMaterialUniformBufferObject& material_factors,
+                                                     VulkanPBRMaterial&                        now_material)
+    {
+        VulkanRHI* vulkan_context = static_cast<VulkanRHI*>(rhi.get());
 
-            mesh_descriptor_writes_info[5] = mesh_descriptor_writes_info[1];
-            mesh_descriptor_writes_info[5].dstBinding = 5;
-            mesh_descriptor_writes_info[5].pImageInfo = &emissive_image_info;
+        // the factors are written once through a persistent mapping, a copy from a staging buffer would wait on the
+        // queue for every material streamed in
+        RHIDeviceSize buffer_size = sizeof(MeshPerMaterialUniformBufferObject);
 
-            rhi->updateDescriptorSets(6, mesh_descriptor_writes_info, 0, nullptr);
+        RHIBufferCreateInfo bufferInfo = { RHI_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+        bufferInfo.size = buffer_size;
+        bufferInfo.usage = RHI_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
 
-            return now_material;
+        VmaAllocationCreateInfo allocInfo = {};
+        allocInfo.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+        allocInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+        VmaAllocationInfo allocation_info = {};
+        rhi->createBufferWithAlignmentVMA(
+            vulkan_context->m_assets_allocator,
+            &bufferInfo,
+            &allocInfo,
+            m_global_render_resource._storage_buffer._min_uniform_buffer_offset_alignment,
+            now_material.material_uniform_buffer,
+            &now_material.material_uniform_buffer_allocation,
+            &allocation_info);
+
+        (*static_cast<MeshPerMaterialUniformBufferObject*>(allocation_info.pMappedData)) = material_factors;
+        vmaFlushAllocation(vulkan_context->m_assets_allocator,
+                           now_material.material_uniform_buffer_allocation,
+                           0,
+                           VK_WHOLE_SIZE);
+    }
+
+    void RenderResource::createMaterialDescriptorSet(std::shared_ptr<RHI>    rhi,
+                                                     VulkanPBRMaterial&      now_material,
+                                                     RHIDescriptorImageInfo* texture_image_infos)
+    {
+        // the textures are slots of the bindless texture array, the material has no descriptor set of its own
+        // unless the array can't hold them, it then leaves the bindless set with its factors
+        if (m_bindless_materials.isBindless(now_material))
+        {
+            if (m_bindless_materials.updateMaterialTextures(now_material, texture_image_infos))
+                return;
+
+            createMaterialUniformBuffer(rhi, m_bindless_materials.releaseMaterial(now_material), now_material);
+        }
+
+        VulkanRHI* vulkan_context = static_cast<VulkanRHI*>(rhi.get());
+
+        // a streamed material replaces its set, the frames in flight may still bind the previous one
+        if (now_material.material_descriptor_set != nullptr)
+        {
+            m_released_material_descriptor_sets.push_back(now_material.material_descriptor_set);
+            now_material.material_descriptor_set = nullptr;
+        }
+
+        RHIDescriptorSetAllocateInfo material_descriptor_set_alloc_info;
+        material_descriptor_set_alloc_info.sType = RHI_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        material_descriptor_set_alloc_info.pNext = NULL;
+        material_descriptor_set_alloc_info.descriptorPool = vulkan_context->m_descriptor_pool;
+        material_descriptor_set_alloc_info.descriptorSetCount = 1;
+        material_descriptor_set_alloc_info.pSetLayouts        = m_material_descriptor_set_layout;
+
+        if (RHI_SUCCESS != rhi->allocateDescriptorSets(
+            &material_descriptor_set_alloc_info,
+            now_material.material_descriptor_set))
+        {
+            throw std::runtime_error("allocate material descriptor set");
+        }
+
+        RHIDescriptorBufferInfo material_uniform_buffer_info = {};
+        material_uniform_buffer_info.offset = 0;
+        material_uniform_buffer_info.range = sizeof(MeshPerMaterialUniformBufferObject);
+        material_uniform_buffer_info.buffer = now_material.material_uniform_buffer;
+
+        RHIWriteDescriptorSet mesh_descriptor_writes_info[6];
+
+        mesh_descriptor_writes_info[0].sType = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        mesh_descriptor_writes_info[0].pNext = NULL;
+        mesh_descriptor_writes_info[0].dstSet = now_material.material_descriptor_set;
+        mesh_descriptor_writes_info[0].dstBinding = 0;
+        mesh_descriptor_writes_info[0].dstArrayElement = 0;
+        mesh_descriptor_writes_info[0].descriptorType = RHI_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        mesh_descriptor_writes_info[0].descriptorCount = 1;
+        mesh_descriptor_writes_info[0].pBufferInfo = &material_uniform_buffer_info;
+
+        mesh_descriptor_writes_info[1].sType = RHI_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        mesh_descriptor_writes_info[1].pNext = NULL;
+        mesh_descriptor_writes_info[1].dstSet = now_material.material_descriptor_set;
+        mesh_descriptor_writes_info[1].dstBinding = 1;
+        mesh_descriptor_writes_info[1].dstArrayElement = 0;
+        mesh_descriptor_writes_info[1].descriptorType = RHI_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        mesh_descriptor_writes_info[1].descriptorCount = 1;
+        mesh_descriptor_writes_info[1].pImageInfo = &texture_image_infos[0];
+
+        // base color, metallic roughness, normal, occlusion and emissive follow the uniform buffer
+        for (uint32_t texture_index = 1; texture_index < 5; ++texture_index)
+        {
+            mesh_descriptor_writes_info[texture_index + 1]            = mesh_descriptor_writes_info[1];
+            mesh_descriptor_writes_info[texture_index + 1].dstBinding = texture_index + 1;
+            mesh_descriptor_writes_info[texture_index + 1].pImageInfo = &texture_image_infos[texture_index];
         }
+
+        rhi->updateDescriptorSets(6, mesh_descriptor_writes_info, 0, nullptr);
     }
 
     void RenderResource::updateMeshData(std::shared_ptr<RHI>                   rhi,
                                         bool                                   enable_vertex_blending,
+                                        RHIIndexType                           index_type,
                                         uint32_t                               index_buffer_size,
                                         void*                                  index_buffer_data,
                                         uint32_t                               vertex_buffer_size,
@@ -611,11 +784,14 @@ namespace Piccolo
                            vertex_buffer_data,
                            joint_binding_buffer_size,
                            joint_binding_buffer_data,
+                           index_type,
                            index_buffer_size,
-                           reinterpret_cast<uint16_t*>(index_buffer_data),
+                           index_buffer_data,
                            now_mesh);
-        assert(0 == (index_buffer_size % sizeof(uint16_t)));
-        now_mesh.mesh_index_count = index_buffer_size / sizeof(uint16_t);
+        const uint32_t index_stride = (index_type == RHI_INDEX_TYPE_UINT32) ? sizeof(uint32_t) : sizeof(uint16_t);
+        assert(0 == (index_buffer_size % index_stride));
+        now_mesh.mesh_index_count = index_buffer_size / index_stride;
+        now_mesh.mesh_index_type  = index_type;
         updateIndexBuffer(rhi, index_buffer_size, index_buffer_data, now_mesh);
     }
 
@@ -625,8 +801,9 @@ namespace Piccolo
                                             MeshVertexDataDefinition const*        vertex_buffer_data,
                                             uint32_t                               joint_binding_buffer_size,
                                             MeshVertexBindingDataDefinition const* joint_binding_buffer_data,
+                                            RHIIndexType                           index_type,
                                             uint32_t                               index_buffer_size,
-                                            uint16_t*                              index_buffer_data,
+                                            const void*                            index_buffer_data,
                                             VulkanMesh&                            now_mesh)
     {
         VulkanRHI* vulkan_context = static_cast<VulkanRHI*>(rhi.get());
@@ -635,8 +812,9 @@ namespace Piccolo
         {
             assert(0 == (vertex_buffer_size % sizeof(MeshVertexDataDefinition)));
             uint32_t vertex_count = vertex_buffer_size / sizeof(MeshVertexDataDefinition);
-            assert(0 == (index_buffer_size % sizeof(uint16_t)));
-            uint32_t index_count = index_buffer_size / sizeof(uint16_t);
+            const uint32_t index_stride = (index_type == RHI_INDEX_TYPE_UINT32) ? sizeof(uint32_t) : sizeof(uint16_t);
+            assert(0 == (index_buffer_size % index_stride));
+            uint32_t index_count = index_buffer_size / index_stride;
 
             RHIDeviceSize vertex_position_buffer_size = sizeof(MeshVertex::VulkanMeshVertexPostition) * vertex_count;
             RHIDeviceSize vertex_varying_enable_blending_buffer_size =
@@ -707,7 +885,10 @@ namespace Piccolo
 
             for (uint32_t index_index = 0; index_index < index_count; ++index_index)
             {
-                uint32_t vertex_buffer_index = index_buffer_data[index_index];
+                uint32_t vertex_buffer_index =
+                    (index_type == RHI_INDEX_TYPE_UINT32) ?
+                        static_cast<const uint32_t*>(index_buffer_data)[index_index] :
+                        static_cast<const uint16_t*>(index_buffer_data)[index_index];
 
                 // TODO: move to assets loading process
 
@@ -738,7 +919,9 @@ namespace Piccolo
             VmaAllocationCreateInfo allocInfo = {};
             allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
 
-            bufferInfo.usage = RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT;
+            // the positions, normals and tangents are also read by the compute skinning, see SkinningPass
+            bufferInfo.usage = RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT | RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                               RHI_BUFFER_USAGE_TRANSFER_DST_BIT;
             bufferInfo.size = vertex_position_buffer_size;
             rhi->createBufferVMA(vulkan_context->m_assets_allocator,
                                  &bufferInfo,
@@ -753,7 +936,8 @@ namespace Piccolo
                                  now_mesh.mesh_vertex_varying_enable_blending_buffer,
                                  &now_mesh.mesh_vertex_varying_enable_blending_buffer_allocation,
                                  NULL);
-            bufferInfo.size = vertex_varying_buffer_size;
+            bufferInfo.usage = RHI_BUFFER_USAGE_VERTEX_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_DST_BIT;
+            bufferInfo.size  = vertex_varying_buffer_size;
             rhi->createBufferVMA(vulkan_context->m_assets_allocator,
                                  &bufferInfo,
                                  &allocInfo,
@@ -1102,7 +1286,7 @@ namespace Piccolo
             texture_data.emissive_image_format);
     }
 
-    VulkanMesh& RenderResource::getEntityMesh(RenderEntity entity)
+    VulkanMesh& RenderResource::getEntityMesh(const RenderEntity& entity)
     {
         size_t assetid = entity.m_mesh_asset_id;
 
@@ -1117,7 +1301,7 @@ namespace Piccolo
         }
     }
 
-    VulkanPBRMaterial& RenderResource::getEntityMaterial(RenderEntity entity)
+    VulkanPBRMaterial& RenderResource::getEntityMaterial(const RenderEntity& entity)
     {
         size_t assetid = entity.m_material_asset_id;
 
@@ -1158,8 +1342,10 @@ namespace Piccolo
         // The size is 128MB in NVIDIA D3D11
         // driver(https://developer.nvidia.com/content/constant-buffers-without-constant-pain-0).
         uint32_t global_storage_buffer_size = 1024 * 1024 * 128;
+        // also the source of the mesh instance copies and holds the indirect draws of the gpu driven path
         rhi->createBuffer(global_storage_buffer_size,
-                          RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                          RHI_BUFFER_USAGE_STORAGE_BUFFER_BIT | RHI_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                              RHI_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
                           RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                           _storage_buffer._global_upload_ringbuffer,
                           _storage_buffer._global_upload_ringbuffer_memory);
@@ -4,7 +4,10 @@
 #include "runtime/function/render/render_type.h"
 #include "runtime/function/render/interface/rhi.h"
 
+#include "runtime/function/render/render_bindless_materials.h"
 #include "runtime/function/render/render_common.h"
+#include "runtime/function/render/render_mesh_instances.h"
+#include "runtime/function/render/render_texture_streamer.h"
 
 #include <vk_mem_alloc.h>
 #include <vulkan/vulkan.h>
@@ -12,6 +15,7 @@
 #include <array>
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <vector>
 #include <cmath>
 
@@ -131,15 +135,28 @@ namespace Piccolo
             RenderEntity         render_entity,
             RenderMaterialData   material_data) override final;
 
+        virtual void streamGameObjectMaterial(std::shared_ptr<RHI>      rhi,
+                                              RenderEntity              render_entity,
+                                              const MaterialSourceDesc& material_source) override final;
+
+        virtual void updateStreamedResources(std::shared_ptr<RHI> rhi) override final;
+
+        virtual void updateMeshInstances(std::shared_ptr<RHI>         rhi,
+                                         std::shared_ptr<RenderScene> render_scene) override final;
+
         virtual void updatePerFrameBuffer(std::shared_ptr<RenderScene>  render_scene,
             std::shared_ptr<RenderCamera> camera) override final;
 
-        VulkanMesh& getEntityMesh(RenderEntity entity);
+        VulkanMesh& getEntityMesh(const RenderEntity& entity);
 
-        VulkanPBRMaterial& getEntityMaterial(RenderEntity entity);
+        VulkanPBRMaterial& getEntityMaterial(const RenderEntity& entity);
 
         void resetRingBufferOffset(uint8_t current_frame_index);
 
+        /// frees the material descriptor sets replaced by the streamed ones, called once the fence of the frame was
+        /// waited
+        void recycleMaterialDescriptorSets(std::shared_ptr<RHI> rhi, uint8_t frame_index);
+
         // global rendering resource, include IBL data, global storage buffer
         GlobalRenderResource m_global_render_resource;
 
@@ -160,11 +177,23 @@ namespace Piccolo
         std::map<size_t, VulkanMesh>        m_vulkan_meshes;
         std::map<size_t, VulkanPBRMaterial> m_vulkan_pbr_materials;
 
+        // render entities of the gpu driven mesh path, not initialized when the device can't draw them
+        RenderMeshInstances m_mesh_instances;
+
+        // materials of the mesh passes in one descriptor set, not initialized when the device can't index textures
+        RenderBindlessMaterials m_bindless_materials;
+
         // descriptor set layout in main camera pass will be used when uploading resource
         RHIDescriptorSetLayout* const* m_mesh_descriptor_set_layout {nullptr};
         RHIDescriptorSetLayout* const* m_material_descriptor_set_layout {nullptr};
 
     private:
+        struct StreamedMaterial
+        {
+            size_t                               m_material_asset_id {0};
+            std::array<StreamedTextureHandle, 5> m_textures;
+        };
+
         void createAndMapStorageBuffer(std::shared_ptr<RHI> rhi);
         void createIBLSamplers(std::shared_ptr<RHI> rhi);
         void createIBLTextures(std::shared_ptr<RHI>                        rhi,
@@ -177,6 +206,7 @@ namespace Piccolo
 
         void updateMeshData(std::shared_ptr<RHI>                          rhi,
                             bool                                          enable_vertex_blending,
+                            RHIIndexType                                  index_type,
                             uint32_t                                      index_buffer_size,
                             void*                                         index_buffer_data,
                             uint32_t                                      vertex_buffer_size,
@@ -190,13 +220,36 @@ namespace Piccolo
                                 struct MeshVertexDataDefinition const*        vertex_buffer_data,
                                 uint32_t                                      joint_binding_buffer_size,
                                 struct MeshVertexBindingDataDefinition const* joint_binding_buffer_data,
+                                RHIIndexType                                  index_type,
                                 uint32_t                                      index_buffer_size,
-                                uint16_t*                                     index_buffer_data,
+                                const void*                                   index_buffer_data,
                                 VulkanMesh&                                   now_mesh);
         void updateIndexBuffer(std::shared_ptr<RHI> rhi,
                                uint32_t             index_buffer_size,
                                void*                index_buffer_data,
                                VulkanMesh&          now_mesh);
         void updateTextureImageData(std::shared_ptr<RHI> rhi, const TextureDataToUpdate& texture_data);
+
+        void createMaterialUniformBuffer(std::shared_ptr<RHI> rhi,
+                                         const RenderEntity&  entity,
+                                         VulkanPBRMaterial&   now_material);
+        void createMaterialUniformBuffer(std::shared_ptr<RHI>                      rhi,
+                                         const MeshPerMaterialUniformBufferObject& material_factors,
+                                         VulkanPBRMaterial&                        now_material);
+        /// the uniform buffer at binding 0 then the five textures in the order of texture_image_infos
+        void createMaterialDescriptorSet(std::shared_ptr<RHI>    rhi,
+                                         VulkanPBRMaterial&      now_material,
+                                         RHIDescriptorImageInfo* texture_image_infos);
+
+        TextureStreamer& getOrCreateTextureStreamer(std::shared_ptr<RHI> rhi);
+        bool             isStreamedMaterialSettled(const StreamedMaterial& streamed_material) const;
+        void createStreamedMaterialDescriptorSet(std::shared_ptr<RHI> rhi, const StreamedMaterial& streamed_material);
+
+        std::unique_ptr<TextureStreamer> m_texture_streamer;
+        // materials still sampling a placeholder for some of their textures
+        std::vector<StreamedMaterial> m_streamed_materials;
+        // descriptor sets replaced since the previous frame, then per frame index until its fence is waited again
+        std::vector<RHIDescriptorSet*>              m_released_material_descriptor_sets;
+        std::vector<std::vector<RHIDescriptorSet*>> m_retired_material_descriptor_sets;
     };
 } // namespace Piccolo
@@ -7,15 +7,14 @@
 #include "runtime/resource/res_type/data/mesh_data.h"
 
 #include "runtime/function/global/global_context.h"
+#include "runtime/function/render/render_mesh_import.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
-#define TINYOBJLOADER_IMPLEMENTATION
-#include "tiny_obj_loader.h"
-
 #include <algorithm>
 #include <filesystem>
+#include <limits>
 #include <vector>
 
 namespace Piccolo
@@ -120,13 +119,27 @@ namespace Piccolo
                 bounding_box.merge(Vector3(vertex[i].x, vertex[i].y, vertex[i].z));
             }
 
-            // index buffer
-            size_t index_size                     = bind_data->index_buffer.size() * sizeof(uint16_t);
-            ret.m_static_mesh_data.m_index_buffer = std::make_shared<BufferData>(index_size);
-            uint16_t* index                       = (uint16_t*)ret.m_static_mesh_data.m_index_buffer->m_data;
-            for (size_t i = 0; i < bind_data->index_buffer.size(); i++)
+            // index buffer, 32 bit only when 16 bit indices can't address all vertices
+            if (bind_data->vertex_buffer.size() > std::numeric_limits<uint16_t>::max())
             {
-                index[i] = static_cast<uint16_t>(bind_data->index_buffer[i]);
+                size_t index_size                     = bind_data->index_buffer.size() * sizeof(uint32_t);
+                ret.m_static_mesh_data.m_index_type   = RHI_INDEX_TYPE_UINT32;
+                ret.m_static_mesh_data.m_index_buffer = std::make_shared<BufferData>(index_size);
+                uint32_t* index                       = (uint32_t*)ret.m_static_mesh_data.m_index_buffer->m_data;
+                for (size_t i = 0; i < bind_data->index_buffer.size(); i++)
+                {
+                    index[i] = static_cast<uint32_t>(bind_data->index_buffer[i]);
+                }
+            }
+            else
+            {
+                size_t index_size                     = bind_data->index_buffer.size() * sizeof(uint16_t);
+                ret.m_static_mesh_data.m_index_buffer = std::make_shared<BufferData>(index_size);
+                uint16_t* index                       = (uint16_t*)ret.m_static_mesh_data.m_index_buffer->m_data;
+                for (size_t i = 0; i < bind_data->index_buffer.size(); i++)
+                {
+                    index[i] = static_cast<uint16_t>(bind_data->index_buffer[i]);
+                }
             }
 
             // skeleton binding buffer
@@ -176,166 +189,27 @@ namespace Piccolo
     StaticMeshData RenderResourceBase::loadStaticMesh(std::string filename, AxisAlignedBox& bounding_box)
     {
         StaticMeshData mesh_data;
+        AxisAlignedBox mesh_bounding_box;
 
-        tinyobj::ObjReader       reader;
-        tinyobj::ObjReaderConfig reader_config;
-        reader_config.vertex_color = false;
-        if (!reader.ParseFromFile(filename, reader_config))
+        // the cached result of the import skips the obj parsing, the welding and the optimization
+        if (!loadMeshCache(filename, mesh_data, mesh_bounding_box))
         {
-            if (!reader.Error().empty())
+            ImportedMesh mesh;
+            if (!importObjMesh(filename, mesh))
             {
-                LOG_ERROR("loadMesh {} failed, error: {}", filename, reader.Error());
+                assert(0);
             }
-            assert(0);
-        }
+            optimizeMesh(mesh);
 
-        if (!reader.Warning().empty())
-        {
-            LOG_WARN("loadMesh {} warning, warning: {}", filename, reader.Warning());
+            mesh_data         = createStaticMeshData(mesh);
+            mesh_bounding_box = mesh.m_bounding_box;
+            saveMeshCache(filename, mesh_data, mesh_bounding_box);
         }
 
-        auto& attrib = reader.GetAttrib();
-        auto& shapes = reader.GetShapes();
-
-        std::vector<MeshVertexDataDefinition> mesh_vertices;
-
-        for (size_t s = 0; s < shapes.size(); s++)
-        {
-            size_t index_offset = 0;
-            for (size_t f = 0; f < shapes[s].mesh.num_face_vertices.size(); f++)
-            {
-                size_t fv = size_t(shapes[s].mesh.num_face_vertices[f]);
-
-                bool with_normal   = true;
-                bool with_texcoord = true;
-
-                Vector3 vertex[3];
-                Vector3 normal[3];
-                Vector2 uv[3];
-
-                // only deals with triangle faces
-                if (fv != 3)
-                {
-                    continue;
-                }
-
-                // expanding vertex data is not efficient and is for testing purposes only
-                for (size_t v = 0; v < fv; v++)
-                {
-                    auto idx = shapes[s].mesh.indices[index_offset + v];
-                    auto vx  = attrib.vertices[3 * size_t(idx.vertex_index) + 0];
-                    auto vy  = attrib.vertices[3 * size_t(idx.vertex_index) + 1];
-                    auto vz  = attrib.vertices[3 * size_t(idx.vertex_index) + 2];
-
-                    vertex[v].x = static_cast<float>(vx);
-                    vertex[v].y = static_cast<float>(vy);
-                    vertex[v].z = static_cast<float>(vz);
-
-                    bounding_box.merge(Vector3(vertex[v].x, vertex[v].y, vertex[v].z));
-
-                    if (idx.normal_index >= 0)
-                    {
-                        auto nx = attrib.normals[3 * size_t(idx.normal_index) + 0];
-                        auto ny = attrib.normals[3 * size_t(idx.normal_index) + 1];
-                        auto nz = attrib.normals[3 * size_t(idx.normal_index) + 2];
-
-                        normal[v].x = static_cast<float>(nx);
-                        normal[v].y = static_cast<float>(ny);
-                        normal[v].z = static_cast<float>(nz);
-                    }
-                    else
-                    {
-                        with_normal = false;
-                    }
-
-                    if (idx.texcoord_index >= 0)
-                    {
-                        auto tx = attrib.texcoords[2 * size_t(idx.texcoord_index) + 0];
-                        auto ty = attrib.texcoords[2 * size_t(idx.texcoord_index) + 1];
-
-                        uv[v].x = static_cast<float>(tx);
-                        uv[v].y = static_cast<float>(ty);
-                    }
-                    else
-                    {
-                        with_texcoord = false;
-                    }
-                }
-                index_offset += fv;
-
-                if (!with_normal)
-                {
-                    Vector3 v0 = vertex[1] - vertex[0];
-                    Vector3 v1 = vertex[2] - vertex[1];
-                    normal[0]  = v0.crossProduct(v1).normalisedCopy();
-                    normal[1]  = normal[0];
-                    normal[2]  = normal[0];
-                }
-
-                if (!with_texcoord)
-                {
-                    uv[0] = Vector2(0.5f, 0.5f);
-                    uv[1] = Vector2(0.5f, 0.5f);
-                    uv[2] = Vector2(0.5f, 0.5f);
-                }
-
-                Vector3 tangent {1, 0, 0};
-                {
-                    Vector3 edge1    = vertex[1] - vertex[0];
-                    Vector3 edge2    = vertex[2] - vertex[1];
-                    Vector2 deltaUV1 = uv[1] - uv[0];
-                    Vector2 deltaUV2 = uv[2] - uv[1];
-
-                    auto divide = deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y;
-                    if (divide >= 0.0f && divide < 0.000001f)
-                        divide = 0.000001f;
-                    else if (divide < 0.0f && divide > -0.000001f)
-                        divide = -0.000001f;
-
-                    float df  = 1.0f / divide;
-                    tangent.x = df * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
-                    tangent.y = df * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
-                    tangent.z = df * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
-                    tangent   = (tangent).normalisedCopy();
-                }
-
-                for (size_t i = 0; i < 3; i++)
-                {
-                    MeshVertexDataDefinition mesh_vert {};
-
-                    mesh_vert.x = vertex[i].x;
-                    mesh_vert.y = vertex[i].y;
-                    mesh_vert.z = vertex[i].z;
-
-                    mesh_vert.nx = normal[i].x;
-                    mesh_vert.ny = normal[i].y;
-                    mesh_vert.nz = normal[i].z;
-
-                    mesh_vert.u = uv[i].x;
-                    mesh_vert.v = uv[i].y;
-
-                    mesh_vert.tx = tangent.x;
-                    mesh_vert.ty = tangent.y;
-                    mesh_vert.tz = tangent.z;
-
-                    mesh_vertices.push_back(mesh_vert);
-                }
-            }
-        }
-
-        uint32_t stride           = sizeof(MeshVertexDataDefinition);
-        mesh_data.m_vertex_buffer = std::make_shared<BufferData>(mesh_vertices.size() * stride);
-        mesh_data.m_index_buffer  = std::make_shared<BufferData>(mesh_vertices.size() * sizeof(uint16_t));
-
-        assert(mesh_vertices.size() <= std::numeric_limits<uint16_t>::max()); // take care of the index range, should be
-                                                                              // consistent with the index range used by
-                                                                              // vulkan
-
-        uint16_t* indices = (uint16_t*)mesh_data.m_index_buffer->m_data;
-        for (size_t i = 0; i < mesh_vertices.size(); i++)
+        if (mesh_data.m_vertex_buffer->m_size > 0)
         {
-            ((MeshVertexDataDefinition*)(mesh_data.m_vertex_buffer->m_data))[i] = mesh_vertices[i];
-            indices[i]                                                          = static_cast<uint16_t>(i);
+            bounding_box.merge(mesh_bounding_box.getMinCorner());
+            bounding_box.merge(mesh_bounding_box.getMaxCorner());
         }
 
         return mesh_data;
@@ -36,6 +36,18 @@ namespace Piccolo
                                                     RenderEntity         render_entity,
                                                     RenderMaterialData   material_data) = 0;
 
+        /// create the material with placeholder textures right away, its textures are decoded and uploaded in the
+        /// background and replace the placeholders once they land, see updateStreamedResources
+        virtual void streamGameObjectMaterial(std::shared_ptr<RHI>      rhi,
+                                              RenderEntity              render_entity,
+                                              const MaterialSourceDesc& material_source) = 0;
+
+        /// called once per frame before the passes record their commands
+        virtual void updateStreamedResources(std::shared_ptr<RHI> rhi) = 0;
+
+        /// mirror the render entities changed since the previous frame in the instance buffer read by the mesh passes
+        virtual void updateMeshInstances(std::shared_ptr<RHI> rhi, std::shared_ptr<RenderScene> render_scene) = 0;
+
         virtual void updatePerFrameBuffer(std::shared_ptr<RenderScene>  render_scene,
                                           std::shared_ptr<RenderCamera> camera) = 0;
 
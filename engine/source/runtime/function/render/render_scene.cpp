@@ -1,4 +1,8 @@
 #include "runtime/function/render/render_scene.h"
+
+#include "runtime/core/job/job_system.h"
+
+#include "runtime/function/global/global_context.h"
 #include "runtime/function/render/render_helper.h"
 #include "runtime/function/render/render_pass.h"
 #include "runtime/function/render/render_resource.h"
@@ -12,9 +16,26 @@ namespace Piccolo
     void RenderScene::updateVisibleObjects(std::shared_ptr<RenderResource> render_resource,
                                            std::shared_ptr<RenderCamera>   camera)
     {
-        updateVisibleObjectsDirectionalLight(render_resource, camera);
-        updateVisibleObjectsPointLight(render_resource);
-        updateVisibleObjectsMainCamera(render_resource, camera);
+        // the visibility queries only read the render entities and write their own node lists
+        std::shared_ptr<JobSystem> job_system = g_runtime_global_context.m_job_system;
+        if (job_system)
+        {
+            JobHandle directional_light_job = job_system->schedule("UpdateVisibleObjectsDirectionalLight", [&]() {
+                updateVisibleObjectsDirectionalLight(render_resource, camera);
+            });
+            JobHandle point_light_job = job_system->schedule(
+                "UpdateVisibleObjectsPointLight", [&]() { updateVisibleObjectsPointLight(render_resource); });
+
+            updateVisibleObjectsMainCamera(render_resource, camera);
+
+            job_system->waitAll({directional_light_job, point_light_job});
+        }
+        else
+        {
+            updateVisibleObjectsDirectionalLight(render_resource, camera);
+            updateVisibleObjectsPointLight(render_resource);
+            updateVisibleObjectsMainCamera(render_resource, camera);
+        }
         updateVisibleObjectsAxis(render_resource);
         updateVisibleObjectsParticle(render_resource);
     }
@@ -25,6 +46,7 @@ namespace Piccolo
         RenderPass::m_visiable_nodes.p_point_lights_visible_mesh_nodes      = &m_point_lights_visible_mesh_nodes;
         RenderPass::m_visiable_nodes.p_main_camera_visible_mesh_nodes       = &m_main_camera_visible_mesh_nodes;
         RenderPass::m_visiable_nodes.p_axis_node                            = &m_axis_node;
+        RenderPass::m_visiable_nodes.p_pick_candidate_mesh_nodes            = &m_pick_candidate_mesh_nodes;
     }
 
     GuidAllocator<GameObjectPartId>& RenderScene::getInstanceIdAllocator() { return m_instance_id_allocator; }
@@ -62,26 +84,90 @@ namespace Piccolo
             }
         }
 
+        auto joint_palette_it = m_joint_palette_map.find(go_id);
+        if (joint_palette_it != m_joint_palette_map.end())
+        {
+            m_joint_palettes[joint_palette_it->second].clear();
+            m_free_joint_palettes.push_back(joint_palette_it->second);
+            m_joint_palette_map.erase(joint_palette_it);
+        }
+
         GameObjectPartId part_id = {go_id, 0};
         size_t           find_guid;
-        if (m_instance_id_allocator.getElementGuid(part_id, find_guid))
+        uint32_t         entity_index;
+        if (m_instance_id_allocator.getElementGuid(part_id, find_guid) &&
+            m_culling.tryGetEntityIndex(static_cast<uint32_t>(find_guid), entity_index))
         {
-            for (auto it = m_render_entities.begin(); it != m_render_entities.end(); it++)
+            m_culling.removeEntity(static_cast<uint32_t>(find_guid));
+
+            // the last entity fills the hole
+            if (entity_index + 1 != m_render_entities.size())
             {
-                if (it->m_instance_id == find_guid)
-                {
-                    m_render_entities.erase(it);
-                    break;
-                }
+                m_render_entities[entity_index] = std::move(m_render_entities.back());
+                m_culling.setEntityIndex(m_render_entities[entity_index].m_instance_id, entity_index);
+                m_dirty_entities.push_back(entity_index);
             }
+            m_render_entities.pop_back();
         }
     }
 
+    void RenderScene::addOrUpdateEntity(const RenderEntity& entity)
+    {
+        uint32_t entity_index;
+        if (m_culling.tryGetEntityIndex(entity.m_instance_id, entity_index))
+        {
+            m_render_entities[entity_index] = entity;
+        }
+        else
+        {
+            entity_index = static_cast<uint32_t>(m_render_entities.size());
+            m_render_entities.push_back(entity);
+        }
+
+        m_culling.addOrUpdateEntity(entity, entity_index);
+        m_dirty_entities.push_back(entity_index);
+    }
+
     void RenderScene::clearForLevelReloading()
     {
         m_instance_id_allocator.clear();
         m_mesh_object_id_map.clear();
         m_render_entities.clear();
+        m_culling.clear();
+        m_joint_palettes.clear();
+        m_free_joint_palettes.clear();
+        m_joint_palette_map.clear();
+    }
+
+    uint32_t RenderScene::acquireJointPalette(GObjectID go_id)
+    {
+        auto find_it = m_joint_palette_map.find(go_id);
+        if (find_it != m_joint_palette_map.end())
+        {
+            return find_it->second;
+        }
+
+        uint32_t joint_palette;
+        if (!m_free_joint_palettes.empty())
+        {
+            joint_palette = m_free_joint_palettes.back();
+            m_free_joint_palettes.pop_back();
+        }
+        else
+        {
+            joint_palette = static_cast<uint32_t>(m_joint_palettes.size());
+            m_joint_palettes.emplace_back();
+        }
+        m_joint_palette_map[go_id] = joint_palette;
+        return joint_palette;
+    }
+
+    void RenderScene::updateJointPalette(GObjectID go_id, const Matrix4x4* joint_matrices, uint32_t joint_count)
+    {
+        assert(joint_count <= s_mesh_vertex_blending_max_joint_count);
+
+        std::vector<Matrix4x4>& palette = m_joint_palettes[acquireJointPalette(go_id)];
+        palette.assign(joint_matrices, joint_matrices + joint_count);
     }
 
     void RenderScene::updateVisibleObjectsDirectionalLight(std::shared_ptr<RenderResource> render_resource,
@@ -99,34 +185,9 @@ namespace Piccolo
         ClusterFrustum frustum =
             CreateClusterFrustumFromMatrix(directional_light_proj_view, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
 
-        for (const RenderEntity& entity : m_render_entities)
-        {
-            BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
-                                                 entity.m_bounding_box.getMaxCorner()};
-
-            if (TiledFrustumIntersectBox(frustum, BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix)))
-            {
-                m_directional_light_visible_mesh_nodes.emplace_back();
-                RenderMeshNode& temp_node = m_directional_light_visible_mesh_nodes.back();
-
-                temp_node.model_matrix = &entity.m_model_matrix;
-
-                assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
-                if (!entity.m_joint_matrices.empty())
-                {
-                    temp_node.joint_count    = static_cast<uint32_t>(entity.m_joint_matrices.size());
-                    temp_node.joint_matrices = entity.m_joint_matrices.data();
-                }
-                temp_node.node_id = entity.m_instance_id;
-
-                VulkanMesh& mesh_asset           = render_resource->getEntityMesh(entity);
-                temp_node.ref_mesh               = &mesh_asset;
-                temp_node.enable_vertex_blending = entity.m_enable_vertex_blending;
-
-                VulkanPBRMaterial& material_asset = render_resource->getEntityMaterial(entity);
-                temp_node.ref_material            = &material_asset;
-            }
-        }
+        m_culling_stats.m_directional_light = m_culling.cullFrustum(frustum, m_directional_light_visible_entities);
+        appendVisibleMeshNodes(
+            *render_resource, m_directional_light_visible_entities, m_directional_light_visible_mesh_nodes);
     }
 
     void RenderScene::updateVisibleObjectsPointLight(std::shared_ptr<RenderResource> render_resource)
@@ -142,45 +203,9 @@ namespace Piccolo
             point_lights_bounding_spheres[i].m_radius = m_point_light_list.m_lights[i].calculateRadius();
         }
 
-        for (const RenderEntity& entity : m_render_entities)
-        {
-            BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
-                                                 entity.m_bounding_box.getMaxCorner()};
-
-            bool intersect_with_point_lights = true;
-            for (size_t i = 0; i < point_light_num; i++)
-            {
-                if (!BoxIntersectsWithSphere(BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix),
-                                             point_lights_bounding_spheres[i]))
-                {
-                    intersect_with_point_lights = false;
-                    break;
-                }
-            }
-
-            if (intersect_with_point_lights)
-            {
-                m_point_lights_visible_mesh_nodes.emplace_back();
-                RenderMeshNode& temp_node = m_point_lights_visible_mesh_nodes.back();
-
-                temp_node.model_matrix = &entity.m_model_matrix;
-
-                assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
-                if (!entity.m_joint_matrices.empty())
-                {
-                    temp_node.joint_count    = static_cast<uint32_t>(entity.m_joint_matrices.size());
-                    temp_node.joint_matrices = entity.m_joint_matrices.data();
-                }
-                temp_node.node_id = entity.m_instance_id;
-
-                VulkanMesh& mesh_asset           = render_resource->getEntityMesh(entity);
-                temp_node.ref_mesh               = &mesh_asset;
-                temp_node.enable_vertex_blending = entity.m_enable_vertex_blending;
-
-                VulkanPBRMaterial& material_asset = render_resource->getEntityMaterial(entity);
-                temp_node.ref_material            = &material_asset;
-            }
-        }
+        m_culling_stats.m_point_lights =
+            m_culling.cullSpheres(point_lights_bounding_spheres, m_point_lights_visible_entities);
+        appendVisibleMeshNodes(*render_resource, m_point_lights_visible_entities, m_point_lights_visible_mesh_nodes);
     }
 
     void RenderScene::updateVisibleObjectsMainCamera(std::shared_ptr<RenderResource> render_resource,
@@ -194,32 +219,60 @@ namespace Piccolo
 
         ClusterFrustum f = CreateClusterFrustumFromMatrix(proj_view_matrix, -1.0, 1.0, -1.0, 1.0, 0.0, 1.0);
 
-        for (const RenderEntity& entity : m_render_entities)
+        m_culling_stats.m_main_camera = m_culling.cullFrustum(f, m_main_camera_visible_entities);
+        appendVisibleMeshNodes(*render_resource, m_main_camera_visible_entities, m_main_camera_visible_mesh_nodes);
+    }
+
+    void RenderScene::updatePickCandidates(std::shared_ptr<RenderResource> render_resource,
+                                           std::shared_ptr<RenderCamera>   camera,
+                                           const Vector2&                  picked_uv)
+    {
+        m_pick_candidate_mesh_nodes.clear();
+
+        Matrix4x4 proj_view_matrix     = camera->getPersProjMatrix() * camera->getViewMatrix();
+        Matrix4x4 inv_proj_view_matrix = proj_view_matrix.inverse();
+
+        // the ray from the near to the far plane through the picked pixel, the viewport y axis points down
+        // like the vulkan ndc one
+        const float ndc_x         = picked_uv.x * 2.0f - 1.0f;
+        const float ndc_y         = picked_uv.y * 2.0f - 1.0f;
+        Vector4     near_point    = inv_proj_view_matrix * Vector4(ndc_x, ndc_y, 0.0f, 1.0f);
+        Vector4     far_point     = inv_proj_view_matrix * Vector4(ndc_x, ndc_y, 1.0f, 1.0f);
+        Vector3     near_position = Vector3(near_point.x, near_point.y, near_point.z) / near_point.w;
+        Vector3     far_position  = Vector3(far_point.x, far_point.y, far_point.z) / far_point.w;
+
+        m_culling.querySegment(near_position, far_position, m_pick_candidate_entities);
+        appendVisibleMeshNodes(*render_resource, m_pick_candidate_entities, m_pick_candidate_mesh_nodes);
+    }
+
+    void RenderScene::appendVisibleMeshNodes(RenderResource&              render_resource,
+                                             const std::vector<uint32_t>& visible_entities,
+                                             std::vector<RenderMeshNode>& out_mesh_nodes) const
+    {
+        out_mesh_nodes.reserve(out_mesh_nodes.size() + visible_entities.size());
+        for (uint32_t entity_index : visible_entities)
         {
-            BoundingBox mesh_asset_bounding_box {entity.m_bounding_box.getMinCorner(),
-                                                 entity.m_bounding_box.getMaxCorner()};
+            const RenderEntity& entity = m_render_entities[entity_index];
+
+            out_mesh_nodes.emplace_back();
+            RenderMeshNode& temp_node = out_mesh_nodes.back();
+            temp_node.model_matrix    = &entity.m_model_matrix;
 
-            if (TiledFrustumIntersectBox(f, BoundingBoxTransform(mesh_asset_bounding_box, entity.m_model_matrix)))
+            if (entity.m_joint_palette != k_invalid_joint_palette && !m_joint_palettes[entity.m_joint_palette].empty())
             {
-                m_main_camera_visible_mesh_nodes.emplace_back();
-                RenderMeshNode& temp_node = m_main_camera_visible_mesh_nodes.back();
-                temp_node.model_matrix    = &entity.m_model_matrix;
-
-                assert(entity.m_joint_matrices.size() <= s_mesh_vertex_blending_max_joint_count);
-                if (!entity.m_joint_matrices.empty())
-                {
-                    temp_node.joint_count    = static_cast<uint32_t>(entity.m_joint_matrices.size());
-                    temp_node.joint_matrices = entity.m_joint_matrices.data();
-                }
-                temp_node.node_id = entity.m_instance_id;
-
-                VulkanMesh& mesh_asset           = render_resource->getEntityMesh(entity);
-                temp_node.ref_mesh               = &mesh_asset;
-                temp_node.enable_vertex_blending = entity.m_enable_vertex_blending;
-
-                VulkanPBRMaterial& material_asset = render_resource->getEntityMaterial(entity);
-                temp_node.ref_material            = &material_asset;
+                const std::vector<Matrix4x4>& joint_palette = m_joint_palettes[entity.m_joint_palette];
+                temp_node.joint_count                       = static_cast<uint32_t>(joint_palette.size());
+                temp_node.joint_matrices                    = joint_palette.data();
             }
+            temp_node.node_id        = entity.m_instance_id;
+            temp_node.instance_index = entity_index;
+
+            VulkanMesh& mesh_asset           = render_resource.getEntityMesh(entity);
+            temp_node.ref_mesh               = &mesh_asset;
+            temp_node.enable_vertex_blending = entity.m_enable_vertex_blending;
+
+            VulkanPBRMaterial& material_asset = render_resource.getEntityMaterial(entity);
+            temp_node.ref_material            = &material_asset;
         }
     }
 
@@ -4,6 +4,7 @@
 
 #include "runtime/function/render/light.h"
 #include "runtime/function/render/render_common.h"
+#include "runtime/function/render/render_culling.h"
 #include "runtime/function/render/render_entity.h"
 #include "runtime/function/render/render_guid_allocator.h"
 #include "runtime/function/render/render_object.h"
@@ -16,6 +17,13 @@ namespace Piccolo
     class RenderResource;
     class RenderCamera;
 
+    struct RenderSceneCullingStats
+    {
+        RenderCullingStats m_main_camera;
+        RenderCullingStats m_directional_light;
+        RenderCullingStats m_point_lights;
+    };
+
     class RenderScene
     {
     public:
@@ -24,7 +32,8 @@ namespace Piccolo
         PDirectionalLight m_directional_light;
         PointLightList    m_point_light_list;
 
-        // render entities
+        // render entities, added and removed through addOrUpdateEntity and deleteEntityByGObjectID so that
+        // the culling hierarchy stays in sync
         std::vector<RenderEntity> m_render_entities;
 
         // axis, for editor
@@ -36,6 +45,9 @@ namespace Piccolo
         std::vector<RenderMeshNode> m_main_camera_visible_mesh_nodes;
         RenderAxisNode              m_axis_node;
 
+        // meshes under the cursor (updated when picking)
+        std::vector<RenderMeshNode> m_pick_candidate_mesh_nodes;
+
         // clear
         void clear();
 
@@ -43,6 +55,11 @@ namespace Piccolo
         void updateVisibleObjects(std::shared_ptr<RenderResource> render_resource,
                                   std::shared_ptr<RenderCamera>   camera);
 
+        // collect the meshes whose bounds are crossed by the camera ray through picked_uv
+        void updatePickCandidates(std::shared_ptr<RenderResource> render_resource,
+                                  std::shared_ptr<RenderCamera>   camera,
+                                  const Vector2&                  picked_uv);
+
         // set visible nodes ptr in render pass
         void setVisibleNodesReference();
 
@@ -52,10 +69,29 @@ namespace Piccolo
 
         void      addInstanceIdToMap(uint32_t instance_id, GObjectID go_id);
         GObjectID getGObjectIDByMeshID(uint32_t mesh_id) const;
+        void      addOrUpdateEntity(const RenderEntity& entity);
         void      deleteEntityByGObjectID(GObjectID go_id);
 
         void clearForLevelReloading();
 
+        /// the joint palette of the game object, shared by all its entities, created on first use and released
+        /// with the game object
+        uint32_t acquireJointPalette(GObjectID go_id);
+        void     updateJointPalette(GObjectID go_id, const Matrix4x4* joint_matrices, uint32_t joint_count);
+        const std::vector<Matrix4x4>& getJointPalette(uint32_t joint_palette) const
+        {
+            return m_joint_palettes[joint_palette];
+        }
+
+        /// indices in m_render_entities of the entities added, updated or moved since the last clearDirtyEntities,
+        /// may hold duplicates and indices past the end of the removed entities
+        const std::vector<uint32_t>& getDirtyEntities() const { return m_dirty_entities; }
+        void                         clearDirtyEntities() { m_dirty_entities.clear(); }
+
+        // world bounds of m_render_entities
+        const RenderCulling&           getCulling() const { return m_culling; }
+        const RenderSceneCullingStats& getCullingStats() const { return m_culling_stats; }
+
     private:
         GuidAllocator<GameObjectPartId>   m_instance_id_allocator;
         GuidAllocator<MeshSourceDesc>     m_mesh_asset_id_allocator;
@@ -63,6 +99,18 @@ namespace Piccolo
 
         std::unordered_map<uint32_t, GObjectID> m_mesh_object_id_map;
 
+        std::vector<std::vector<Matrix4x4>>     m_joint_palettes;
+        std::vector<uint32_t>                   m_free_joint_palettes;
+        std::unordered_map<GObjectID, uint32_t> m_joint_palette_map;
+
+        RenderCulling           m_culling;
+        RenderSceneCullingStats m_culling_stats;
+        std::vector<uint32_t>   m_main_camera_visible_entities;
+        std::vector<uint32_t>   m_directional_light_visible_entities;
+        std::vector<uint32_t>   m_point_lights_visible_entities;
+        std::vector<uint32_t>   m_pick_candidate_entities;
+        std::vector<uint32_t>   m_dirty_entities;
+
         void updateVisibleObjectsDirectionalLight(std::shared_ptr<RenderResource> render_resource,
                                                   std::shared_ptr<RenderCamera>   camera);
         void updateVisibleObjectsPointLight(std::shared_ptr<RenderResource> render_resource);
@@ -70,5 +118,9 @@ namespace Piccolo
                                             std::shared_ptr<RenderCamera>   camera);
         void updateVisibleObjectsAxis(std::shared_ptr<RenderResource> render_resource);
         void updateVisibleObjectsParticle(std::shared_ptr<RenderResource> render_resource);
+
+        void appendVisibleMeshNodes(RenderResource&              render_resource,
+                                    const std::vector<uint32_t>& visible_entities,
+                                    std::vector<RenderMeshNode>& out_mesh_nodes) const;
     };
 } // namespace Piccolo
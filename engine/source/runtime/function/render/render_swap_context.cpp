@@ -1,7 +1,5 @@
 #include "runtime/function/render/render_swap_context.h"
 
-#include <utility>
-
 namespace Piccolo
 {
     void GameObjectResourceDesc::add(GameObjectDesc& desc) { m_game_object_descs.push_back(desc); }
@@ -30,15 +28,74 @@ namespace Piccolo
         return m_transform_descs[index];
     }
 
+    Matrix4x4* JointPaletteUpdateRequest::add(GObjectID go_id, uint32_t joint_count)
+    {
+        auto found = m_palette_indices.find(go_id);
+        if (found != m_palette_indices.end() && m_palettes[found->second].m_joint_count == joint_count)
+        {
+            return m_joint_matrices.data() + m_palettes[found->second].m_first_joint;
+        }
+
+        const uint32_t first_joint = static_cast<uint32_t>(m_joint_matrices.size());
+        m_joint_matrices.resize(first_joint + joint_count);
+        m_palette_indices[go_id] = static_cast<uint32_t>(m_palettes.size());
+        m_palettes.push_back({go_id, first_joint, joint_count});
+        return m_joint_matrices.data() + first_joint;
+    }
+
+    bool JointPaletteUpdateRequest::isEmpty() const { return m_palettes.empty(); }
+
+    void JointPaletteUpdateRequest::clear()
+    {
+        m_joint_matrices.clear();
+        m_palettes.clear();
+        m_palette_indices.clear();
+    }
+
     RenderSwapData& RenderSwapContext::getLogicSwapData() { return m_swap_data[m_logic_swap_data_index]; }
 
     RenderSwapData& RenderSwapContext::getRenderSwapData() { return m_swap_data[m_render_swap_data_index]; }
 
+    bool RenderSwapContext::publishLogicSwapData()
+    {
+        const uint8_t pending_state = m_pending_state.load(std::memory_order_acquire);
+        if (pending_state & k_pending_flag)
+            return false;
+
+        // the render side leaves the word alone while the flag is clear
+        m_pending_state.store(m_logic_swap_data_index | k_pending_flag, std::memory_order_release);
+        m_logic_swap_data_index = pending_state & k_pending_index_mask;
+        return true;
+    }
+
+    bool RenderSwapContext::acquireRenderSwapData()
+    {
+        const uint8_t pending_state = m_pending_state.load(std::memory_order_acquire);
+        if (!(pending_state & k_pending_flag))
+            return false;
+
+        // the render side processes the requests it still holds first, the published frame stays pending meanwhile
+        if (!isReadyToSwap())
+            return false;
+
+        // the logic side leaves the word alone while the flag is set
+        m_pending_state.store(m_render_swap_data_index, std::memory_order_release);
+        m_render_swap_data_index = pending_state & k_pending_index_mask;
+        return true;
+    }
+
+    bool RenderSwapContext::hasPendingSwapData() const
+    {
+        return m_pending_state.load(std::memory_order_acquire) & k_pending_flag;
+    }
+
     void RenderSwapContext::swapLogicRenderData()
     {
+        // keep accumulating on the logic side until the render side consumed its swap data
         if (isReadyToSwap())
         {
-            swap();
+            publishLogicSwapData();
+            acquireRenderSwapData();
         }
     }
 
@@ -50,7 +107,8 @@ namespace Piccolo
                  m_swap_data[m_render_swap_data_index].m_camera_swap_data.has_value() ||
                  m_swap_data[m_render_swap_data_index].m_particle_submit_request.has_value() ||
                  m_swap_data[m_render_swap_data_index].m_emitter_tick_request.has_value() ||
-                 m_swap_data[m_render_swap_data_index].m_emitter_transform_request.has_value());
+                 m_swap_data[m_render_swap_data_index].m_emitter_transform_request.has_value() ||
+                 !m_swap_data[m_render_swap_data_index].m_joint_palette_update_request.isEmpty());
     }
 
     void RenderSwapContext::resetLevelRsourceSwapData()
@@ -85,16 +143,9 @@ namespace Piccolo
         m_swap_data[m_render_swap_data_index].m_emitter_transform_request.reset();
     }
 
-    void RenderSwapContext::swap()
+    void RenderSwapContext::resetJointPaletteSwapData()
     {
-        resetLevelRsourceSwapData();
-        resetGameObjectResourceSwapData();
-        resetGameObjectToDelete();
-        resetCameraSwapData();
-        resetEmitterTickSwapData();
-        resetEmitterTransformSwapData();
-        resetPartilceBatchSwapData();
-        std::swap(m_logic_swap_data_index, m_render_swap_data_index);
+        m_swap_data[m_render_swap_data_index].m_joint_palette_update_request.clear();
     }
 
     void RenderSwapData::addDirtyGameObject(GameObjectDesc&& desc)
@@ -166,4 +217,9 @@ namespace Piccolo
             m_emitter_transform_request = request;
         }
     }
+
+    Matrix4x4* RenderSwapData::addJointPalette(GObjectID go_id, uint32_t joint_count)
+    {
+        return m_joint_palette_update_request.add(go_id, joint_count);
+    }
 } // namespace Piccolo
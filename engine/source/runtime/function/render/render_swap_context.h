@@ -8,10 +8,12 @@
 #include "runtime/resource/res_type/global/global_particle.h"
 #include "runtime/resource/res_type/global/global_rendering.h"
 
+#include <atomic>
 #include <cstdint>
 #include <deque>
 #include <optional>
 #include <string>
+#include <unordered_map>
 
 namespace Piccolo
 {
@@ -81,6 +83,30 @@ namespace Piccolo
         const ParticleEmitterTransformDesc& getNextEmitterTransformDesc(unsigned int index);
     };
 
+    struct JointPaletteUpdate
+    {
+        GObjectID m_go_id {k_invalid_gobject_id};
+        uint32_t  m_first_joint {0};
+        uint32_t  m_joint_count {0};
+    };
+
+    /// The joint palettes of the animated game objects, written by the animation components straight into one
+    /// buffer per swap data. A game object ticked again before the swap overwrites its previous palette. The
+    /// buffers keep their capacity when the request is cleared, so the logic side doesn't allocate once the swap
+    /// data warmed up.
+    struct JointPaletteUpdateRequest
+    {
+        std::vector<Matrix4x4>                  m_joint_matrices;
+        std::vector<JointPaletteUpdate>         m_palettes;
+        std::unordered_map<GObjectID, uint32_t> m_palette_indices;
+
+        /// where to write the joint_count matrices of the palette, valid until the next add
+        Matrix4x4* add(GObjectID go_id, uint32_t joint_count);
+
+        bool isEmpty() const;
+        void clear();
+    };
+
     struct RenderSwapData
     {
         std::optional<LevelResourceDesc>       m_level_resource_desc;
@@ -90,6 +116,7 @@ namespace Piccolo
         std::optional<ParticleSubmitRequest>   m_particle_submit_request;
         std::optional<EmitterTickRequest>      m_emitter_tick_request;
         std::optional<EmitterTransformRequest> m_emitter_transform_request;
+        JointPaletteUpdateRequest              m_joint_palette_update_request;
 
         void addDirtyGameObject(GameObjectDesc&& desc);
         void addDeleteGameObject(GameObjectDesc&& desc);
@@ -97,20 +124,37 @@ namespace Piccolo
         void addNewParticleEmitter(ParticleEmitterDesc& desc);
         void addTickParticleEmitter(ParticleEmitterID id);
         void updateParticleTransform(ParticleEmitterTransformDesc& desc);
+        Matrix4x4* addJointPalette(GObjectID go_id, uint32_t joint_count);
     };
 
     enum SwapDataType : uint8_t
     {
         LogicSwapDataType = 0,
         RenderSwapDataType,
+        PendingSwapDataType,
         SwapDataTypeCount
     };
 
+    /// Triple buffered swap data between the logic and the render side.
+    /// The logic side writes into its own swap data and publishes it into the pending slot, the render side
+    /// acquires the pending slot and processes it. The handoff is a single atomic word, so the two sides may run on
+    /// different threads without locking. Swap data hold incremental requests, a frame is never overwritten: the
+    /// logic side keeps accumulating until the render side took the previous one.
     class RenderSwapContext
     {
     public:
+        /// only accessed by the logic side
         RenderSwapData& getLogicSwapData();
+        /// only accessed by the render side
         RenderSwapData& getRenderSwapData();
+
+        /// logic side, return false if the previously published swap data is still pending
+        bool publishLogicSwapData();
+        /// render side, return false if nothing new was published or the render swap data still holds requests
+        bool acquireRenderSwapData();
+        bool hasPendingSwapData() const;
+
+        /// publish and acquire in a row, when both sides run on the same thread
         void            swapLogicRenderData();
         void            resetLevelRsourceSwapData();
         void            resetGameObjectResourceSwapData();
@@ -119,13 +163,19 @@ namespace Piccolo
         void            resetPartilceBatchSwapData();
         void            resetEmitterTickSwapData();
         void            resetEmitterTransformSwapData();
+        void            resetJointPaletteSwapData();
 
     private:
-        uint8_t        m_logic_swap_data_index {LogicSwapDataType};
-        uint8_t        m_render_swap_data_index {RenderSwapDataType};
-        RenderSwapData m_swap_data[SwapDataTypeCount];
+        // pending slot index in the low bits, the flag is set by the logic side and cleared by the render side,
+        // whoever doesn't own the flag state never writes the word
+        static constexpr uint8_t k_pending_index_mask = 0x3;
+        static constexpr uint8_t k_pending_flag       = 0x4;
+
+        uint8_t              m_logic_swap_data_index {LogicSwapDataType};
+        uint8_t              m_render_swap_data_index {RenderSwapDataType};
+        std::atomic<uint8_t> m_pending_state {PendingSwapDataType};
+        RenderSwapData       m_swap_data[SwapDataTypeCount];
 
         bool isReadyToSwap() const;
-        void swap();
     };
 } // namespace Piccolo
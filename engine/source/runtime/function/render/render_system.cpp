@@ -37,6 +37,8 @@ namespace Piccolo
         // render context initialize
         RHIInitInfo rhi_init_info;
         rhi_init_info.window_system = init_info.window_system;
+        // the compiled pipelines are kept next to the engine, the next start skips most of the compilation
+        rhi_init_info.pipeline_cache_folder = config_manager->getRootFolder() / "cache";
 
         m_rhi = std::make_shared<VulkanRHI>();
         m_rhi->initialize(rhi_init_info);
@@ -65,6 +67,7 @@ namespace Piccolo
         m_render_camera->m_znear = global_rendering_res.m_camera_config.m_z_near;
         m_render_camera->setAspect(global_rendering_res.m_camera_config.m_aspect.x /
                                    global_rendering_res.m_camera_config.m_aspect.y);
+        publishCameraFOV();
 
         // setup render scene
         m_render_scene                  = std::make_shared<RenderScene>();
@@ -76,8 +79,9 @@ namespace Piccolo
 
         // initialize render pipeline
         RenderPipelineInitInfo pipeline_init_info;
-        pipeline_init_info.enable_fxaa     = global_rendering_res.m_enable_fxaa;
-        pipeline_init_info.render_resource = m_render_resource;
+        pipeline_init_info.enable_fxaa             = global_rendering_res.m_enable_fxaa;
+        pipeline_init_info.enable_compute_skinning = global_rendering_res.m_enable_compute_skinning;
+        pipeline_init_info.render_resource         = m_render_resource;
 
         m_render_pipeline        = std::make_shared<RenderPipeline>();
         m_render_pipeline->m_rhi = m_rhi;
@@ -98,6 +102,13 @@ namespace Piccolo
     {
         // process swap data between logic and render contexts
         processSwapData();
+        publishCameraFOV();
+
+        // swap in the textures which finished uploading
+        m_render_resource->updateStreamedResources(m_rhi);
+
+        // copy the moved and added entities to the gpu driven mesh path
+        m_render_resource->updateMeshInstances(m_rhi, m_render_scene);
 
         // prepare render command context
         m_rhi->prepareContext();
@@ -164,6 +175,20 @@ namespace Piccolo
 
     std::shared_ptr<RHI>          RenderSystem::getRHI() const { return m_rhi; }
 
+    Vector2 RenderSystem::getCameraFOV() const
+    {
+        std::lock_guard<std::mutex> lock(m_camera_fov_mutex);
+        return m_camera_fov;
+    }
+
+    void RenderSystem::publishCameraFOV()
+    {
+        const Vector2 camera_fov = m_render_camera->getFOV();
+
+        std::lock_guard<std::mutex> lock(m_camera_fov_mutex);
+        m_camera_fov = camera_fov;
+    }
+
     void RenderSystem::updateEngineContentViewport(float offset_x, float offset_y, float width, float height)
     {
         std::static_pointer_cast<VulkanRHI>(m_rhi)->m_viewport.x        = offset_x;
@@ -174,6 +199,7 @@ namespace Piccolo
         std::static_pointer_cast<VulkanRHI>(m_rhi)->m_viewport.maxDepth = 1.0f;
 
         m_render_camera->setAspect(width / height);
+        publishCameraFOV();
     }
 
     EngineContentViewport RenderSystem::getEngineContentViewport() const
@@ -187,6 +213,8 @@ namespace Piccolo
 
     uint32_t RenderSystem::getGuidOfPickedMesh(const Vector2& picked_uv)
     {
+        m_render_scene->updatePickCandidates(
+            std::static_pointer_cast<RenderResource>(m_render_resource), m_render_camera, picked_uv);
         return m_render_pipeline->getGuidOfPickedMesh(picked_uv);
     }
 
@@ -275,8 +303,6 @@ namespace Piccolo
                     const auto&      game_object_part = gobject.getObjectParts()[part_index];
                     GameObjectPartId part_id          = {gobject.getId(), part_index};
 
-                    bool is_entity_in_scene = m_render_scene->getInstanceIdAllocator().hasElement(part_id);
-
                     RenderEntity render_entity;
                     render_entity.m_instance_id =
                         static_cast<uint32_t>(m_render_scene->getInstanceIdAllocator().allocGuid(part_id));
@@ -299,14 +325,11 @@ namespace Piccolo
                     }
 
                     render_entity.m_mesh_asset_id = m_render_scene->getMeshAssetIdAllocator().allocGuid(mesh_source);
-                    render_entity.m_enable_vertex_blending =
-                        game_object_part.m_skeleton_animation_result.m_transforms.size() > 1; // take care
-                    render_entity.m_joint_matrices.resize(
-                        game_object_part.m_skeleton_animation_result.m_transforms.size());
-                    for (size_t i = 0; i < game_object_part.m_skeleton_animation_result.m_transforms.size(); ++i)
+                    render_entity.m_enable_vertex_blending = game_object_part.m_with_animation;
+                    if (game_object_part.m_with_animation)
                     {
-                        render_entity.m_joint_matrices[i] =
-                            game_object_part.m_skeleton_animation_result.m_transforms[i].m_matrix;
+                        // filled by the joint palette updates of the animation component
+                        render_entity.m_joint_palette = m_render_scene->acquireJointPalette(gobject.getId());
                     }
 
                     // material properties
@@ -331,12 +354,6 @@ namespace Piccolo
                     }
                     bool is_material_loaded = m_render_scene->getMaterialAssetdAllocator().hasElement(material_source);
 
-                    RenderMaterialData material_data;
-                    if (!is_material_loaded)
-                    {
-                        material_data = m_render_resource->loadMaterialData(material_source);
-                    }
-
                     render_entity.m_material_asset_id =
                         m_render_scene->getMaterialAssetdAllocator().allocGuid(material_source);
 
@@ -346,27 +363,14 @@ namespace Piccolo
                         m_render_resource->uploadGameObjectRenderResource(m_rhi, render_entity, mesh_data);
                     }
 
+                    // the textures are decoded and uploaded in the background, the material starts on placeholders
                     if (!is_material_loaded)
                     {
-                        m_render_resource->uploadGameObjectRenderResource(m_rhi, render_entity, material_data);
+                        m_render_resource->streamGameObjectMaterial(m_rhi, render_entity, material_source);
                     }
 
-                    // add object to render scene if needed
-                    if (!is_entity_in_scene)
-                    {
-                        m_render_scene->m_render_entities.push_back(render_entity);
-                    }
-                    else
-                    {
-                        for (auto& entity : m_render_scene->m_render_entities)
-                        {
-                            if (entity.m_instance_id == render_entity.m_instance_id)
-                            {
-                                entity = render_entity;
-                                break;
-                            }
-                        }
-                    }
+                    // add object to render scene or move it
+                    m_render_scene->addOrUpdateEntity(render_entity);
                 }
                 // after finished processing, pop this game object
                 swap_data.m_game_object_resource_desc->pop();
@@ -376,6 +380,19 @@ namespace Piccolo
             m_swap_context.resetGameObjectResourceSwapData();
         }
 
+        // update the joint palettes of the animated objects
+        if (!swap_data.m_joint_palette_update_request.isEmpty())
+        {
+            const JointPaletteUpdateRequest& request = swap_data.m_joint_palette_update_request;
+            for (const JointPaletteUpdate& palette : request.m_palettes)
+            {
+                m_render_scene->updateJointPalette(
+                    palette.m_go_id, request.m_joint_matrices.data() + palette.m_first_joint, palette.m_joint_count);
+            }
+
+            m_swap_context.resetJointPaletteSwapData();
+        }
+
         // remove deleted objects
         if (swap_data.m_game_object_to_delete.has_value())
         {
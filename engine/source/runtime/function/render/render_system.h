@@ -7,6 +7,7 @@
 
 #include <array>
 #include <memory>
+#include <mutex>
 #include <optional>
 
 namespace Piccolo
@@ -48,6 +49,9 @@ namespace Piccolo
         RenderSwapContext&            getSwapContext();
         std::shared_ptr<RenderCamera> getRenderCamera() const;
         std::shared_ptr<RHI>          getRHI() const;
+        /// the field of view of the render camera in degrees as of the last rendered frame, for the logic side,
+        /// which may run on another thread than the one owning the render camera
+        Vector2 getCameraFOV() const;
 
         void      setRenderPipelineType(RENDER_PIPELINE_TYPE pipeline_type);
         void      initializeUIRenderBackend(WindowUI* window_ui);
@@ -76,6 +80,10 @@ namespace Piccolo
         std::shared_ptr<RenderResourceBase> m_render_resource;
         std::shared_ptr<RenderPipelineBase> m_render_pipeline;
 
+        mutable std::mutex m_camera_fov_mutex;
+        Vector2            m_camera_fov;
+
         void processSwapData();
+        void publishCameraFOV();
     };
 } // namespace Piccolo
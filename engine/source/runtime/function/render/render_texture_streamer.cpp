@@ -0,0 +1,526 @@
+#include "runtime/function/render/render_texture_streamer.h"
+
+#include "runtime/core/base/macro.h"
+
+#include "runtime/resource/asset_manager/asset_manager.h"
+
+#include "runtime/function/global/global_context.h"
+#include "runtime/function/render/interface/rhi.h"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Piccolo
+{
+    namespace
+    {
+        constexpr uint64_t k_staging_buffer_size = 64 * 1024 * 1024;
+        // the top mips of larger textures are dropped so that a single texture can't stall the ring
+        constexpr uint64_t k_max_texture_staging_size = k_staging_buffer_size / 2;
+        // bounds the time the render thread spends copying to the ring in a tick
+        constexpr uint64_t k_max_staging_size_per_tick = 16 * 1024 * 1024;
+        constexpr uint64_t k_staging_alignment         = 16;
+
+        constexpr uint32_t k_linear_to_srgb_table_size = 4096;
+
+        struct SrgbTables
+        {
+            float   m_srgb_to_linear[256];
+            uint8_t m_linear_to_srgb[k_linear_to_srgb_table_size];
+
+            SrgbTables()
+            {
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    float c             = i / 255.0f;
+                    m_srgb_to_linear[i] = (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                }
+                for (uint32_t i = 0; i < k_linear_to_srgb_table_size; ++i)
+                {
+                    float c = i / static_cast<float>(k_linear_to_srgb_table_size - 1);
+                    float s = (c <= 0.0031308f) ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+                    m_linear_to_srgb[i] = static_cast<uint8_t>(std::min(255.0f, s * 255.0f + 0.5f));
+                }
+            }
+
+            uint8_t toSrgb(float linear) const
+            {
+                return m_linear_to_srgb[static_cast<uint32_t>(linear * (k_linear_to_srgb_table_size - 1) + 0.5f)];
+            }
+        };
+
+        const SrgbTables& getSrgbTables()
+        {
+            static const SrgbTables tables;
+            return tables;
+        }
+
+        /// 2x2 box filter of a rgba8 level, odd edges repeat their last texel, srgb colors are averaged in linear
+        void downsampleMipLevel(const uint8_t* src,
+                                uint32_t       src_width,
+                                uint32_t       src_height,
+                                uint8_t*       dst,
+                                uint32_t       dst_width,
+                                uint32_t       dst_height,
+                                bool           is_srgb)
+        {
+            const SrgbTables& srgb_tables = getSrgbTables();
+
+            for (uint32_t y = 0; y < dst_height; ++y)
+            {
+                const uint8_t* row0 = src + size_t(std::min(y * 2, src_height - 1)) * src_width * 4;
+                const uint8_t* row1 = src + size_t(std::min(y * 2 + 1, src_height - 1)) * src_width * 4;
+                for (uint32_t x = 0; x < dst_width; ++x)
+                {
+                    const uint32_t x0    = std::min(x * 2, src_width - 1) * 4;
+                    const uint32_t x1    = std::min(x * 2 + 1, src_width - 1) * 4;
+                    uint8_t*       texel = dst + (size_t(y) * dst_width + x) * 4;
+
+                    for (uint32_t c = 0; c < 4; ++c)
+                    {
+                        // alpha is linear in both formats
+                        if (is_srgb && c < 3)
+                        {
+                            float sum = srgb_tables.m_srgb_to_linear[row0[x0 + c]] +
+                                        srgb_tables.m_srgb_to_linear[row0[x1 + c]] +
+                                        srgb_tables.m_srgb_to_linear[row1[x0 + c]] +
+                                        srgb_tables.m_srgb_to_linear[row1[x1 + c]];
+                            texel[c] = srgb_tables.toSrgb(sum * 0.25f);
+                        }
+                        else
+                        {
+                            uint32_t sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+                            texel[c]     = static_cast<uint8_t>((sum + 2) / 4);
+                        }
+                    }
+                }
+            }
+        }
+    } // namespace
+
+    TextureStreamer::TextureStreamer(std::shared_ptr<RHI> rhi) : m_rhi(rhi)
+    {
+        createPlaceholders();
+        createUploadResources();
+    }
+
+    TextureStreamer::~TextureStreamer()
+    {
+        m_is_cancelled = true;
+        for (const auto& texture : m_textures)
+        {
+            if (texture->m_decode_job)
+            {
+                g_runtime_global_context.m_job_system->wait(texture->m_decode_job);
+            }
+        }
+
+        for (const UploadBatch& batch : m_upload_batches)
+        {
+            if (batch.m_is_in_flight)
+            {
+                m_rhi->waitForFencesPFN(1, &batch.m_fence, RHI_TRUE, UINT64_MAX);
+            }
+            m_rhi->destroyFence(batch.m_fence);
+            m_rhi->freeCommandBuffers(m_command_pool, 1, batch.m_command_buffer);
+        }
+        m_rhi->destroyCommandPool(m_command_pool);
+
+        m_rhi->unmapMemory(m_staging_buffer_memory);
+        m_rhi->destroyBuffer(m_staging_buffer);
+        m_rhi->freeMemory(m_staging_buffer_memory);
+    }
+
+    void TextureStreamer::createPlaceholders()
+    {
+        // same texel as the textures a material doesn't have
+        float empty_image[] = {0.5f, 0.5f, 0.5f, 0.5f};
+
+        m_rhi->createGlobalImage(m_unorm_placeholder.m_image,
+                                 m_unorm_placeholder.m_image_view,
+                                 m_unorm_placeholder.m_image_allocation,
+                                 1,
+                                 1,
+                                 empty_image,
+                                 RHI_FORMAT_R8G8B8A8_UNORM);
+        m_rhi->createGlobalImage(m_srgb_placeholder.m_image,
+                                 m_srgb_placeholder.m_image_view,
+                                 m_srgb_placeholder.m_image_allocation,
+                                 1,
+                                 1,
+                                 empty_image,
+                                 RHI_FORMAT_R8G8B8A8_SRGB);
+    }
+
+    void TextureStreamer::createUploadResources()
+    {
+        m_rhi->createBuffer(k_staging_buffer_size,
+                            RHI_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                            RHI_MEMORY_PROPERTY_HOST_VISIBLE_BIT | RHI_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                            m_staging_buffer,
+                            m_staging_buffer_memory);
+        void* staging_data = nullptr;
+        m_rhi->mapMemory(m_staging_buffer_memory, 0, k_staging_buffer_size, 0, &staging_data);
+        m_staging_data = static_cast<uint8_t*>(staging_data);
+
+        RHICommandPoolCreateInfo command_pool_create_info {};
+        command_pool_create_info.sType            = RHI_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        command_pool_create_info.pNext            = NULL;
+        command_pool_create_info.flags            = RHI_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        command_pool_create_info.queueFamilyIndex = m_rhi->getQueueFamilyIndices().m_transfer_family.value();
+        if (RHI_SUCCESS != m_rhi->createCommandPool(&command_pool_create_info, m_command_pool))
+        {
+            throw std::runtime_error("create texture upload command pool");
+        }
+
+        RHICommandBufferAllocateInfo command_buffer_allocate_info {};
+        command_buffer_allocate_info.sType              = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        command_buffer_allocate_info.commandPool        = m_command_pool;
+        command_buffer_allocate_info.level              = RHI_COMMAND_BUFFER_LEVEL_PRIMARY;
+        command_buffer_allocate_info.commandBufferCount = 1;
+
+        RHIFenceCreateInfo fence_create_info {};
+        fence_create_info.sType = RHI_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        fence_create_info.flags = 0;
+
+        for (UploadBatch& batch : m_upload_batches)
+        {
+            if (RHI_SUCCESS != m_rhi->allocateCommandBuffers(&command_buffer_allocate_info, batch.m_command_buffer))
+            {
+                throw std::runtime_error("alloc texture upload command buffer");
+            }
+            if (RHI_SUCCESS != m_rhi->createFence(&fence_create_info, batch.m_fence))
+            {
+                throw std::runtime_error("create texture upload fence");
+            }
+        }
+    }
+
+    StreamedTextureHandle TextureStreamer::requestTexture(const std::string& file, bool is_srgb)
+    {
+        auto iter = m_texture_handles.find(std::make_pair(file, is_srgb));
+        if (iter != m_texture_handles.end())
+            return iter->second;
+
+        StreamedTextureHandle handle = static_cast<StreamedTextureHandle>(m_textures.size());
+        m_texture_handles.emplace(std::make_pair(file, is_srgb), handle);
+
+        m_textures.push_back(std::make_unique<StreamedTexture>());
+        StreamedTexture& texture = *m_textures.back();
+        texture.m_file           = file;
+        texture.m_format         = is_srgb ? RHI_FORMAT_R8G8B8A8_SRGB : RHI_FORMAT_R8G8B8A8_UNORM;
+
+        if (file.empty())
+        {
+            texture.m_is_settled = true;
+            return handle;
+        }
+
+        texture.m_decode_job = g_runtime_global_context.m_job_system->schedule(
+            "TextureDecode", [this, &texture]() { decodeTexture(texture); });
+        m_pending_textures.push_back(handle);
+
+        return handle;
+    }
+
+    void TextureStreamer::decodeTexture(StreamedTexture& texture) const
+    {
+        if (!m_is_cancelled)
+        {
+            std::shared_ptr<AssetManager> asset_manager = g_runtime_global_context.m_asset_manager;
+
+            int      iw, ih, n;
+            stbi_uc* pixels =
+                stbi_load(asset_manager->getFullPath(texture.m_file).generic_string().c_str(), &iw, &ih, &n, 4);
+            if (pixels)
+            {
+                // the same number of levels the samplers expect, down to 1x1
+                uint32_t width      = static_cast<uint32_t>(iw);
+                uint32_t height     = static_cast<uint32_t>(ih);
+                uint32_t mip_levels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+
+                size_t total_size = 0;
+                texture.m_mip_levels.resize(mip_levels);
+                for (MipLevel& mip_level : texture.m_mip_levels)
+                {
+                    mip_level.m_offset = total_size;
+                    mip_level.m_width  = width;
+                    mip_level.m_height = height;
+                    total_size += size_t(width) * height * 4;
+
+                    width  = std::max(width / 2, 1u);
+                    height = std::max(height / 2, 1u);
+                }
+
+                texture.m_pixels.resize(total_size);
+                std::memcpy(texture.m_pixels.data(), pixels, size_t(iw) * ih * 4);
+                stbi_image_free(pixels);
+
+                const bool is_srgb = texture.m_format == RHI_FORMAT_R8G8B8A8_SRGB;
+                for (size_t level = 1; level < texture.m_mip_levels.size(); ++level)
+                {
+                    const MipLevel& src = texture.m_mip_levels[level - 1];
+                    const MipLevel& dst = texture.m_mip_levels[level];
+                    downsampleMipLevel(texture.m_pixels.data() + src.m_offset,
+                                       src.m_width,
+                                       src.m_height,
+                                       texture.m_pixels.data() + dst.m_offset,
+                                       dst.m_width,
+                                       dst.m_height,
+                                       is_srgb);
+                }
+            }
+        }
+
+        // an empty mip chain marks a failed decode
+        texture.m_is_decoded.store(true, std::memory_order_release);
+    }
+
+    bool TextureStreamer::tick()
+    {
+        bool is_any_settled = retireUploadBatches();
+        is_any_settled |= submitDecodedTextures();
+        return is_any_settled;
+    }
+
+    bool TextureStreamer::isSettled(StreamedTextureHandle handle) const { return m_textures[handle]->m_is_settled; }
+
+    const TextureStreamer::Texture& TextureStreamer::getTexture(StreamedTextureHandle handle) const
+    {
+        const StreamedTexture& texture = *m_textures[handle];
+        if (texture.m_is_resident)
+            return texture.m_texture;
+
+        return texture.m_format == RHI_FORMAT_R8G8B8A8_SRGB ? m_srgb_placeholder : m_unorm_placeholder;
+    }
+
+    bool TextureStreamer::retireUploadBatches()
+    {
+        bool is_any_settled = false;
+        while (!m_in_flight_batches.empty())
+        {
+            UploadBatch& batch = m_upload_batches[m_in_flight_batches.front()];
+            if (!m_rhi->getFenceStatus(batch.m_fence))
+                break;
+
+            m_rhi->resetFencesPFN(1, &batch.m_fence);
+            for (StreamedTextureHandle handle : batch.m_textures)
+            {
+                m_textures[handle]->m_is_resident = true;
+                m_textures[handle]->m_is_settled  = true;
+            }
+            is_any_settled |= !batch.m_textures.empty();
+
+            m_staging_tail = batch.m_staging_end;
+            batch.m_textures.clear();
+            batch.m_is_in_flight = false;
+            m_in_flight_batches.pop_front();
+        }
+        return is_any_settled;
+    }
+
+    bool TextureStreamer::submitDecodedTextures()
+    {
+        if (m_pending_textures.empty() || m_in_flight_batches.size() == k_upload_batch_count)
+            return false;
+
+        uint32_t batch_index = 0;
+        while (m_upload_batches[batch_index].m_is_in_flight)
+        {
+            ++batch_index;
+        }
+        UploadBatch& batch = m_upload_batches[batch_index];
+
+        bool     is_any_settled = false;
+        uint64_t staged_size    = 0;
+        size_t   pending_count  = 0;
+        for (StreamedTextureHandle handle : m_pending_textures)
+        {
+            StreamedTexture& texture = *m_textures[handle];
+
+            bool is_staged = false;
+            if (texture.m_is_decoded.load(std::memory_order_acquire))
+            {
+                if (texture.m_mip_levels.empty())
+                {
+                    LOG_WARN("texture {} failed to load, keeping its placeholder", texture.m_file);
+                    texture.m_is_settled = true;
+                    texture.m_decode_job.reset();
+                    is_any_settled = true;
+                    continue;
+                }
+
+                size_t first_mip = 0;
+                while (texture.m_pixels.size() - texture.m_mip_levels[first_mip].m_offset > k_max_texture_staging_size)
+                {
+                    ++first_mip;
+                }
+                uint64_t size = texture.m_pixels.size() - texture.m_mip_levels[first_mip].m_offset;
+
+                // at least one texture goes each tick, whatever its size
+                uint64_t staging_offset = 0;
+                if ((staged_size == 0 || staged_size + size <= k_max_staging_size_per_tick) &&
+                    allocateStaging(size, staging_offset))
+                {
+                    if (first_mip != 0)
+                    {
+                        LOG_WARN("texture {} is too large to stream, its {} largest mip levels are dropped",
+                                 texture.m_file,
+                                 first_mip);
+                    }
+
+                    std::memcpy(m_staging_data + staging_offset,
+                                texture.m_pixels.data() + texture.m_mip_levels[first_mip].m_offset,
+                                size);
+                    recordTextureUpload(batch, texture, first_mip, staging_offset);
+                    batch.m_textures.push_back(handle);
+                    staged_size += size;
+
+                    std::vector<uint8_t>().swap(texture.m_pixels);
+                    texture.m_decode_job.reset();
+                    is_staged = true;
+                }
+            }
+
+            if (!is_staged)
+            {
+                m_pending_textures[pending_count++] = handle;
+            }
+        }
+        m_pending_textures.resize(pending_count);
+
+        if (!batch.m_textures.empty())
+        {
+            m_rhi->endCommandBufferPFN(batch.m_command_buffer);
+
+            RHISubmitInfo submit_info {};
+            submit_info.sType              = RHI_STRUCTURE_TYPE_SUBMIT_INFO;
+            submit_info.commandBufferCount = 1;
+            submit_info.pCommandBuffers    = &batch.m_command_buffer;
+            if (RHI_SUCCESS != m_rhi->queueSubmit(m_rhi->getTransferQueue(), 1, &submit_info, batch.m_fence))
+            {
+                throw std::runtime_error("texture upload queue submit");
+            }
+
+            batch.m_staging_end  = m_staging_head;
+            batch.m_is_in_flight = true;
+            m_in_flight_batches.push_back(batch_index);
+        }
+
+        return is_any_settled;
+    }
+
+    void TextureStreamer::recordTextureUpload(UploadBatch&     batch,
+                                              StreamedTexture& texture,
+                                              size_t           first_mip,
+                                              uint64_t         staging_offset)
+    {
+        if (batch.m_textures.empty())
+        {
+            RHICommandBufferBeginInfo command_buffer_begin_info {};
+            command_buffer_begin_info.sType = RHI_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            command_buffer_begin_info.flags = RHI_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            m_rhi->beginCommandBufferPFN(batch.m_command_buffer, &command_buffer_begin_info);
+        }
+
+        const uint32_t mip_levels = static_cast<uint32_t>(texture.m_mip_levels.size() - first_mip);
+        const MipLevel top_level  = texture.m_mip_levels[first_mip];
+
+        texture.m_texture.m_width  = top_level.m_width;
+        texture.m_texture.m_height = top_level.m_height;
+        m_rhi->createSampledImage(texture.m_texture.m_image,
+                                  texture.m_texture.m_image_view,
+                                  texture.m_texture.m_image_allocation,
+                                  top_level.m_width,
+                                  top_level.m_height,
+                                  texture.m_format,
+                                  mip_levels);
+
+        RHIImageMemoryBarrier barrier {};
+        barrier.sType                           = RHI_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask                   = 0;
+        barrier.dstAccessMask                   = RHI_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout                       = RHI_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout                       = RHI_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex             = RHI_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex             = RHI_QUEUE_FAMILY_IGNORED;
+        barrier.image                           = texture.m_texture.m_image;
+        barrier.subresourceRange.aspectMask     = RHI_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel   = 0;
+        barrier.subresourceRange.levelCount     = mip_levels;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount     = 1;
+        m_rhi->cmdPipelineBarrier(batch.m_command_buffer,
+                                  RHI_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                  RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr,
+                                  1,
+                                  &barrier);
+
+        std::vector<RHIBufferImageCopy> regions(mip_levels);
+        for (uint32_t level = 0; level < mip_levels; ++level)
+        {
+            const MipLevel& mip_level = texture.m_mip_levels[first_mip + level];
+
+            RHIBufferImageCopy& region             = regions[level];
+            region.bufferOffset                    = staging_offset + (mip_level.m_offset - top_level.m_offset);
+            region.bufferRowLength                 = 0;
+            region.bufferImageHeight               = 0;
+            region.imageSubresource.aspectMask     = RHI_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel       = level;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount     = 1;
+            region.imageOffset                     = {0, 0, 0};
+            region.imageExtent                     = {mip_level.m_width, mip_level.m_height, 1};
+        }
+        m_rhi->cmdCopyBufferToImage(batch.m_command_buffer,
+                                    m_staging_buffer,
+                                    texture.m_texture.m_image,
+                                    RHI_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                    mip_levels,
+                                    regions.data());
+
+        // the graphics queue samples the image once the fence of the batch has signaled
+        barrier.srcAccessMask = RHI_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        barrier.oldLayout     = RHI_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout     = RHI_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        m_rhi->cmdPipelineBarrier(batch.m_command_buffer,
+                                  RHI_PIPELINE_STAGE_TRANSFER_BIT,
+                                  RHI_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                  0,
+                                  0,
+                                  nullptr,
+                                  0,
+                                  nullptr,
+                                  1,
+                                  &barrier);
+    }
+
+    bool TextureStreamer::allocateStaging(uint64_t size, uint64_t& out_offset)
+    {
+        uint64_t position = (m_staging_head + k_staging_alignment - 1) & ~(k_staging_alignment - 1);
+
+        // a texture never straddles the end of the buffer
+        uint64_t offset = position % k_staging_buffer_size;
+        if (offset + size > k_staging_buffer_size)
+        {
+            position += k_staging_buffer_size - offset;
+            offset = 0;
+        }
+
+        if (position + size - m_staging_tail > k_staging_buffer_size)
+            return false;
+
+        m_staging_head = position + size;
+        out_offset     = offset;
+        return true;
+    }
+} // namespace Piccolo
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "runtime/core/job/job_system.h"
+
+#include "runtime/function/render/render_type.h"
+
+#include <vk_mem_alloc.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Piccolo
+{
+    class RHI;
+    class RHIBuffer;
+    class RHICommandBuffer;
+    class RHICommandPool;
+    class RHIDeviceMemory;
+    class RHIFence;
+    class RHIImage;
+    class RHIImageView;
+
+    using StreamedTextureHandle = uint32_t;
+
+    /// Loads the material textures in the background.
+    /// The files are decoded and their mip chains built on the job system workers. Each tick the render thread
+    /// copies the decoded textures to a persistently mapped staging ring and records their uploads into one
+    /// command buffer submitted to the transfer queue, a fence per batch tells when its textures can be sampled
+    /// and when its range of the ring can be reused, so the texture uploads never wait for the gpu.
+    /// A texture is backed by a 1x1 placeholder until it's resident.
+    /// Only textures are streamed: the vertex and index buffers of a mesh are drawn the frame it's first used, so
+    /// they are still copied with single time commands waiting for the graphics queue.
+    class TextureStreamer
+    {
+    public:
+        struct Texture
+        {
+            RHIImage*     m_image {nullptr};
+            RHIImageView* m_image_view {nullptr};
+            VmaAllocation m_image_allocation {nullptr};
+            uint32_t      m_width {1};
+            uint32_t      m_height {1};
+        };
+
+        explicit TextureStreamer(std::shared_ptr<RHI> rhi);
+        /// wait for the decodes and the uploads in flight, the images of the textures outlive the streamer
+        ~TextureStreamer();
+
+        /// textures are shared by file, an empty file or one failing to decode stays on the placeholder
+        StreamedTextureHandle requestTexture(const std::string& file, bool is_srgb);
+
+        /// retire the completed uploads and submit the decoded textures, return whether any texture settled
+        bool tick();
+
+        /// settled textures won't change anymore, they are either resident or failed
+        bool isSettled(StreamedTextureHandle handle) const;
+        /// the texture if it's resident, its placeholder otherwise
+        const Texture& getTexture(StreamedTextureHandle handle) const;
+
+    private:
+        struct MipLevel
+        {
+            size_t   m_offset {0};
+            uint32_t m_width {0};
+            uint32_t m_height {0};
+        };
+
+        struct StreamedTexture
+        {
+            std::string m_file;
+            RHIFormat   m_format {RHI_FORMAT_R8G8B8A8_UNORM};
+
+            // written by the decode job, the mip chain is tightly packed from the largest level
+            std::vector<uint8_t>  m_pixels;
+            std::vector<MipLevel> m_mip_levels;
+            std::atomic<bool>     m_is_decoded {false};
+            JobHandle             m_decode_job;
+
+            Texture m_texture;
+            bool    m_is_resident {false};
+            bool    m_is_settled {false};
+        };
+
+        struct UploadBatch
+        {
+            RHICommandBuffer* m_command_buffer {nullptr};
+            RHIFence*         m_fence {nullptr};
+            // the ring is free up to there once the batch is complete
+            uint64_t                           m_staging_end {0};
+            std::vector<StreamedTextureHandle> m_textures;
+            bool                               m_is_in_flight {false};
+        };
+
+        static constexpr uint32_t k_upload_batch_count = 4;
+
+        void createPlaceholders();
+        void createUploadResources();
+
+        void decodeTexture(StreamedTexture& texture) const;
+        bool retireUploadBatches();
+        bool submitDecodedTextures();
+        void recordTextureUpload(UploadBatch&     batch,
+                                 StreamedTexture& texture,
+                                 size_t           first_mip,
+                                 uint64_t         staging_offset);
+        bool allocateStaging(uint64_t size, uint64_t& out_offset);
+
+        std::shared_ptr<RHI> m_rhi;
+
+        std::vector<std::unique_ptr<StreamedTexture>>                 m_textures;
+        std::map<std::pair<std::string, bool>, StreamedTextureHandle> m_texture_handles;
+        // requested textures which are not settled yet and not being uploaded, in request order
+        std::vector<StreamedTextureHandle> m_pending_textures;
+
+        Texture m_unorm_placeholder;
+        Texture m_srgb_placeholder;
+
+        // the ring is addressed by ever growing positions, the offset in the buffer is the position modulo its size
+        RHIBuffer*       m_staging_buffer {nullptr};
+        RHIDeviceMemory* m_staging_buffer_memory {nullptr};
+        uint8_t*         m_staging_data {nullptr};
+        uint64_t         m_staging_head {0};
+        uint64_t         m_staging_tail {0};
+
+        RHICommandPool*                               m_command_pool {nullptr};
+        std::array<UploadBatch, k_upload_batch_count> m_upload_batches;
+        // submitted batches complete in submission order on the transfer queue
+        std::deque<uint32_t> m_in_flight_batches;
+
+        std::atomic<bool> m_is_cancelled {false};
+    };
+} // namespace Piccolo
@@ -1616,6 +1616,31 @@ namespace Piccolo
         RHI_DEPENDENCY_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
     };
 
+    enum RHIDescriptorPoolCreateFlagBits {
+        RHI_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT = 0x00000001,
+        RHI_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT = 0x00000002,
+        RHI_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT = RHI_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+        RHI_DESCRIPTOR_POOL_CREATE_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    enum RHIDescriptorSetLayoutCreateFlagBits {
+        RHI_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT = 0x00000002,
+        RHI_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT = RHI_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+        RHI_DESCRIPTOR_SET_LAYOUT_CREATE_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
+
+    enum RHIDescriptorBindingFlagBits {
+        RHI_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT = 0x00000001,
+        RHI_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT = 0x00000002,
+        RHI_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT = 0x00000004,
+        RHI_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT = 0x00000008,
+        RHI_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT = RHI_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT,
+        RHI_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT = RHI_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT,
+        RHI_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT = RHI_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT,
+        RHI_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT_EXT = RHI_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT,
+        RHI_DESCRIPTOR_BINDING_FLAG_BITS_MAX_ENUM = 0x7FFFFFFF
+    };
+
     typedef uint32_t RHIAccessFlags;
     typedef uint32_t RHIImageAspectFlags;
     typedef uint32_t RHIFormatFeatureFlags;
@@ -1663,6 +1688,7 @@ namespace Piccolo
     typedef uint32_t RHIDescriptorPoolCreateFlags;
     typedef uint32_t RHIDescriptorPoolResetFlags;
     typedef uint32_t RHIDescriptorSetLayoutCreateFlags;
+    typedef uint32_t RHIDescriptorBindingFlags;
     typedef uint32_t RHIAttachmentDescriptionFlags;
     typedef uint32_t RHIDependencyFlags;
     typedef uint32_t RHIFramebufferCreateFlags;
@@ -1805,6 +1831,8 @@ namespace Piccolo
     {
         std::shared_ptr<BufferData> m_vertex_buffer;
         std::shared_ptr<BufferData> m_index_buffer;
+        // 32 bit indices are only used by the meshes with more vertices than 16 bit indices can address
+        RHIIndexType m_index_type {RHI_INDEX_TYPE_UINT16};
     };
 
     struct RenderMeshData
@@ -41,9 +41,15 @@ namespace Piccolo
         glfwSetScrollCallback(m_window, scrollCallback);
         glfwSetDropCallback(m_window, dropCallback);
         glfwSetWindowSizeCallback(m_window, windowSizeCallback);
+        glfwSetFramebufferSizeCallback(m_window, framebufferSizeCallback);
         glfwSetWindowCloseCallback(m_window, windowCloseCallback);
 
         glfwSetInputMode(m_window, GLFW_RAW_MOUSE_MOTION, GLFW_FALSE);
+
+        int framebuffer_width  = 0;
+        int framebuffer_height = 0;
+        glfwGetFramebufferSize(m_window, &framebuffer_width, &framebuffer_height);
+        setFramebufferSize(framebuffer_width, framebuffer_height);
     }
 
     void WindowSystem::pollEvents() const { glfwPollEvents(); }
@@ -56,6 +62,20 @@ namespace Piccolo
 
     std::array<int, 2> WindowSystem::getWindowSize() const { return std::array<int, 2>({m_width, m_height}); }
 
+    std::array<int, 2> WindowSystem::getFramebufferSize() const
+    {
+        const uint64_t framebuffer_size = m_framebuffer_size.load(std::memory_order_acquire);
+        return std::array<int, 2>(
+            {static_cast<int>(framebuffer_size >> 32), static_cast<int>(framebuffer_size & 0xffffffff)});
+    }
+
+    void WindowSystem::setFramebufferSize(int width, int height)
+    {
+        m_framebuffer_size.store((static_cast<uint64_t>(static_cast<uint32_t>(width)) << 32) |
+                                     static_cast<uint32_t>(height),
+                                 std::memory_order_release);
+    }
+
     void WindowSystem::setFocusMode(bool mode)
     {
         m_is_focus_mode = mode;
@@ -4,6 +4,8 @@
 #include <GLFW/glfw3.h>
 
 #include <array>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <vector>
 
@@ -28,6 +30,8 @@ namespace Piccolo
         void               setTitle(const char* title);
         GLFWwindow*        getWindow() const;
         std::array<int, 2> getWindowSize() const;
+        /// as of the last processed window events, may be called from any thread
+        std::array<int, 2> getFramebufferSize() const;
 
         typedef std::function<void()>                   onResetFunc;
         typedef std::function<void(int, int, int, int)> onKeyFunc;
@@ -139,6 +143,14 @@ namespace Piccolo
                 app->m_height = height;
             }
         }
+        static void framebufferSizeCallback(GLFWwindow* window, int width, int height)
+        {
+            WindowSystem* app = (WindowSystem*)glfwGetWindowUserPointer(window);
+            if (app)
+            {
+                app->setFramebufferSize(width, height);
+            }
+        }
         static void windowCloseCallback(GLFWwindow* window) { glfwSetWindowShouldClose(window, true); }
 
         void onReset()
@@ -193,9 +205,13 @@ namespace Piccolo
         }
 
     private:
+        void setFramebufferSize(int width, int height);
+
         GLFWwindow* m_window {nullptr};
         int         m_width {0};
         int         m_height {0};
+        // width in the high and height in the low half, glfw may only be queried on the thread owning the window
+        std::atomic<uint64_t> m_framebuffer_size {0};
 
         bool m_is_focus_mode {false};
 
@@ -0,0 +1,288 @@
+#pragma once
+
+#include "runtime/core/job/job_system.h"
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Piccolo
+{
+    struct AssetCacheStatistics
+    {
+        uint64_t m_hit_count {0};
+        uint64_t m_miss_count {0};
+        uint64_t m_eviction_count {0};
+        size_t   m_resident_count {0};
+        size_t   m_resident_bytes {0};
+        size_t   m_loading_count {0};
+
+        float getHitRate() const
+        {
+            const uint64_t request_count = m_hit_count + m_miss_count;
+            return request_count > 0 ? static_cast<float>(m_hit_count) / request_count : 0.0f;
+        }
+
+        AssetCacheStatistics& operator+=(const AssetCacheStatistics& rhs)
+        {
+            m_hit_count += rhs.m_hit_count;
+            m_miss_count += rhs.m_miss_count;
+            m_eviction_count += rhs.m_eviction_count;
+            m_resident_count += rhs.m_resident_count;
+            m_resident_bytes += rhs.m_resident_bytes;
+            m_loading_count += rhs.m_loading_count;
+            return *this;
+        }
+    };
+
+    /// Thread safe cache of the assets of one type, keyed by file.
+    /// Assets are loaded on the job system workers and handed out as shared pointers, which are the references
+    /// counted by the cache: once the resident bytes exceed the budget, the least recently used assets nobody
+    /// else references are evicted. Referenced assets are never evicted, so the budget is a soft limit. An asset
+    /// that fails to load is not cached, the next request loads it again.
+    template<typename AssetType>
+    class AssetCache
+    {
+    public:
+        using AssetHandle  = std::shared_ptr<AssetType>;
+        using LoadFunction = std::function<AssetHandle(const std::string&)>;
+        using SizeFunction = std::function<size_t(const AssetType&)>;
+
+        /// @job_system: runs the loads, must outlive the cache
+        /// @name: must outlive the cache, names the load jobs
+        AssetCache(std::shared_ptr<JobSystem> job_system,
+                   const char*                name,
+                   LoadFunction               load_function,
+                   SizeFunction               size_function,
+                   size_t                     budget_bytes) :
+            m_job_system(std::move(job_system)), m_name(name), m_load_function(std::move(load_function)),
+            m_size_function(std::move(size_function)), m_budget_bytes(budget_bytes)
+        {}
+
+        ~AssetCache() { clear(); }
+
+        /// start loading the asset on a worker if it's neither resident nor loading, never blocks
+        void prefetch(const std::string& file_path)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_entries.find(file_path) == m_entries.end())
+            {
+                m_statistics.m_miss_count++;
+                startLoad(file_path);
+            }
+        }
+
+        /// the asset if it's resident, nullptr otherwise, a missing asset starts loading
+        AssetHandle tryGet(const std::string& file_path)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto found = m_entries.find(file_path);
+            if (found != m_entries.end() && found->second.m_is_loaded)
+            {
+                touch(found->second);
+                m_statistics.m_hit_count++;
+                return found->second.m_asset;
+            }
+            if (found == m_entries.end())
+            {
+                m_statistics.m_miss_count++;
+                startLoad(file_path);
+            }
+            return nullptr;
+        }
+
+        /// the asset, blocks until it's loaded, the calling thread runs other jobs meanwhile, nullptr if it fails to
+        /// load
+        AssetHandle load(const std::string& file_path)
+        {
+            JobHandle                    load_job;
+            std::shared_ptr<AssetHandle> load_result;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                auto found = m_entries.find(file_path);
+                if (found == m_entries.end())
+                {
+                    m_statistics.m_miss_count++;
+                    found = startLoad(file_path);
+                }
+                else
+                {
+                    m_statistics.m_hit_count++;
+                    if (found->second.m_is_loaded)
+                    {
+                        touch(found->second);
+                        return found->second.m_asset;
+                    }
+                }
+                load_job    = found->second.m_load_job;
+                load_result = found->second.m_load_result;
+            }
+
+            // the result of the job is read rather than the entry, the asset may be evicted before this thread wakes
+            // up and a failed load leaves no entry
+            m_job_system->wait(load_job);
+            return *load_result;
+        }
+
+        void setBudget(size_t budget_bytes)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_budget_bytes = budget_bytes;
+            trim();
+        }
+
+        AssetCacheStatistics getStatistics() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            AssetCacheStatistics statistics = m_statistics;
+            statistics.m_resident_count     = m_lru_file_paths.size();
+            statistics.m_loading_count      = m_entries.size() - m_lru_file_paths.size();
+            return statistics;
+        }
+
+        /// wait for the loads in flight and drop every asset, the handles held outside stay valid
+        void clear()
+        {
+            std::vector<JobHandle> load_jobs;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                for (auto& entry : m_entries)
+                {
+                    if (!entry.second.m_is_loaded && entry.second.m_load_job)
+                    {
+                        load_jobs.push_back(entry.second.m_load_job);
+                    }
+                }
+            }
+            if (!load_jobs.empty())
+            {
+                m_job_system->waitAll(load_jobs);
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_entries.clear();
+            m_lru_file_paths.clear();
+            m_statistics.m_resident_bytes = 0;
+        }
+
+    private:
+        struct Entry
+        {
+            AssetHandle m_asset;
+            JobHandle   m_load_job;
+            // written by the load job before it's done, read by the threads waiting for it
+            std::shared_ptr<AssetHandle> m_load_result;
+            size_t                       m_size {0};
+            bool                         m_is_loaded {false};
+            // position in m_lru_file_paths once loaded
+            typename std::list<std::string>::iterator m_lru_position;
+        };
+        using EntryMap = std::unordered_map<std::string, Entry>;
+
+        typename EntryMap::iterator startLoad(const std::string& file_path)
+        {
+            auto   inserted = m_entries.emplace(file_path, Entry()).first;
+            Entry& entry    = inserted->second;
+
+            // the file path is copied, the entry may be gone by the time the job runs
+            entry.m_load_result = std::make_shared<AssetHandle>();
+            entry.m_load_job    = m_job_system->schedule(m_name,
+                                                      [this, file_path, load_result = entry.m_load_result]() {
+                                                          finishLoad(file_path, *load_result);
+                                                      });
+            return inserted;
+        }
+
+        void finishLoad(const std::string& file_path, AssetHandle& load_result)
+        {
+            // the lock is not held while loading, other assets are loaded and handed out meanwhile
+            AssetHandle  asset = m_load_function(file_path);
+            const size_t size  = asset ? m_size_function(*asset) : 0;
+            load_result        = asset;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto found = m_entries.find(file_path);
+            if (found == m_entries.end())
+            {
+                return;
+            }
+
+            // a failed load is not cached, the next request loads the asset again
+            if (!asset)
+            {
+                m_entries.erase(found);
+                return;
+            }
+
+            Entry& entry      = found->second;
+            entry.m_asset     = asset;
+            entry.m_size      = size;
+            entry.m_is_loaded = true;
+            entry.m_load_job.reset();
+            entry.m_load_result.reset();
+            m_lru_file_paths.push_front(file_path);
+            entry.m_lru_position = m_lru_file_paths.begin();
+
+            m_statistics.m_resident_bytes += size;
+            trim();
+        }
+
+        void touch(Entry& entry)
+        {
+            m_lru_file_paths.splice(m_lru_file_paths.begin(), m_lru_file_paths, entry.m_lru_position);
+        }
+
+        // evict the least recently used assets nobody references until the cache is back within its budget
+        // the most recently used asset is kept, it may be the one about to be handed out
+        void trim()
+        {
+            if (m_lru_file_paths.size() < 2)
+            {
+                return;
+            }
+
+            auto iter = std::prev(m_lru_file_paths.end());
+            while (m_statistics.m_resident_bytes > m_budget_bytes && iter != m_lru_file_paths.begin())
+            {
+                // every reference is copied from the cache under the lock, a single owner can't grow meanwhile
+                auto found = m_entries.find(*iter);
+                if (found->second.m_asset.use_count() > 1)
+                {
+                    --iter;
+                    continue;
+                }
+
+                m_statistics.m_resident_bytes -= found->second.m_size;
+                m_statistics.m_eviction_count++;
+                m_entries.erase(found);
+                iter = std::prev(m_lru_file_paths.erase(iter));
+            }
+        }
+
+        std::shared_ptr<JobSystem> m_job_system;
+        const char*                m_name {nullptr};
+        LoadFunction               m_load_function;
+        SizeFunction               m_size_function;
+        size_t                     m_budget_bytes {0};
+
+        mutable std::mutex m_mutex;
+        EntryMap           m_entries;
+        // the loaded assets, most recently used first
+        std::list<std::string> m_lru_file_paths;
+        AssetCacheStatistics   m_statistics;
+    };
+} // namespace Piccolo
@@ -1,13 +1,85 @@
 #include "runtime/resource/asset_manager/asset_manager.h"
 
+#include "runtime/platform/file_service/file_service.h"
+#include "runtime/platform/path/path.h"
+
 #include "runtime/resource/config_manager/config_manager.h"
+#include "runtime/resource/res_type/common/level.h"
+#include "runtime/resource/res_type/common/object.h"
+#include "runtime/resource/res_type/common/world.h"
+#include "runtime/resource/res_type/data/animation_clip.h"
+#include "runtime/resource/res_type/data/animation_skeleton_node_map.h"
+#include "runtime/resource/res_type/data/material.h"
+#include "runtime/resource/res_type/data/skeleton_data.h"
+#include "runtime/resource/res_type/data/skeleton_mask.h"
+#include "runtime/resource/res_type/global/global_particle.h"
+#include "runtime/resource/res_type/global/global_rendering.h"
 
 #include "runtime/function/global/global_context.h"
 
+#include <chrono>
+#include <cstring>
 #include <filesystem>
+#include <system_error>
 
 namespace Piccolo
 {
+    namespace
+    {
+        template<typename AssetType>
+        bool cookAndMeasureAsset(const AssetManager& asset_manager, const std::string& asset_url, AssetCookStats& stats)
+        {
+            if (!asset_manager.cookAsset<AssetType>(asset_url))
+                return false;
+
+            using Clock = std::chrono::steady_clock;
+
+            const Clock::time_point json_start = Clock::now();
+            {
+                AssetType asset;
+                asset_manager.loadJsonAsset(asset_url, asset);
+            }
+            const Clock::time_point cooked_start = Clock::now();
+            {
+                AssetType asset;
+                if (!asset_manager.loadCookedAsset(asset_url, asset))
+                    return false;
+            }
+            const Clock::time_point cooked_end = Clock::now();
+
+            stats.m_json_load_ms += std::chrono::duration<double, std::milli>(cooked_start - json_start).count();
+            stats.m_cooked_load_ms += std::chrono::duration<double, std::milli>(cooked_end - cooked_start).count();
+            return true;
+        }
+
+        struct AssetCooker
+        {
+            const char* m_suffix;
+            bool (*m_cook)(const AssetManager&, const std::string&, AssetCookStats&);
+        };
+
+        // the asset type of a json file is given by its suffix
+        const AssetCooker k_asset_cookers[] = {
+            {".world.json", &cookAndMeasureAsset<WorldRes>},
+            {".level.json", &cookAndMeasureAsset<LevelRes>},
+            {".object.json", &cookAndMeasureAsset<ObjectDefinitionRes>},
+            {".material.json", &cookAndMeasureAsset<MaterialRes>},
+            {"rendering.global.json", &cookAndMeasureAsset<GlobalRenderingRes>},
+            {"particle.global.json", &cookAndMeasureAsset<GlobalParticleRes>},
+            {".animation_clip.json", &cookAndMeasureAsset<AnimationAsset>},
+            {".skeleton.json", &cookAndMeasureAsset<SkeletonData>},
+            {".skeleton_map.json", &cookAndMeasureAsset<AnimSkelMap>},
+            {".skeleton_mask.json", &cookAndMeasureAsset<BoneBlendMask>},
+        };
+
+        bool endsWith(const std::string& text, const char* suffix)
+        {
+            const size_t suffix_length = std::strlen(suffix);
+            return text.size() >= suffix_length &&
+                   text.compare(text.size() - suffix_length, suffix_length, suffix) == 0;
+        }
+    } // namespace
+
     std::filesystem::path AssetManager::getFullPath(const std::string& relative_path) const
     {
         return std::filesystem::absolute(g_runtime_global_context.m_config_manager->getRootFolder() / relative_path);
@@ -17,4 +89,122 @@ namespace Piccolo
     {
         return std::filesystem::absolute(g_runtime_global_context.m_config_manager->getRuntimeFolder() / relative_path);
     }
-} // namespace Piccolo
\ No newline at end of file
+
+    std::filesystem::path AssetManager::getCookedPath(const std::string& relative_path) const
+    {
+        return getFullPath(relative_path).replace_extension(".bin");
+    }
+
+    bool AssetManager::mapCookedAsset(const std::string& asset_url, MappedFile& out_file) const
+    {
+        const std::filesystem::path cooked_path = getCookedPath(asset_url);
+        const std::filesystem::path json_path   = getFullPath(asset_url);
+
+        // a json edited after the cook wins, the cooked file alone is enough when the json isn't shipped
+        std::error_code error;
+        const auto      cooked_time = std::filesystem::last_write_time(cooked_path, error);
+        if (error)
+            return false;
+        const auto json_time = std::filesystem::last_write_time(json_path, error);
+        if (!error && json_time > cooked_time)
+            return false;
+
+        if (!out_file.open(cooked_path))
+            return false;
+
+        CookedAssetHeader header;
+        if (out_file.getSize() < sizeof(CookedAssetHeader))
+        {
+            LOG_WARN("cooked asset {} is truncated, loading json instead", cooked_path.generic_string());
+            out_file.close();
+            return false;
+        }
+        std::memcpy(&header, out_file.getData(), sizeof(CookedAssetHeader));
+
+        if (header.m_magic != CookedAssetHeader::k_magic ||
+            header.m_format_version != CookedAssetHeader::k_format_version ||
+            header.m_schema_hash != k_serializer_schema_hash ||
+            header.m_payload_size != out_file.getSize() - sizeof(CookedAssetHeader))
+        {
+            LOG_WARN("cooked asset {} is out of date, loading json instead", cooked_path.generic_string());
+            out_file.close();
+            return false;
+        }
+        return true;
+    }
+
+    bool AssetManager::writeCookedAsset(const std::string& asset_url, BinaryWriter& writer) const
+    {
+        std::vector<uint8_t>& buffer = writer.getBuffer();
+
+        CookedAssetHeader header;
+        header.m_payload_size = buffer.size() - sizeof(CookedAssetHeader);
+        std::memcpy(buffer.data(), &header, sizeof(CookedAssetHeader));
+
+        // write next to the final file and swap, a running engine never maps a half written file
+        const std::filesystem::path cooked_path = getCookedPath(asset_url);
+        std::filesystem::path       temp_path   = cooked_path;
+        temp_path += ".tmp";
+        {
+            std::ofstream cooked_file(temp_path, std::ios::binary | std::ios::trunc);
+            if (!cooked_file)
+            {
+                LOG_ERROR("open file {} failed!", temp_path.generic_string());
+                return false;
+            }
+            cooked_file.write(reinterpret_cast<const char*>(buffer.data()),
+                              static_cast<std::streamsize>(buffer.size()));
+            if (!cooked_file)
+            {
+                LOG_ERROR("write file {} failed!", temp_path.generic_string());
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temp_path, cooked_path, error);
+        if (error)
+        {
+            LOG_ERROR("replace file {} failed: {}", cooked_path.generic_string(), error.message());
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+        return true;
+    }
+
+    AssetCookStats AssetManager::cookAssets() const
+    {
+        AssetCookStats stats;
+
+        const std::filesystem::path& root_folder = g_runtime_global_context.m_config_manager->getRootFolder();
+        FileSystem                   file_system;
+        for (const std::filesystem::path& file_path :
+             file_system.getFiles(g_runtime_global_context.m_config_manager->getAssetFolder()))
+        {
+            const std::string asset_url = Path::getRelativePath(root_folder, file_path).generic_string();
+            for (const AssetCooker& cooker : k_asset_cookers)
+            {
+                if (!endsWith(asset_url, cooker.m_suffix))
+                    continue;
+
+                if (cooker.m_cook(*this, asset_url, stats))
+                {
+                    ++stats.m_cooked_count;
+                }
+                else
+                {
+                    LOG_ERROR("cook asset {} failed!", asset_url);
+                    ++stats.m_failed_count;
+                }
+                break;
+            }
+        }
+
+        LOG_INFO("cooked {} assets, {} failed, load time json {:.3f} ms, cooked {:.3f} ms",
+                 stats.m_cooked_count,
+                 stats.m_failed_count,
+                 stats.m_json_load_ms,
+                 stats.m_cooked_load_ms);
+        return stats;
+    }
+} // namespace Piccolo
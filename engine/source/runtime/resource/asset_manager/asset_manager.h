@@ -1,8 +1,12 @@
 #pragma once
 
 #include "runtime/core/base/macro.h"
+#include "runtime/core/meta/serializer/binary_serializer.h"
 #include "runtime/core/meta/serializer/serializer.h"
 
+#include "runtime/platform/file_service/mapped_file.h"
+
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <functional>
@@ -13,11 +17,42 @@
 
 namespace Piccolo
 {
+    /// Header of the cooked assets, followed by the BinarySerializer payload of the asset.
+    struct CookedAssetHeader
+    {
+        static constexpr uint32_t k_magic          = 0x4b434350; // "PCCK"
+        static constexpr uint32_t k_format_version = 1;
+
+        uint32_t m_magic {k_magic};
+        uint32_t m_format_version {k_format_version};
+        uint64_t m_schema_hash {k_serializer_schema_hash};
+        uint64_t m_payload_size {0};
+    };
+
+    struct AssetCookStats
+    {
+        uint32_t m_cooked_count {0};
+        uint32_t m_failed_count {0};
+        // total time to load every cooked asset once through each path
+        double m_json_load_ms {0.0};
+        double m_cooked_load_ms {0.0};
+    };
+
     class AssetManager
     {
     public:
+        /// load the cooked version of the asset if it's up to date, the json one otherwise
         template<typename AssetType>
         bool loadAsset(const std::string& asset_url, AssetType& out_asset) const
+        {
+            if (loadCookedAsset(asset_url, out_asset))
+                return true;
+
+            return loadJsonAsset(asset_url, out_asset);
+        }
+
+        template<typename AssetType>
+        bool loadJsonAsset(const std::string& asset_url, AssetType& out_asset) const
         {
             // read json file to string
             std::filesystem::path asset_path = getFullPath(asset_url);
@@ -45,6 +80,40 @@ namespace Piccolo
             return true;
         }
 
+        /// read the asset straight from the mapped cooked file, fails if there is none or it's out of date
+        template<typename AssetType>
+        bool loadCookedAsset(const std::string& asset_url, AssetType& out_asset) const
+        {
+            MappedFile cooked_file;
+            if (!mapCookedAsset(asset_url, cooked_file))
+                return false;
+
+            BinaryReader reader(cooked_file.getData() + sizeof(CookedAssetHeader),
+                                cooked_file.getSize() - sizeof(CookedAssetHeader));
+            BinarySerializer::read(reader, out_asset);
+            if (!reader.isValid() || reader.getRemainingSize() != 0)
+            {
+                LOG_WARN("cooked asset {} is corrupted, loading json instead",
+                         getCookedPath(asset_url).generic_string());
+                // the components read so far are owned by nobody yet
+                reader.deleteReadInstances();
+                out_asset = AssetType {};
+                return false;
+            }
+            return true;
+        }
+
+        /// convert the json asset to its cooked version next to it
+        template<typename AssetType>
+        bool cookAsset(const std::string& asset_url) const
+        {
+            AssetType asset;
+            if (!loadJsonAsset(asset_url, asset))
+                return false;
+
+            return saveCookedAsset(asset, asset_url);
+        }
+
         template<typename AssetType>
         bool saveAsset(const AssetType& out_asset, const std::string& asset_url) const
         {
@@ -60,18 +129,42 @@ namespace Piccolo
             std::string&& asset_json_text = asset_json.dump();
 
             // write to file
-            asset_json_file << asset_json_text; 
+            asset_json_file << asset_json_text;
             asset_json_file.flush();
 
             std::ofstream asset_json_file_runtime(getRuntimePath(asset_url));
             asset_json_file_runtime << asset_json_text;
             asset_json_file_runtime.flush();
 
+            // keep an existing cooked version in sync, otherwise it's ignored until the next cook
+            if (std::filesystem::exists(getCookedPath(asset_url)))
+            {
+                saveCookedAsset(out_asset, asset_url);
+            }
+
             return true;
         }
 
+        template<typename AssetType>
+        bool saveCookedAsset(const AssetType& asset, const std::string& asset_url) const
+        {
+            BinaryWriter writer;
+            writer.writeValue(CookedAssetHeader {});
+            BinarySerializer::write(writer, asset);
+
+            return writeCookedAsset(asset_url, writer);
+        }
+
+        /// cook every json asset of a known type under the asset folder, then time the json and the cooked loads
+        /// of all of them
+        AssetCookStats cookAssets() const;
+
         std::filesystem::path getFullPath(const std::string& relative_path) const;
         std::filesystem::path getRuntimePath(const std::string& relative_path) const;
+        std::filesystem::path getCookedPath(const std::string& relative_path) const;
 
+    private:
+        bool mapCookedAsset(const std::string& asset_url, MappedFile& out_file) const;
+        bool writeCookedAsset(const std::string& asset_url, BinaryWriter& writer) const;
     };
 } // namespace Piccolo
@@ -1,7 +1,10 @@
 #include "runtime/resource/config_manager/config_manager.h"
 
+#include "runtime/core/base/macro.h"
+
 #include "runtime/engine.h"
 
+#include <charconv>
 #include <filesystem>
 #include <fstream>
 #include <string>
@@ -64,6 +67,21 @@ namespace Piccolo
                 {
                     m_global_particle_res_url = value;
                 }
+                else if (name == "RenderFrameLatency")
+                {
+                    // a bad value must not abort the start, the default is kept then
+                    uint32_t   render_frame_latency = 0;
+                    const auto result =
+                        std::from_chars(value.data(), value.data() + value.size(), render_frame_latency);
+                    if (result.ec == std::errc())
+                    {
+                        m_render_frame_latency = render_frame_latency;
+                    }
+                    else
+                    {
+                        LOG_WARN("invalid RenderFrameLatency {}, {} is used", value, m_render_frame_latency);
+                    }
+                }
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
                 else if (name == "JoltAssetFolder")
                 {
@@ -96,6 +114,8 @@ namespace Piccolo
 
     const std::string& ConfigManager::getGlobalParticleResUrl() const { return m_global_particle_res_url; }
 
+    uint32_t ConfigManager::getRenderFrameLatency() const { return m_render_frame_latency; }
+
 #ifdef ENABLE_PHYSICS_DEBUG_RENDERER
     const std::filesystem::path& ConfigManager::getJoltPhysicsAssetFolder() const { return m_jolt_physics_asset_folder; }
 #endif
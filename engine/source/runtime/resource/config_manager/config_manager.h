@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 
 namespace Piccolo
@@ -28,6 +29,10 @@ namespace Piccolo
         const std::string& getGlobalRenderingResUrl() const;
         const std::string& getGlobalParticleResUrl() const;
 
+        // frames the logic may run ahead of the render thread, 0 renders on the logic thread
+        // only a runtime without the editor renders on its own thread, the editor always uses 0
+        uint32_t getRenderFrameLatency() const;
+
     private:
         std::filesystem::path m_root_folder;
         std::filesystem::path m_runtime_folder;
@@ -45,5 +50,7 @@ namespace Piccolo
         std::string m_demo_world_url;
         std::string m_global_rendering_res_url;
         std::string m_global_particle_res_url;
+
+        uint32_t m_render_frame_latency {0};
     };
 } // namespace Piccolo
@@ -16,6 +16,14 @@ namespace Piccolo
         invalid
     };
 
+    enum class RigidBodyActorType : int
+    {
+        invalid,
+        static_actor,
+        dynamic_actor,
+        kinematic_actor
+    };
+
     REFLECTION_TYPE(RigidBodyShape)
     CLASS(RigidBodyShape, WhiteListFields)
     {
@@ -44,7 +52,9 @@ namespace Piccolo
 
     public:
         std::vector<RigidBodyShape> m_shapes;
-        float                       m_inverse_mass;
-        int                         m_actor_type;
+        // only used by dynamic actors, 0 keeps the mass computed from the density of the shapes
+        float m_inverse_mass;
+        // a RigidBodyActorType, invalid actors are static
+        int m_actor_type;
     };
 } // namespace Piccolo
\ No newline at end of file
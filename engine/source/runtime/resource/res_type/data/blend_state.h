@@ -1,7 +1,5 @@
 #pragma once
 #include "runtime/core/meta/reflection/reflection.h"
-#include "runtime/resource/res_type/data/animation_clip.h"
-#include "runtime/resource/res_type/data/animation_skeleton_node_map.h"
 #include <string>
 #include <vector>
 namespace Piccolo
@@ -16,19 +14,6 @@ namespace Piccolo
         std::vector<float> blend_weight;
     };
 
-    REFLECTION_TYPE(BlendStateWithClipData)
-    CLASS(BlendStateWithClipData, Fields)
-    {
-        REFLECTION_BODY(BlendStateWithClipData);
-
-    public:
-        int                          clip_count;
-        std::vector<AnimationClip>   blend_clip;
-        std::vector<AnimSkelMap>     blend_anim_skel_map;
-        std::vector<BoneBlendWeight> blend_weight;
-        std::vector<float>           blend_ratio;
-    };
-
     REFLECTION_TYPE(BlendState)
     CLASS(BlendState, Fields)
     {
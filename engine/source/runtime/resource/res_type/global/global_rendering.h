@@ -53,6 +53,7 @@ namespace Piccolo
 
     public:
         bool                m_enable_fxaa {false};
+        bool                m_enable_compute_skinning {false};
         SkyBoxIrradianceMap m_skybox_irradiance_map;
         SkyBoxSpecularMap   m_skybox_specular_map;
         std::string         m_brdf_map;